@@ -0,0 +1,664 @@
+﻿// <copyright file="powenetics_bench.cpp" company="Visualisierungsinstitut der Universität Stuttgart">
+// Copyright © 2026 Visualisierungsinstitut der Universität Stuttgart.
+// Licensed under the MIT licence. See LICENCE file for details.
+// </copyright>
+// <author>Christoph Müller</author>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#if !defined(_WIN32)
+#include <unistd.h>
+#endif /* !defined(_WIN32) */
+
+#include <libpowenetics/powenetics.h>
+#include <libpowenetics/timestamp.h>
+
+#include "clock.h"
+#include "columnar_parser_v2.h"
+#include "convert.h"
+#include "resumable_parser_v2.h"
+#include "stream_parser_v2.h"
+#include "uring_reader.h"
+
+#include "stream_generator.h"
+
+
+/// <summary>
+/// The result of a single benchmark.
+/// </summary>
+struct measurement final {
+    std::string name;
+    std::string variant;
+    std::size_t bytes;
+    std::size_t items;
+    double seconds;
+};
+
+
+/// <summary>
+/// Holds the command line arguments of the benchmark.
+/// </summary>
+struct bench_options final {
+    bool csv = false;
+    std::size_t repeat = 5;
+    std::size_t segments = 100000;
+    std::uint32_t seed = 42;
+};
+
+
+/// <summary>
+/// Prevents the compiler from optimising away computations whose results
+/// are otherwise unused.
+/// </summary>
+static volatile std::uint64_t sink;
+
+
+/// <summary>
+/// Runs <paramref name="work" /> <paramref name="repeat" /> times and answer
+/// the shortest time in seconds.
+/// </summary>
+/// <remarks>
+/// We use the best rather than the mean run, because the best run is least
+/// affected by other activity on the machine and therefore most suitable for
+/// comparing builds.
+/// </remarks>
+static double best_of(_In_ const std::size_t repeat,
+        _In_ const std::function<void(void)>& work) {
+    using namespace std::chrono;
+    auto retval = (std::numeric_limits<double>::max)();
+
+    for (std::size_t i = 0; i < (std::max)(repeat, std::size_t(1)); ++i) {
+        const auto begin = steady_clock::now();
+        work();
+        const auto end = steady_clock::now();
+        retval = (std::min)(retval, duration<double>(end - begin).count());
+    }
+
+    return retval;
+}
+
+
+/// <summary>
+/// Measures the throughput of the <c>push_back</c> method of
+/// <typeparamref name="TParser" /> when feeding <paramref name="stream" /> in
+/// chunks according to <paramref name="fragmentation" />.
+/// </summary>
+/// <remarks>
+/// If the samples are stamped by interpolation, the host time is obtained
+/// once per chunk like the streaming thread does it once per read.
+/// </remarks>
+template<class TSample, class TParser = stream_parser_v2>
+static measurement bench_parser(_In_ const std::string& name,
+        _In_ const synthetic_stream& stream,
+        _In_ const fragmentation& fragmentation,
+        _In_ const bench_options& options,
+        _In_ const powenetics_timestamping timestamping
+            = powenetics_timestamping::per_sample) {
+    const auto chunks = fragmentation.chunks(stream.data.size());
+    const auto interpolated = (timestamping
+        == powenetics_timestamping::interpolated);
+    std::size_t samples = 0;
+
+    const auto seconds = best_of(options.repeat, [&](void) {
+        TParser parser;
+        auto cur = stream.data.data();
+        parser.timestamping(timestamping);
+        samples = 0;
+
+        for (auto c : chunks) {
+            if (interpolated) {
+                parser.received(::powenetics_make_timestamp());
+            }
+            parser.template push_back<TSample>(cur, c,
+                    [&samples](const TSample&) {
+                ++samples;
+            });
+            cur += c;
+        }
+    });
+
+    if (samples != stream.segments) {
+        std::cerr << name << ": expected " << stream.segments
+            << " samples, but got " << samples << "." << std::endl;
+    }
+
+    return measurement { name, fragmentation.to_string(), stream.data.size(),
+        samples, seconds };
+}
+
+
+/// <summary>
+/// Measures the throughput of the endian conversions over all bytes of
+/// <paramref name="stream" />.
+/// </summary>
+static std::vector<measurement> bench_convert(
+        _In_ const synthetic_stream& stream,
+        _In_ const bench_options& options) {
+    const auto data = stream.data.data();
+    const auto size = stream.data.size();
+    std::vector<measurement> retval;
+
+    {
+        const auto cnt = size / sizeof(std::uint16_t);
+        const auto seconds = best_of(options.repeat, [&](void) {
+            std::uint64_t sum = 0;
+            for (std::size_t i = 0; i < cnt; ++i) {
+                sum += ::to_uint16(data + i * sizeof(std::uint16_t));
+            }
+            sink = sum;
+        });
+        retval.push_back({ "to_uint16", "", cnt * sizeof(std::uint16_t), cnt,
+            seconds });
+    }
+
+    {
+        const auto cnt = size / 3;
+        const auto seconds = best_of(options.repeat, [&](void) {
+            std::uint64_t sum = 0;
+            for (std::size_t i = 0; i < cnt; ++i) {
+                sum += ::to_uint24(data + i * 3);
+            }
+            sink = sum;
+        });
+        retval.push_back({ "to_uint24", "", cnt * 3, cnt, seconds });
+    }
+
+    return retval;
+}
+
+
+/// <summary>
+/// Measures how fast timestamps can be created from each of the clocks that
+/// are supported on the machine.
+/// </summary>
+static std::vector<measurement> bench_timestamp(
+        _In_ const bench_options& options) {
+    const std::pair<powenetics_clock, const char *> clocks[] = {
+        { powenetics_clock::system_time, "system time" },
+        { powenetics_clock::monotonic, "monotonic" },
+        { powenetics_clock::monotonic_raw, "monotonic raw" },
+        { powenetics_clock::tsc, "TSC" }
+    };
+    const auto cnt = options.segments;
+    std::vector<measurement> retval;
+
+    for (auto& c : clocks) {
+        const auto clock = ::select_clock(c.first);
+        if (clock == nullptr) {
+            continue;
+        }
+
+        const auto seconds = best_of(options.repeat, [clock, cnt](void) {
+            std::uint64_t sum = 0;
+            for (std::size_t i = 0; i < cnt; ++i) {
+                sum += clock();
+            }
+            sink = sum;
+        });
+        retval.push_back({ "timestamp", c.second, 0, cnt, seconds });
+    }
+
+    return retval;
+}
+
+
+/// <summary>
+/// The data callback used for measuring the end-to-end delivery, which
+/// touches the sample like a client storing the data would.
+/// </summary>
+static void on_sample(_In_ const powenetics_handle,
+        _In_ const powenetics_sample *sample,
+        _In_opt_ void *context) {
+    auto s = static_cast<std::vector<powenetics_sample> *>(context);
+    s->push_back(*sample);
+}
+
+
+/// <summary>
+/// The batch callback used for measuring the end-to-end delivery.
+/// </summary>
+static void on_batch(_In_ const powenetics_handle,
+        _In_reads_(cnt) const powenetics_sample *samples,
+        _In_ const std::size_t cnt,
+        _In_opt_ void *context) {
+    auto s = static_cast<std::vector<powenetics_sample> *>(context);
+    s->insert(s->end(), samples, samples + cnt);
+}
+
+
+/// <summary>
+/// Measures the delivery of samples to the callbacks of the public API in
+/// the same way as the streaming thread of the library does it, but without
+/// the I/O.
+/// </summary>
+static std::vector<measurement> bench_delivery(
+        _In_ const synthetic_stream& stream,
+        _In_ const bench_options& options) {
+    // This is the size of the reads the streaming thread issues.
+    const fragmentation reads(4 * 1024);
+    const auto chunks = reads.chunks(stream.data.size());
+    std::vector<powenetics_sample> output;
+    std::vector<measurement> retval;
+
+    output.reserve(stream.segments);
+
+    {
+        const auto seconds = best_of(options.repeat, [&](void) {
+            stream_parser_v2 parser;
+            auto cur = stream.data.data();
+            output.clear();
+
+            for (auto c : chunks) {
+                parser.push_back(cur, c, [&output](const powenetics_sample& s) {
+                    ::on_sample(nullptr, &s, &output);
+                });
+                cur += c;
+            }
+        });
+        retval.push_back({ "delivery", "per sample", stream.data.size(),
+            output.size(), seconds });
+    }
+
+    {
+        std::vector<powenetics_sample> batch;
+        batch.reserve(4 * 1024 / stream_parser_v2::carry_capacity + 1);
+
+        const auto seconds = best_of(options.repeat, [&](void) {
+            stream_parser_v2 parser;
+            auto cur = stream.data.data();
+            output.clear();
+
+            for (auto c : chunks) {
+                parser.push_back(cur, c, [&batch](const powenetics_sample& s) {
+                    batch.push_back(s);
+                });
+                cur += c;
+
+                if (!batch.empty()) {
+                    ::on_batch(nullptr, batch.data(), batch.size(), &output);
+                    batch.clear();
+                }
+            }
+        });
+        retval.push_back({ "delivery", "per read", stream.data.size(),
+            output.size(), seconds });
+    }
+
+    return retval;
+}
+
+
+/// <summary>
+/// The callback used for measuring the parsing of captures, which counts the
+/// samples.
+/// </summary>
+static void on_capture(_In_reads_(cnt) const powenetics_raw_sample *,
+        _In_ const std::size_t cnt,
+        _In_opt_ void *context) {
+    *static_cast<std::size_t *>(context) += cnt;
+}
+
+
+/// <summary>
+/// Measures how the parsing of a capture scales with the number of threads.
+/// </summary>
+static std::vector<measurement> bench_capture(
+        _In_ const synthetic_stream& stream,
+        _In_ const bench_options& options) {
+    const std::size_t max_threads = (std::max)(
+        std::thread::hardware_concurrency(), 1u);
+    std::vector<measurement> retval;
+
+    for (std::size_t t = 1; t <= max_threads; t *= 2) {
+        std::size_t samples = 0;
+        const auto seconds = best_of(options.repeat, [&](void) {
+            samples = 0;
+            ::powenetics_parse_capture(stream.data.data(), stream.data.size(),
+                on_capture, &samples, t);
+        });
+
+        if (samples != stream.segments) {
+            std::cerr << "capture: expected " << stream.segments
+                << " samples, but got " << samples << "." << std::endl;
+        }
+
+        retval.push_back({ "capture", std::to_string(t) + " threads",
+            stream.data.size(), samples, seconds });
+    }
+
+    return retval;
+}
+
+
+#if !defined(_WIN32)
+/// <summary>
+/// Writes <paramref name="stream" /> into the pipe <paramref name="pipe" />
+/// in chunks of <paramref name="chunk" /> bytes on a separate thread, which
+/// emulates a device sending data.
+/// </summary>
+static std::thread feed_pipe(_In_ const synthetic_stream& stream,
+        _In_ const int pipe,
+        _In_ const std::size_t chunk) {
+    return std::thread([&stream, pipe, chunk](void) {
+        auto cur = stream.data.data();
+        auto end = cur + stream.data.size();
+
+        while (cur < end) {
+            const auto cnt = (std::min)(chunk,
+                static_cast<std::size_t>(end - cur));
+            const auto written = ::write(pipe, cur, cnt);
+            if (written < 0) {
+                std::cerr << "Writing to the pipe failed." << std::endl;
+                break;
+            }
+            cur += written;
+        }
+    });
+}
+
+
+/// <summary>
+/// Measures how fast <paramref name="stream" /> can be received and parsed
+/// if it is read from a pipe standing in for the serial port, once using a
+/// blocking <c>read</c> and once using the <see cref="uring_reader" />.
+/// </summary>
+/// <remarks>
+/// The variant reports the number of system calls the reader made for
+/// waiting and reading in the last run.
+/// </remarks>
+static std::vector<measurement> bench_io(
+        _In_ const synthetic_stream& stream,
+        _In_ const bench_options& options) {
+    // This is the size of the reads the streaming thread issues.
+    const std::size_t size = 4 * 1024;
+    // This emulates a device that sends a few segments at a time.
+    const std::size_t chunk = 256;
+    std::vector<measurement> retval;
+
+    {
+        std::vector<stream_parser_v2::byte_type> buffer(size);
+        std::size_t calls = 0;
+        std::size_t samples = 0;
+
+        const auto seconds = best_of(options.repeat, [&](void) {
+            int pipe[2];
+            if (::pipe(pipe) != 0) {
+                std::cerr << "Creating the pipe failed." << std::endl;
+                return;
+            }
+
+            auto writer = feed_pipe(stream, pipe[1], chunk);
+            stream_parser_v2 parser;
+            std::size_t total = 0;
+            calls = 0;
+            samples = 0;
+
+            while (total < stream.data.size()) {
+                const auto cnt = ::read(pipe[0], buffer.data(), buffer.size());
+                ++calls;
+                if (cnt <= 0) {
+                    break;
+                }
+
+                parser.push_back(buffer.data(), cnt,
+                        [&samples](const powenetics_sample&) {
+                    ++samples;
+                });
+                total += cnt;
+            }
+
+            writer.join();
+            ::close(pipe[0]);
+            ::close(pipe[1]);
+        });
+
+        retval.push_back({ "pipe (read)", std::to_string(calls) + " calls",
+            stream.data.size(), samples, seconds });
+    }
+
+#if defined(POWENETICS_IO_URING)
+    {
+        std::size_t calls = 0;
+        std::size_t samples = 0;
+        auto supported = true;
+
+        const auto seconds = best_of(options.repeat, [&](void) {
+            int pipe[2];
+            if (!supported || (::pipe(pipe) != 0)) {
+                return;
+            }
+
+            uring_reader reader;
+            if (FAILED(reader.open(pipe[0], -1, uring_reader::default_depth,
+                    size))) {
+                std::cerr << "io_uring is not available." << std::endl;
+                ::close(pipe[0]);
+                ::close(pipe[1]);
+                supported = false;
+                return;
+            }
+
+            auto writer = feed_pipe(stream, pipe[1], chunk);
+            stream_parser_v2 parser;
+            std::size_t total = 0;
+            samples = 0;
+
+            while ((total < stream.data.size())
+                    && SUCCEEDED(reader.wait(-1))) {
+                const stream_parser_v2::byte_type *data;
+                std::size_t cnt;
+
+                while (reader.next(data, cnt) == S_OK) {
+                    parser.push_back(data, cnt,
+                            [&samples](const powenetics_sample&) {
+                        ++samples;
+                    });
+                    total += cnt;
+                }
+            }
+
+            writer.join();
+            calls = static_cast<std::size_t>(reader.calls());
+            reader.close();
+            ::close(pipe[0]);
+            ::close(pipe[1]);
+        });
+
+        if (supported) {
+            retval.push_back({ "pipe (io_uring)",
+                std::to_string(calls) + " calls", stream.data.size(),
+                samples, seconds });
+        }
+    }
+#endif /* defined(POWENETICS_IO_URING) */
+
+    return retval;
+}
+#endif /* !defined(_WIN32) */
+
+
+/// <summary>
+/// Parses the command line.
+/// </summary>
+static bool parse_options(_Out_ bench_options& options, _In_ const int argc,
+        _In_reads_(argc) const char **argv) {
+    for (int i = 1; i < argc; ++i) {
+        const auto has_value = (i + 1 < argc);
+
+        if (::strcmp(argv[i], "--csv") == 0) {
+            options.csv = true;
+        } else if (has_value && (::strcmp(argv[i], "--repeat") == 0)) {
+            options.repeat = std::strtoull(argv[++i], nullptr, 10);
+        } else if (has_value && (::strcmp(argv[i], "--segments") == 0)) {
+            options.segments = std::strtoull(argv[++i], nullptr, 10);
+        } else if (has_value && (::strcmp(argv[i], "--seed") == 0)) {
+            options.seed = static_cast<std::uint32_t>(
+                std::strtoul(argv[++i], nullptr, 10));
+        } else {
+            std::cerr << "Usage: " << argv[0] << " [--segments <n>] "
+                "[--repeat <n>] [--seed <n>] [--csv]" << std::endl;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+
+/// <summary>
+/// Prints the <paramref name="results" /> as table or CSV.
+/// </summary>
+static void print(_In_ const std::vector<measurement>& results,
+        _In_ const bool csv) {
+    if (csv) {
+        std::cout << "name,variant,bytes,items,seconds,MB/s,Mitems/s"
+            << std::endl;
+    } else {
+        std::cout << std::left << std::setw(40) << "Benchmark"
+            << std::setw(14) << "Variant"
+            << std::right << std::setw(12) << "MB/s"
+            << std::setw(14) << "Mitems/s"
+            << std::setw(12) << "ns/item" << std::endl;
+    }
+
+    for (auto& r : results) {
+        const auto mbs = r.bytes / r.seconds / 1.0e6;
+        const auto mis = r.items / r.seconds / 1.0e6;
+        const auto ns = (r.items > 0) ? r.seconds * 1.0e9 / r.items : 0.0;
+
+        if (csv) {
+            std::cout << r.name << "," << r.variant << "," << r.bytes << ","
+                << r.items << "," << r.seconds << "," << mbs << "," << mis
+                << std::endl;
+        } else {
+            std::cout << std::left << std::setw(40) << r.name
+                << std::setw(14) << r.variant
+                << std::right << std::fixed << std::setprecision(1)
+                << std::setw(12) << mbs
+                << std::setw(14) << std::setprecision(2) << mis
+                << std::setw(12) << std::setprecision(1) << ns
+                << std::endl;
+        }
+    }
+}
+
+
+/// <summary>
+/// The entry point of the benchmark.
+/// </summary>
+/// <remarks>
+/// The benchmark measures the throughput of the data path from the bytes
+/// received from the device to the callback of the client on synthetic
+/// data, so it can be run on any machine without a device attached.
+/// </remarks>
+/// <param name="argc">The number of command line arguments.</param>
+/// <param name="argv">The list of command line arguments.</param>
+/// <returns>Zero in case of success, a non-zero value if the command line
+/// was invalid.</returns>
+int main(_In_ const int argc, _In_reads_(argc) const char **argv) {
+    bench_options options;
+    if (!parse_options(options, argc, argv)) {
+        return 1;
+    }
+
+    stream_configuration config;
+    config.segments = options.segments;
+    config.seed = options.seed;
+    const auto clean = ::generate_stream(config);
+
+    config.garbage_rate = 0.01;
+    const auto garbage = ::generate_stream(config);
+
+    config.garbage_rate = 0.0;
+    config.delimiter_rate = 0.05;
+    const auto delimiters = ::generate_stream(config);
+
+    config.delimiter_rate = 0.0;
+    config.pcie_powered = false;
+    const auto no_pcie = ::generate_stream(config);
+
+    const fragmentation fragmentations[] = {
+        fragmentation(1),
+        fragmentation(64),
+        fragmentation(4 * 1024),
+        fragmentation(1, 512, options.seed)
+    };
+
+    std::vector<measurement> results;
+
+    for (auto& f : fragmentations) {
+        results.push_back(bench_parser<powenetics_sample>(
+            "push_back (sample)", clean, f, options));
+    }
+    for (auto& f : fragmentations) {
+        results.push_back(bench_parser<powenetics_raw_sample>(
+            "push_back (raw)", clean, f, options));
+    }
+
+    {
+        const fragmentation f(4 * 1024);
+        results.push_back(bench_parser<powenetics_sample>(
+            "push_back (sample, 1% garbage)", garbage, f, options));
+        results.push_back(bench_parser<powenetics_sample>(
+            "push_back (sample, fake delimiters)", delimiters, f, options));
+        results.push_back(bench_parser<powenetics_sample>(
+            "push_back (sample, no PCIe)", no_pcie, f, options));
+        results.push_back(bench_parser<powenetics_sample>(
+            "push_back (sample, interpolated)", clean, f, options,
+            powenetics_timestamping::interpolated));
+        results.push_back(bench_parser<powenetics_raw_sample>(
+            "push_back (raw, interpolated)", clean, f, options,
+            powenetics_timestamping::interpolated));
+        results.push_back(bench_parser<powenetics_segment>(
+            "push_back (segment)", clean, f, options));
+        results.push_back(bench_parser<powenetics_sample, columnar_parser_v2>(
+            "columnar (sample)", clean, f, options));
+        results.push_back(bench_parser<powenetics_raw_sample,
+            columnar_parser_v2>("columnar (raw)", clean, f, options));
+        results.push_back(bench_parser<powenetics_sample, columnar_parser_v2>(
+            "columnar (sample, 1% garbage)", garbage, f, options));
+        results.push_back(bench_parser<powenetics_sample,
+            resumable_parser_v2>("resumable (sample)", clean, f, options));
+        results.push_back(bench_parser<powenetics_raw_sample,
+            resumable_parser_v2>("resumable (raw)", clean, f, options));
+        results.push_back(bench_parser<powenetics_sample,
+            resumable_parser_v2>("resumable (sample, 1% garbage)", garbage, f,
+            options));
+    }
+
+    for (auto& m : bench_convert(clean, options)) {
+        results.push_back(m);
+    }
+
+    for (auto& m : bench_timestamp(options)) {
+        results.push_back(m);
+    }
+
+    for (auto& m : bench_delivery(clean, options)) {
+        results.push_back(m);
+    }
+
+    for (auto& m : bench_capture(clean, options)) {
+        results.push_back(m);
+    }
+
+#if !defined(_WIN32)
+    for (auto& m : bench_io(clean, options)) {
+        results.push_back(m);
+    }
+#endif /* !defined(_WIN32) */
+
+    print(results, options.csv);
+    return 0;
+}
@@ -0,0 +1,159 @@
+﻿// <copyright file="stream_generator.cpp" company="Visualisierungsinstitut der Universität Stuttgart">
+// Copyright © 2026 Visualisierungsinstitut der Universität Stuttgart.
+// Licensed under the MIT licence. See LICENCE file for details.
+// </copyright>
+// <author>Christoph Müller</author>
+
+#include "stream_generator.h"
+
+#include <algorithm>
+#include <iterator>
+
+#include "convert.h"
+#include "responses.h"
+
+
+/// <summary>
+/// The nominal voltages of the channels in millivolts when a 24-pin ATX
+/// connector is attached. A zero indicates that the channel is not
+/// connected.
+/// </summary>
+static constexpr std::uint16_t nominal_voltages[] = {
+    3300,   // ATX 3.3V
+    5000,   // ATX 5V STB
+    12000,  // ATX 12V
+    5000,   // ATX 5V
+    12000,  // EPS #1
+    0,      // ATX 12V STB (10-pin only)
+    12000,  // EPS #3
+    12000,  // EPS #2
+    12000,  // PCIe #3
+    12000,  // PCIe #2
+    3300,   // PEG 3.3V
+    12000,  // PEG 12V
+    12000   // PCIe #1
+};
+
+
+/*
+ * fragmentation::fragmentation
+ */
+fragmentation::fragmentation(_In_ const std::size_t size)
+    : _max(size), _min(size), _seed(0) { }
+
+
+/*
+ * fragmentation::fragmentation
+ */
+fragmentation::fragmentation(_In_ const std::size_t min,
+        _In_ const std::size_t max, _In_ const std::uint32_t seed)
+    : _max((std::max)(min, max)), _min(min), _seed(seed) { }
+
+
+/*
+ * fragmentation::chunks
+ */
+std::vector<std::size_t> fragmentation::chunks(
+        _In_ const std::size_t size) const {
+    std::mt19937 rng(this->_seed);
+    std::uniform_int_distribution<std::size_t> dist(
+        (std::max)(this->_min, std::size_t(1)),
+        (std::max)(this->_max, std::size_t(1)));
+    std::vector<std::size_t> retval;
+
+    for (std::size_t rem = size; rem > 0;) {
+        const auto cnt = (std::min)(dist(rng), rem);
+        retval.push_back(cnt);
+        rem -= cnt;
+    }
+
+    return retval;
+}
+
+
+/*
+ * fragmentation::to_string
+ */
+std::string fragmentation::to_string(void) const {
+    if (this->_min == this->_max) {
+        return std::to_string(this->_min);
+    } else {
+        return std::to_string(this->_min) + "-" + std::to_string(this->_max);
+    }
+}
+
+
+/*
+ * ::generate_stream
+ */
+synthetic_stream generate_stream(_In_ const stream_configuration& config) {
+    constexpr std::size_t channels = std::size(nominal_voltages);
+    auto& delimiter = responses_v2::segment_delimiter;
+    std::mt19937 rng(config.seed);
+    std::bernoulli_distribution garbage(config.garbage_rate);
+    std::uniform_int_distribution<std::size_t> garbage_length(1,
+        (std::max)(config.max_garbage, std::size_t(1)));
+    std::bernoulli_distribution fake_delimiter(config.delimiter_rate);
+    std::uniform_int_distribution<int> noise(-50, 50);
+    std::uniform_int_distribution<int> step(-100, 100);
+    std::uniform_int_distribution<int> byte(0, 255);
+    synthetic_stream retval;
+    retval.segments = 0;
+
+    // The currents perform a random walk such that the values look like
+    // varying load rather than white noise.
+    std::int32_t currents[channels];
+    for (std::size_t c = 0; c < channels; ++c) {
+        currents[c] = (nominal_voltages[c] > 0) ? 2000 : 0;
+    }
+
+    retval.data.reserve((config.segments + 1) * (2 + 67));
+
+    for (std::size_t i = 0; i < config.segments; ++i) {
+        std::uint8_t segment[67];
+        ::from_uint16(segment, static_cast<std::uint16_t>(i));
+
+        for (std::size_t c = 0; c < channels; ++c) {
+            auto dst = segment + sizeof(std::uint16_t) + 5 * c;
+            const auto pcie = (c == 8) || (c == 9) || (c == 12);
+            const auto connected = (nominal_voltages[c] > 0)
+                && (config.pcie_powered || !pcie);
+
+            if (connected) {
+                currents[c] = (std::clamp)(currents[c] + step(rng), 0,
+                    20000);
+                ::from_uint16(dst, static_cast<std::uint16_t>(
+                    nominal_voltages[c] + noise(rng)));
+                ::from_uint24(dst + 2, static_cast<std::uint32_t>(
+                    currents[c]));
+            } else {
+                ::from_uint16(dst, static_cast<std::uint16_t>(
+                    (std::max)(noise(rng), 0)));
+                ::from_uint24(dst + 2, 0);
+            }
+
+            if (fake_delimiter(rng)) {
+                dst[3] = delimiter.front();
+                dst[4] = delimiter.back();
+            }
+        }
+
+        retval.data.insert(retval.data.end(), delimiter.begin(),
+            delimiter.end());
+        retval.data.insert(retval.data.end(), segment,
+            segment + sizeof(segment));
+
+        if (garbage(rng)) {
+            // The garbage breaks the framing of the segment before.
+            const auto cnt = garbage_length(rng);
+            for (std::size_t j = 0; j < cnt; ++j) {
+                retval.data.push_back(static_cast<std::uint8_t>(byte(rng)));
+            }
+        } else {
+            ++retval.segments;
+        }
+    }
+
+    retval.data.insert(retval.data.end(), delimiter.begin(), delimiter.end());
+    return retval;
+}
@@ -0,0 +1,127 @@
+﻿// <copyright file="stream_generator.h" company="Visualisierungsinstitut der Universität Stuttgart">
+// Copyright © 2026 Visualisierungsinstitut der Universität Stuttgart.
+// Licensed under the MIT licence. See LICENCE file for details.
+// </copyright>
+// <author>Christoph Müller</author>
+
+#pragma once
+
+#include <cinttypes>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <libpowenetics/api.h>
+
+
+/// <summary>
+/// Configures the synthetic data stream created by
+/// <see cref="generate_stream" />.
+/// </summary>
+struct stream_configuration final {
+
+    /// <summary>
+    /// The number of segments to be generated.
+    /// </summary>
+    std::size_t segments = 100000;
+
+    /// <summary>
+    /// The probability of injecting garbage bytes after a segment, which
+    /// breaks the framing of this segment.
+    /// </summary>
+    double garbage_rate = 0.0;
+
+    /// <summary>
+    /// The maximum number of bytes injected if garbage is injected.
+    /// </summary>
+    std::size_t max_garbage = 64;
+
+    /// <summary>
+    /// The probability of the current of a channel containing the bytes of
+    /// the segment delimiter.
+    /// </summary>
+    double delimiter_rate = 0.0;
+
+    /// <summary>
+    /// Determines whether the PCIe connectors are powered.
+    /// </summary>
+    bool pcie_powered = true;
+
+    /// <summary>
+    /// The seed for the random number generator, which makes streams
+    /// reproducible.
+    /// </summary>
+    std::uint32_t seed = 42;
+};
+
+
+/// <summary>
+/// A synthetic data stream as it would be received from a Powenetics v2
+/// device.
+/// </summary>
+struct synthetic_stream final {
+
+    /// <summary>
+    /// The raw bytes of the stream.
+    /// </summary>
+    std::vector<std::uint8_t> data;
+
+    /// <summary>
+    /// The number of correctly framed segments in <see cref="data" />, which
+    /// is the number of samples a parser must deliver at most.
+    /// </summary>
+    std::size_t segments;
+};
+
+
+/// <summary>
+/// Splits a stream into chunks of random size between
+/// <see cref="min" /> and <see cref="max" /> bytes, which emulates how data
+/// arrive from the serial port.
+/// </summary>
+class fragmentation final {
+
+public:
+
+    /// <summary>
+    /// Initialises a new instance producing chunks of fixed size.
+    /// </summary>
+    explicit fragmentation(_In_ const std::size_t size);
+
+    /// <summary>
+    /// Initialises a new instance producing chunks of random size.
+    /// </summary>
+    fragmentation(_In_ const std::size_t min, _In_ const std::size_t max,
+        _In_ const std::uint32_t seed = 42);
+
+    /// <summary>
+    /// Answer the sizes of the chunks for a stream of
+    /// <paramref name="size" /> bytes.
+    /// </summary>
+    /// <remarks>
+    /// The chunks are computed up-front such that the random number
+    /// generator is not part of the measurement.
+    /// </remarks>
+    std::vector<std::size_t> chunks(_In_ const std::size_t size) const;
+
+    /// <summary>
+    /// Answer a human-readable description of the fragmentation.
+    /// </summary>
+    std::string to_string(void) const;
+
+private:
+
+    std::size_t _max;
+    std::size_t _min;
+    std::uint32_t _seed;
+};
+
+
+/// <summary>
+/// Generates a stream of segments with realistic readings for all
+/// channels.
+/// </summary>
+/// <param name="config">The configuration of the stream.</param>
+/// <returns>The synthetic stream, which is terminated by a delimiter such
+/// that all segments can be parsed.</returns>
+synthetic_stream generate_stream(_In_ const stream_configuration& config);
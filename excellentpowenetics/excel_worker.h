@@ -1,19 +1,15 @@
 ﻿// <copyright file="excel_worker.h" company="Visualisierungsinstitut der Universität Stuttgart">
-// Copyright © 2023 - 2024 Visualisierungsinstitut der Universität Stuttgart.
+// Copyright © 2023 - 2026 Visualisierungsinstitut der Universität Stuttgart.
 // Licensed under the MIT licence. See LICENCE file for details.
 // </copyright>
 // <author>Christoph Müller</author>
 
 #pragma once
 
-#include <mutex>
 #include <thread>
-#include <vector>
 
 #include <libpowenetics/powenetics.h>
 
-#include <wil/resource.h>
-
 #include "excel_output.h"
 
 
@@ -21,6 +17,11 @@
 /// Manages the output of Powenetics data into an excel sheet and most
 /// importantly decouples writing the data from the sampler thread.
 /// </summary>
+/// <remarks>
+/// The worker pulls the samples from the bounded queue of the library rather
+/// than accumulating them itself, so the memory it uses does not grow if Excel
+/// cannot keep up during a long capture.
+/// </remarks>
 class excel_worker final {
 
 public:
@@ -64,40 +65,23 @@ public:
     /// to exit.
     /// </summary>
     /// <remarks>
-    /// It is safe to assume that the writer thread has exited once the method
-    /// returns. The destructor will call this method, too, if streaming has not
-    /// been stopped before.
+    /// The writer thread writes the samples that are still queued before it
+    /// exits. It is safe to assume that the writer thread has exited once the
+    /// method returns. The destructor will call this method, too, if streaming
+    /// has not been stopped before.
     /// </remarks>
     void stop(void);
 
 private:
 
     /// <summary>
-    /// The callback that can be registered with a
-    /// <see cref="powenetics_handle" /> to write its data to the
-    /// configured Excel sheet. Note that a pointer to the
-    /// <see cref="excel_worker" /> must be passed as the context.
-    /// </summary>
-    /// <param name="source">The handle to the device we receive the
-    /// data from.</param>
-    /// <param name="sample">The sample that the device has just produced.
-    /// </param>
-    /// <param name="context">A pointer to this worker object.</param>
-    static void callback(_In_ powenetics_handle source,
-        _In_ const struct powenetics_sample_t *sample,
-        _In_opt_ void *context);
-
-    /// <summary>
-    /// The worker thread that periodically writes the data into the
-    /// Excel sheet.
+    /// The worker thread that continuously reads the samples from the queue
+    /// of the device and writes them into the Excel sheet.
     /// </summary>
     void worker(void);
 
-    wil::unique_event _event;
     visus::powenetics::unique_handle _input;
-    std::mutex _lock;
     excel_output& _output;
-    std::vector<powenetics_sample> _samples;
     std::thread _thread;
 
 };
@@ -0,0 +1,88 @@
+﻿// <copyright file="batch.h" company="Visualisierungsinstitut der Universität Stuttgart">
+// Copyright © 2026 Visualisierungsinstitut der Universität Stuttgart.
+// Licensed under the MIT licence. See LICENCE file for details.
+// </copyright>
+// <author>Christoph Müller</author>
+
+#if !defined(_LIBPOWENETICS_BATCH_H)
+#define _LIBPOWENETICS_BATCH_H
+#pragma once
+
+#include "libpowenetics/api.h"
+#include "libpowenetics/types.h"
+
+
+/// <summary>
+/// Configures when samples are delivered to a
+/// <see cref="powenetics_batch_callback" />.
+/// </summary>
+/// <remarks>
+/// A batch is delivered as soon as one of the configured limits is reached.
+/// If neither limit is set, all samples parsed from a single read from the
+/// serial port are delivered as one batch.
+/// </remarks>
+typedef struct LIBPOWENETICS_API powenetics_batch_configuration_t {
+
+    /// <summary>
+    /// The version of the structure.
+    /// </summary>
+    /// <remarks>
+    /// <para>This member allows the library to discern between future versions
+    /// of the structure. It must be initialised to 2 in the first version of
+    /// the library (for Powenetics v2).</para>
+    /// <para>This must be the first member of the struct and any future version
+    /// of it.</para>
+    /// </remarks>
+    uint32_t version;
+
+    /// <summary>
+    /// The number of samples that are accumulated before the batch is
+    /// delivered.
+    /// </summary>
+    /// <remarks>
+    /// If this is zero, the number of samples does not cause the batch to be
+    /// delivered.
+    /// </remarks>
+    size_t samples;
+
+    /// <summary>
+    /// The time in milliseconds after which a batch is delivered even if it
+    /// has not reached <see cref="samples" />.
+    /// </summary>
+    /// <remarks>
+    /// The time is measured from the arrival of the first sample in the batch
+    /// and checked whenever data have been read from the device, so the actual
+    /// delay may be slightly longer. On POSIX systems, it is also checked
+    /// every 100 ms if the device does not send any data. If this is zero,
+    /// time does not cause the batch to be delivered.
+    /// </remarks>
+    uint32_t window;
+} powenetics_batch_configuration;
+
+
+#if defined(__cplusplus)
+extern "C" {
+#endif /* defined(__cplusplus) */
+
+/// <summary>
+/// Applies the default configuration for batched delivery to the structure
+/// passed to the method.
+/// </summary>
+/// <remarks>
+/// The default configuration delivers all samples parsed from a single read
+/// from the device as one batch.
+/// </remarks>
+/// <param name="config">A pointer to the structure to be filled. The version
+/// of the structure must have been initialised before the call.</param>
+/// <returns><c>S_OK</c> in case of success,
+/// <c>E_POINTER</c> if <paramref name="config" /> is <c>nullptr</c>,
+/// <c>E_INVALIDARG</c> if the version of the configuration has not been
+/// initialised or is unsupported by the function.</returns>
+HRESULT LIBPOWENETICS_API powenetics_initialise_batch_configuration(
+    _In_ powenetics_batch_configuration *config);
+
+#if defined(__cplusplus)
+}
+#endif /* defined(__cplusplus) */
+
+#endif /* !defined(_LIBPOWENETICS_BATCH_H) */
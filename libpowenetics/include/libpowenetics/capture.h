@@ -0,0 +1,76 @@
+﻿// <copyright file="capture.h" company="Visualisierungsinstitut der Universität Stuttgart">
+// Copyright © 2026 Visualisierungsinstitut der Universität Stuttgart.
+// Licensed under the MIT licence. See LICENCE file for details.
+// </copyright>
+// <author>Christoph Müller</author>
+
+#if !defined(_LIBPOWENETICS_CAPTURE_H)
+#define _LIBPOWENETICS_CAPTURE_H
+#pragma once
+
+#include "libpowenetics/api.h"
+#include "libpowenetics/raw_sample.h"
+#include "libpowenetics/types.h"
+
+
+/// <summary>
+/// The callback receiving the samples parsed from a capture.
+/// </summary>
+/// <param name="samples">The samples parsed from the capture, which are only
+/// valid until the callback returns.</param>
+/// <param name="cnt">The number of samples in <paramref name="samples" />,
+/// which is never zero.</param>
+/// <param name="context">The user-defined context pointer passed to
+/// <see cref="powenetics_parse_capture" />.</param>
+typedef void (*powenetics_capture_callback)(
+    _In_reads_(cnt) const struct powenetics_raw_sample_t *samples,
+    _In_ const size_t cnt,
+    _In_opt_ void *context);
+
+
+#if defined(__cplusplus)
+extern "C" {
+#endif /* defined(__cplusplus) */
+
+/// <summary>
+/// Parses a capture of the raw data stream of a Powenetics v2 device.
+/// </summary>
+/// <remarks>
+/// <para>A capture is everything the device has sent over the serial port,
+/// for instance a copy of the TTY made while streaming. The function splits
+/// the capture into chunks and parses them in parallel, which is much faster
+/// than passing the data through a parser one after the other for large
+/// captures. Large files should be mapped into memory for this purpose.</para>
+/// <para>The samples are the same as a single parser would produce for the
+/// whole capture, including the indices and the gaps in the sequence of
+/// samples. As the capture does not record when the data have been received,
+/// the timestamps of all samples are zero.</para>
+/// <para>The callback is invoked on the calling thread, with the samples in
+/// the order of their index. The function returns after the last sample has
+/// been delivered.</para>
+/// </remarks>
+/// <param name="data">The captured data.</param>
+/// <param name="cnt">The size of <paramref name="data" /> in bytes.</param>
+/// <param name="callback">The callback receiving the samples.</param>
+/// <param name="context">A user-defined context pointer that is passed to
+/// <paramref name="callback" />.</param>
+/// <param name="threads">The number of threads parsing the chunks, or zero
+/// to use all logical processors of the machine.</param>
+/// <returns><c>S_OK</c> in case of success,
+/// <c>E_POINTER</c> if <paramref name="data" /> is <c>nullptr</c> while
+/// <paramref name="cnt" /> is non-zero or if <paramref name="callback" /> is
+/// <c>nullptr</c>,
+/// <c>E_OUTOFMEMORY</c> if the parsed chunks could not be allocated,
+/// <c>E_FAIL</c> if the worker threads could not be started.</returns>
+HRESULT LIBPOWENETICS_API powenetics_parse_capture(
+    _In_reads_(cnt) const uint8_t *data,
+    _In_ const size_t cnt,
+    _In_ const powenetics_capture_callback callback,
+    _In_opt_ void *context,
+    _In_ const size_t threads);
+
+#if defined(__cplusplus)
+} /* extern "C" */
+#endif /* defined(__cplusplus) */
+
+#endif /* !defined(_LIBPOWENETICS_CAPTURE_H) */
@@ -0,0 +1,94 @@
+﻿// <copyright file="connector_profile.h" company="Visualisierungsinstitut der Universität Stuttgart">
+// Copyright © 2026 Visualisierungsinstitut der Universität Stuttgart.
+// Licensed under the MIT licence. See LICENCE file for details.
+// </copyright>
+// <author>Christoph Müller</author>
+
+#if !defined(_LIBPOWENETICS_CONNECTOR_PROFILE_H)
+#define _LIBPOWENETICS_CONNECTOR_PROFILE_H
+#pragma once
+
+#include "libpowenetics/api.h"
+#include "libpowenetics/types.h"
+
+
+/// <summary>
+/// Identifies the type of ATX connector attached to the device.
+/// </summary>
+typedef enum LIBPOWENETICS_ENUM powenetics_atx_connector_t {
+
+    /// <summary>
+    /// The type of the connector has not yet been determined, because no
+    /// data have been received from the device.
+    /// </summary>
+    LIBPOWENETICS_ENUM_SCOPE(powenetics_atx_connector, unknown) = 0,
+
+    /// <summary>
+    /// A 10-pin ATX connector (ATX12VO), which reports 12V standby power
+    /// instead of 5V standby power and has no 3.3V rail.
+    /// </summary>
+    LIBPOWENETICS_ENUM_SCOPE(powenetics_atx_connector, pin10) = 10,
+
+    /// <summary>
+    /// A 24-pin ATX connector.
+    /// </summary>
+    LIBPOWENETICS_ENUM_SCOPE(powenetics_atx_connector, pin24) = 24
+} powenetics_atx_connector;
+
+
+/// <summary>
+/// The flag in <see cref="powenetics_connector_profile::pcie" /> indicating
+/// that PCIe connector #1 is supplied with power.
+/// </summary>
+#define POWENETICS_PCIE_12V1 (0x1)
+
+/// <summary>
+/// The flag in <see cref="powenetics_connector_profile::pcie" /> indicating
+/// that PCIe connector #2 is supplied with power.
+/// </summary>
+#define POWENETICS_PCIE_12V2 (0x2)
+
+/// <summary>
+/// The flag in <see cref="powenetics_connector_profile::pcie" /> indicating
+/// that PCIe connector #3 is supplied with power.
+/// </summary>
+#define POWENETICS_PCIE_12V3 (0x4)
+
+
+/// <summary>
+/// Describes which connectors of the Powenetics v2 power measurement device
+/// are in use as detected from the data stream.
+/// </summary>
+/// <remarks>
+/// The library determines the profile from the readings it receives and uses
+/// it to select a decoder specialised for the channels that are in use. The
+/// profile is therefore only known after the first sample has been received
+/// and it changes if a PCIe connector is powered up or down while streaming.
+/// </remarks>
+typedef struct LIBPOWENETICS_API powenetics_connector_profile_t {
+
+    /// <summary>
+    /// The version of the structure, which must be initialised when this
+    /// structure is passed to any API.
+    /// </summary>
+    /// <remarks>
+    /// <para>For the current version of the API, this value must always be 2
+    /// for Powenetics v2.</para>
+    /// <para>This must be the first member of the struct and any future version
+    /// of it.</para>
+    /// </remarks>
+    uint32_t version;
+
+    /// <summary>
+    /// The type of ATX connector attached to the device.
+    /// </summary>
+    powenetics_atx_connector atx;
+
+    /// <summary>
+    /// A combination of the <c>POWENETICS_PCIE_*</c> flags for the PCIe
+    /// connectors that report a voltage.
+    /// </summary>
+    uint32_t pcie;
+} powenetics_connector_profile;
+
+#endif /* !defined(_LIBPOWENETICS_CONNECTOR_PROFILE_H) */
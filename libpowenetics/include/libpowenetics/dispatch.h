@@ -0,0 +1,116 @@
+﻿// <copyright file="dispatch.h" company="Visualisierungsinstitut der Universität Stuttgart">
+// Copyright © 2026 Visualisierungsinstitut der Universität Stuttgart.
+// Licensed under the MIT licence. See LICENCE file for details.
+// </copyright>
+// <author>Christoph Müller</author>
+
+#if !defined(_LIBPOWENETICS_DISPATCH_H)
+#define _LIBPOWENETICS_DISPATCH_H
+#pragma once
+
+#include "libpowenetics/api.h"
+#include "libpowenetics/overflow.h"
+#include "libpowenetics/types.h"
+
+
+/// <summary>
+/// Identifies the threads the callbacks of a device can be invoked on.
+/// </summary>
+typedef enum LIBPOWENETICS_ENUM powenetics_dispatch_t {
+
+    /// <summary>
+    /// The callbacks are invoked on the thread reading from the device, which
+    /// is the default.
+    /// </summary>
+    /// <remarks>
+    /// This causes the least overhead, but the device is not read while a
+    /// callback is running, so a slow callback can cause the buffer of the
+    /// serial port to overflow.
+    /// </remarks>
+    LIBPOWENETICS_ENUM_SCOPE(powenetics_dispatch, synchronous) = 0,
+
+    /// <summary>
+    /// The callbacks are invoked on a dispatch thread, to which the thread
+    /// reading from the device hands the data over through a lock-free queue.
+    /// </summary>
+    /// <remarks>
+    /// The thread reading from the device does not wait for the callbacks
+    /// unless the queue is full and the overflow policy is
+    /// <see cref="powenetics_overflow::block" />.
+    /// </remarks>
+    LIBPOWENETICS_ENUM_SCOPE(powenetics_dispatch, asynchronous) = 1
+} powenetics_dispatch;
+
+
+/// <summary>
+/// Configures the thread the callbacks of a device are invoked on.
+/// </summary>
+typedef struct LIBPOWENETICS_API powenetics_dispatch_configuration_t {
+
+    /// <summary>
+    /// The version of the structure.
+    /// </summary>
+    /// <remarks>
+    /// <para>This member allows the library to discern between future versions
+    /// of the structure. It must be initialised to 2 in the first version of
+    /// the library (for Powenetics v2).</para>
+    /// <para>This must be the first member of the struct and any future version
+    /// of it.</para>
+    /// </remarks>
+    uint32_t version;
+
+    /// <summary>
+    /// Determines the thread the callbacks are invoked on.
+    /// </summary>
+    powenetics_dispatch dispatch;
+
+    /// <summary>
+    /// The minimum number of samples or segments the queue to the dispatch
+    /// thread can hold.
+    /// </summary>
+    /// <remarks>
+    /// The capacity is rounded up to the next power of two. For batched
+    /// delivery, the end of each batch takes an additional slot. The capacity
+    /// is ignored for <see cref="powenetics_dispatch::synchronous" /> and
+    /// must not be zero otherwise.
+    /// </remarks>
+    size_t capacity;
+
+    /// <summary>
+    /// Determines what happens if the callbacks do not keep up with the
+    /// device and the queue to the dispatch thread is full.
+    /// </summary>
+    /// <remarks>
+    /// The end of a batch is never decimated. If it is discarded, the batch
+    /// is delivered along with the next one.
+    /// </remarks>
+    powenetics_overflow overflow;
+} powenetics_dispatch_configuration;
+
+
+#if defined(__cplusplus)
+extern "C" {
+#endif /* defined(__cplusplus) */
+
+/// <summary>
+/// Applies the default dispatch configuration to the structure passed to the
+/// method.
+/// </summary>
+/// <remarks>
+/// The default configuration invokes the callbacks on the thread reading
+/// from the device.
+/// </remarks>
+/// <param name="config">A pointer to the structure to be filled. The version
+/// of the structure must have been initialised before the call.</param>
+/// <returns><c>S_OK</c> in case of success,
+/// <c>E_POINTER</c> if <paramref name="config" /> is <c>nullptr</c>,
+/// <c>E_INVALIDARG</c> if the version of the configuration has not been
+/// initialised or is unsupported by the function.</returns>
+HRESULT LIBPOWENETICS_API powenetics_initialise_dispatch_configuration(
+    _In_ powenetics_dispatch_configuration *config);
+
+#if defined(__cplusplus)
+}
+#endif /* defined(__cplusplus) */
+
+#endif /* !defined(_LIBPOWENETICS_DISPATCH_H) */
@@ -0,0 +1,133 @@
+﻿// <copyright file="energy.h" company="Visualisierungsinstitut der Universität Stuttgart">
+// Copyright © 2026 Visualisierungsinstitut der Universität Stuttgart.
+// Licensed under the MIT licence. See LICENCE file for details.
+// </copyright>
+// <author>Christoph Müller</author>
+
+#if !defined(_LIBPOWENETICS_ENERGY_H)
+#define _LIBPOWENETICS_ENERGY_H
+#pragma once
+
+#include "libpowenetics/api.h"
+#include "libpowenetics/types.h"
+
+
+/// <summary>
+/// The energy the library has integrated from the data stream of a Powenetics
+/// v2 power measurement device, in Joules per rail.
+/// </summary>
+/// <remarks>
+/// <para>The library integrates the products of the raw millivolt and
+/// milliampere readings over the timestamps of the samples using the
+/// trapezoidal rule. The sums are exact integers, which are only converted to
+/// Joules when the structure is filled, so the same stream always yields the
+/// same result, regardless of how long streaming has been running.</para>
+/// <para>The energy is integrated from the start of streaming. It is reset
+/// each time streaming is started, but retained after streaming has been
+/// stopped. Segments delivered via
+/// <see cref="powenetics_start_streaming_segments" /> are not decoded and
+/// therefore not integrated.</para>
+/// <para>The energy is updated by the streaming thread once per read from
+/// the device, so a snapshot obtained while streaming might be slightly
+/// behind.</para>
+/// </remarks>
+typedef struct LIBPOWENETICS_API powenetics_energy_t {
+
+    /// <summary>
+    /// The version of the structure, which must be initialised when this
+    /// structure is passed to any API.
+    /// </summary>
+    /// <remarks>
+    /// <para>For the current version of the API, this value must always be 2
+    /// for Powenetics v2.</para>
+    /// <para>This must be the first member of the struct and any future version
+    /// of it.</para>
+    /// </remarks>
+    uint32_t version;
+
+    /// <summary>
+    /// The energy drawn from the 12V rail of the ATX connector.
+    /// </summary>
+    double atx_12v;
+
+    /// <summary>
+    /// The energy drawn from the 3.3V rail of the ATX connector.
+    /// </summary>
+    double atx_3_3v;
+
+    /// <summary>
+    /// The energy drawn from the 5V rail of the ATX connector.
+    /// </summary>
+    double atx_5v;
+
+    /// <summary>
+    /// The energy drawn from the 5V standby rail of the ATX connector.
+    /// </summary>
+    double atx_stb;
+
+    /// <summary>
+    /// The energy drawn from the first EPS connector.
+    /// </summary>
+    double eps1;
+
+    /// <summary>
+    /// The energy drawn from the second EPS connector.
+    /// </summary>
+    double eps2;
+
+    /// <summary>
+    /// The energy drawn from the third EPS connector.
+    /// </summary>
+    double eps3;
+
+    /// <summary>
+    /// The energy drawn from the first PCIe 12V connector.
+    /// </summary>
+    double pcie_12v1;
+
+    /// <summary>
+    /// The energy drawn from the second PCIe 12V connector.
+    /// </summary>
+    double pcie_12v2;
+
+    /// <summary>
+    /// The energy drawn from the third PCIe 12V connector.
+    /// </summary>
+    double pcie_12v3;
+
+    /// <summary>
+    /// The energy drawn from the 12V rail of the PCIe slot.
+    /// </summary>
+    double peg_12v;
+
+    /// <summary>
+    /// The energy drawn from the 3.3V rail of the PCIe slot.
+    /// </summary>
+    double peg_3_3v;
+
+    /// <summary>
+    /// The energy drawn from all rails.
+    /// </summary>
+    /// <remarks>
+    /// The total is computed from the exact sums of all rails rather than by
+    /// adding up the values above.
+    /// </remarks>
+    double total;
+
+    /// <summary>
+    /// The time span between the first and the last sample that have been
+    /// integrated in seconds.
+    /// </summary>
+    /// <remarks>
+    /// Intervals in which the timestamps did not increase, for instance
+    /// because the system time has been adjusted, are not included.
+    /// </remarks>
+    double duration;
+
+    /// <summary>
+    /// The number of samples that have been integrated.
+    /// </summary>
+    uint64_t samples;
+} powenetics_energy;
+
+#endif /* !defined(_LIBPOWENETICS_ENERGY_H) */
@@ -0,0 +1,78 @@
+﻿// <copyright file="overflow.h" company="Visualisierungsinstitut der Universität Stuttgart">
+// Copyright © 2026 Visualisierungsinstitut der Universität Stuttgart.
+// Licensed under the MIT licence. See LICENCE file for details.
+// </copyright>
+// <author>Christoph Müller</author>
+
+#if !defined(_LIBPOWENETICS_OVERFLOW_H)
+#define _LIBPOWENETICS_OVERFLOW_H
+#pragma once
+
+#include "libpowenetics/api.h"
+#include "libpowenetics/types.h"
+
+
+/// <summary>
+/// Identifies what happens if the consumer of a queue falls behind and the
+/// queue between the thread reading from the device and the consumer is full.
+/// </summary>
+/// <remarks>
+/// <para>The policy applies to the queue of
+/// <see cref="powenetics_start_streaming_queued" /> and to the queue of
+/// <see cref="powenetics_dispatch::asynchronous" /> dispatch. In any case, the
+/// memory the queue uses is allocated when streaming starts and does not grow
+/// afterwards.</para>
+/// <para>Each sample or segment that is discarded is counted in
+/// <see cref="powenetics_statistics::samples_dropped" /> and marked in the
+/// <c>dropped</c> member of the next one that is delivered.</para>
+/// </remarks>
+typedef enum LIBPOWENETICS_ENUM powenetics_overflow_t {
+
+    /// <summary>
+    /// The data that arrive while the queue is full are discarded, which is
+    /// the default.
+    /// </summary>
+    LIBPOWENETICS_ENUM_SCOPE(powenetics_overflow, drop_newest) = 0,
+
+    /// <summary>
+    /// The oldest data in the queue are discarded in favour of the ones that
+    /// arrive.
+    /// </summary>
+    /// <remarks>
+    /// The thread reading from the device removes the oldest data itself, so
+    /// the consumer always finds the newest data once it resumes, no matter
+    /// how long it has stalled. The queue reserves twice its capacity for
+    /// this. Only if the consumer is still copying the data that would need
+    /// to be removed, the data that arrive are discarded like for
+    /// <see cref="powenetics_overflow::drop_newest" />. If the end of a batch
+    /// is removed, the batch is delivered before the next data that have not
+    /// been removed, so batches are never merged.
+    /// </remarks>
+    LIBPOWENETICS_ENUM_SCOPE(powenetics_overflow, drop_oldest) = 1,
+
+    /// <summary>
+    /// The thread reading from the device waits until the consumer has made
+    /// room in the queue.
+    /// </summary>
+    /// <remarks>
+    /// No data are discarded by the library, but the device is not read while
+    /// the thread is waiting, so the buffer of the serial port may overflow
+    /// instead, which results in missing samples. If the device is served by
+    /// a reactor, all devices served by it wait. Once streaming is being
+    /// stopped, the thread does not wait anymore, but discards the data that
+    /// do not fit.
+    /// </remarks>
+    LIBPOWENETICS_ENUM_SCOPE(powenetics_overflow, block) = 2,
+
+    /// <summary>
+    /// Only every second sample is retained while the queue is more than half
+    /// full, and the samples that arrive while it is full are discarded.
+    /// </summary>
+    /// <remarks>
+    /// This preserves the whole duration of the capture at a reduced rate if
+    /// the consumer is permanently slower than the device.
+    /// </remarks>
+    LIBPOWENETICS_ENUM_SCOPE(powenetics_overflow, decimate) = 3
+} powenetics_overflow;
+
+#endif /* !defined(_LIBPOWENETICS_OVERFLOW_H) */
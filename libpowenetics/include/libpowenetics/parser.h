@@ -0,0 +1,46 @@
+﻿// <copyright file="parser.h" company="Visualisierungsinstitut der Universität Stuttgart">
+// Copyright © 2026 Visualisierungsinstitut der Universität Stuttgart.
+// Licensed under the MIT licence. See LICENCE file for details.
+// </copyright>
+// <author>Christoph Müller</author>
+
+#if !defined(_LIBPOWENETICS_PARSER_H)
+#define _LIBPOWENETICS_PARSER_H
+#pragma once
+
+#include "libpowenetics/api.h"
+#include "libpowenetics/types.h"
+
+
+/// <summary>
+/// Identifies the implementations of the parser that can decode the data
+/// stream of a device.
+/// </summary>
+/// <remarks>
+/// All parsers deliver the same samples. They only differ in how they decode
+/// the data, which might make a difference in performance.
+/// </remarks>
+typedef enum LIBPOWENETICS_ENUM powenetics_parser_t {
+
+    /// <summary>
+    /// The default parser, which decodes one segment after the other as it
+    /// is found in the stream.
+    /// </summary>
+    LIBPOWENETICS_ENUM_SCOPE(powenetics_parser, stream) = 0,
+
+    /// <summary>
+    /// A parser that collects runs of contiguous segments from each read and
+    /// decodes them into columns using vector instructions if the processor
+    /// supports them.
+    /// </summary>
+    LIBPOWENETICS_ENUM_SCOPE(powenetics_parser, columnar) = 1,
+
+    /// <summary>
+    /// A parser that consumes the stream byte by byte using a state machine
+    /// that only retains a single segment between two reads, which bounds the
+    /// time spent on each byte and never allocates memory.
+    /// </summary>
+    LIBPOWENETICS_ENUM_SCOPE(powenetics_parser, resumable) = 2
+} powenetics_parser;
+
+#endif /* !defined(_LIBPOWENETICS_PARSER_H) */
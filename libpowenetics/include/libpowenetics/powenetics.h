@@ -13,8 +13,23 @@
 #endif /* defined(__cplusplus) */
 
 #include "libpowenetics/api.h"
+#include "libpowenetics/batch.h"
+#include "libpowenetics/capture.h"
+#include "libpowenetics/connector_profile.h"
+#include "libpowenetics/dispatch.h"
+#include "libpowenetics/energy.h"
+#include "libpowenetics/overflow.h"
+#include "libpowenetics/parser.h"
+#include "libpowenetics/queue.h"
+#include "libpowenetics/raw_sample.h"
+#include "libpowenetics/reactor.h"
+#include "libpowenetics/reader.h"
 #include "libpowenetics/sample.h"
+#include "libpowenetics/scheduling.h"
+#include "libpowenetics/segment.h"
 #include "libpowenetics/serial.h"
+#include "libpowenetics/statistics.h"
+#include "libpowenetics/timestamp.h"
 
 
 #if defined(__cplusplus)
@@ -60,6 +75,71 @@ HRESULT LIBPOWENETICS_API powenetics_calibrate(
 /// <c>E_HANDLE</c> if <paramref name="handle" /> is invalid.</returns>
 HRESULT LIBPOWENETICS_API powenetics_close(_In_ const powenetics_handle handle);
 
+/// <summary>
+/// Retrieves the connector profile which the library has detected from the
+/// data stream of the given Powenetics v2 power measurement device.
+/// </summary>
+/// <remarks>
+/// The profile is only known once the device has delivered its first sample.
+/// It is safe to call this function while the device is streaming data.
+/// </remarks>
+/// <param name="handle">The handle for a Powenetics v2 device.</param>
+/// <param name="profile">Receives the profile. The version of the structure
+/// must have been initialised before the call.</param>
+/// <returns><c>S_OK</c> in case of success,
+/// <c>E_HANDLE</c> if <paramref name="handle" /> is invalid,
+/// <c>E_POINTER</c> if <paramref name="profile" /> is <c>nullptr</c>,
+/// <c>E_INVALIDARG</c> if the version of <paramref name="profile" /> has
+/// not been initialised or is unsupported by the function.</returns>
+HRESULT LIBPOWENETICS_API powenetics_get_connector_profile(
+    _In_ const powenetics_handle handle,
+    _Inout_ powenetics_connector_profile *profile);
+
+/// <summary>
+/// Retrieves the energy the library has integrated from the data stream of
+/// the given Powenetics v2 power measurement device.
+/// </summary>
+/// <remarks>
+/// The energy is integrated from the exact readings on the streaming thread
+/// since streaming has been started. It is safe to call this function while
+/// the device is streaming data, in which case the energy reflects the state
+/// at the end of one of the most recent reads from the device.
+/// </remarks>
+/// <param name="handle">The handle for a Powenetics v2 device.</param>
+/// <param name="energy">Receives the energy per rail and in total. The
+/// version of the structure must have been initialised before the call.
+/// </param>
+/// <returns><c>S_OK</c> in case of success,
+/// <c>E_HANDLE</c> if <paramref name="handle" /> is invalid,
+/// <c>E_POINTER</c> if <paramref name="energy" /> is <c>nullptr</c>,
+/// <c>E_INVALIDARG</c> if the version of <paramref name="energy" /> has
+/// not been initialised or is unsupported by the function.</returns>
+HRESULT LIBPOWENETICS_API powenetics_get_energy(
+    _In_ const powenetics_handle handle,
+    _Inout_ powenetics_energy *energy);
+
+/// <summary>
+/// Retrieves the counters about the health of the data stream from the given
+/// Powenetics v2 power measurement device.
+/// </summary>
+/// <remarks>
+/// The counters are always maintained, regardless of the build configuration
+/// of the library. It is safe to call this function while the device is
+/// streaming data, in which case the counters reflect the state at the end
+/// of one of the most recent reads from the device.
+/// </remarks>
+/// <param name="handle">The handle for a Powenetics v2 device.</param>
+/// <param name="statistics">Receives the counters. The version of the
+/// structure must have been initialised before the call.</param>
+/// <returns><c>S_OK</c> in case of success,
+/// <c>E_HANDLE</c> if <paramref name="handle" /> is invalid,
+/// <c>E_POINTER</c> if <paramref name="statistics" /> is <c>nullptr</c>,
+/// <c>E_INVALIDARG</c> if the version of <paramref name="statistics" /> has
+/// not been initialised or is unsupported by the function.</returns>
+HRESULT LIBPOWENETICS_API powenetics_get_statistics(
+    _In_ const powenetics_handle handle,
+    _Inout_ powenetics_statistics *statistics);
+
 /// <summary>
 /// Opens a handle to the Powenetics v2 power measurement device connected to
 /// the specified serial port.
@@ -111,6 +191,45 @@ HRESULT LIBPOWENETICS_API powenetics_probe(
     _Inout_ size_t *cnt,
     _In_ const size_t timeout);
 
+/// <summary>
+/// Removes the oldest samples from the queue of a Powenetics v2 power
+/// measurement device that has been started using
+/// <see cref="powenetics_start_streaming_queued" />.
+/// </summary>
+/// <remarks>
+/// <para>The queue has a single consumer, so the function must not be called
+/// by multiple threads at the same time for the same device, and it must not
+/// be called while streaming is being started.</para>
+/// <para>The samples that are left in the queue once streaming has stopped
+/// can still be read until streaming is started again.</para>
+/// </remarks>
+/// <param name="handle">The handle for a Powenetics v2 device.</param>
+/// <param name="dst">A buffer to receive at least <paramref name="cnt" />
+/// samples. The version of the first sample must have been initialised
+/// before the call and determines the version, and therefore the size, of
+/// all samples written. If it is 2, the members added in version 3 are not
+/// written.</param>
+/// <param name="cnt">On entry, the number of samples that can be saved to
+/// <paramref name="dst" />, on exit, the number of samples that have actually
+/// been written.</param>
+/// <param name="timeout">The time in milliseconds the function waits for
+/// samples if the queue is empty. If this is zero, the function returns
+/// immediately.</param>
+/// <returns><c>S_OK</c> if at least one sample has been read,
+/// <c>S_FALSE</c> if no sample arrived before the timeout expired,
+/// <c>E_HANDLE</c> if <paramref name="handle" /> is invalid,
+/// <c>E_POINTER</c> if <paramref name="dst" /> or <paramref name="cnt" />
+/// is <c>nullptr</c>,
+/// <c>E_INVALIDARG</c> if the version of <paramref name="dst" /> is not
+/// supported,
+/// <c>E_NOT_VALID_STATE</c> if the queue is empty and the device is not
+/// streaming anymore or has never been streaming to a queue.</returns>
+HRESULT LIBPOWENETICS_API powenetics_read_samples(
+    _In_ const powenetics_handle handle,
+    _Inout_updates_(*cnt) powenetics_sample *dst,
+    _Inout_ size_t *cnt,
+    _In_ const uint32_t timeout);
+
 #if 0
 /// <summary>
 /// Resets the calibration of the device identified by the given handle.
@@ -126,6 +245,167 @@ HRESULT LIBPOWENETICS_API powenetics_reset_calibration(
     _In_ const powenetics_handle handle);
 #endif
 
+/// <summary>
+/// Selects the clock the samples from the given Powenetics v2 power
+/// measurement device are stamped with.
+/// </summary>
+/// <remarks>
+/// By default, the samples are stamped with the system time. The setting
+/// takes effect the next time streaming is started. Use
+/// <see cref="powenetics_convert_timestamp" /> to convert the timestamps to
+/// another clock.
+/// </remarks>
+/// <param name="handle">The handle for a Powenetics v2 device.</param>
+/// <param name="clock">The clock to stamp the samples with.</param>
+/// <returns><c>S_OK</c> in case of success,
+/// <c>E_HANDLE</c> if <paramref name="handle" /> is invalid,
+/// <c>E_INVALIDARG</c> if <paramref name="clock" /> is not a valid clock,
+/// <c>E_NOTIMPL</c> if the clock is not supported on the machine,
+/// <c>E_NOT_VALID_STATE</c> if the device is streaming.</returns>
+HRESULT LIBPOWENETICS_API powenetics_set_clock(
+    _In_ const powenetics_handle handle,
+    _In_ const powenetics_clock clock);
+
+/// <summary>
+/// Determines the thread the callbacks of the given Powenetics v2 power
+/// measurement device are invoked on.
+/// </summary>
+/// <remarks>
+/// <para>By default, the callbacks are invoked on the thread reading from the
+/// device, so a slow callback delays reading. If the callbacks are invoked
+/// asynchronously, the data are handed over to a dispatch thread through a
+/// lock-free queue, and the depth of the queue and the longest time spent in
+/// a callback can be obtained using
+/// <see cref="powenetics_get_statistics" />. Stopping the stream waits for
+/// the dispatch thread to deliver everything in the queue.</para>
+/// <para>The setting takes effect the next time streaming is started. It has
+/// no effect if the samples are read using
+/// <see cref="powenetics_read_samples" />.</para>
+/// </remarks>
+/// <param name="handle">The handle for a Powenetics v2 device.</param>
+/// <param name="config">The dispatch configuration, or <c>nullptr</c> for
+/// restoring the default.</param>
+/// <returns><c>S_OK</c> in case of success,
+/// <c>E_HANDLE</c> if <paramref name="handle" /> is invalid,
+/// <c>E_INVALIDARG</c> if the version, the dispatch or the capacity in
+/// <paramref name="config" /> is invalid,
+/// <c>E_NOT_VALID_STATE</c> if the device is streaming.</returns>
+HRESULT LIBPOWENETICS_API powenetics_set_dispatch(
+    _In_ const powenetics_handle handle,
+    _In_opt_ const powenetics_dispatch_configuration *config);
+
+/// <summary>
+/// Selects the implementation of the parser that decodes the data stream of
+/// the given Powenetics v2 power measurement device.
+/// </summary>
+/// <remarks>
+/// The parser for the protocol of the device is chosen when the device is
+/// opened, which is <see cref="powenetics_parser::stream" /> by default. The
+/// setting takes effect the next time streaming is started.
+/// </remarks>
+/// <param name="handle">The handle for a Powenetics v2 device.</param>
+/// <param name="parser">The parser to decode the stream with.</param>
+/// <returns><c>S_OK</c> in case of success,
+/// <c>E_HANDLE</c> if <paramref name="handle" /> is invalid,
+/// <c>E_INVALIDARG</c> if <paramref name="parser" /> is not a valid parser,
+/// <c>E_NOT_VALID_STATE</c> if the device is streaming.</returns>
+HRESULT LIBPOWENETICS_API powenetics_set_parser(
+    _In_ const powenetics_handle handle,
+    _In_ const powenetics_parser parser);
+
+/// <summary>
+/// Assigns the given Powenetics v2 power measurement device to a reactor that
+/// serves it together with other devices.
+/// </summary>
+/// <remarks>
+/// <para>By default, each device starts a thread of its own when streaming
+/// is started. If a reactor has been assigned, one of the threads of the
+/// reactor reads and parses the data of the device and invokes its
+/// callbacks. The setting takes effect the next time streaming is started.
+/// </para>
+/// <para>The reactor cannot be destroyed while devices are assigned to it.
+/// A device is unassigned by passing <c>nullptr</c> or by closing it.</para>
+/// </remarks>
+/// <param name="handle">The handle for a Powenetics v2 device.</param>
+/// <param name="reactor">The reactor to serve the device, or <c>nullptr</c>
+/// for the device to start a thread of its own.</param>
+/// <returns><c>S_OK</c> in case of success,
+/// <c>E_HANDLE</c> if <paramref name="handle" /> is invalid,
+/// <c>E_NOT_VALID_STATE</c> if the device is streaming.</returns>
+HRESULT LIBPOWENETICS_API powenetics_set_reactor(
+    _In_ const powenetics_handle handle,
+    _In_opt_ const powenetics_reactor_handle reactor);
+
+/// <summary>
+/// Selects how the streaming thread of the given Powenetics v2 power
+/// measurement device reads the data from the serial port.
+/// </summary>
+/// <remarks>
+/// <para>By default, the streaming thread uses
+/// <see cref="powenetics_reader::standard" />. The setting takes effect the
+/// next time streaming is started. If the selected reader cannot be used at
+/// this point, the streaming thread falls back to the standard one.</para>
+/// <para>The setting has no effect on devices that are served by a reactor,
+/// which always waits for its devices using <c>epoll</c>.</para>
+/// </remarks>
+/// <param name="handle">The handle for a Powenetics v2 device.</param>
+/// <param name="reader">The way the data are read.</param>
+/// <returns><c>S_OK</c> in case of success,
+/// <c>E_HANDLE</c> if <paramref name="handle" /> is invalid,
+/// <c>E_INVALIDARG</c> if <paramref name="reader" /> is not a valid reader,
+/// <c>E_NOTIMPL</c> if the reader is not supported on the platform,
+/// <c>E_NOT_VALID_STATE</c> if the device is streaming.</returns>
+HRESULT LIBPOWENETICS_API powenetics_set_reader(
+    _In_ const powenetics_handle handle,
+    _In_ const powenetics_reader reader);
+
+/// <summary>
+/// Configures the affinity, the scheduling and the memory locking of the
+/// streaming thread of the given Powenetics v2 power measurement device.
+/// </summary>
+/// <remarks>
+/// <para>By default, the streaming thread inherits the affinity and the
+/// scheduling from the thread starting it. The setting takes effect the next
+/// time streaming is started. If the configuration cannot be applied at this
+/// point, most likely due to insufficient privileges, starting the stream
+/// fails with the error reported by the system.</para>
+/// <para>The setting has no effect on devices that are served by a reactor.
+/// </para>
+/// </remarks>
+/// <param name="handle">The handle for a Powenetics v2 device.</param>
+/// <param name="config">The configuration of the thread, or <c>nullptr</c>
+/// for restoring the default.</param>
+/// <returns><c>S_OK</c> in case of success,
+/// <c>E_HANDLE</c> if <paramref name="handle" /> is invalid,
+/// <c>E_INVALIDARG</c> if the version, the scheduling or the priority in
+/// <paramref name="config" /> is invalid,
+/// <c>E_NOTIMPL</c> if a part of the configuration is not supported on the
+/// platform,
+/// <c>E_NOT_VALID_STATE</c> if the device is streaming.</returns>
+HRESULT LIBPOWENETICS_API powenetics_set_thread_configuration(
+    _In_ const powenetics_handle handle,
+    _In_opt_ const powenetics_thread_configuration *config);
+
+/// <summary>
+/// Determines how the samples from the given Powenetics v2 power measurement
+/// device are stamped.
+/// </summary>
+/// <remarks>
+/// By default, the samples are stamped with the time at which they have been
+/// parsed. The setting takes effect the next time streaming is started.
+/// </remarks>
+/// <param name="handle">The handle for a Powenetics v2 device.</param>
+/// <param name="timestamping">The way the timestamps of the samples are
+/// obtained.</param>
+/// <returns><c>S_OK</c> in case of success,
+/// <c>E_HANDLE</c> if <paramref name="handle" /> is invalid,
+/// <c>E_INVALIDARG</c> if <paramref name="timestamping" /> is not a valid
+/// mode,
+/// <c>E_NOT_VALID_STATE</c> if the device is streaming.</returns>
+HRESULT LIBPOWENETICS_API powenetics_set_timestamping(
+    _In_ const powenetics_handle handle,
+    _In_ const powenetics_timestamping timestamping);
+
 /// <summary>
 /// Puts the given Powenetics v2 power measurement device in streaming mode.
 /// </summary>
@@ -140,12 +420,132 @@ HRESULT LIBPOWENETICS_API powenetics_start_streaming(
     _In_ const powenetics_data_callback callback,
     _In_opt_ void *context);
 
+/// <summary>
+/// Puts the given Powenetics v2 power measurement device in streaming mode and
+/// delivers the samples in batches.
+/// </summary>
+/// <remarks>
+/// Delivering multiple samples at once reduces the number of calls into the
+/// user code and allows callers to synchronise with their own threads once per
+/// batch rather than once per sample. The samples in a batch are contiguous
+/// and in the order they have been received from the device.
+/// </remarks>
+/// <param name="handle">The handle for a Powenetics v2 device.</param>
+/// <param name="callback">The callback to be invoked if a batch of samples
+/// is ready.</param>
+/// <param name="context">A user-defined pointer that will be passed to
+/// <paramref name="callback" /> along with each batch.</param>
+/// <param name="config">The configuration determining when a batch is
+/// delivered. It is safe to pass <c>nullptr</c>, in which case the function
+/// will obtain the default configuration by calling
+/// <see cref="powenetics_initialise_batch_configuration" />.</param>
+/// <returns><c>S_OK</c> in case of success,
+/// <c>E_HANDLE</c> if <paramref name="handle" /> is invalid,
+/// <c>E_POINTER</c> if <paramref name="callback" /> is <c>nullptr</c>,
+/// <c>E_INVALIDARG</c> if <paramref name="config" /> has an unsupported
+/// version,
+/// <c>E_NOT_VALID_STATE</c> if the device is already streaming,
+/// another error code if for instance I/O with the device failed.</returns>
+HRESULT LIBPOWENETICS_API powenetics_start_streaming_batched(
+    _In_ const powenetics_handle handle,
+    _In_ const powenetics_batch_callback callback,
+    _In_opt_ void *context,
+    _In_opt_ const powenetics_batch_configuration *config);
+
+/// <summary>
+/// Puts the given Powenetics v2 power measurement device in streaming mode and
+/// stores the samples in a queue they can be read from using
+/// <see cref="powenetics_read_samples" />.
+/// </summary>
+/// <remarks>
+/// The queue is a lock-free ring buffer between the streaming thread and a
+/// single consumer thread, so the streaming thread never waits for the
+/// consumer. This allows for polling the data in bulk, for instance from a
+/// control loop, instead of synchronising a callback with the thread
+/// consuming the samples.
+/// </remarks>
+/// <param name="handle">The handle for a Powenetics v2 device.</param>
+/// <param name="config">The configuration of the queue. It is safe to pass
+/// <c>nullptr</c>, in which case the function will obtain the default
+/// configuration by calling
+/// <see cref="powenetics_initialise_queue_configuration" />.</param>
+/// <returns><c>S_OK</c> in case of success,
+/// <c>E_HANDLE</c> if <paramref name="handle" /> is invalid,
+/// <c>E_INVALIDARG</c> if <paramref name="config" /> has an unsupported
+/// version or a capacity of zero,
+/// <c>E_OUTOFMEMORY</c> if the queue could not be allocated,
+/// <c>E_NOT_VALID_STATE</c> if the device is already streaming,
+/// another error code if for instance I/O with the device failed.</returns>
+HRESULT LIBPOWENETICS_API powenetics_start_streaming_queued(
+    _In_ const powenetics_handle handle,
+    _In_opt_ const powenetics_queue_configuration *config);
+
+/// <summary>
+/// Puts the given Powenetics v2 power measurement device in streaming mode and
+/// delivers the readings as the integers received from the device.
+/// </summary>
+/// <remarks>
+/// This mode skips the conversion to floating-point numbers on the streaming
+/// thread, which is useful for callers that need exact values, for instance
+/// for recording or integrating energy. Use
+/// <see cref="powenetics_convert_raw_sample" /> to obtain Volts and Amperes
+/// later on.
+/// </remarks>
+/// <param name="handle">The handle for a Powenetics v2 device.</param>
+/// <param name="callback">The callback to be invoked if a sample was
+/// received.</param>
+/// <param name="context">A user-defined pointer that will be passed to
+/// <paramref name="callback" /> along with each sample.</param>
+/// <returns><c>S_OK</c> in case of success,
+/// <c>E_HANDLE</c> if <paramref name="handle" /> is invalid,
+/// <c>E_POINTER</c> if <paramref name="callback" /> is <c>nullptr</c>,
+/// <c>E_NOT_VALID_STATE</c> if the device is already streaming,
+/// another error code if for instance I/O with the device failed.</returns>
+HRESULT LIBPOWENETICS_API powenetics_start_streaming_raw(
+    _In_ const powenetics_handle handle,
+    _In_ const powenetics_raw_data_callback callback,
+    _In_opt_ void *context);
+
+/// <summary>
+/// Puts the given Powenetics v2 power measurement device in streaming mode and
+/// delivers the segments received from the device without decoding them.
+/// </summary>
+/// <remarks>
+/// <para>In this mode, the streaming thread only checks the framing of the
+/// segments and assigns the sequence number, the index and the timestamp.
+/// The readings are passed on as they have been received from the device,
+/// which is the cheapest way to archive the data. Use
+/// <see cref="powenetics_decode_segment" /> to obtain the readings later on.
+/// </para>
+/// <para>As the readings are not decoded, the connector profile is not
+/// detected in this mode.</para>
+/// </remarks>
+/// <param name="handle">The handle for a Powenetics v2 device.</param>
+/// <param name="callback">The callback to be invoked if a segment was
+/// received.</param>
+/// <param name="context">A user-defined pointer that will be passed to
+/// <paramref name="callback" /> along with each segment.</param>
+/// <returns><c>S_OK</c> in case of success,
+/// <c>E_HANDLE</c> if <paramref name="handle" /> is invalid,
+/// <c>E_POINTER</c> if <paramref name="callback" /> is <c>nullptr</c>,
+/// <c>E_NOT_VALID_STATE</c> if the device is already streaming,
+/// another error code if for instance I/O with the device failed.</returns>
+HRESULT LIBPOWENETICS_API powenetics_start_streaming_segments(
+    _In_ const powenetics_handle handle,
+    _In_ const powenetics_segment_callback callback,
+    _In_opt_ void *context);
+
 /// <summary>
 /// Returns the given Powenetics n2 power measurement to startup state.
 /// </summary>
 /// <remarks>
-/// This method blocks until the thread delivering the samples actually stopped
-/// and it is safe to invalidate any previously installed callback.
+/// <para>This method blocks until the thread delivering the samples actually
+/// stopped and it is safe to invalidate any previously installed callback.
+/// </para>
+/// <para>On POSIX systems, the thread is woken right away, so the method
+/// returns promptly even if the device does not send any data.</para>
+/// <para>The method must not be called from a callback of a device that is
+/// served by the same reactor.</para>
 /// </remarks>
 /// <param name="handle">The handle for a Powenetics v2 device.</param>
 /// <returns><c>S_OK</c> in case of success, <c>E_HANDLE</c> if
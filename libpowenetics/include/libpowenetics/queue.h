@@ -0,0 +1,78 @@
+﻿// <copyright file="queue.h" company="Visualisierungsinstitut der Universität Stuttgart">
+// Copyright © 2026 Visualisierungsinstitut der Universität Stuttgart.
+// Licensed under the MIT licence. See LICENCE file for details.
+// </copyright>
+// <author>Christoph Müller</author>
+
+#if !defined(_LIBPOWENETICS_QUEUE_H)
+#define _LIBPOWENETICS_QUEUE_H
+#pragma once
+
+#include "libpowenetics/api.h"
+#include "libpowenetics/overflow.h"
+#include "libpowenetics/types.h"
+
+
+/// <summary>
+/// Configures the queue the samples are stored in if they are read using
+/// <see cref="powenetics_read_samples" /> rather than being delivered to a
+/// callback.
+/// </summary>
+typedef struct LIBPOWENETICS_API powenetics_queue_configuration_t {
+
+    /// <summary>
+    /// The version of the structure.
+    /// </summary>
+    /// <remarks>
+    /// <para>This member allows the library to discern between future versions
+    /// of the structure. It must be initialised to 2 in the first version of
+    /// the library (for Powenetics v2).</para>
+    /// <para>This must be the first member of the struct and any future version
+    /// of it.</para>
+    /// </remarks>
+    uint32_t version;
+
+    /// <summary>
+    /// The minimum number of samples the queue can hold.
+    /// </summary>
+    /// <remarks>
+    /// The capacity is rounded up to the next power of two. What happens if
+    /// the queue is full is determined by <see cref="overflow" />. The
+    /// capacity must not be zero.
+    /// </remarks>
+    size_t capacity;
+
+    /// <summary>
+    /// Determines what happens if the consumer does not read the samples as
+    /// fast as they arrive and the queue is full.
+    /// </summary>
+    powenetics_overflow overflow;
+} powenetics_queue_configuration;
+
+
+#if defined(__cplusplus)
+extern "C" {
+#endif /* defined(__cplusplus) */
+
+/// <summary>
+/// Applies the default configuration of the sample queue to the structure
+/// passed to the method.
+/// </summary>
+/// <remarks>
+/// The default queue holds 16384 samples, which is the data of several
+/// seconds.
+/// </remarks>
+/// <param name="config">A pointer to the structure to be filled. The version
+/// of the structure must have been initialised before the call.</param>
+/// <returns><c>S_OK</c> in case of success,
+/// <c>E_POINTER</c> if <paramref name="config" /> is <c>nullptr</c>,
+/// <c>E_INVALIDARG</c> if the version of the configuration has not been
+/// initialised or is unsupported by the function.</returns>
+HRESULT LIBPOWENETICS_API powenetics_initialise_queue_configuration(
+    _In_ powenetics_queue_configuration *config);
+
+#if defined(__cplusplus)
+}
+#endif /* defined(__cplusplus) */
+
+#endif /* !defined(_LIBPOWENETICS_QUEUE_H) */
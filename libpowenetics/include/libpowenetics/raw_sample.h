@@ -0,0 +1,260 @@
+﻿// <copyright file="raw_sample.h" company="Visualisierungsinstitut der Universität Stuttgart">
+// Copyright © 2026 Visualisierungsinstitut der Universität Stuttgart.
+// Licensed under the MIT licence. See LICENCE file for details.
+// </copyright>
+// <author>Christoph Müller</author>
+
+#if !defined(_LIBPOWENETICS_RAW_SAMPLE_H)
+#define _LIBPOWENETICS_RAW_SAMPLE_H
+#pragma once
+
+#include "libpowenetics/api.h"
+#include "libpowenetics/sample.h"
+#include "libpowenetics/timestamp.h"
+#include "libpowenetics/types.h"
+
+
+/// <summary>
+/// Holds the voltage and the current reading from a single sensor as the
+/// integers transmitted by the device.
+/// </summary>
+/// <remarks>
+/// <para>In contrast to <see cref="powenetics_voltage_current" />, the values
+/// are not converted to floating-point numbers, but are exactly what the
+/// device reported. Use <see cref="powenetics_convert_raw_sample" /> to obtain
+/// Volts and Amperes.</para>
+/// <para>Due to the natural alignment of <see cref="current" />, the structure
+/// occupies eight bytes like <see cref="powenetics_voltage_current" />, so
+/// the raw samples are not smaller than the converted ones. The 40 bits the
+/// device sends per sensor do not fit into four bytes anyway, and packing the
+/// structure to six bytes would misalign <see cref="current" />, which C++
+/// cannot bind references to.</para>
+/// </remarks>
+typedef struct LIBPOWENETICS_API powenetics_raw_voltage_current_t {
+    /// <summary>
+    /// The voltage reading in millivolts.
+    /// </summary>
+    uint16_t voltage;
+
+    /// <summary>
+    /// The current reading in milliamperes.
+    /// </summary>
+    /// <remarks>
+    /// The device transmits 24 bits of current data. As for
+    /// <see cref="powenetics_voltage_current" />, the current is zero if the
+    /// voltage does not exceed 1000 mV.
+    /// </remarks>
+    uint32_t current;
+} powenetics_raw_voltage_current;
+
+
+/// <summary>
+/// A voltage/current sample as produced by the Powenetics v2 power measurement
+/// device, which holds the readings in fixed-point format.
+/// </summary>
+/// <remarks>
+/// The layout of the structure mirrors <see cref="powenetics_sample" />, and
+/// all fields have the same semantics except for the unit of the readings.
+/// </remarks>
+typedef struct LIBPOWENETICS_API powenetics_raw_sample_t {
+
+    /// <summary>
+    /// The version of the sample, which must be initialised when this
+    /// strucuture is passed to any API.
+    /// </summary>
+    /// <remarks>
+    /// <para>For the current version of the API, this value must be 3 for
+    /// Powenetics v2. Version 2 of the structure ends before
+    /// <see cref="index" />. Functions writing samples to memory of the caller
+    /// only write the members of the version the caller has initialised.
+    /// Callbacks always receive the current version, including the layout of
+    /// arrays.</para>
+    /// <para>This field must always remain at the first version of the
+    /// strucuture, even if additional fields are added.</para>
+    /// </remarks>
+    uint32_t version;
+
+    /// <summary>
+    /// The sequence number of the sample.
+    /// </summary>
+    /// <remarks>
+    /// <para>This must always remain the second field in the structure.</para>
+    /// </remarks>
+    uint16_t sequence_number;
+
+    /// <summary>
+    /// The timestamp of the sample.
+    /// </summary>
+    /// <remarks>
+    /// The timestamp is obtained from the same clock as
+    /// <see cref="powenetics_sample::timestamp" />.
+    /// </remarks>
+    powenetics_timestamp timestamp;
+
+    /* Begin of data measured by Powenetics v2. */
+
+    /// <summary>
+    /// 12V rail of 10-pin and 24-pin ATX connector.
+    /// </summary>
+    powenetics_raw_voltage_current atx_12v;
+
+    /// <summary>
+    /// 3.3V rail of the 24-pin ATX connector.
+    /// </summary>
+    powenetics_raw_voltage_current atx_3_3v;
+
+    /// <summary>
+    /// 5V rail of the 24-pin ATX connector.
+    /// </summary>
+    powenetics_raw_voltage_current atx_5v;
+
+    /// <summary>
+    /// 5V standby power of the 24-pin ATX connector or 12V standby power for
+    /// the 10-pin ATX connector.
+    /// </summary>
+    powenetics_raw_voltage_current atx_stb;
+
+    /// <summary>
+    /// EPS connector #1.
+    /// </summary>
+    powenetics_raw_voltage_current eps1;
+
+    /// <summary>
+    /// EPS connector #2.
+    /// </summary>
+    powenetics_raw_voltage_current eps2;
+
+    /// <summary>
+    /// EPS connector #3.
+    /// </summary>
+    powenetics_raw_voltage_current eps3;
+
+    /// <summary>
+    /// PCIe 6+2 connector #1 or PCIe 12+4 connector #1.
+    /// </summary>
+    powenetics_raw_voltage_current pcie_12v1;
+
+    /// <summary>
+    /// PCIe 6+2 connector #2 or PCIe 12+4 connector #2.
+    /// </summary>
+    powenetics_raw_voltage_current pcie_12v2;
+
+    /// <summary>
+    /// PCIe 6+2 connector #3.
+    /// </summary>
+    powenetics_raw_voltage_current pcie_12v3;
+
+    /// <summary>
+    /// PEG slot 12V rail.
+    /// </summary>
+    powenetics_raw_voltage_current peg_12v;
+
+    /// <summary>
+    /// PEG slot 3.3V rail.
+    /// </summary>
+    powenetics_raw_voltage_current peg_3_3v;
+
+    /* End of Powenetics v2, future versions must add fields below. */
+
+    /* Begin of version 3. */
+
+    /// <summary>
+    /// The position of the sample in the stream since streaming was started.
+    /// </summary>
+    /// <remarks>
+    /// <para>The index is derived from <see cref="sequence_number" />, but
+    /// does not wrap. It starts at zero for the first sample delivered after
+    /// streaming has been started. If the device sent samples that have not
+    /// been received or that have been dropped, the index skips these samples,
+    /// ie the difference between the indices of two consecutive samples is
+    /// always the sum of <see cref="missing" /> and <see cref="dropped" /> plus
+    /// one.</para>
+    /// <para>As the sequence number of the device has only 16 bits, a gap of
+    /// 65536 samples or more cannot be detected.</para>
+    /// </remarks>
+    uint64_t index;
+
+    /// <summary>
+    /// The number of samples that the device sent between the previous sample
+    /// and this one, but that have not been received.
+    /// </summary>
+    /// <remarks>
+    /// This is zero unless data have been lost, so a non-zero value marks the
+    /// position of a gap in the data.
+    /// </remarks>
+    uint32_t missing;
+
+    /// <summary>
+    /// The number of samples that have been received between the previous
+    /// sample and this one, but that the library has dropped because the
+    /// consumer did not keep up.
+    /// </summary>
+    /// <remarks>
+    /// This can only be non-zero if the samples are buffered for the consumer,
+    /// in which case the <see cref="powenetics_overflow" /> policy of the
+    /// buffer determines whether samples are dropped. A non-zero value marks
+    /// the position of the gap in the data.
+    /// </remarks>
+    uint32_t dropped;
+} powenetics_raw_sample;
+
+
+/// <summary>
+/// The callback to be invoked when a new raw sample is available.
+/// </summary>
+typedef void (*powenetics_raw_data_callback)(_In_ powenetics_handle source,
+    _In_ const struct powenetics_raw_sample_t *sample, _In_opt_ void *context);
+
+
+#if defined(__cplusplus)
+extern "C" {
+#endif /* defined(__cplusplus) */
+
+/// <summary>
+/// Converts a raw sample into a sample holding Volts and Amperes.
+/// </summary>
+/// <remarks>
+/// The result is the same as if the sample had been received via
+/// <see cref="powenetics_start_streaming" /> in the first place.
+/// </remarks>
+/// <param name="dst">Receives the converted sample. The version of the
+/// structure must have been initialised before the call. If it is 2, the
+/// members added in version 3 are not written.</param>
+/// <param name="src">The raw sample to be converted. If its version is 2,
+/// the members added in version 3 are zero in the result.</param>
+/// <returns><c>S_OK</c> in case of success,
+/// <c>E_POINTER</c> if <paramref name="dst" /> or <paramref name="src" /> is
+/// <c>nullptr</c>,
+/// <c>E_INVALIDARG</c> if the version of <paramref name="dst" /> or
+/// <paramref name="src" /> is not supported.</returns>
+HRESULT LIBPOWENETICS_API powenetics_convert_raw_sample(
+    _Inout_ powenetics_sample *dst,
+    _In_ const powenetics_raw_sample *src);
+
+/// <summary>
+/// Converts <paramref name="cnt" /> raw samples into samples holding Volts and
+/// Amperes.
+/// </summary>
+/// <param name="dst">Receives the converted samples. This must be an array of
+/// at least <paramref name="cnt" /> elements. The version of the first
+/// element must have been initialised before the call and determines the
+/// version, and therefore the size, of all elements.</param>
+/// <param name="src">The raw samples to be converted, all of which must
+/// have the same version.</param>
+/// <param name="cnt">The number of samples to be converted.</param>
+/// <returns><c>S_OK</c> in case of success,
+/// <c>E_POINTER</c> if <paramref name="dst" /> or <paramref name="src" /> is
+/// <c>nullptr</c> while <paramref name="cnt" /> is non-zero,
+/// <c>E_INVALIDARG</c> if the version of <paramref name="dst" /> or of any
+/// sample in <paramref name="src" /> is not supported, in which case the
+/// content of <paramref name="dst" /> is undefined.</returns>
+HRESULT LIBPOWENETICS_API powenetics_convert_raw_samples(
+    _Inout_updates_(cnt) powenetics_sample *dst,
+    _In_reads_(cnt) const powenetics_raw_sample *src,
+    _In_ const size_t cnt);
+
+#if defined(__cplusplus)
+} /* extern "C" */
+#endif /* defined(__cplusplus) */
+
+#endif /* !defined(_LIBPOWENETICS_RAW_SAMPLE_H) */
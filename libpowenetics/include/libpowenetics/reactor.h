@@ -0,0 +1,81 @@
+﻿// <copyright file="reactor.h" company="Visualisierungsinstitut der Universität Stuttgart">
+// Copyright © 2026 Visualisierungsinstitut der Universität Stuttgart.
+// Licensed under the MIT licence. See LICENCE file for details.
+// </copyright>
+// <author>Christoph Müller</author>
+
+#if !defined(_LIBPOWENETICS_REACTOR_H)
+#define _LIBPOWENETICS_REACTOR_H
+#pragma once
+
+#include "libpowenetics/api.h"
+#include "libpowenetics/types.h"
+
+
+/// <summary>
+/// The opaque type used to represent a set of threads serving multiple
+/// Powenetics v2 power measurement devices.
+/// </summary>
+/// <remarks>
+/// This is a forward declaration of the internal type. Callers must not make
+/// any assumptions about the internal memory layout of this type.
+/// </remarks>
+struct powenetics_reactor;
+
+
+/// <summary>
+/// The handle to a reactor serving multiple devices.
+/// </summary>
+/// <remarks>
+/// <c>nullptr</c> is used to represent an invalid handle.
+/// </remarks>
+typedef struct powenetics_reactor *powenetics_reactor_handle;
+
+
+#if defined(__cplusplus)
+extern "C" {
+#endif /* defined(__cplusplus) */
+
+/// <summary>
+/// Creates a reactor, which is a fixed number of threads reading and parsing
+/// the data of all devices that have been assigned to it.
+/// </summary>
+/// <remarks>
+/// <para>By default, each device starts a thread of its own when streaming
+/// is started. Devices that have been assigned to a reactor using
+/// <see cref="powenetics_set_reactor" /> are instead served by one of the
+/// threads of the reactor, which waits for all of its devices using
+/// <c>epoll</c>. The callbacks of these devices are invoked on the threads
+/// of the reactor, so a slow callback delays all devices served by the same
+/// thread.</para>
+/// <para>The reactor is only supported on Linux.</para>
+/// </remarks>
+/// <param name="out_reactor">Receives the handle of the reactor.</param>
+/// <param name="threads">The number of threads of the reactor, which must be
+/// at least one.</param>
+/// <returns><c>S_OK</c> in case of success,
+/// <c>E_POINTER</c> if <paramref name="out_reactor" /> is <c>nullptr</c>,
+/// <c>E_INVALIDARG</c> if <paramref name="threads" /> is zero,
+/// <c>E_NOTIMPL</c> if the reactor is not supported on the platform,
+/// <c>E_OUTOFMEMORY</c> if the reactor could not be allocated,
+/// another error code if the threads could not be started.</returns>
+HRESULT LIBPOWENETICS_API powenetics_create_reactor(
+    _Out_ powenetics_reactor_handle *out_reactor,
+    _In_ const size_t threads);
+
+/// <summary>
+/// Stops the threads of the given reactor and frees its resources.
+/// </summary>
+/// <param name="reactor">The handle of the reactor.</param>
+/// <returns><c>S_OK</c> in case of success,
+/// <c>E_HANDLE</c> if <paramref name="reactor" /> is invalid,
+/// <c>E_NOT_VALID_STATE</c> if any device is still assigned to the reactor.
+/// </returns>
+HRESULT LIBPOWENETICS_API powenetics_destroy_reactor(
+    _In_ const powenetics_reactor_handle reactor);
+
+#if defined(__cplusplus)
+} /* extern "C" */
+#endif /* defined(__cplusplus) */
+
+#endif /* !defined(_LIBPOWENETICS_REACTOR_H) */
@@ -0,0 +1,49 @@
+﻿// <copyright file="reader.h" company="Visualisierungsinstitut der Universität Stuttgart">
+// Copyright © 2026 Visualisierungsinstitut der Universität Stuttgart.
+// Licensed under the MIT licence. See LICENCE file for details.
+// </copyright>
+// <author>Christoph Müller</author>
+
+#if !defined(_LIBPOWENETICS_READER_H)
+#define _LIBPOWENETICS_READER_H
+#pragma once
+
+#include "libpowenetics/api.h"
+#include "libpowenetics/types.h"
+
+
+/// <summary>
+/// Identifies the ways in which the streaming thread of a device can read the
+/// data from the serial port.
+/// </summary>
+/// <remarks>
+/// All readers deliver the same data. They only differ in how many system
+/// calls they need for that, which might make a difference in performance.
+/// </remarks>
+typedef enum LIBPOWENETICS_ENUM powenetics_reader_t {
+
+    /// <summary>
+    /// The default reader, which waits for the serial port using
+    /// <c>poll</c> and reads it using <c>read</c> on POSIX systems, or which
+    /// blocks in <c>ReadFile</c> on Windows.
+    /// </summary>
+    LIBPOWENETICS_ENUM_SCOPE(powenetics_reader, standard) = 0,
+
+    /// <summary>
+    /// A reader that keeps a chain of reads into pre-registered buffers in
+    /// flight in an <c>io_uring</c> and reaps their completions in batches,
+    /// which is only available on Linux.
+    /// </summary>
+    /// <remarks>
+    /// <para>The reads of a chain run one after the other, and the next
+    /// chain is only submitted once the previous one has completed, so the
+    /// data are delivered in the order in which they have been received.
+    /// </para>
+    /// <para>If the kernel does not support <c>io_uring</c> or does not
+    /// allow for using it, the streaming thread falls back to the
+    /// <see cref="powenetics_reader::standard" /> reader.</para>
+    /// </remarks>
+    LIBPOWENETICS_ENUM_SCOPE(powenetics_reader, io_uring) = 1
+} powenetics_reader;
+
+#endif /* !defined(_LIBPOWENETICS_READER_H) */
@@ -45,8 +45,12 @@ typedef struct LIBPOWENETICS_API powenetics_sample_t {
     /// strucuture is passed to any API.
     /// </summary>
     /// <remarks>
-    /// <para>For the current version of the API, this value must always be 2
-    /// for Powenetics v2.</para>
+    /// <para>For the current version of the API, this value must be 3 for
+    /// Powenetics v2. Version 2 of the structure ends before
+    /// <see cref="index" />. Functions writing samples to memory of the caller
+    /// only write the members of the version the caller has initialised.
+    /// Callbacks always receive the current version, including the layout of
+    /// arrays.</para>
     /// <para>This field must always remain at the first version of the
     /// strucuture, even if additional fields are added.</para>
     /// </remarks>
@@ -64,8 +68,10 @@ typedef struct LIBPOWENETICS_API powenetics_sample_t {
     /// The timestamp of the sample.
     /// </summary>
     /// <remarks>
-    /// For Powenetics v2, the timestamp is the system time at which the sample
-    /// was received from the serial port.
+    /// For Powenetics v2, the timestamp is the time at which the sample was
+    /// received from the serial port as read from the clock selected by
+    /// <see cref="powenetics_set_clock" />, which is the system time by
+    /// default.
     /// </remarks>
     powenetics_timestamp timestamp;
 
@@ -133,6 +139,47 @@ typedef struct LIBPOWENETICS_API powenetics_sample_t {
     powenetics_voltage_current peg_3_3v;
 
     /* End of Powenetics v2, future versions must add fields below. */
+
+    /* Begin of version 3. */
+
+    /// <summary>
+    /// The position of the sample in the stream since streaming was started.
+    /// </summary>
+    /// <remarks>
+    /// <para>The index is derived from <see cref="sequence_number" />, but
+    /// does not wrap. It starts at zero for the first sample delivered after
+    /// streaming has been started. If the device sent samples that have not
+    /// been received or that have been dropped, the index skips these samples,
+    /// ie the difference between the indices of two consecutive samples is
+    /// always the sum of <see cref="missing" /> and <see cref="dropped" /> plus
+    /// one.</para>
+    /// <para>As the sequence number of the device has only 16 bits, a gap of
+    /// 65536 samples or more cannot be detected.</para>
+    /// </remarks>
+    uint64_t index;
+
+    /// <summary>
+    /// The number of samples that the device sent between the previous sample
+    /// and this one, but that have not been received.
+    /// </summary>
+    /// <remarks>
+    /// This is zero unless data have been lost, so a non-zero value marks the
+    /// position of a gap in the data.
+    /// </remarks>
+    uint32_t missing;
+
+    /// <summary>
+    /// The number of samples that have been received between the previous
+    /// sample and this one, but that the library has dropped because the
+    /// consumer did not keep up.
+    /// </summary>
+    /// <remarks>
+    /// This can only be non-zero if the samples are buffered for the consumer,
+    /// in which case the <see cref="powenetics_overflow" /> policy of the
+    /// buffer determines whether samples are dropped. A non-zero value marks
+    /// the position of the gap in the data.
+    /// </remarks>
+    uint32_t dropped;
 } powenetics_sample;
 
 #endif /* !defined(_LIBPOWENETICS_SAMPLE_H)*/
@@ -0,0 +1,145 @@
+﻿// <copyright file="scheduling.h" company="Visualisierungsinstitut der Universität Stuttgart">
+// Copyright © 2026 Visualisierungsinstitut der Universität Stuttgart.
+// Licensed under the MIT licence. See LICENCE file for details.
+// </copyright>
+// <author>Christoph Müller</author>
+
+#if !defined(_LIBPOWENETICS_SCHEDULING_H)
+#define _LIBPOWENETICS_SCHEDULING_H
+#pragma once
+
+#include "libpowenetics/api.h"
+#include "libpowenetics/types.h"
+
+
+/// <summary>
+/// Identifies the scheduling policies the streaming thread of a device can
+/// run with.
+/// </summary>
+typedef enum LIBPOWENETICS_ENUM powenetics_scheduling_t {
+
+    /// <summary>
+    /// The thread runs with the policy and priority it inherits from the
+    /// thread starting it, which is the default.
+    /// </summary>
+    LIBPOWENETICS_ENUM_SCOPE(powenetics_scheduling, inherit) = 0,
+
+    /// <summary>
+    /// The thread runs with the real-time policy <c>SCHED_FIFO</c>, ie it is
+    /// only preempted by threads of higher real-time priority.
+    /// </summary>
+    /// <remarks>
+    /// On Windows, the thread runs with time-critical priority instead.
+    /// </remarks>
+    LIBPOWENETICS_ENUM_SCOPE(powenetics_scheduling, fifo) = 1,
+
+    /// <summary>
+    /// The thread runs with the real-time policy <c>SCHED_RR</c>, which is
+    /// the same as <see cref="powenetics_scheduling::fifo" /> except for
+    /// threads of the same priority sharing the processor in time slices.
+    /// </summary>
+    /// <remarks>
+    /// On Windows, the thread runs with time-critical priority instead.
+    /// </remarks>
+    LIBPOWENETICS_ENUM_SCOPE(powenetics_scheduling, round_robin) = 2
+} powenetics_scheduling;
+
+
+/// <summary>
+/// Configures how the streaming thread of a device is scheduled, which
+/// allows for keeping the jitter of the samples low while the machine is
+/// fully loaded.
+/// </summary>
+/// <remarks>
+/// The configuration is applied to the streaming thread when it starts,
+/// before the device is instructed to send data. It does not apply to
+/// devices served by a reactor, whose threads are shared.
+/// </remarks>
+typedef struct LIBPOWENETICS_API powenetics_thread_configuration_t {
+
+    /// <summary>
+    /// The version of the structure.
+    /// </summary>
+    /// <remarks>
+    /// <para>This member allows the library to discern between future versions
+    /// of the structure. It must be initialised to 2 in the first version of
+    /// the library (for Powenetics v2).</para>
+    /// <para>This must be the first member of the struct and any future version
+    /// of it.</para>
+    /// </remarks>
+    uint32_t version;
+
+    /// <summary>
+    /// The set of processors the thread may run on.
+    /// </summary>
+    /// <remarks>
+    /// Bit <c>i % 64</c> of element <c>i / 64</c> allows for running on the
+    /// processor with index <c>i</c>. If no bit is set, the thread may run on
+    /// the same processors as the thread starting it. On Windows, only the
+    /// processors of the first processor group can be selected.
+    /// </remarks>
+    uint64_t affinity[16];
+
+    /// <summary>
+    /// The scheduling policy of the thread.
+    /// </summary>
+    /// <remarks>
+    /// On Linux, the real-time policies require the
+    /// <c>CAP_SYS_NICE</c> capability or a sufficient
+    /// <c>RLIMIT_RTPRIO</c>.
+    /// </remarks>
+    powenetics_scheduling scheduling;
+
+    /// <summary>
+    /// The real-time priority of the thread, which must be within the range
+    /// the system supports for <see cref="scheduling" />, ie [1, 99] on Linux.
+    /// </summary>
+    /// <remarks>
+    /// The priority is ignored for
+    /// <see cref="powenetics_scheduling::inherit" />.
+    /// </remarks>
+    int32_t priority;
+
+    /// <summary>
+    /// If non-zero, all pages of the process are locked into memory using
+    /// <c>mlockall</c>, such that the buffers of the parser and the stack of
+    /// the thread cannot be paged out.
+    /// </summary>
+    /// <remarks>
+    /// <para>Locking affects the whole process and also applies to memory
+    /// allocated afterwards. It is not undone when streaming stops. The
+    /// amount of memory that can be locked is limited by
+    /// <c>RLIMIT_MEMLOCK</c> unless the process has the <c>CAP_IPC_LOCK</c>
+    /// capability.</para>
+    /// <para>Locking memory is not supported on Windows.</para>
+    /// </remarks>
+    uint32_t lock_memory;
+} powenetics_thread_configuration;
+
+
+#if defined(__cplusplus)
+extern "C" {
+#endif /* defined(__cplusplus) */
+
+/// <summary>
+/// Applies the default configuration of the streaming thread to the structure
+/// passed to the method.
+/// </summary>
+/// <remarks>
+/// The default configuration does not change the affinity, the scheduling or
+/// the memory of the thread.
+/// </remarks>
+/// <param name="config">A pointer to the structure to be filled. The version
+/// of the structure must have been initialised before the call.</param>
+/// <returns><c>S_OK</c> in case of success,
+/// <c>E_POINTER</c> if <paramref name="config" /> is <c>nullptr</c>,
+/// <c>E_INVALIDARG</c> if the version of the configuration has not been
+/// initialised or is unsupported by the function.</returns>
+HRESULT LIBPOWENETICS_API powenetics_initialise_thread_configuration(
+    _In_ powenetics_thread_configuration *config);
+
+#if defined(__cplusplus)
+}
+#endif /* defined(__cplusplus) */
+
+#endif /* !defined(_LIBPOWENETICS_SCHEDULING_H) */
@@ -0,0 +1,147 @@
+﻿// <copyright file="segment.h" company="Visualisierungsinstitut der Universität Stuttgart">
+// Copyright © 2026 Visualisierungsinstitut der Universität Stuttgart.
+// Licensed under the MIT licence. See LICENCE file for details.
+// </copyright>
+// <author>Christoph Müller</author>
+
+#if !defined(_LIBPOWENETICS_SEGMENT_H)
+#define _LIBPOWENETICS_SEGMENT_H
+#pragma once
+
+#include "libpowenetics/api.h"
+#include "libpowenetics/raw_sample.h"
+#include "libpowenetics/timestamp.h"
+#include "libpowenetics/types.h"
+
+
+/// <summary>
+/// The number of bytes in a segment of a Powenetics v2 device.
+/// </summary>
+/// <remarks>
+/// A segment comprises the 16-bit sequence number and 13 readings of 16-bit
+/// voltage data and 24-bit current data, all in big-endian byte order. The
+/// delimiter preceding the segment is not included.
+/// </remarks>
+#define POWENETICS_SEGMENT_LENGTH (67)
+
+
+/// <summary>
+/// A correctly framed segment of the data stream of a Powenetics v2 device,
+/// which has not been decoded.
+/// </summary>
+/// <remarks>
+/// The library fills all fields except for the readings, which remain in
+/// <see cref="data" /> exactly as they have been received from the device.
+/// <see cref="powenetics_decode_segment" /> decodes them into a
+/// <see cref="powenetics_raw_sample" /> if needed.
+/// </remarks>
+typedef struct LIBPOWENETICS_API powenetics_segment_t {
+
+    /// <summary>
+    /// The version of the segment, which must be initialised when this
+    /// structure is passed to any API.
+    /// </summary>
+    /// <remarks>
+    /// <para>For the current version of the API, this value must be 3 for
+    /// Powenetics v2. Version 2 of the structure ends before
+    /// <see cref="index" />. Callbacks always receive the current
+    /// version.</para>
+    /// <para>This field must always remain at the first version of the
+    /// structure, even if additional fields are added.</para>
+    /// </remarks>
+    uint32_t version;
+
+    /// <summary>
+    /// The sequence number of the segment, which is the same as in the first
+    /// two bytes of <see cref="data" />.
+    /// </summary>
+    /// <remarks>
+    /// <para>This must always remain the second field in the structure.</para>
+    /// </remarks>
+    uint16_t sequence_number;
+
+    /// <summary>
+    /// The time at which the segment has been received.
+    /// </summary>
+    powenetics_timestamp timestamp;
+
+    /// <summary>
+    /// The <see cref="POWENETICS_SEGMENT_LENGTH" /> bytes of the segment.
+    /// </summary>
+    /// <remarks>
+    /// The data are owned by the library and only valid until the callback
+    /// that received the segment returns. Callers that need the data later on
+    /// must copy them.
+    /// </remarks>
+    const uint8_t *data;
+
+    /* Begin of version 3. */
+
+    /// <summary>
+    /// The position of the segment in the stream since streaming was started.
+    /// </summary>
+    /// <remarks>
+    /// This has the same semantics as <see cref="powenetics_sample::index" />.
+    /// </remarks>
+    uint64_t index;
+
+    /// <summary>
+    /// The number of segments that the device sent between the previous
+    /// segment and this one, but that have not been received.
+    /// </summary>
+    uint32_t missing;
+
+    /// <summary>
+    /// The number of segments that have been received between the previous
+    /// segment and this one, but that the library has dropped because the
+    /// consumer did not keep up.
+    /// </summary>
+    /// <remarks>
+    /// This has the same semantics as <see cref="powenetics_sample::dropped" />.
+    /// </remarks>
+    uint32_t dropped;
+} powenetics_segment;
+
+
+/// <summary>
+/// The callback to be invoked when a new segment is available.
+/// </summary>
+typedef void (*powenetics_segment_callback)(_In_ powenetics_handle source,
+    _In_ const struct powenetics_segment_t *segment, _In_opt_ void *context);
+
+
+#if defined(__cplusplus)
+extern "C" {
+#endif /* defined(__cplusplus) */
+
+/// <summary>
+/// Decodes the readings of a segment into a raw sample.
+/// </summary>
+/// <remarks>
+/// <para>The result is the same as if the sample had been received via
+/// <see cref="powenetics_start_streaming_raw" /> in the first place. The
+/// sequence number, the timestamp, the index and the numbers of missing and
+/// dropped samples are copied from <paramref name="src" />.</para>
+/// <para>The function does not depend on any state of the library, so it
+/// can be called at any time on segments that have been copied, for instance
+/// when reading an archive.</para>
+/// </remarks>
+/// <param name="dst">Receives the decoded sample. The version of the
+/// structure must have been initialised before the call. If it is 2, the
+/// members added in version 3 are not written.</param>
+/// <param name="src">The segment to be decoded. If its version is 2, the
+/// index and the numbers of missing and dropped samples are zero.</param>
+/// <returns><c>S_OK</c> in case of success,
+/// <c>E_POINTER</c> if <paramref name="dst" />, <paramref name="src" /> or
+/// the data of <paramref name="src" /> are <c>nullptr</c>,
+/// <c>E_INVALIDARG</c> if the version of <paramref name="dst" /> or
+/// <paramref name="src" /> is not supported.</returns>
+HRESULT LIBPOWENETICS_API powenetics_decode_segment(
+    _Inout_ powenetics_raw_sample *dst,
+    _In_ const powenetics_segment *src);
+
+#if defined(__cplusplus)
+} /* extern "C" */
+#endif /* defined(__cplusplus) */
+
+#endif /* !defined(_LIBPOWENETICS_SEGMENT_H) */
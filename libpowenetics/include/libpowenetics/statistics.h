@@ -0,0 +1,127 @@
+﻿// <copyright file="statistics.h" company="Visualisierungsinstitut der Universität Stuttgart">
+// Copyright © 2026 Visualisierungsinstitut der Universität Stuttgart.
+// Licensed under the MIT licence. See LICENCE file for details.
+// </copyright>
+// <author>Christoph Müller</author>
+
+#if !defined(_LIBPOWENETICS_STATISTICS_H)
+#define _LIBPOWENETICS_STATISTICS_H
+#pragma once
+
+#include "libpowenetics/api.h"
+#include "libpowenetics/types.h"
+
+
+/// <summary>
+/// Counters about the health of the data stream from a Powenetics v2 power
+/// measurement device.
+/// </summary>
+/// <remarks>
+/// <para>The counters are maintained over the whole lifetime of a handle, ie
+/// they are not reset if streaming is stopped and restarted.</para>
+/// <para>The counters are updated by the streaming thread once per read from
+/// the device, so a snapshot obtained while streaming might be slightly
+/// behind.</para>
+/// </remarks>
+typedef struct LIBPOWENETICS_API powenetics_statistics_t {
+
+    /// <summary>
+    /// The version of the structure, which must be initialised when this
+    /// structure is passed to any API.
+    /// </summary>
+    /// <remarks>
+    /// <para>For the current version of the API, this value must always be 2
+    /// for Powenetics v2.</para>
+    /// <para>This must be the first member of the struct and any future version
+    /// of it.</para>
+    /// </remarks>
+    uint32_t version;
+
+    /// <summary>
+    /// The total number of bytes that have been read from the device.
+    /// </summary>
+    uint64_t bytes_read;
+
+    /// <summary>
+    /// The number of read operations that have been issued to the operating
+    /// system.
+    /// </summary>
+    uint64_t reads;
+
+    /// <summary>
+    /// The number of segments that have been parsed and delivered as samples.
+    /// </summary>
+    uint64_t segments_parsed;
+
+    /// <summary>
+    /// The number of segments that have been discarded, because they did not
+    /// have the expected length.
+    /// </summary>
+    uint64_t segments_rejected;
+
+    /// <summary>
+    /// The number of bytes that have been discarded while resynchronising with
+    /// the stream, including any leading garbage.
+    /// </summary>
+    uint64_t bytes_discarded;
+
+    /// <summary>
+    /// The number of reads that ended with an incomplete segment, which had to
+    /// be retained until the next read.
+    /// </summary>
+    uint64_t carry_overs;
+
+    /// <summary>
+    /// The number of gaps in the sequence numbers of the samples that have
+    /// been delivered.
+    /// </summary>
+    /// <remarks>
+    /// The positions of the gaps can be identified by the
+    /// <see cref="powenetics_sample::missing" /> member of the samples.
+    /// </remarks>
+    uint64_t sequence_gaps;
+
+    /// <summary>
+    /// The total number of samples that the device sent, but that have not
+    /// been delivered.
+    /// </summary>
+    uint64_t samples_missing;
+
+    /// <summary>
+    /// The number of samples or segments that have been received, but that
+    /// have been discarded, because the queue they should have been handed
+    /// over to was full.
+    /// </summary>
+    /// <remarks>
+    /// Samples are only dropped if they are delivered through
+    /// <see cref="powenetics_read_samples" /> or on a dispatch thread. The
+    /// <see cref="powenetics_overflow" /> policy of the queue determines
+    /// which samples are dropped. The position of the drops is marked in
+    /// <see cref="powenetics_sample::dropped" />.
+    /// </remarks>
+    uint64_t samples_dropped;
+
+    /// <summary>
+    /// The number of samples or segments waiting for the dispatch thread to
+    /// invoke the callback when the counters were last updated.
+    /// </summary>
+    uint64_t dispatch_depth;
+
+    /// <summary>
+    /// The highest value that <see cref="dispatch_depth" /> has reached.
+    /// </summary>
+    uint64_t dispatch_depth_max;
+
+    /// <summary>
+    /// The longest time in nanoseconds a single callback has taken on the
+    /// dispatch thread.
+    /// </summary>
+    /// <remarks>
+    /// The time is only measured if the callbacks are invoked
+    /// asynchronously, because measuring it on the thread reading from the
+    /// device would slow down reading.
+    /// </remarks>
+    uint64_t callback_time_max;
+} powenetics_statistics;
+
+#endif /* !defined(_LIBPOWENETICS_STATISTICS_H) */
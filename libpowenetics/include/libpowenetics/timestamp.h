@@ -17,11 +17,88 @@ extern "C" {
 #endif /* defined(__cplusplus) */
 
 /// <summary>
-/// The type used to represent a timestamp, which is the time elapsed since
-/// 1st January 1601 (UTC) in units of 100ns.
+/// The type used to represent a timestamp.
 /// </summary>
+/// <remarks>
+/// For the system time, which is the default clock, a timestamp is the time
+/// elapsed since 1st January 1601 (UTC) in units of 100ns. For the other
+/// clocks in <see cref="powenetics_clock" />, the epoch and potentially the
+/// unit are different.
+/// </remarks>
 typedef int64_t powenetics_timestamp;
 
+
+/// <summary>
+/// Identifies the clocks the timestamps of the samples can be obtained from.
+/// </summary>
+typedef enum LIBPOWENETICS_ENUM powenetics_clock_t {
+
+    /// <summary>
+    /// The system time in units of 100ns since 1st January 1601 (UTC).
+    /// </summary>
+    /// <remarks>
+    /// This clock might jump if the system time is adjusted, for instance by
+    /// NTP.
+    /// </remarks>
+    LIBPOWENETICS_ENUM_SCOPE(powenetics_clock, system_time) = 0,
+
+    /// <summary>
+    /// The monotonic clock of the STL (<c>std::chrono::steady_clock</c>) in
+    /// units of 100ns since an unspecified epoch.
+    /// </summary>
+    LIBPOWENETICS_ENUM_SCOPE(powenetics_clock, monotonic) = 1,
+
+    /// <summary>
+    /// The monotonic clock that is not adjusted by NTP, which is
+    /// <c>CLOCK_MONOTONIC_RAW</c> on Linux and the performance counter on
+    /// Windows, in units of 100ns since an unspecified epoch.
+    /// </summary>
+    LIBPOWENETICS_ENUM_SCOPE(powenetics_clock, monotonic_raw) = 2,
+
+    /// <summary>
+    /// The invariant time stamp counter of the processor in units of its
+    /// reference cycles, which can be obtained from
+    /// <see cref="powenetics_get_clock_frequency" />.
+    /// </summary>
+    /// <remarks>
+    /// This clock is only available on x86 processors that have an invariant
+    /// TSC. Reading it is the cheapest way to obtain a timestamp.
+    /// </remarks>
+    LIBPOWENETICS_ENUM_SCOPE(powenetics_clock, tsc) = 3
+} powenetics_clock;
+
+
+/// <summary>
+/// Determines how the timestamps of the samples are obtained.
+/// </summary>
+typedef enum LIBPOWENETICS_ENUM powenetics_timestamping_t {
+
+    /// <summary>
+    /// Each sample is stamped with the host time at which it has been
+    /// parsed.
+    /// </summary>
+    /// <remarks>
+    /// All samples received by a single read from the device have almost the
+    /// same timestamp in this mode, followed by a jump to the next read.
+    /// </remarks>
+    LIBPOWENETICS_ENUM_SCOPE(powenetics_timestamping, per_sample) = 0,
+
+    /// <summary>
+    /// The host time is only obtained once per read from the device, and the
+    /// timestamps of the samples are interpolated using a linear model of the
+    /// sample index against the host time, which is continuously fitted to
+    /// these observations.
+    /// </summary>
+    /// <remarks>
+    /// In this mode, the timestamps of the samples are evenly spaced and
+    /// follow drift between the clock of the device and the host clock. The
+    /// timestamps include the average latency of the I/O, though. The first
+    /// samples after streaming has started are stamped with the time of the
+    /// read until enough observations are available to fit the model.
+    /// </remarks>
+    LIBPOWENETICS_ENUM_SCOPE(powenetics_timestamping, interpolated) = 1
+} powenetics_timestamping;
+
 #if defined(LIBPOWENETICS_EXPOSE_TO_TESTING)
 /// <summary>
 /// Creates a timestamp from the current system time using the STL clock.
@@ -36,12 +113,68 @@ typedef int64_t powenetics_timestamp;
 powenetics_timestamp LIBPOWENETICS_TEST_API _powenetics_make_timestamp(void);
 #endif /* defined(LIBPOWENETICS_EXPOSE_TO_TESTING) */
 
+/// <summary>
+/// Converts a timestamp from one clock to another one.
+/// </summary>
+/// <remarks>
+/// The conversion reads both clocks to determine their current offset, so
+/// the result is only exact for timestamps that are reasonably close to the
+/// current time. If the system time has been adjusted between the time
+/// <paramref name="timestamp" /> was taken and the conversion, the result
+/// reflects the adjustment.
+/// </remarks>
+/// <param name="dst">Receives the converted timestamp.</param>
+/// <param name="dst_clock">The clock to convert to.</param>
+/// <param name="timestamp">The timestamp to be converted.</param>
+/// <param name="src_clock">The clock <paramref name="timestamp" /> was
+/// obtained from.</param>
+/// <returns><c>S_OK</c> in case of success,
+/// <c>E_POINTER</c> if <paramref name="dst" /> is <c>nullptr</c>,
+/// <c>E_INVALIDARG</c> if one of the clocks is invalid,
+/// <c>E_NOTIMPL</c> if one of the clocks is not supported on the machine.
+/// </returns>
+HRESULT LIBPOWENETICS_API powenetics_convert_timestamp(
+    _Out_ powenetics_timestamp *dst,
+    _In_ const powenetics_clock dst_clock,
+    _In_ const powenetics_timestamp timestamp,
+    _In_ const powenetics_clock src_clock);
+
+/// <summary>
+/// Retrieves the number of ticks per second of the given clock.
+/// </summary>
+/// <param name="frequency">Receives the number of ticks per second.</param>
+/// <param name="clock">The clock to retrieve the frequency of.</param>
+/// <returns><c>S_OK</c> in case of success,
+/// <c>E_POINTER</c> if <paramref name="frequency" /> is <c>nullptr</c>,
+/// <c>E_INVALIDARG</c> if <paramref name="clock" /> is invalid,
+/// <c>E_NOTIMPL</c> if the clock is not supported on the machine.</returns>
+HRESULT LIBPOWENETICS_API powenetics_get_clock_frequency(
+    _Out_ uint64_t *frequency,
+    _In_ const powenetics_clock clock);
+
 /// <summary>
 /// Creates a timestamp from the current system time.
 /// </summary>
 /// <returns>The timestamp in 100ns units.</returns>
 powenetics_timestamp LIBPOWENETICS_API powenetics_make_timestamp(void);
 
+/// <summary>
+/// Reads the current time from the given clock.
+/// </summary>
+/// <remarks>
+/// Applications can use this function to stamp their own events in the same
+/// domain as the samples.
+/// </remarks>
+/// <param name="timestamp">Receives the current time.</param>
+/// <param name="clock">The clock to be read.</param>
+/// <returns><c>S_OK</c> in case of success,
+/// <c>E_POINTER</c> if <paramref name="timestamp" /> is <c>nullptr</c>,
+/// <c>E_INVALIDARG</c> if <paramref name="clock" /> is invalid,
+/// <c>E_NOTIMPL</c> if the clock is not supported on the machine.</returns>
+HRESULT LIBPOWENETICS_API powenetics_read_clock(
+    _Out_ powenetics_timestamp *timestamp,
+    _In_ const powenetics_clock clock);
+
 #if defined(__cplusplus)
 } /* extern "C" */
 #endif /* defined(__cplusplus) */
@@ -88,4 +88,16 @@ struct powenetics_sample_t;
 typedef void (*powenetics_data_callback)(_In_ powenetics_handle source,
     _In_ const struct powenetics_sample_t *sample, _In_opt_ void *context);
 
+/// <summary>
+/// The callback to be invoked when a batch of new samples is available.
+/// </summary>
+/// <remarks>
+/// The samples are only valid while the callback is running. Callers must copy
+/// them if they need them afterwards.
+/// </remarks>
+typedef void (*powenetics_batch_callback)(_In_ powenetics_handle source,
+    _In_reads_(cnt) const struct powenetics_sample_t *samples,
+    _In_ const size_t cnt,
+    _In_opt_ void *context);
+
 #endif /* !defined(_LIBPOWENETICS_TYPES_H) */
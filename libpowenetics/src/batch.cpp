@@ -0,0 +1,28 @@
+﻿// <copyright file="batch.cpp" company="Visualisierungsinstitut der Universität Stuttgart">
+// Copyright © 2026 Visualisierungsinstitut der Universität Stuttgart.
+// Licensed under the MIT licence. See LICENCE file for details.
+// </copyright>
+// <author>Christoph Müller</author>
+
+#include "libpowenetics/batch.h"
+
+
+/*
+ * ::powenetics_initialise_batch_configuration
+ */
+HRESULT LIBPOWENETICS_API powenetics_initialise_batch_configuration(
+        _In_ powenetics_batch_configuration *config) {
+    if (config == nullptr) {
+        return E_POINTER;
+    }
+
+    switch (config->version) {
+        case 2:
+            config->samples = 0;
+            config->window = 0;
+            return S_OK;
+
+        default:
+            return E_INVALIDARG;
+    }
+}
@@ -0,0 +1,45 @@
+﻿// <copyright file="capture.cpp" company="Visualisierungsinstitut der Universität Stuttgart">
+// Copyright © 2026 Visualisierungsinstitut der Universität Stuttgart.
+// Licensed under the MIT licence. See LICENCE file for details.
+// </copyright>
+// <author>Christoph Müller</author>
+
+#include "libpowenetics/capture.h"
+
+#include <new>
+#include <system_error>
+
+#include "capture_parser.h"
+#include "debug.h"
+
+
+/*
+ * ::powenetics_parse_capture
+ */
+HRESULT LIBPOWENETICS_API powenetics_parse_capture(
+        _In_reads_(cnt) const uint8_t *data,
+        _In_ const size_t cnt,
+        _In_ const powenetics_capture_callback callback,
+        _In_opt_ void *context,
+        _In_ const size_t threads) {
+    if ((cnt > 0) && (data == nullptr)) {
+        _powenetics_debug("Invalid capture provided.\r\n");
+        return E_POINTER;
+    }
+    if (callback == nullptr) {
+        _powenetics_debug("Invalid capture callback provided.\r\n");
+        return E_POINTER;
+    }
+
+    try {
+        capture_parser parser(data, cnt, threads);
+        parser.parse(callback, context);
+        return S_OK;
+    } catch (std::bad_alloc) {
+        _powenetics_debug("Insufficient memory for parsing capture.\r\n");
+        return E_OUTOFMEMORY;
+    } catch (std::system_error) {
+        _powenetics_debug("Failed to start capture parser thread.\r\n");
+        return E_FAIL;
+    }
+}
@@ -0,0 +1,369 @@
+﻿// <copyright file="capture_parser.cpp" company="Visualisierungsinstitut der Universität Stuttgart">
+// Copyright © 2026 Visualisierungsinstitut der Universität Stuttgart.
+// Licensed under the MIT licence. See LICENCE file for details.
+// </copyright>
+// <author>Christoph Müller</author>
+
+#include "capture_parser.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <thread>
+
+#include "debug.h"
+#include "thread_name.h"
+
+
+/*
+ * capture_parser::capture_parser
+ */
+capture_parser::capture_parser(_In_reads_(cnt) const byte_type *data,
+        _In_ const std::size_t cnt,
+        _In_ const std::size_t threads,
+        _In_ const std::size_t chunk_size)
+    : _chunk_size(chunk_size),
+        _cnt(cnt),
+        _cursor(),
+        _data(data),
+        _next(0),
+        _scanner(::select_delimiter_scanner()),
+        _threads(threads) {
+    assert((data != nullptr) || (cnt == 0));
+
+    if (this->_threads == 0) {
+        this->_threads = (std::max)(std::thread::hardware_concurrency(), 1u);
+    }
+
+    if (this->_chunk_size == 0) {
+        // Give each worker a share of the capture, but limit the size of the
+        // chunks such that huge captures are not held in memory at once and
+        // such that small captures are not split into tiny pieces.
+        const std::size_t min_chunk_size = 64 * 1024;
+        this->_chunk_size = (this->_cnt + this->_threads - 1) / this->_threads;
+        this->_chunk_size = (std::max)(this->_chunk_size, min_chunk_size);
+        this->_chunk_size = (std::min)(this->_chunk_size, default_chunk_size);
+    }
+
+    // A chunk must be able to hold at least one segment, because the chain
+    // of the previous chunk could otherwise skip a whole chunk.
+    this->_chunk_size = (std::max)(this->_chunk_size, segment_stride);
+}
+
+
+/*
+ * capture_parser::parse
+ */
+void capture_parser::parse(_In_ const powenetics_capture_callback callback,
+        _In_opt_ void *context) {
+    assert(callback != nullptr);
+    const auto cnt_chunks = (this->_cnt + this->_chunk_size - 1)
+        / this->_chunk_size;
+    const auto cnt_threads = (std::min)(this->_threads, cnt_chunks);
+
+    this->_continuity.reset();
+    this->_cursor.position = 0;
+    this->_cursor.synchronised = false;
+    this->_sequencer = sample_sequencer();
+    this->_sequencer.clock(no_clock);
+
+    if (cnt_threads < 2) {
+        chunk_type chunk;
+        for (std::size_t i = 0; i < cnt_chunks; ++i) {
+            this->parse(chunk, i);
+            this->merge(chunk, i, callback, context);
+        }
+        return;
+    }
+
+    // The chunks are a ring buffer into which the workers parse. A worker may
+    // only reuse the slot of a chunk once it has been merged, which limits
+    // how far the workers can run ahead of the merge and therefore the amount
+    // of memory we need for huge captures.
+    std::vector<chunk_type> window(2 * cnt_threads);
+    bool abort = false;
+    std::exception_ptr error;
+    std::mutex lock;
+    std::size_t merged = 0;
+    std::atomic<std::size_t> next(0);
+    std::condition_variable signal;
+    std::vector<std::thread> workers;
+
+    auto fail = [&](void) {
+        std::lock_guard<std::mutex> l(lock);
+        if (!error) {
+            error = std::current_exception();
+        }
+        abort = true;
+        signal.notify_all();
+    };
+
+    try {
+        workers.reserve(cnt_threads);
+
+        for (std::size_t t = 0; t < cnt_threads; ++t) {
+            workers.emplace_back([&](void) {
+                ::set_thread_name("libpowenetics capture parser");
+
+                try {
+                    for (auto i = next++; i < cnt_chunks; i = next++) {
+                        auto& chunk = window[i % window.size()];
+
+                        {
+                            std::unique_lock<std::mutex> l(lock);
+                            signal.wait(l, [&](void) {
+                                return (abort || (i < merged + window.size()));
+                            });
+                            if (abort) {
+                                return;
+                            }
+                        }
+
+                        this->parse(chunk, i);
+
+                        {
+                            std::lock_guard<std::mutex> l(lock);
+                            chunk.ready = true;
+                        }
+                        signal.notify_all();
+                    }
+                } catch (...) {
+                    fail();
+                }
+            });
+        }
+
+        for (std::size_t i = 0; i < cnt_chunks; ++i) {
+            auto& chunk = window[i % window.size()];
+
+            {
+                std::unique_lock<std::mutex> l(lock);
+                signal.wait(l, [&](void) { return (abort || chunk.ready); });
+                if (abort) {
+                    break;
+                }
+            }
+
+            this->merge(chunk, i, callback, context);
+
+            {
+                std::lock_guard<std::mutex> l(lock);
+                chunk.ready = false;
+                ++merged;
+            }
+            signal.notify_all();
+        }
+    } catch (...) {
+        fail();
+    }
+
+    for (auto& w : workers) {
+        w.join();
+    }
+
+    if (error) {
+        _powenetics_debug("Parsing the capture failed.\r\n");
+        std::rethrow_exception(error);
+    }
+}
+
+
+/*
+ * capture_parser::chunk_type::clear
+ */
+void capture_parser::chunk_type::clear(void) noexcept {
+    this->candidates.clear();
+    this->offsets.clear();
+    this->samples.clear();
+}
+
+
+/*
+ * capture_parser::no_clock
+ */
+powenetics_timestamp capture_parser::no_clock(void) noexcept {
+    return 0;
+}
+
+
+/*
+ * capture_parser::follow
+ */
+void capture_parser::follow(_Inout_ chunk_type& dst,
+        _In_ cursor_type cursor,
+        _In_ const std::size_t limit,
+        _Inout_ sample_sequencer& sequencer,
+        _In_opt_ const chunk_type *meet) const {
+    assert(limit <= this->_cnt);
+    auto& delimiter = responses_v2::segment_delimiter;
+    const auto length = sample_sequencer::segment_length;
+
+    while (true) {
+        if (!cursor.synchronised) {
+            // A delimiter starting at the last byte of the chunk yields a
+            // candidate beyond the chunk, so we do not need to search further
+            // than the first byte of the next chunk.
+            assert(cursor.position <= limit);
+            const auto end = (std::min)(limit + 1, this->_cnt);
+            auto found = (cursor.position < end)
+                ? this->_scanner(this->_data + cursor.position,
+                    end - cursor.position)
+                : nullptr;
+
+            if (found == nullptr) {
+                // There is no delimiter starting in the rest of the chunk, so
+                // the next chunk must search from its begin, too.
+                cursor.position = limit;
+                break;
+            }
+
+            cursor.position = (found - this->_data) + delimiter.size();
+            cursor.synchronised = true;
+        }
+
+        if (cursor.position >= limit) {
+            // The candidate belongs to the next chunk.
+            break;
+        }
+
+        if (cursor.position + segment_stride > this->_cnt) {
+            // The capture ends before the candidate could be checked, which
+            // is the end of the chain.
+            break;
+        }
+
+        if ((meet != nullptr) && std::binary_search(meet->candidates.begin(),
+                meet->candidates.end(), cursor.position)) {
+            // We have met the chain of the worker, which is therefore exact
+            // from here on.
+            const auto first = std::lower_bound(meet->offsets.begin(),
+                meet->offsets.end(), cursor.position)
+                - meet->offsets.begin();
+            dst.offsets.insert(dst.offsets.end(),
+                meet->offsets.begin() + first,
+                meet->offsets.end());
+            dst.samples.insert(dst.samples.end(),
+                meet->samples.begin() + first,
+                meet->samples.end());
+            dst.end = meet->end;
+            return;
+        }
+
+        dst.candidates.push_back(cursor.position);
+        auto segment = this->_data + cursor.position;
+
+        if ((segment[length] == delimiter.front())
+                && (segment[length + 1] == delimiter.back())) {
+            dst.offsets.push_back(cursor.position);
+            dst.samples.emplace_back();
+            sequencer.parse_segment(dst.samples.back(), segment);
+            cursor.position += segment_stride;
+
+        } else {
+            // Search the next delimiter from the begin of the failed
+            // candidate like stream_parser_v2::resync does.
+            cursor.synchronised = false;
+        }
+    }
+
+    dst.end = cursor;
+}
+
+
+/*
+ * capture_parser::merge
+ */
+void capture_parser::merge(_Inout_ chunk_type& chunk,
+        _In_ const std::size_t index,
+        _In_ const powenetics_capture_callback callback,
+        _In_opt_ void *context) {
+    assert(callback != nullptr);
+    auto result = &chunk;
+    std::size_t first = 0;
+
+    // If the chain of the previous chunk has left it without a delimiter, it
+    // searches from the begin of this chunk like the worker did. Otherwise,
+    // we need to check where it enters this chunk.
+    assert(this->_cursor.synchronised
+        || (this->_cursor.position == index * this->_chunk_size));
+    if (this->_cursor.synchronised) {
+        auto& candidates = chunk.candidates;
+        auto& offsets = chunk.offsets;
+
+        if (std::binary_search(candidates.begin(), candidates.end(),
+                this->_cursor.position)) {
+            // The worker has visited the candidate, so we only need to drop
+            // the segments it found in the payload of the previous segment.
+            first = std::lower_bound(offsets.begin(), offsets.end(),
+                this->_cursor.position) - offsets.begin();
+
+        } else {
+            _powenetics_debug("Framing differs at chunk boundary.\r\n");
+            this->_repair.clear();
+            this->follow(this->_repair, this->_cursor, this->limit(index),
+                this->_sequencer, &chunk);
+            result = &this->_repair;
+        }
+    }
+
+    this->_cursor = result->end;
+
+    // Deliver the samples in the order stream_parser_v2 would do, compacting
+    // the ones that have been confirmed in place. A sample held back at the
+    // end of the previous chunk is delivered on its own if the first sample
+    // of this chunk confirms it, because there is no room for it. Like the
+    // stream parser, we unlock the filter whenever the segment does not begin
+    // directly after the previous one.
+    auto offsets = result->offsets.data() + first;
+    auto samples = result->samples.data() + first;
+    const auto cnt = result->samples.size() - first;
+    std::size_t retained = 0;
+    for (std::size_t i = 0; i < cnt; ++i) {
+        const auto held = this->_continuity.held();
+
+        if (offsets[i] != this->_next) {
+            this->_continuity.interrupt();
+        }
+        this->_next = offsets[i] + segment_stride;
+
+        if (this->_continuity.check(samples[i].sequence_number)) {
+            if (held && (retained < i)) {
+                samples[retained++] = this->_held;
+            } else if (held) {
+                assert(i == 0);
+                this->_sequencer.sequence(this->_held);
+                callback(&this->_held, 1, context);
+            }
+            samples[retained++] = samples[i];
+
+        } else {
+            this->_held = samples[i];
+        }
+    }
+
+    for (std::size_t i = 0; i < retained; ++i) {
+        this->_sequencer.sequence(samples[i]);
+    }
+
+    if (retained > 0) {
+        callback(samples, retained, context);
+    }
+}
+
+
+/*
+ * capture_parser::parse
+ */
+void capture_parser::parse(_Inout_ chunk_type& dst,
+        _In_ const std::size_t index) const {
+    sample_sequencer sequencer;
+    cursor_type cursor;
+    cursor.position = index * this->_chunk_size;
+    cursor.synchronised = false;
+
+    dst.clear();
+    this->follow(dst, cursor, this->limit(index), sequencer, nullptr);
+}
@@ -0,0 +1,254 @@
+﻿// <copyright file="capture_parser.h" company="Visualisierungsinstitut der Universität Stuttgart">
+// Copyright © 2026 Visualisierungsinstitut der Universität Stuttgart.
+// Licensed under the MIT licence. See LICENCE file for details.
+// </copyright>
+// <author>Christoph Müller</author>
+
+#if !defined(_LIBPOWENETICS_CAPTURE_PARSER_H)
+#define _LIBPOWENETICS_CAPTURE_PARSER_H
+#pragma once
+
+#include <cinttypes>
+#include <cstddef>
+#include <vector>
+
+#include "libpowenetics/api.h"
+#include "libpowenetics/capture.h"
+#include "libpowenetics/raw_sample.h"
+
+#include "delimiter_scanner.h"
+#include "continuity_filter.h"
+#include "responses.h"
+#include "sample_sequencer.h"
+
+
+/// <summary>
+/// Parses a capture of the data stream of a Powenetics v2 device that is
+/// completely in memory by splitting it into chunks that are parsed in
+/// parallel.
+/// </summary>
+/// <remarks>
+/// <para>The framing of the stream is a chain of segment candidates: a parser
+/// starts after the first delimiter, jumps from segment to segment as long as
+/// each one is followed by a delimiter and searches the next delimiter from
+/// the begin of the candidate that failed this check. The parser follows the
+/// same chain as <see cref="stream_parser_v2" />, but it knows the position
+/// of each candidate in the capture.</para>
+/// <para>Each worker resynchronises on the first delimiter in its chunk and
+/// follows the chain until it leaves the chunk. Two chains that share a
+/// candidate are the same from there on, so the output of a worker is exact
+/// from the position at which the chain of its predecessor enters its chunk
+/// if the worker has visited this position, too. If it has not, which is
+/// only possible if there is a delimiter in the payload of the segment at the
+/// boundary or if the stream is corrupted at the boundary, the merge
+/// follows the exact chain until it meets the one of the worker.</para>
+/// <para>The merge runs on the calling thread. It applies the same
+/// <see cref="continuity_filter" /> as <see cref="stream_parser_v2" />,
+/// extends the sequence numbers to indices and delivers the samples of each
+/// chunk in order, while
+/// at most twice as many chunks as there are workers are held in memory.
+/// </para>
+/// </remarks>
+class LIBPOWENETICS_TEST_API capture_parser final {
+
+public:
+
+    /// <summary>
+    /// The type used to represent a single byte.
+    /// </summary>
+    typedef sample_sequencer::byte_type byte_type;
+
+    /// <summary>
+    /// The size of the chunks in bytes if the capture is large enough to
+    /// keep all workers busy.
+    /// </summary>
+    static constexpr std::size_t default_chunk_size = 4 * 1024 * 1024;
+
+    /// <summary>
+    /// The distance between the begin of two consecutive segments, which is
+    /// the smallest chunk size the parser accepts.
+    /// </summary>
+    static constexpr std::size_t segment_stride
+        = sample_sequencer::segment_length
+        + responses_v2::segment_delimiter.size();
+
+    /// <summary>
+    /// Initialises a new instance.
+    /// </summary>
+    /// <param name="data">The capture, which must remain valid while the
+    /// parser is in use.</param>
+    /// <param name="cnt">The size of <paramref name="data" /> in bytes.
+    /// </param>
+    /// <param name="threads">The number of worker threads, or zero to use all
+    /// logical processors of the machine.</param>
+    /// <param name="chunk_size">The size of the chunks, or zero to select it
+    /// based on the size of the capture and the number of threads.</param>
+    capture_parser(_In_reads_(cnt) const byte_type *data,
+        _In_ const std::size_t cnt,
+        _In_ const std::size_t threads = 0,
+        _In_ const std::size_t chunk_size = 0);
+
+    /// <summary>
+    /// Answer the size of the chunks the capture is split into.
+    /// </summary>
+    inline std::size_t chunk_size(void) const noexcept {
+        return this->_chunk_size;
+    }
+
+    /// <summary>
+    /// Parses the capture and delivers the samples of each chunk to
+    /// <paramref name="callback" />.
+    /// </summary>
+    /// <remarks>
+    /// The parser does not retain any state between two calls, so each call
+    /// parses the whole capture.
+    /// </remarks>
+    /// <param name="callback">The callback receiving the samples, which must
+    /// not be <c>nullptr</c>.</param>
+    /// <param name="context">The context pointer passed to
+    /// <paramref name="callback" />.</param>
+    /// <exception cref="std::bad_alloc">If a chunk could not be allocated.
+    /// </exception>
+    /// <exception cref="std::system_error">If a worker thread could not be
+    /// started.</exception>
+    void parse(_In_ const powenetics_capture_callback callback,
+        _In_opt_ void *context);
+
+    /// <summary>
+    /// Answer the number of worker threads.
+    /// </summary>
+    inline std::size_t threads(void) const noexcept {
+        return this->_threads;
+    }
+
+private:
+
+    /// <summary>
+    /// The position in the chain of segment candidates.
+    /// </summary>
+    struct cursor_type {
+
+        /// <summary>
+        /// The offset of the next segment candidate if
+        /// <see cref="synchronised" /> is set, or the offset from which on
+        /// the next delimiter must be searched otherwise.
+        /// </summary>
+        std::size_t position;
+
+        /// <summary>
+        /// Indicates whether <see cref="position" /> is the begin of a
+        /// segment candidate.
+        /// </summary>
+        bool synchronised;
+    };
+
+    /// <summary>
+    /// The result of parsing a single chunk.
+    /// </summary>
+    struct chunk_type {
+
+        /// <summary>
+        /// The offsets of all segment candidates visited within the chunk,
+        /// including the ones that failed the framing check.
+        /// </summary>
+        std::vector<std::size_t> candidates;
+
+        /// <summary>
+        /// The position at which the chain left the chunk.
+        /// </summary>
+        cursor_type end;
+
+        /// <summary>
+        /// The offsets of the correctly framed segments in the chunk.
+        /// </summary>
+        std::vector<std::size_t> offsets;
+
+        /// <summary>
+        /// Indicates that a worker has finished the chunk.
+        /// </summary>
+        bool ready;
+
+        /// <summary>
+        /// The samples decoded from the segments at
+        /// <see cref="offsets" />.
+        /// </summary>
+        std::vector<powenetics_raw_sample> samples;
+
+        /// <summary>
+        /// Empties the chunk while retaining its memory.
+        /// </summary>
+        void clear(void) noexcept;
+    };
+
+    /// <summary>
+    /// A clock that is always zero, because a capture does not tell us when
+    /// the data have been received.
+    /// </summary>
+    static powenetics_timestamp no_clock(void) noexcept;
+
+    /// <summary>
+    /// Follows the chain of segment candidates from <paramref name="cursor" />
+    /// until it leaves the chunk ending at <paramref name="limit" />.
+    /// </summary>
+    /// <param name="dst">Receives the candidates, segments and the end of the
+    /// chain.</param>
+    /// <param name="cursor">The position from which on the chain is
+    /// followed.</param>
+    /// <param name="limit">The end of the chunk.</param>
+    /// <param name="sequencer">The sequencer used to decode the segments.
+    /// </param>
+    /// <param name="meet">If not <c>nullptr</c>, the result of a worker with
+    /// which the chain is merged once both share a candidate.</param>
+    void follow(_Inout_ chunk_type& dst,
+        _In_ cursor_type cursor,
+        _In_ const std::size_t limit,
+        _Inout_ sample_sequencer& sequencer,
+        _In_opt_ const chunk_type *meet) const;
+
+    /// <summary>
+    /// Answer the end of the chunk with the given index.
+    /// </summary>
+    inline std::size_t limit(_In_ const std::size_t chunk) const noexcept {
+        const auto retval = (chunk + 1) * this->_chunk_size;
+        return (retval < this->_cnt) ? retval : this->_cnt;
+    }
+
+    /// <summary>
+    /// Fixes the framing at the begin of <paramref name="chunk" />, extends
+    /// the sequence numbers of its samples to indices and delivers them.
+    /// </summary>
+    void merge(_Inout_ chunk_type& chunk,
+        _In_ const std::size_t index,
+        _In_ const powenetics_capture_callback callback,
+        _In_opt_ void *context);
+
+    /// <summary>
+    /// Parses the chunk with the given index starting from the first
+    /// delimiter in it.
+    /// </summary>
+    void parse(_Inout_ chunk_type& dst, _In_ const std::size_t index) const;
+
+    std::size_t _chunk_size;
+    std::size_t _cnt;
+    continuity_filter _continuity;
+    cursor_type _cursor;
+    const byte_type *_data;
+
+    /// <summary>
+    /// The sample held back by <see cref="_continuity" />, which might have
+    /// been decoded from the previous chunk.
+    /// </summary>
+    powenetics_raw_sample _held;
+
+    /// <summary>
+    /// The offset at which a segment directly following the last one merged
+    /// would begin.
+    /// </summary>
+    std::size_t _next;
+    chunk_type _repair;
+    delimiter_scanner _scanner;
+    sample_sequencer _sequencer;
+    std::size_t _threads;
+};
+
+#endif /* !defined(_LIBPOWENETICS_CAPTURE_PARSER_H) */
@@ -0,0 +1,149 @@
+﻿// <copyright file="clock.cpp" company="Visualisierungsinstitut der Universität Stuttgart">
+// Copyright © 2026 Visualisierungsinstitut der Universität Stuttgart.
+// Licensed under the MIT licence. See LICENCE file for details.
+// </copyright>
+// <author>Christoph Müller</author>
+
+#include "clock.h"
+
+#if defined(_WIN32)
+#include <Windows.h>
+#else /* defined(_WIN32) */
+#include <time.h>
+#endif /* defined(_WIN32) */
+
+#include "cpu_features.h"
+
+#if (defined(POWENETICS_X86) && defined(_MSC_VER))
+#include <intrin.h>
+#elif defined(POWENETICS_X86)
+#include <x86intrin.h>
+#endif /* (defined(POWENETICS_X86) && defined(_MSC_VER)) */
+
+
+/// <summary>
+/// Measures the frequency of the time stamp counter against the raw
+/// monotonic clock.
+/// </summary>
+/// <remarks>
+/// The calibration spins for 20 ms, which makes the relative error caused by
+/// reading the clocks a few parts per million.
+/// </remarks>
+static std::uint64_t calibrate_tsc(void) noexcept {
+    if (!::has_cpu_feature(cpu_feature::invariant_tsc)) {
+        return 0;
+    }
+
+    const powenetics_timestamp duration = 200000;
+    const auto t0 = ::read_monotonic_raw_clock();
+    const auto c0 = ::read_tsc_clock();
+
+    auto t1 = t0;
+    auto c1 = c0;
+    while (t1 - t0 < duration) {
+        t1 = ::read_monotonic_raw_clock();
+        c1 = ::read_tsc_clock();
+    }
+
+    const auto cycles = static_cast<double>(c1 - c0);
+    const auto seconds = static_cast<double>(t1 - t0)
+        / filetime_period::den;
+    return static_cast<std::uint64_t>(cycles / seconds + 0.5);
+}
+
+
+/*
+ * ::clock_frequency
+ */
+std::uint64_t clock_frequency(_In_ const powenetics_clock clock) noexcept {
+    switch (clock) {
+        case powenetics_clock::system_time:
+        case powenetics_clock::monotonic:
+        case powenetics_clock::monotonic_raw:
+            return filetime_period::den;
+
+        case powenetics_clock::tsc: {
+            static const auto frequency = ::calibrate_tsc();
+            return frequency;
+        }
+
+        default:
+            return 0;
+    }
+}
+
+
+/*
+ * ::read_monotonic_clock
+ */
+powenetics_timestamp read_monotonic_clock(void) {
+    using namespace std::chrono;
+    const auto now = steady_clock::now().time_since_epoch();
+    return duration_cast<filetime_duration>(now).count();
+}
+
+
+/*
+ * ::read_monotonic_raw_clock
+ */
+powenetics_timestamp read_monotonic_raw_clock(void) {
+#if defined(_WIN32)
+    static const auto frequency = [](void) {
+        LARGE_INTEGER retval;
+        ::QueryPerformanceFrequency(&retval);
+        return retval.QuadPart;
+    }();
+
+    // Split the conversion in order to prevent the multiplication from
+    // overflowing.
+    LARGE_INTEGER counter;
+    ::QueryPerformanceCounter(&counter);
+    const auto s = counter.QuadPart / frequency;
+    const auto r = counter.QuadPart % frequency;
+    return s * filetime_period::den + (r * filetime_period::den) / frequency;
+
+#elif defined(CLOCK_MONOTONIC_RAW)
+    struct timespec ts;
+    ::clock_gettime(CLOCK_MONOTONIC_RAW, &ts);
+    return static_cast<powenetics_timestamp>(ts.tv_sec) * filetime_period::den
+        + ts.tv_nsec / 100;
+
+#else /* defined(_WIN32) */
+    return ::read_monotonic_clock();
+#endif /* defined(_WIN32) */
+}
+
+
+/*
+ * ::read_tsc_clock
+ */
+powenetics_timestamp read_tsc_clock(void) {
+#if defined(POWENETICS_X86)
+    return static_cast<powenetics_timestamp>(__rdtsc());
+#else /* defined(POWENETICS_X86) */
+    return 0;
+#endif /* defined(POWENETICS_X86) */
+}
+
+
+/*
+ * ::select_clock
+ */
+clock_function select_clock(_In_ const powenetics_clock clock) noexcept {
+    switch (clock) {
+        case powenetics_clock::system_time:
+            return ::powenetics_make_timestamp;
+
+        case powenetics_clock::monotonic:
+            return ::read_monotonic_clock;
+
+        case powenetics_clock::monotonic_raw:
+            return ::read_monotonic_raw_clock;
+
+        case powenetics_clock::tsc:
+            return (::clock_frequency(clock) > 0) ? ::read_tsc_clock : nullptr;
+
+        default:
+            return nullptr;
+    }
+}
@@ -0,0 +1,85 @@
+﻿// <copyright file="clock.h" company="Visualisierungsinstitut der Universität Stuttgart">
+// Copyright © 2026 Visualisierungsinstitut der Universität Stuttgart.
+// Licensed under the MIT licence. See LICENCE file for details.
+// </copyright>
+// <author>Christoph Müller</author>
+
+#if !defined(_LIBPOWENETICS_CLOCK_H)
+#define _LIBPOWENETICS_CLOCK_H
+#pragma once
+
+#include <chrono>
+#include <cinttypes>
+#include <ratio>
+
+#include "libpowenetics/api.h"
+#include "libpowenetics/timestamp.h"
+
+
+/// <summary>
+/// The 100ns period defining the reolution of <see cref="FILETIME" />, which
+/// we use for all clocks except for the TSC.
+/// </summary>
+typedef std::ratio<1, 10000000> filetime_period;
+
+/// <summary>
+/// The STL representation of <see cref="FILETIME" />.
+/// </summary>
+typedef std::chrono::duration<powenetics_timestamp, filetime_period>
+    filetime_duration;
+
+/// <summary>
+/// The signature of a function reading one of the clocks in
+/// <see cref="powenetics_clock" />.
+/// </summary>
+typedef powenetics_timestamp (*clock_function)(void);
+
+
+/// <summary>
+/// Answer the rate of the given clock.
+/// </summary>
+/// <param name="clock">The clock to get the rate of.</param>
+/// <returns>The number of ticks of the clock per second, or zero if the
+/// clock is not supported on the machine.</returns>
+std::uint64_t LIBPOWENETICS_TEST_API clock_frequency(
+    _In_ const powenetics_clock clock) noexcept;
+
+/// <summary>
+/// Reads the monotonic clock of the system, which is subject to frequency
+/// adjustments by NTP, but never jumps.
+/// </summary>
+/// <returns>The time since an unspecified epoch in units of 100ns.</returns>
+powenetics_timestamp LIBPOWENETICS_TEST_API read_monotonic_clock(void);
+
+/// <summary>
+/// Reads the raw monotonic clock of the system, which is not adjusted at
+/// all.
+/// </summary>
+/// <remarks>
+/// This is <c>CLOCK_MONOTONIC_RAW</c> on Linux and the performance counter
+/// on Windows. On other platforms, the function falls back to
+/// <see cref="read_monotonic_clock" />.
+/// </remarks>
+/// <returns>The time since an unspecified epoch in units of 100ns.</returns>
+powenetics_timestamp LIBPOWENETICS_TEST_API read_monotonic_raw_clock(void);
+
+/// <summary>
+/// Reads the time stamp counter of the processor.
+/// </summary>
+/// <remarks>
+/// The caller must check that the processor has an invariant TSC before
+/// using this function.
+/// </remarks>
+/// <returns>The value of the TSC in cycles of the reference clock.</returns>
+powenetics_timestamp LIBPOWENETICS_TEST_API read_tsc_clock(void);
+
+/// <summary>
+/// Answer the function reading the given clock.
+/// </summary>
+/// <param name="clock">The clock to be read.</param>
+/// <returns>The function reading the clock, or <c>nullptr</c> if the clock
+/// is invalid or not supported on the machine.</returns>
+clock_function LIBPOWENETICS_TEST_API select_clock(
+    _In_ const powenetics_clock clock) noexcept;
+
+#endif /* !defined(_LIBPOWENETICS_CLOCK_H) */
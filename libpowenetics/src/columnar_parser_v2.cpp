@@ -0,0 +1,60 @@
+﻿// <copyright file="columnar_parser_v2.cpp" company="Visualisierungsinstitut der Universität Stuttgart">
+// Copyright © 2026 Visualisierungsinstitut der Universität Stuttgart.
+// Licensed under the MIT licence. See LICENCE file for details.
+// </copyright>
+// <author>Christoph Müller</author>
+
+#include "columnar_parser_v2.h"
+
+
+/*
+ * columnar_parser_v2::columnar_parser_v2
+ */
+columnar_parser_v2::columnar_parser_v2(void) noexcept
+    : _decoder(::select_segment_decoder()),
+    _profile(connector_profile_unknown),
+    _run(nullptr),
+    _run_length(0) { }
+
+
+/*
+ * columnar_parser_v2::gather
+ */
+void columnar_parser_v2::gather(_Out_ powenetics_raw_sample& dst,
+        _In_ const std::size_t row) noexcept {
+    assert(row < this->_run_length);
+    auto read = [this, row](const std::size_t channel) {
+        powenetics_raw_voltage_current retval;
+        retval.voltage = this->_voltages[channel - 1][row];
+        retval.current = this->_currents[channel - 1][row];
+        return retval;
+    };
+
+    dst.version = sample_version;
+    dst.sequence_number = this->_sequence_numbers[row];
+    dst.index = 0;
+    dst.missing = 0;
+    dst.dropped = 0;
+    dst.timestamp = 0;
+
+    // The columnar decoder has already cleared the currents of all channels
+    // with a voltage of at most 1V, which covers the channels the connector
+    // profile reports as unsupplied. The only thing left to do is choosing
+    // the standby rail, which is on channel 6 for the 10-pin connector, which
+    // in turn is detected by a voltage strictly below 1V on channel 1 as in
+    // ::detect_connector_profile.
+    const auto atx_10pin = (this->_voltages[0][row] < 1000);
+
+    dst.atx_3_3v = read(1);
+    dst.atx_stb = read(atx_10pin ? 6 : 2);
+    dst.atx_12v = read(3);
+    dst.atx_5v = read(4);
+    dst.eps1 = read(5);
+    dst.eps3 = read(7);
+    dst.eps2 = read(8);
+    dst.pcie_12v3 = read(9);
+    dst.pcie_12v2 = read(10);
+    dst.peg_3_3v = read(11);
+    dst.peg_12v = read(12);
+    dst.pcie_12v1 = read(13);
+}
@@ -0,0 +1,220 @@
+﻿// <copyright file="columnar_parser_v2.h" company="Visualisierungsinstitut der Universität Stuttgart">
+// Copyright © 2026 Visualisierungsinstitut der Universität Stuttgart.
+// Licensed under the MIT licence. See LICENCE file for details.
+// </copyright>
+// <author>Christoph Müller</author>
+
+#if !defined(_LIBPOWENETICS_COLUMNAR_PARSER_V2_H)
+#define _LIBPOWENETICS_COLUMNAR_PARSER_V2_H
+#pragma once
+
+#include <array>
+#include <cassert>
+#include <cinttypes>
+#include <type_traits>
+
+#include "libpowenetics/api.h"
+#include "libpowenetics/raw_sample.h"
+#include "libpowenetics/sample.h"
+#include "libpowenetics/segment.h"
+#include "libpowenetics/timestamp.h"
+
+#include "convert.h"
+#include "profile_decoder.h"
+#include "segment_decoder.h"
+#include "stream_parser_v2.h"
+
+
+/// <summary>
+/// Parses the data stream of a Powenetics v2 device by decoding runs of
+/// consecutive segments at once with the vectorised
+/// <see cref="segment_decoder" />.
+/// </summary>
+/// <remarks>
+/// <para>The parser uses <see cref="stream_parser_v2" /> to split the stream
+/// into segments and to assign the indices and timestamps, so it delivers the
+/// same samples and maintains the same statistics. Instead of decoding each
+/// segment on its own, it collects up to <see cref="block_size" /> segments
+/// that are contiguous in the input and decodes them into columns in one go.
+/// Only segments that have been assembled in the carry-over area of the
+/// framing parser are decoded one by one.</para>
+/// <para>The parser is <i>not thread-safe!</i> Make sure to enqueue new data
+/// always from the same thread or serialise the operation somehow.</para>
+/// </remarks>
+class LIBPOWENETICS_TEST_API columnar_parser_v2 final {
+
+public:
+
+    /// <summary>
+    /// The type used to represent a single byte.
+    /// </summary>
+    typedef stream_parser_v2::byte_type byte_type;
+
+    /// <summary>
+    /// The counters the parser maintains about the health of the stream.
+    /// </summary>
+    typedef stream_parser_v2::statistics_type statistics_type;
+
+    /// <summary>
+    /// The maximum number of segments decoded at once.
+    /// </summary>
+    static constexpr std::size_t block_size = 32;
+
+    /// <summary>
+    /// Initialises a new instance.
+    /// </summary>
+    columnar_parser_v2(void) noexcept;
+
+    /// <summary>
+    /// Changes the clock the samples are stamped with.
+    /// </summary>
+    inline void clock(_In_ const clock_function clock) noexcept {
+        this->_framer.clock(clock);
+    }
+
+    /// <summary>
+    /// Answer the counters accumulated since the last call and reset them.
+    /// </summary>
+    inline statistics_type collect_statistics(void) noexcept {
+        return this->_framer.collect_statistics();
+    }
+
+    /// <summary>
+    /// Answer the energy integrated from all samples delivered so far.
+    /// </summary>
+    inline const energy_integrator& energy(void) const noexcept {
+        return this->_framer.energy();
+    }
+
+    /// <summary>
+    /// Discards any buffered data from previous calls that could not be
+    /// delivered.
+    /// </summary>
+    inline void flush(void) noexcept {
+        this->_framer.flush();
+    }
+
+    /// <summary>
+    /// Answer whether and how reliably the parser is synchronised with the
+    /// segments in the data stream.
+    /// </summary>
+    inline framing_state framing(void) const noexcept {
+        return this->_framer.framing();
+    }
+
+    /// <summary>
+    /// Reads the clock the samples are stamped with.
+    /// </summary>
+    inline powenetics_timestamp now(void) const {
+        return this->_framer.now();
+    }
+
+    /// <summary>
+    /// Answer the connector profile detected from the most recent segment.
+    /// </summary>
+    inline connector_profile profile(void) const noexcept {
+        return this->_profile;
+    }
+
+    /// <summary>
+    /// Splits the given <paramref name="data" /> and potentially a remainder
+    /// that could not be processed in the previous call into segments, parses
+    /// the data in these segments and delivers the resulting samples to
+    /// <paramref name="callback" />.
+    /// </summary>
+    /// <remarks>
+    /// The samples of a run of contiguous segments are delivered once the run
+    /// has been decoded, but always in the order of the stream and before the
+    /// method returns.
+    /// </remarks>
+    /// <typeparam name="TSample">The type of the samples to be delivered,
+    /// which must be <see cref="powenetics_sample" />,
+    /// <see cref="powenetics_raw_sample" /> or
+    /// <see cref="powenetics_segment" />.</typeparam>
+    /// <typeparam name="TCallback">The type of the callback functor to be
+    /// invoked, which must accept a single <typeparamref name="TSample" />.
+    /// </typeparam>
+    /// <param name="data">The data to be parsed, which must be a
+    /// non-<c>nullptr</c> pointer to <paramref name="cnt" /> bytes of data
+    /// received from the device.</param>
+    /// <param name="cnt">The size of <paramref name="data" /> in bytes.</param>
+    /// <param name="callback">The callback to be invoked for each sample.
+    /// </param>
+    /// <returns><c>true</c> if data have been buffered until the next call,
+    /// because the input could not be fully tokenised.</returns>
+    template<class TSample = powenetics_sample, class TCallback>
+    bool push_back(
+        _In_reads_(cnt) const byte_type *data,
+        _In_ const std::size_t cnt,
+        _In_ TCallback&& callback);
+
+    /// <summary>
+    /// Sets the host time at which the data passed to the next call to
+    /// <see cref="push_back" /> have been received.
+    /// </summary>
+    inline void received(_In_ const powenetics_timestamp timestamp) noexcept {
+        this->_framer.received(timestamp);
+    }
+
+    /// <summary>
+    /// Answer how the timestamps of the samples are obtained.
+    /// </summary>
+    inline powenetics_timestamping timestamping(void) const noexcept {
+        return this->_framer.timestamping();
+    }
+
+    /// <summary>
+    /// Changes how the timestamps of the samples are obtained.
+    /// </summary>
+    inline void timestamping(
+            _In_ const powenetics_timestamping timestamping) noexcept {
+        this->_framer.timestamping(timestamping);
+    }
+
+private:
+
+    /// <summary>
+    /// The distance between the begin of two contiguous segments.
+    /// </summary>
+    static constexpr std::size_t stride = stream_parser_v2::carry_capacity;
+
+    /// <summary>
+    /// Decodes the pending run of segments and delivers the samples to
+    /// <paramref name="callback" />.
+    /// </summary>
+    template<class TSample, class TCallback>
+    void decode_run(_In_ TCallback& callback);
+
+    /// <summary>
+    /// Assembles the raw sample with the given <paramref name="row" /> in the
+    /// columns of the most recently decoded run.
+    /// </summary>
+    void gather(_Out_ powenetics_raw_sample& dst,
+        _In_ const std::size_t row) noexcept;
+
+    /// <summary>
+    /// Collects runs of contiguous segments from <paramref name="data" />,
+    /// decodes them into columns and delivers the samples to
+    /// <paramref name="callback" />.
+    /// </summary>
+    template<class TSample, class TCallback>
+    bool push_back_runs(
+        _In_reads_(cnt) const byte_type *data,
+        _In_ const std::size_t cnt,
+        _In_ TCallback& callback);
+
+    std::array<std::array<std::uint32_t, block_size>, segment_channels>
+        _currents;
+    segment_decoder _decoder;
+    stream_parser_v2 _framer;
+    connector_profile _profile;
+    const byte_type *_run;
+    std::size_t _run_length;
+    std::array<std::uint16_t, block_size> _sequence_numbers;
+    std::array<std::array<std::uint16_t, block_size>, segment_channels>
+        _voltages;
+};
+
+#include "columnar_parser_v2.inl"
+
+#endif /* !defined(_LIBPOWENETICS_COLUMNAR_PARSER_V2_H) */
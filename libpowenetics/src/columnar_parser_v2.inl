@@ -0,0 +1,114 @@
+﻿// <copyright file="columnar_parser_v2.inl" company="Visualisierungsinstitut der Universität Stuttgart">
+// Copyright © 2026 Visualisierungsinstitut der Universität Stuttgart.
+// Licensed under the MIT licence. See LICENCE file for details.
+// </copyright>
+// <author>Christoph Müller</author>
+
+
+/*
+ * columnar_parser_v2::push_back
+ */
+template<class TSample, class TCallback>
+bool columnar_parser_v2::push_back(_In_reads_(cnt) const byte_type *data,
+        _In_ const std::size_t cnt,
+        _In_ TCallback&& callback) {
+    if constexpr (std::is_same<TSample, powenetics_segment>::value) {
+        // Segments are delivered without decoding them, so there is nothing
+        // to collect into columns.
+        return this->_framer.template push_back<TSample>(data, cnt, callback);
+    } else {
+        return this->push_back_runs<TSample>(data, cnt, callback);
+    }
+}
+
+
+/*
+ * columnar_parser_v2::push_back_runs
+ */
+template<class TSample, class TCallback>
+bool columnar_parser_v2::push_back_runs(
+        _In_reads_(cnt) const byte_type *data,
+        _In_ const std::size_t cnt,
+        _In_ TCallback& callback) {
+    assert(data != nullptr);
+    assert(this->_run_length == 0);
+    const auto end = data + cnt;
+
+    const auto retval = this->_framer.push_back_segments(data, cnt,
+            [this, data, end, &callback](const byte_type *segment) {
+        const auto in_place = (segment >= data) && (segment < end);
+        const auto contiguous = (this->_run_length > 0)
+            && (segment == this->_run + this->_run_length * stride);
+
+        if ((this->_run_length > 0)
+                && (!contiguous || (this->_run_length == block_size))) {
+            this->decode_run<TSample>(callback);
+        }
+
+        if (in_place) {
+            // The segment will remain valid until we return, so we can defer
+            // decoding it until the run is complete.
+            if (this->_run_length == 0) {
+                this->_run = segment;
+            }
+            ++this->_run_length;
+
+        } else {
+            // The segment is in the carry-over area of the framer, which will
+            // be overwritten, so we need to decode it immediately.
+            TSample sample;
+            auto& sequencer = this->_framer.sequencer();
+            sequencer.sequence(sample, segment);
+            this->_profile = sequencer.profile();
+            callback(sample);
+        }
+    });
+
+    if (this->_run_length > 0) {
+        this->decode_run<TSample>(callback);
+    }
+
+    this->_framer.sequencer().observe();
+
+    return retval;
+}
+
+
+/*
+ * columnar_parser_v2::decode_run
+ */
+template<class TSample, class TCallback>
+void columnar_parser_v2::decode_run(_In_ TCallback& callback) {
+    assert(this->_run != nullptr);
+    assert(this->_run_length > 0);
+    assert(this->_run_length <= block_size);
+
+    segment_columns columns;
+    columns.sequence_numbers = this->_sequence_numbers.data();
+    for (std::size_t c = 0; c < segment_channels; ++c) {
+        columns.voltages[c] = this->_voltages[c].data();
+        columns.currents[c] = this->_currents[c].data();
+    }
+
+    this->_decoder(columns, this->_run, stride, this->_run_length);
+
+    for (std::size_t r = 0; r < this->_run_length; ++r) {
+        // The sequencer integrates the energy from the raw readings, so the
+        // conversion into Volts and Amperes must come after it.
+        powenetics_raw_sample raw;
+        this->gather(raw, r);
+        this->_framer.sequencer().sequence(raw);
+
+        if constexpr (std::is_same<TSample, powenetics_sample>::value) {
+            powenetics_sample sample;
+            ::to_sample(sample, raw);
+            callback(sample);
+        } else {
+            callback(raw);
+        }
+    }
+
+    this->_profile = ::detect_connector_profile(this->_run
+        + (this->_run_length - 1) * stride);
+    this->_run_length = 0;
+}
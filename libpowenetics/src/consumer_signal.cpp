@@ -0,0 +1,32 @@
+﻿// <copyright file="consumer_signal.cpp" company="Visualisierungsinstitut der Universität Stuttgart">
+// Copyright © 2026 Visualisierungsinstitut der Universität Stuttgart.
+// Licensed under the MIT licence. See LICENCE file for details.
+// </copyright>
+// <author>Christoph Müller</author>
+
+#include "consumer_signal.h"
+
+
+/*
+ * consumer_signal::consumer_signal
+ */
+consumer_signal::consumer_signal(void) noexcept : _waiting(false) { }
+
+
+/*
+ * consumer_signal::notify
+ */
+void consumer_signal::notify(void) noexcept {
+    // Pairs with the fence in 'wait'.
+    std::atomic_thread_fence(std::memory_order::memory_order_seq_cst);
+
+    if (this->_waiting.load(std::memory_order::memory_order_relaxed)) {
+        // The consumer holds the lock from announcing that it waits until it
+        // actually waits, so acquiring it here ensures that the notification
+        // is not lost.
+        {
+            std::lock_guard<std::mutex> l(this->_lock);
+        }
+        this->_signal.notify_one();
+    }
+}
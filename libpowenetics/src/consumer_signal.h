@@ -0,0 +1,76 @@
+﻿// <copyright file="consumer_signal.h" company="Visualisierungsinstitut der Universität Stuttgart">
+// Copyright © 2026 Visualisierungsinstitut der Universität Stuttgart.
+// Licensed under the MIT licence. See LICENCE file for details.
+// </copyright>
+// <author>Christoph Müller</author>
+
+#if !defined(_LIBPOWENETICS_CONSUMER_SIGNAL_H)
+#define _LIBPOWENETICS_CONSUMER_SIGNAL_H
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+
+#include "libpowenetics/api.h"
+#include "libpowenetics/types.h"
+
+
+/// <summary>
+/// Allows the consumer of a <see cref="spsc_queue" /> to sleep while the
+/// queue is empty without the producer ever waiting for the consumer.
+/// </summary>
+/// <remarks>
+/// The producer only synchronises with the consumer if the consumer has
+/// announced that it is waiting, which it only does if it has found the queue
+/// empty. While the consumer is busy, <see cref="notify" /> costs a fence and
+/// a load.
+/// </remarks>
+class LIBPOWENETICS_TEST_API consumer_signal final {
+
+public:
+
+    /// <summary>
+    /// Initialises a new instance.
+    /// </summary>
+    consumer_signal(void) noexcept;
+
+    consumer_signal(const consumer_signal&) = delete;
+
+    /// <summary>
+    /// Wakes the consumer if it is waiting.
+    /// </summary>
+    /// <remarks>
+    /// This method must be called by the producer after it has made the
+    /// condition the consumer is waiting for come true, for instance after it
+    /// has added elements to the queue.
+    /// </remarks>
+    void notify(void) noexcept;
+
+    /// <summary>
+    /// Blocks the consumer until <paramref name="predicate" /> is satisfied
+    /// or <paramref name="timeout" /> has expired.
+    /// </summary>
+    /// <param name="timeout">The maximum time to wait.</param>
+    /// <param name="predicate">A function answering whether the consumer can
+    /// continue, for instance because the queue is not empty anymore.</param>
+    /// <returns>The result of the last evaluation of
+    /// <paramref name="predicate" />.</returns>
+    template<class TPredicate>
+    bool wait(_In_ const std::chrono::milliseconds timeout,
+        _In_ TPredicate predicate);
+
+    consumer_signal& operator =(const consumer_signal&) = delete;
+
+private:
+
+    std::mutex _lock;
+    std::condition_variable _signal;
+    std::atomic<bool> _waiting;
+};
+
+
+#include "consumer_signal.inl"
+
+#endif /* !defined(_LIBPOWENETICS_CONSUMER_SIGNAL_H) */
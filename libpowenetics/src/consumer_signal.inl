@@ -0,0 +1,25 @@
+﻿// <copyright file="consumer_signal.inl" company="Visualisierungsinstitut der Universität Stuttgart">
+// Copyright © 2026 Visualisierungsinstitut der Universität Stuttgart.
+// Licensed under the MIT licence. See LICENCE file for details.
+// </copyright>
+// <author>Christoph Müller</author>
+
+
+/*
+ * consumer_signal::wait
+ */
+template<class TPredicate>
+bool consumer_signal::wait(_In_ const std::chrono::milliseconds timeout,
+        _In_ TPredicate predicate) {
+    std::unique_lock<std::mutex> l(this->_lock);
+    this->_waiting.store(true, std::memory_order::memory_order_relaxed);
+
+    // Pairs with the fence in 'notify': either the producer sees that we are
+    // waiting, or the predicate sees what the producer has published.
+    std::atomic_thread_fence(std::memory_order::memory_order_seq_cst);
+
+    auto retval = this->_signal.wait_for(l, timeout, predicate);
+
+    this->_waiting.store(false, std::memory_order::memory_order_relaxed);
+    return retval;
+}
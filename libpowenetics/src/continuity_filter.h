@@ -0,0 +1,122 @@
+﻿// <copyright file="continuity_filter.h" company="Visualisierungsinstitut der Universität Stuttgart">
+// Copyright © 2026 Visualisierungsinstitut der Universität Stuttgart.
+// Licensed under the MIT licence. See LICENCE file for details.
+// </copyright>
+// <author>Christoph Müller</author>
+
+#if !defined(_LIBPOWENETICS_CONTINUITY_FILTER_H)
+#define _LIBPOWENETICS_CONTINUITY_FILTER_H
+#pragma once
+
+#include <cinttypes>
+
+#include "libpowenetics/api.h"
+#include "libpowenetics/types.h"
+
+
+/// <summary>
+/// Decides whether correctly framed segments are delivered based on the
+/// continuity of their sequence numbers.
+/// </summary>
+/// <remarks>
+/// <para>While the filter is not locked, a correctly framed segment is
+/// accepted if its sequence number continues the one of the previous
+/// correctly framed segment or if the sequence number of the next correctly
+/// framed segment continues its own. If the framing has been interrupted
+/// between two segments, the segment that broke the framing had a sequence
+/// number, too, so the sequence is also continued if one number is missing.
+/// A segment that does not continue the
+/// sequence is therefore held back until the next one arrives and discarded
+/// if that one does not continue the sequence either. Segments that are
+/// framed by delimiters in the payload are rejected this way, because they
+/// are very unlikely to carry consecutive sequence numbers. The price is that
+/// the first segment after each break in the framing is delivered one
+/// segment late.</para>
+/// <para>Once a segment has been accepted, the filter is locked and accepts
+/// every segment until the caller reports that the framing has been
+/// interrupted. A segment that directly follows an accepted one cannot have
+/// been framed by a delimiter in the payload, so a break in the sequence
+/// numbers means that the device skipped samples, which the
+/// <see cref="sample_sequencer" /> reports as a gap.</para>
+/// <para>The decision only depends on the order of the correctly framed
+/// segments, such that all parsers using the filter deliver the same samples
+/// no matter how they find the segments.</para>
+/// </remarks>
+class continuity_filter final {
+
+public:
+
+    /// <summary>
+    /// Initialises a new instance.
+    /// </summary>
+    inline continuity_filter(void) noexcept
+        : _held(false), _interrupted(false), _locked(false), _previous(0),
+        _valid(false) { }
+
+    /// <summary>
+    /// Processes the sequence number of the next correctly framed segment.
+    /// </summary>
+    /// <remarks>
+    /// The caller must check <see cref="held" /> before calling this method
+    /// in order to know whether it holds back a segment the result applies
+    /// to.
+    /// </remarks>
+    /// <param name="sequence_number">The sequence number of the segment.
+    /// </param>
+    /// <returns><c>true</c> if the filter is locked or if the segment
+    /// continues the sequence, in which case the segment held back, if any,
+    /// is confirmed and must be delivered before this one. <c>false</c> if
+    /// the segment must be held back, in which case the segment held back
+    /// before, if any, must be discarded.</returns>
+    inline bool check(_In_ const std::uint16_t sequence_number) noexcept {
+        const auto distance = static_cast<std::uint16_t>(sequence_number
+            - this->_previous);
+        const auto tolerance = this->_interrupted ? 2 : 1;
+        const auto retval = this->_locked || (this->_valid
+            && (distance >= 1) && (distance <= tolerance));
+        this->_held = !retval;
+        this->_interrupted = false;
+        this->_locked = retval;
+        this->_previous = sequence_number;
+        this->_valid = true;
+        return retval;
+    }
+
+    /// <summary>
+    /// Answer whether the caller must hold back a segment until the next one
+    /// has been checked.
+    /// </summary>
+    inline bool held(void) const noexcept {
+        return this->_held;
+    }
+
+    /// <summary>
+    /// Indicates that the next correctly framed segment does not directly
+    /// follow the previous one, which unlocks the filter.
+    /// </summary>
+    inline void interrupt(void) noexcept {
+        this->_interrupted = true;
+        this->_locked = false;
+    }
+
+    /// <summary>
+    /// Forgets the segment held back and the sequence number, which must be
+    /// done if the stream is interrupted on purpose.
+    /// </summary>
+    inline void reset(void) noexcept {
+        this->_held = false;
+        this->_interrupted = false;
+        this->_locked = false;
+        this->_valid = false;
+    }
+
+private:
+
+    bool _held;
+    bool _interrupted;
+    bool _locked;
+    std::uint16_t _previous;
+    bool _valid;
+};
+
+#endif /* !defined(_LIBPOWENETICS_CONTINUITY_FILTER_H) */
@@ -7,9 +7,15 @@
 #if !defined(_LIBPOWENETICS_CONVERT_H)
 #define _LIBPOWENETICS_CONVERT_H
 #pragma once
+
+#include <cassert>
 #include <cinttypes>
 
 #include "libpowenetics/api.h"
+#include "libpowenetics/raw_sample.h"
+#include "libpowenetics/sample.h"
+
+#include "sample_version.h"
 
 
 /// <summary>
@@ -51,4 +57,48 @@ std::uint16_t LIBPOWENETICS_TEST_API to_uint16(
 std::uint32_t LIBPOWENETICS_TEST_API to_uint24(
     _In_reads_(3) const std::uint8_t *src) noexcept;
 
+/// <summary>
+/// Converts a raw reading in millivolts and milliamperes into Volts and
+/// Amperes.
+/// </summary>
+/// <param name="src">The raw reading.</param>
+/// <returns>The reading as floating-point numbers.</returns>
+inline powenetics_voltage_current to_voltage_current(
+        _In_ const powenetics_raw_voltage_current& src) noexcept {
+    powenetics_voltage_current retval;
+    retval.voltage = src.voltage / 1000.0f;
+    retval.current = src.current / 1000.0f;
+    return retval;
+}
+
+/// <summary>
+/// Converts all readings in the raw sample <paramref name="src" /> into Volts
+/// and Amperes and copies the metadata.
+/// </summary>
+/// <param name="dst">Receives the converted sample.</param>
+/// <param name="src">The raw sample to be converted, which must be of the
+/// current <see cref="sample_version" />.</param>
+inline void to_sample(_Out_ powenetics_sample& dst,
+        _In_ const powenetics_raw_sample& src) noexcept {
+    assert(src.version == sample_version);
+    dst.version = src.version;
+    dst.sequence_number = src.sequence_number;
+    dst.timestamp = src.timestamp;
+    dst.atx_12v = to_voltage_current(src.atx_12v);
+    dst.atx_3_3v = to_voltage_current(src.atx_3_3v);
+    dst.atx_5v = to_voltage_current(src.atx_5v);
+    dst.atx_stb = to_voltage_current(src.atx_stb);
+    dst.eps1 = to_voltage_current(src.eps1);
+    dst.eps2 = to_voltage_current(src.eps2);
+    dst.eps3 = to_voltage_current(src.eps3);
+    dst.pcie_12v1 = to_voltage_current(src.pcie_12v1);
+    dst.pcie_12v2 = to_voltage_current(src.pcie_12v2);
+    dst.pcie_12v3 = to_voltage_current(src.pcie_12v3);
+    dst.peg_12v = to_voltage_current(src.peg_12v);
+    dst.peg_3_3v = to_voltage_current(src.peg_3_3v);
+    dst.index = src.index;
+    dst.missing = src.missing;
+    dst.dropped = src.dropped;
+}
+
 #endif /* !defined(_LIBPOWENETICS_CONVERT_H) */
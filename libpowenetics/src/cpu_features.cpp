@@ -0,0 +1,101 @@
+﻿// <copyright file="cpu_features.cpp" company="Visualisierungsinstitut der Universität Stuttgart">
+// Copyright © 2026 Visualisierungsinstitut der Universität Stuttgart.
+// Licensed under the MIT licence. See LICENCE file for details.
+// </copyright>
+// <author>Christoph Müller</author>
+
+#include "cpu_features.h"
+
+#if (defined(POWENETICS_X86) && defined(_MSC_VER))
+#include <immintrin.h>
+#include <intrin.h>
+#elif defined(POWENETICS_X86)
+#include <cpuid.h>
+#endif /* (defined(POWENETICS_X86) && defined(_MSC_VER)) */
+
+
+#if defined(POWENETICS_X86)
+/// <summary>
+/// The bits of the extensions that are supported on the current processor.
+/// </summary>
+struct cpu_feature_set final {
+    bool sse2;
+    bool ssse3;
+    bool avx2;
+    bool invariant_tsc;
+
+    cpu_feature_set(void) noexcept : sse2(false), ssse3(false), avx2(false),
+            invariant_tsc(false) {
+#if defined(_MSC_VER)
+        int info[4];
+
+        ::__cpuid(info, 0);
+        const auto max_leaf = info[0];
+
+        if (max_leaf >= 1) {
+            ::__cpuid(info, 1);
+            this->sse2 = ((info[3] & (1 << 26)) != 0);
+            this->ssse3 = ((info[2] & (1 << 9)) != 0);
+
+            // AVX requires the OS to save the YMM registers (OSXSAVE and the
+            // XCR0 bits for XMM and YMM state).
+            const auto os_avx = ((info[2] & (1 << 27)) != 0)
+                && ((::_xgetbv(0) & 0x6) == 0x6);
+
+            if (os_avx && (max_leaf >= 7)) {
+                ::__cpuidex(info, 7, 0);
+                this->avx2 = ((info[1] & (1 << 5)) != 0);
+            }
+        }
+
+        // The invariant TSC is reported in the advanced power management
+        // leaf of the extended functions.
+        ::__cpuid(info, static_cast<int>(0x80000000));
+        if (static_cast<unsigned int>(info[0]) >= 0x80000007) {
+            ::__cpuid(info, static_cast<int>(0x80000007));
+            this->invariant_tsc = ((info[3] & (1 << 8)) != 0);
+        }
+#else /* defined(_MSC_VER) */
+        __builtin_cpu_init();
+        this->sse2 = __builtin_cpu_supports("sse2");
+        this->ssse3 = __builtin_cpu_supports("ssse3");
+        this->avx2 = __builtin_cpu_supports("avx2");
+
+        unsigned int eax, ebx, ecx, edx;
+        if ((::__get_cpuid_max(0x80000000, nullptr) >= 0x80000007)
+                && ::__get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx)) {
+            this->invariant_tsc = ((edx & (1 << 8)) != 0);
+        }
+#endif /* defined(_MSC_VER) */
+    }
+};
+#endif /* defined(POWENETICS_X86) */
+
+
+/*
+ * ::has_cpu_feature
+ */
+bool has_cpu_feature(_In_ const cpu_feature feature) noexcept {
+#if defined(POWENETICS_X86)
+    static const cpu_feature_set features;
+
+    switch (feature) {
+        case cpu_feature::sse2:
+            return features.sse2;
+
+        case cpu_feature::ssse3:
+            return features.ssse3;
+
+        case cpu_feature::avx2:
+            return features.avx2;
+
+        case cpu_feature::invariant_tsc:
+            return features.invariant_tsc;
+
+        default:
+            return false;
+    }
+#else /* defined(POWENETICS_X86) */
+    return false;
+#endif /* defined(POWENETICS_X86) */
+}
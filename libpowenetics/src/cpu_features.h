@@ -0,0 +1,99 @@
+﻿// <copyright file="cpu_features.h" company="Visualisierungsinstitut der Universität Stuttgart">
+// Copyright © 2026 Visualisierungsinstitut der Universität Stuttgart.
+// Licensed under the MIT licence. See LICENCE file for details.
+// </copyright>
+// <author>Christoph Müller</author>
+
+#if !defined(_LIBPOWENETICS_CPU_FEATURES_H)
+#define _LIBPOWENETICS_CPU_FEATURES_H
+#pragma once
+
+#include <cinttypes>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif /* defined(_MSC_VER) */
+
+#include "libpowenetics/api.h"
+
+
+// Determine whether we are compiling for an x86 processor, which is the only
+// architecture for which we provide vectorised implementations.
+#if (defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) \
+    || defined(__i386__))
+#define POWENETICS_X86 (1)
+#endif /* (defined(_M_X64) || defined(_M_IX86) || ... */
+
+
+// Enables the use of instruction set extensions in single functions. MSVC
+// allows for using all intrinsics anywhere, whereas GCC and Clang require the
+// function to be marked explicitly.
+#if (defined(POWENETICS_X86) && (defined(__GNUC__) || defined(__clang__)))
+#define POWENETICS_TARGET(isa) __attribute__((target(isa)))
+#else /* (defined(POWENETICS_X86) && (defined(__GNUC__) || ... */
+#define POWENETICS_TARGET(isa)
+#endif /* (defined(POWENETICS_X86) && (defined(__GNUC__) || ... */
+
+
+/// <summary>
+/// Identifies the instruction set extensions that we can dispatch to at
+/// runtime.
+/// </summary>
+enum class cpu_feature {
+
+    /// <summary>
+    /// Streaming SIMD Extensions 2.
+    /// </summary>
+    sse2,
+
+    /// <summary>
+    /// Supplemental Streaming SIMD Extensions 3.
+    /// </summary>
+    ssse3,
+
+    /// <summary>
+    /// Advanced Vector Extensions 2, including support by the operating
+    /// system for saving the extended register state.
+    /// </summary>
+    avx2,
+
+    /// <summary>
+    /// A time stamp counter that runs at a constant rate in all power and
+    /// performance states.
+    /// </summary>
+    invariant_tsc
+};
+
+
+/// <summary>
+/// Answer whether the processor the code is running on supports the given
+/// instruction set extension.
+/// </summary>
+/// <remarks>
+/// The result is determined only once and cached afterwards, so this function
+/// can be used to select an implementation at runtime.
+/// </remarks>
+/// <param name="feature">The feature to be checked.</param>
+/// <returns><c>true</c> if the feature is available, <c>false</c> otherwise,
+/// in particular on all processors other than x86.</returns>
+bool LIBPOWENETICS_TEST_API has_cpu_feature(
+    _In_ const cpu_feature feature) noexcept;
+
+
+/// <summary>
+/// Answer the zero-based index of the least significant bit set in
+/// <paramref name="value" />.
+/// </summary>
+/// <param name="value">A value that must not be zero.</param>
+/// <returns>The number of trailing zero bits.</returns>
+inline unsigned int count_trailing_zeros(_In_ const std::uint32_t value) {
+#if defined(_MSC_VER)
+    unsigned long retval;
+    _BitScanForward(&retval, value);
+    return retval;
+#else /* defined(_MSC_VER) */
+    return __builtin_ctz(value);
+#endif /* defined(_MSC_VER) */
+}
+
+#endif /* !defined(_LIBPOWENETICS_CPU_FEATURES_H) */
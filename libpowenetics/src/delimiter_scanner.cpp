@@ -0,0 +1,154 @@
+﻿// <copyright file="delimiter_scanner.cpp" company="Visualisierungsinstitut der Universität Stuttgart">
+// Copyright © 2026 Visualisierungsinstitut der Universität Stuttgart.
+// Licensed under the MIT licence. See LICENCE file for details.
+// </copyright>
+// <author>Christoph Müller</author>
+
+#include "delimiter_scanner.h"
+
+#include <cassert>
+
+#if defined(POWENETICS_X86)
+#include <immintrin.h>
+#endif /* defined(POWENETICS_X86) */
+
+#include "responses.h"
+
+
+// Note: All of the implementations only work, because the delimiter is two
+// bytes. If this should ever change, we must check in a loop.
+static_assert(responses_v2::segment_delimiter.size() == 2,
+    "The delimiter scanners assume a two-byte delimiter.");
+
+
+/*
+ * ::find_delimiter_scalar
+ */
+_Ret_maybenull_ const std::uint8_t *find_delimiter_scalar(
+        _In_reads_(cnt) const std::uint8_t *data,
+        _In_ const std::size_t cnt) noexcept {
+    assert((data != nullptr) || (cnt == 0));
+    auto& delimiter = responses_v2::segment_delimiter;
+
+    for (std::size_t i = 1; i < cnt; ++i) {
+        if ((data[i] == delimiter.back()) && (data[i - 1] == delimiter.front())) {
+            return data + i - 1;
+        }
+    }
+    // Not found at this point.
+
+    return nullptr;
+}
+
+
+#if defined(POWENETICS_X86)
+/*
+ * ::find_delimiter_sse2
+ */
+POWENETICS_TARGET("sse2")
+_Ret_maybenull_ const std::uint8_t *find_delimiter_sse2(
+        _In_reads_(cnt) const std::uint8_t *data,
+        _In_ const std::size_t cnt) noexcept {
+    assert((data != nullptr) || (cnt == 0));
+    auto& delimiter = responses_v2::segment_delimiter;
+    const auto front = ::_mm_set1_epi8(static_cast<char>(delimiter.front()));
+    const auto back = ::_mm_set1_epi8(static_cast<char>(delimiter.back()));
+    constexpr std::size_t width = sizeof(__m128i);
+    std::size_t i = 0;
+
+    // Compare the input and the input shifted by one byte against the two
+    // halves of the delimiter. The delimiter starts wherever both match. Note
+    // that the second load reads one byte ahead, so we must stop one byte
+    // earlier than the last full vector.
+    for (; i + width < cnt; i += width) {
+        auto cur = reinterpret_cast<const __m128i *>(data + i);
+        auto nxt = reinterpret_cast<const __m128i *>(data + i + 1);
+        auto f = ::_mm_cmpeq_epi8(::_mm_loadu_si128(cur), front);
+        auto b = ::_mm_cmpeq_epi8(::_mm_loadu_si128(nxt), back);
+        auto mask = static_cast<std::uint32_t>(::_mm_movemask_epi8(
+            ::_mm_and_si128(f, b)));
+
+        if (mask != 0) {
+            return data + i + ::count_trailing_zeros(mask);
+        }
+    }
+
+    // Check the remainder byte by byte.
+    return ::find_delimiter_scalar(data + i, cnt - i);
+}
+
+
+/*
+ * ::find_delimiter_avx2
+ */
+POWENETICS_TARGET("avx2")
+_Ret_maybenull_ const std::uint8_t *find_delimiter_avx2(
+        _In_reads_(cnt) const std::uint8_t *data,
+        _In_ const std::size_t cnt) noexcept {
+    assert((data != nullptr) || (cnt == 0));
+    auto& delimiter = responses_v2::segment_delimiter;
+    const auto front = ::_mm256_set1_epi8(static_cast<char>(delimiter.front()));
+    const auto back = ::_mm256_set1_epi8(static_cast<char>(delimiter.back()));
+    constexpr std::size_t width = sizeof(__m256i);
+    std::size_t i = 0;
+
+    // This is the same as the SSE2 implementation, but for 32 bytes at once.
+    for (; i + width < cnt; i += width) {
+        auto cur = reinterpret_cast<const __m256i *>(data + i);
+        auto nxt = reinterpret_cast<const __m256i *>(data + i + 1);
+        auto f = ::_mm256_cmpeq_epi8(::_mm256_loadu_si256(cur), front);
+        auto b = ::_mm256_cmpeq_epi8(::_mm256_loadu_si256(nxt), back);
+        auto mask = static_cast<std::uint32_t>(::_mm256_movemask_epi8(
+            ::_mm256_and_si256(f, b)));
+
+        if (mask != 0) {
+            return data + i + ::count_trailing_zeros(mask);
+        }
+    }
+
+    // Check the next 16 bytes, if there are enough. Note that we must not call
+    // the SSE2 implementation for that, because mixing legacy SSE and AVX
+    // instructions incurs a severe state transition penalty. In this function,
+    // the compiler emits the VEX-encoded variants of the SSE2 intrinsics.
+    if (i + sizeof(__m128i) < cnt) {
+        auto cur = reinterpret_cast<const __m128i *>(data + i);
+        auto nxt = reinterpret_cast<const __m128i *>(data + i + 1);
+        auto f = ::_mm_cmpeq_epi8(::_mm_loadu_si128(cur),
+            ::_mm256_castsi256_si128(front));
+        auto b = ::_mm_cmpeq_epi8(::_mm_loadu_si128(nxt),
+            ::_mm256_castsi256_si128(back));
+        auto mask = static_cast<std::uint32_t>(::_mm_movemask_epi8(
+            ::_mm_and_si128(f, b)));
+
+        if (mask != 0) {
+            return data + i + ::count_trailing_zeros(mask);
+        }
+
+        i += sizeof(__m128i);
+    }
+
+    // Check the remainder byte by byte. For the reason stated above, clear the
+    // upper halves of the registers before leaving AVX code, which the
+    // compiler does not reliably do for tail calls.
+    ::_mm256_zeroupper();
+    return ::find_delimiter_scalar(data + i, cnt - i);
+}
+#endif /* defined(POWENETICS_X86) */
+
+
+/*
+ * ::select_delimiter_scanner
+ */
+delimiter_scanner select_delimiter_scanner(void) noexcept {
+#if defined(POWENETICS_X86)
+    if (::has_cpu_feature(cpu_feature::avx2)) {
+        return ::find_delimiter_avx2;
+    }
+
+    if (::has_cpu_feature(cpu_feature::sse2)) {
+        return ::find_delimiter_sse2;
+    }
+#endif /* defined(POWENETICS_X86) */
+
+    return ::find_delimiter_scalar;
+}
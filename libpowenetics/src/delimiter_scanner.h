@@ -0,0 +1,85 @@
+﻿// <copyright file="delimiter_scanner.h" company="Visualisierungsinstitut der Universität Stuttgart">
+// Copyright © 2026 Visualisierungsinstitut der Universität Stuttgart.
+// Licensed under the MIT licence. See LICENCE file for details.
+// </copyright>
+// <author>Christoph Müller</author>
+
+#if !defined(_LIBPOWENETICS_DELIMITER_SCANNER_H)
+#define _LIBPOWENETICS_DELIMITER_SCANNER_H
+#pragma once
+
+#include <cinttypes>
+#include <cstddef>
+
+#include "libpowenetics/api.h"
+
+#include "cpu_features.h"
+
+
+/// <summary>
+/// The signature of all functions searching the first
+/// <see cref="responses_v2::segment_delimiter" /> in a range of bytes.
+/// </summary>
+typedef const std::uint8_t *(*delimiter_scanner)(
+    _In_reads_(cnt) const std::uint8_t *data,
+    _In_ const std::size_t cnt);
+
+/// <summary>
+/// Finds the first <see cref="responses_v2::segment_delimiter" /> in
+/// <paramref name="data" /> by checking one byte after the other.
+/// </summary>
+/// <param name="data">A valid pointer to at least <paramref name="cnt" />
+/// bytes.</param>
+/// <param name="cnt">The number of bytes to search.</param>
+/// <returns>A pointer to the first byte of the delimiter, or <c>nullptr</c>
+/// if <paramref name="data" /> does not contain the delimiter.</returns>
+_Ret_maybenull_ LIBPOWENETICS_TEST_API const std::uint8_t *
+find_delimiter_scalar(_In_reads_(cnt) const std::uint8_t *data,
+    _In_ const std::size_t cnt) noexcept;
+
+#if defined(POWENETICS_X86)
+/// <summary>
+/// Finds the first <see cref="responses_v2::segment_delimiter" /> in
+/// <paramref name="data" /> checking 16 positions at once.
+/// </summary>
+/// <remarks>
+/// This function must only be called if the processor supports
+/// <see cref="cpu_feature::sse2" />.
+/// </remarks>
+/// <param name="data">A valid pointer to at least <paramref name="cnt" />
+/// bytes.</param>
+/// <param name="cnt">The number of bytes to search.</param>
+/// <returns>A pointer to the first byte of the delimiter, or <c>nullptr</c>
+/// if <paramref name="data" /> does not contain the delimiter.</returns>
+_Ret_maybenull_ LIBPOWENETICS_TEST_API const std::uint8_t *
+find_delimiter_sse2(_In_reads_(cnt) const std::uint8_t *data,
+    _In_ const std::size_t cnt) noexcept;
+
+/// <summary>
+/// Finds the first <see cref="responses_v2::segment_delimiter" /> in
+/// <paramref name="data" /> checking 32 positions at once.
+/// </summary>
+/// <remarks>
+/// This function must only be called if the processor supports
+/// <see cref="cpu_feature::avx2" />.
+/// </remarks>
+/// <param name="data">A valid pointer to at least <paramref name="cnt" />
+/// bytes.</param>
+/// <param name="cnt">The number of bytes to search.</param>
+/// <returns>A pointer to the first byte of the delimiter, or <c>nullptr</c>
+/// if <paramref name="data" /> does not contain the delimiter.</returns>
+_Ret_maybenull_ LIBPOWENETICS_TEST_API const std::uint8_t *
+find_delimiter_avx2(_In_reads_(cnt) const std::uint8_t *data,
+    _In_ const std::size_t cnt) noexcept;
+#endif /* defined(POWENETICS_X86) */
+
+/// <summary>
+/// Answer the fastest implementation of the delimiter search that is
+/// supported by the processor the code is running on.
+/// </summary>
+/// <returns>A pointer to the scanner function, which is never
+/// <c>nullptr</c>.</returns>
+delimiter_scanner LIBPOWENETICS_TEST_API select_delimiter_scanner(
+    void) noexcept;
+
+#endif /* !defined(_LIBPOWENETICS_DELIMITER_SCANNER_H) */
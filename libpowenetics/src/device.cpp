@@ -1,5 +1,5 @@
 ﻿// <copyright file="device.cpp" company="Visualisierungsinstitut der Universität Stuttgart">
-// Copyright © 2023 - 2024 Visualisierungsinstitut der Universität Stuttgart.
+// Copyright © 2023 - 2026 Visualisierungsinstitut der Universität Stuttgart.
 // Licensed under the MIT licence. See LICENCE file for details.
 // </copyright>
 // <author>Christoph Müller</author>
@@ -7,6 +7,8 @@
 #include "device.h"
 
 #include <cassert>
+#include <chrono>
+#include <cstring>
 #include <memory>
 #include <regex>
 #include <string>
@@ -19,6 +21,7 @@
 #else /* defined(_WIN32) */
 #include <dirent.h>
 #include <fcntl.h>
+#include <poll.h>
 #include <termios.h>
 #include <unistd.h>
 
@@ -29,10 +32,15 @@
 #include <libudev.h>
 #endif /* defined(USE_UDEV) */
 
+#include "clock.h"
+#include "columnar_parser_v2.h"
 #include "commands.h"
 #include "debug.h"
+#include "io_reactor.h"
 #include "responses.h"
+#include "resumable_parser_v2.h"
 #include "stream_parser_v2.h"
+#include "thread_configuration.h"
 #include "thread_name.h"
 
 
@@ -229,16 +237,49 @@ std::vector<powenetics_device::string_type> powenetics_device::probe_candidates(
  * powenetics_device::powenetics_device
  */
 powenetics_device::powenetics_device(void) noexcept
-    : _callback(nullptr),
+    : _batch_callback(nullptr),
+    _bytes_discarded(0),
+    _bytes_read(0),
+    _callback(nullptr),
+    _callback_time_max(0),
+    _carry_overs(0),
+    _clock(powenetics_clock::system_time),
     _context(nullptr),
+    _dispatch_depth(0),
+    _dispatch_depth_max(0),
+    _dispatch_exit(false),
+    _energy_frequency(0),
     _handle(invalid_handle),
-    _state(stream_state::stopped) { }
+    _parser(powenetics_parser::stream),
+    _profile(connector_profile_unknown),
+    _protocol(0),
+    _queued(false),
+    _raw_callback(nullptr),
+    _reactor(nullptr),
+    _reader(powenetics_reader::standard),
+    _reads(0),
+    _samples_dropped(0),
+    _samples_missing(0),
+    _segments_parsed(0),
+    _segment_callback(nullptr),
+    _segments_rejected(0),
+    _sequence_gaps(0),
+    _session_factory(nullptr),
+    _state(stream_state::stopped),
+    _timestamping(powenetics_timestamping::per_sample) {
+    ::memset(&this->_batch_config, 0, sizeof(this->_batch_config));
+    this->_dispatch_config.version = 2;
+    ::powenetics_initialise_dispatch_configuration(&this->_dispatch_config);
+    this->_thread_config.version = 2;
+    ::powenetics_initialise_thread_configuration(&this->_thread_config);
+}
 
 
 /*
  * powenetics_device::~powenetics_device
  */
 powenetics_device::~powenetics_device(void) noexcept {
+#if defined(_WIN32)
     this->close();
     // Note: closing the handle will cause the thread to exit with an I/O error,
     // so we do not need to set the state here (it cannot be used anyway,
@@ -248,6 +289,39 @@ powenetics_device::~powenetics_device(void) noexcept {
         _powenetics_debug("Waiting for serial reader thread to exit ...\r\n");
         this->_thread.join();
     }
+
+#else /* defined(_WIN32) */
+    // Closing a descriptor does not interrupt a thread polling it, so we need
+    // to ask the thread to exit and wake it before we can close the handle. A
+    // thread that has just been launched must be running before it can be
+    // stopped.
+    while (this->_state.load(std::memory_order::memory_order_acquire)
+            == stream_state::starting) {
+        std::this_thread::yield();
+    }
+
+    {
+        auto expected = stream_state::running;
+        this->_state.compare_exchange_strong(expected, stream_state::stopping,
+            std::memory_order::memory_order_acq_rel);
+        this->_wake.set();
+    }
+
+    if (this->_reactor != nullptr) {
+        this->_reactor->detach(*this);
+    }
+
+    if (this->_thread.joinable()) {
+        _powenetics_debug("Waiting for serial reader thread to exit ...\r\n");
+        this->_thread.join();
+    }
+
+    this->close();
+#endif /* defined(_WIN32) */
+
+    if (this->_reactor != nullptr) {
+        this->_reactor->release();
+    }
 }
 
 
@@ -297,6 +371,39 @@ HRESULT powenetics_device::calibrate(_In_ const std::uint8_t channel,
 }
 
 
+/*
+ * powenetics_device::clock
+ */
+HRESULT powenetics_device::clock(_In_ const powenetics_clock clock) noexcept {
+    switch (clock) {
+        case powenetics_clock::system_time:
+        case powenetics_clock::monotonic:
+        case powenetics_clock::monotonic_raw:
+        case powenetics_clock::tsc:
+            break;
+
+        default:
+            return E_INVALIDARG;
+    }
+
+    if (::select_clock(clock) == nullptr) {
+        _powenetics_debug("The requested clock is not supported on this "
+            "machine.\r\n");
+        return E_NOTIMPL;
+    }
+
+    // The streaming thread reads the clock only when it starts, so it must
+    // not be changed while streaming.
+    auto retval = this->check_stopped();
+
+    if (SUCCEEDED(retval)) {
+        this->_clock = clock;
+    }
+
+    return retval;
+}
+
+
 /*
  * powenetics_device::close
  */
@@ -309,6 +416,7 @@ HRESULT powenetics_device::close(void) noexcept {
     auto retval = (::close(this->_handle) == 0)
         ? S_OK
         : static_cast<HRESULT>(-errno);
+    this->_wake.close();
 #endif /* defined(_WIN32) */
 
     this->_handle = invalid_handle;
@@ -316,6 +424,69 @@ HRESULT powenetics_device::close(void) noexcept {
 }
 
 
+/*
+ * powenetics_device::dispatch
+ */
+HRESULT powenetics_device::dispatch(
+        _In_ const powenetics_dispatch_configuration& config) noexcept {
+    switch (config.dispatch) {
+        case powenetics_dispatch::synchronous:
+            break;
+
+        case powenetics_dispatch::asynchronous:
+            if (config.capacity == 0) {
+                _powenetics_debug("The dispatch queue must be able to hold at "
+                    "least one sample.\r\n");
+                return E_INVALIDARG;
+            }
+            break;
+
+        default:
+            return E_INVALIDARG;
+    }
+
+    switch (config.overflow) {
+        case powenetics_overflow::drop_newest:
+        case powenetics_overflow::drop_oldest:
+        case powenetics_overflow::block:
+        case powenetics_overflow::decimate:
+            break;
+
+        default:
+            return E_INVALIDARG;
+    }
+
+    // The dispatch thread is only started along with streaming, so the
+    // configuration must not be changed while streaming.
+    auto retval = this->check_stopped();
+
+    if (SUCCEEDED(retval)) {
+        this->_dispatch_config = config;
+    }
+
+    return retval;
+}
+
+
+/*
+ * powenetics_device::energy
+ */
+void powenetics_device::energy(_Inout_ powenetics_energy& dst) const noexcept {
+    assert(dst.version == 2);
+    std::lock_guard<std::mutex> l(this->_energy_lock);
+    this->_energy.energy(dst, this->_energy_frequency);
+}
+
+
+/*
+ * powenetics_device::housekeeping
+ */
+void powenetics_device::housekeeping(void) {
+    assert(this->_session != nullptr);
+    this->_session->process(nullptr, 0);
+}
+
+
 /*
  * powenetics_device::open
  */
@@ -331,6 +502,20 @@ HRESULT powenetics_device::open(
         return E_NOT_VALID_STATE;
     }
 
+    // The version of the configuration tells us which protocol the device
+    // speaks, so we can choose the parser once and for all here.
+    {
+        const auto factory = select_session(config->version, this->_parser);
+        if (factory == nullptr) {
+            _powenetics_debug("The protocol version of the serial "
+                "configuration is not supported.\r\n");
+            return E_INVALIDARG;
+        }
+
+        this->_protocol = config->version;
+        this->_session_factory = factory;
+    }
+
 #if defined(_WIN32)
     this->_handle = ::CreateFileW(com_port, GENERIC_READ | GENERIC_WRITE, 0,
         nullptr, OPEN_EXISTING, 0, NULL);
@@ -455,6 +640,10 @@ HRESULT powenetics_device::open(
         tty.c_iflag &= ~(IGNBRK | BRKINT | PARMRK | ISTRIP | INLCR | IGNCR
             | ICRNL);
 
+        // Disable software flow control, which would swallow any 0x11 (XON)
+        // and 0x13 (XOFF) in the binary data.
+        tty.c_iflag &= ~(IXON | IXOFF | IXANY);
+
         // Same for the output: just send what we write.
         tty.c_oflag &= ~(OPOST | ONLCR);
 
@@ -465,12 +654,86 @@ HRESULT powenetics_device::open(
             return retval;
         }
     }
+
+    // The streaming thread polls the port together with the wake-up event,
+    // which allows for stopping it even if the device does not send data.
+    {
+        auto retval = this->_wake.open();
+        if (FAILED(retval)) {
+            return retval;
+        }
+    }
 #endif /* defined(_WIN32) */
 
     return S_OK;
 }
 
 
+/*
+ * powenetics_device::parser
+ */
+HRESULT powenetics_device::parser(
+        _In_ const powenetics_parser parser) noexcept {
+    switch (parser) {
+        case powenetics_parser::stream:
+        case powenetics_parser::columnar:
+        case powenetics_parser::resumable:
+            break;
+
+        default:
+            return E_INVALIDARG;
+    }
+
+    // The parser is a template argument of the session, so it cannot be
+    // changed while streaming.
+    auto retval = this->check_stopped();
+
+    if (SUCCEEDED(retval)) {
+        this->_parser = parser;
+
+        if (this->_protocol != 0) {
+            // If the device is open, the protocol is known and we can select
+            // the session right away. Otherwise, 'open' will do that.
+            this->_session_factory = select_session(this->_protocol, parser);
+            assert(this->_session_factory != nullptr);
+        }
+    }
+
+    return retval;
+}
+
+
+/*
+ * powenetics_device::profile
+ */
+void powenetics_device::profile(
+        _Inout_ powenetics_connector_profile& dst) const noexcept {
+    assert(dst.version == 2);
+    const auto profile = this->_profile.load(
+        std::memory_order::memory_order_relaxed);
+
+    if (profile == connector_profile_unknown) {
+        dst.atx = powenetics_atx_connector::unknown;
+    } else if ((profile & connector_profile_atx_10pin) != 0) {
+        dst.atx = powenetics_atx_connector::pin10;
+    } else {
+        dst.atx = powenetics_atx_connector::pin24;
+    }
+
+    // Note: connector_profile_unknown has none of the PCIe flags set.
+    dst.pcie = 0;
+    if ((profile & connector_profile_pcie_12v1) != 0) {
+        dst.pcie |= POWENETICS_PCIE_12V1;
+    }
+    if ((profile & connector_profile_pcie_12v2) != 0) {
+        dst.pcie |= POWENETICS_PCIE_12V2;
+    }
+    if ((profile & connector_profile_pcie_12v3) != 0) {
+        dst.pcie |= POWENETICS_PCIE_12V3;
+    }
+}
+
+
 /*
  * powenetics_device::read
  */
@@ -479,9 +742,12 @@ HRESULT powenetics_device::read(_Out_writes_(cnt) byte_type *dst,
 #if defined(_WIN32)
     DWORD read;
 
+    add(this->_reads, 1);
+
     if (::ReadFile(this->_handle, dst, static_cast<DWORD>(cnt), &read,
             nullptr)) {
         cnt = read;
+        add(this->_bytes_read, cnt);
         return S_OK;
     } else {
         cnt = 0;
@@ -489,17 +755,125 @@ HRESULT powenetics_device::read(_Out_writes_(cnt) byte_type *dst,
     }
 
 #else /* defined(_WIN32) */
-    cnt = ::read(this->_handle, dst, cnt);
-    if (cnt < 0) {
+    add(this->_reads, 1);
+
+    // Note: 'cnt' is unsigned, so we must check the result of the call before
+    // assigning it, or we would miss errors.
+    const auto read = ::read(this->_handle, dst, cnt);
+    if (read < 0) {
         cnt = 0;
         return static_cast<HRESULT>(-errno);
     } else {
+        cnt = static_cast<std::size_t>(read);
+        add(this->_bytes_read, cnt);
         return S_OK;
     }
 #endif /* defined(_WIN32) */
 }
 
 
+/*
+ * powenetics_device::read_samples
+ */
+HRESULT powenetics_device::read_samples(
+        _Inout_updates_(cnt) powenetics_sample *dst,
+        _Inout_ std::size_t& cnt,
+        _In_ const std::uint32_t timeout) noexcept {
+    if (this->_queue == nullptr) {
+        _powenetics_debug("The Powenetics v2 device has not been streaming to "
+            "a queue.\r\n");
+        cnt = 0;
+        return E_NOT_VALID_STATE;
+    }
+
+    auto& queue = *this->_queue;
+    const auto max = cnt;
+    const auto version = dst->version;
+    assert(::is_sample_version(version));
+
+    // Note: we must check the state before looking at the queue, because
+    // the streaming thread might add samples before it stops, in which case
+    // we would report that we are done while samples are left.
+    auto streaming = (this->state() != stream_state::stopped);
+    cnt = this->pop_samples(dst, max, version);
+
+    if ((cnt == 0) && (timeout > 0) && streaming) {
+        this->_queue_signal.wait(std::chrono::milliseconds(timeout),
+                [this, &queue](void) {
+            return (!queue.empty()
+                || (this->state() == stream_state::stopped));
+        });
+
+        streaming = (this->state() != stream_state::stopped);
+        cnt = this->pop_samples(dst, max, version);
+    }
+
+    if (cnt > 0) {
+        return S_OK;
+    } else {
+        return streaming ? S_FALSE : E_NOT_VALID_STATE;
+    }
+}
+
+
+/*
+ * powenetics_device::reactor
+ */
+HRESULT powenetics_device::reactor(
+        _In_opt_ powenetics_reactor *reactor) noexcept {
+    // The device is only attached to the reactor when streaming starts, so
+    // the reactor must not be changed while streaming.
+    auto retval = this->check_stopped();
+
+    if (SUCCEEDED(retval) && (reactor != this->_reactor)) {
+        if (reactor != nullptr) {
+            reactor->acquire();
+        }
+        if (this->_reactor != nullptr) {
+            this->_reactor->release();
+        }
+
+        this->_reactor = reactor;
+    }
+
+    return retval;
+}
+
+
+/*
+ * powenetics_device::reader
+ */
+HRESULT powenetics_device::reader(
+        _In_ const powenetics_reader reader) noexcept {
+    switch (reader) {
+        case powenetics_reader::standard:
+            break;
+
+        case powenetics_reader::io_uring:
+#if defined(POWENETICS_IO_URING)
+            break;
+#else /* defined(POWENETICS_IO_URING) */
+            _powenetics_debug("io_uring is not supported on this "
+                "platform.\r\n");
+            return E_NOTIMPL;
+#endif /* defined(POWENETICS_IO_URING) */
+
+        default:
+            return E_INVALIDARG;
+    }
+
+    // The streaming thread chooses how to read when it starts, so the reader
+    // must not be changed while streaming.
+    auto retval = this->check_stopped();
+
+    if (SUCCEEDED(retval)) {
+        this->_reader = reader;
+    }
+
+    return retval;
+}
+
+
 /*
  * powenetics_device::reset_calibration
  */
@@ -520,52 +894,253 @@ HRESULT powenetics_device::reset_calibration(void) noexcept {
 }
 
 
+/*
+ * powenetics_device::retire
+ */
+void powenetics_device::retire(void) {
+    assert(this->_session != nullptr);
+    this->_session->finish();
+    this->_session.reset();
+
+    // Deliver everything that has been handed over to the dispatch thread,
+    // because stopping must not return before the last callback.
+    this->stop_dispatch();
+
+    // Indicate that we are done. We do not CAS this from
+    // stream_state::stopping, because a request for orderly shutdown is only
+    // one way we can get here, the file handle being closed and the I/O failing
+    // being the other one. In the latter case, the state will still be
+    // stream_state::running at this point.
+    this->_state.store(stream_state::stopped,
+        std::memory_order::memory_order_release);
+
+    // A consumer waiting for the queue would otherwise not notice until its
+    // timeout expires.
+    this->_queue_signal.notify();
+}
+
+
+/*
+ * powenetics_device::serve
+ */
+bool powenetics_device::serve(_Out_writes_(cnt) byte_type *buffer,
+        _In_ const std::size_t cnt) {
+    assert(this->_session != nullptr);
+    auto read = cnt;
+
+    if (FAILED(this->read(buffer, read))) {
+        _powenetics_debug("Reading from the COM port failed.\r\n");
+        return false;
+    }
+
+    this->_session->process(buffer, read);
+    return true;
+}
+
+
 /*
  * powenetics_device::start
  */
 HRESULT powenetics_device::start(
         _In_ const powenetics_data_callback callback,
         _In_opt_ void *context) noexcept {
-    auto retval = this->check_valid();
+    if (callback == nullptr) {
+        _powenetics_debug("An invalid data callback has been passed.\r\n");
+        return E_POINTER;
+    }
+
+    auto retval = this->prepare_start();
 
     if (SUCCEEDED(retval)) {
-        auto expected = stream_state::stopped;
-        auto succeeded = this->_state.compare_exchange_strong(expected,
-            stream_state::starting, std::memory_order::memory_order_acq_rel);
-        assert(!this->_thread.joinable() || !succeeded);
-        if (!succeeded) {
-            _powenetics_debug("The Powenetics device is already streaming "
-                "data.\r\n");
-            retval = E_NOT_VALID_STATE;
+        this->_batch_callback = nullptr;
+        this->_callback = callback;
+        this->_context = context;
+        this->_queued = false;
+        this->_raw_callback = nullptr;
+        this->_segment_callback = nullptr;
+        retval = this->launch();
+    }
+
+    return retval;
+}
+
+
+/*
+ * powenetics_device::start
+ */
+HRESULT powenetics_device::start(
+        _In_ const powenetics_batch_callback callback,
+        _In_opt_ void *context,
+        _In_ const powenetics_batch_configuration& config) noexcept {
+    if (callback == nullptr) {
+        _powenetics_debug("An invalid batch callback has been passed.\r\n");
+        return E_POINTER;
+    }
+
+    auto retval = this->prepare_start();
+
+    if (SUCCEEDED(retval)) {
+        this->_batch_callback = callback;
+        this->_batch_config = config;
+        this->_callback = nullptr;
+        this->_context = context;
+        this->_queued = false;
+        this->_raw_callback = nullptr;
+        this->_segment_callback = nullptr;
+
+        // Allocate the batch up front such that the streaming thread does not
+        // need to reallocate it. If the batch is only limited by time, we
+        // reserve enough for the samples in a full read buffer.
+        try {
+            this->_batch.clear();
+            this->_batch.reserve((config.samples > 0)
+                ? config.samples
+                : read_buffer_size / stream_parser_v2::carry_capacity + 1);
+        } catch (std::bad_alloc) {
+            _powenetics_debug("Insufficient memory for sample batch.\r\n");
+            this->_state.store(stream_state::stopped,
+                std::memory_order::memory_order_release);
+            retval = E_OUTOFMEMORY;
         }
     }
 
     if (SUCCEEDED(retval)) {
-        this->_thread = std::thread(&powenetics_device::do_read, this);
+        retval = this->launch();
+    }
+
+    return retval;
+}
+
+
+/*
+ * powenetics_device::start
+ */
+HRESULT powenetics_device::start(
+        _In_ const powenetics_raw_data_callback callback,
+        _In_opt_ void *context) noexcept {
+    if (callback == nullptr) {
+        _powenetics_debug("An invalid raw data callback has been passed.\r\n");
+        return E_POINTER;
     }
 
+    auto retval = this->prepare_start();
+
     if (SUCCEEDED(retval)) {
-        this->_callback = callback;
+        this->_batch_callback = nullptr;
+        this->_callback = nullptr;
         this->_context = context;
+        this->_queued = false;
+        this->_raw_callback = callback;
+        this->_segment_callback = nullptr;
+        retval = this->launch();
+    }
 
-        if (this->_callback == nullptr) {
-            _powenetics_debug("An invalid data callback has been passed.\n\n");
-            retval = E_POINTER;
-        }
+    return retval;
+}
+
+
+/*
+ * powenetics_device::start
+ */
+HRESULT powenetics_device::start(
+        _In_ const powenetics_segment_callback callback,
+        _In_opt_ void *context) noexcept {
+    if (callback == nullptr) {
+        _powenetics_debug("An invalid segment callback has been passed.\r\n");
+        return E_POINTER;
+    }
+
+    auto retval = this->prepare_start();
+
+    if (SUCCEEDED(retval)) {
+        this->_batch_callback = nullptr;
+        this->_callback = nullptr;
+        this->_context = context;
+        this->_queued = false;
+        this->_raw_callback = nullptr;
+        this->_segment_callback = callback;
+        retval = this->launch();
+    }
+
+    return retval;
+}
+
+
+/*
+ * powenetics_device::start
+ */
+HRESULT powenetics_device::start(
+        _In_ const powenetics_queue_configuration& config) noexcept {
+    if (config.capacity == 0) {
+        _powenetics_debug("The sample queue must be able to hold at least one "
+            "sample.\r\n");
+        return E_INVALIDARG;
+    }
+
+    switch (config.overflow) {
+        case powenetics_overflow::drop_newest:
+        case powenetics_overflow::drop_oldest:
+        case powenetics_overflow::block:
+        case powenetics_overflow::decimate:
+            break;
+
+        default:
+            return E_INVALIDARG;
     }
 
+    auto retval = this->prepare_start();
+
     if (SUCCEEDED(retval)) {
-        retval = this->write(commands_v2::calibration_ok);
+        this->_batch_callback = nullptr;
+        this->_callback = nullptr;
+        this->_context = nullptr;
+        this->_queued = true;
+        this->_raw_callback = nullptr;
+        this->_segment_callback = nullptr;
+
+        // Allocate a new queue such that the consumer does not receive any
+        // samples left over from a previous run.
+        try {
+            this->_queue.reset(new overflow_queue<powenetics_sample>(
+                config.capacity, config.overflow, this->_queue_signal));
+        } catch (std::bad_alloc) {
+            _powenetics_debug("Insufficient memory for sample queue.\r\n");
+            this->_state.store(stream_state::stopped,
+                std::memory_order::memory_order_release);
+            retval = E_OUTOFMEMORY;
+        }
     }
 
     if (SUCCEEDED(retval)) {
-        retval = this->write(commands_v2::stream_mode);
+        retval = this->launch();
     }
 
     return retval;
 }
 
 
+/*
+ * powenetics_device::statistics
+ */
+void powenetics_device::statistics(
+        _Inout_ powenetics_statistics& dst) const noexcept {
+    assert(dst.version == 2);
+    const auto order = std::memory_order::memory_order_relaxed;
+    dst.bytes_read = this->_bytes_read.load(order);
+    dst.reads = this->_reads.load(order);
+    dst.segments_parsed = this->_segments_parsed.load(order);
+    dst.segments_rejected = this->_segments_rejected.load(order);
+    dst.bytes_discarded = this->_bytes_discarded.load(order);
+    dst.carry_overs = this->_carry_overs.load(order);
+    dst.sequence_gaps = this->_sequence_gaps.load(order);
+    dst.samples_missing = this->_samples_missing.load(order);
+    dst.samples_dropped = this->_samples_dropped.load(order);
+    dst.dispatch_depth = this->_dispatch_depth.load(order);
+    dst.dispatch_depth_max = this->_dispatch_depth_max.load(order);
+    dst.callback_time_max = this->_callback_time_max.load(order);
+}
+
+
 /*
  * powenetics_device::stop
  */
@@ -587,16 +1162,28 @@ HRESULT powenetics_device::stop(void) noexcept {
         }
     }
 
+#if !defined(_WIN32)
+    // Wake the thread if it is waiting for data, such that it notices the
+    // request to exit right away. If the event has already been closed along
+    // with the handle, the thread exits after the housekeeping interval.
+    this->_wake.set();
+#endif /* !defined(_WIN32) */
+
     // If the handle is valid, put the device back in bootload mode. Note that
     // it is important to do that *after* requesting the thread to exit, because
-    // if the thread does not receive any data from the device, the I/O will
-    // block and the only way to exit is closing the handle.
+    // on Windows, if the thread does not receive any data from the device, the
+    // I/O will block and the only way to exit is closing the handle.
     if (SUCCEEDED(retval)) {
         retval = this->write(commands_v2::bootload_mode);
     }
 
     // Our contract states that the sampler thread must not run anymore once the
-    // methods exits, so we wait for the thread to exit.
+    // methods exits, so we wait for the thread or the reactor to let go of the
+    // device.
+    if (this->_reactor != nullptr) {
+        this->_reactor->detach(*this);
+    }
+
     if (this->_thread.joinable()) {
         this->_thread.join();
     }
@@ -605,6 +1192,53 @@ HRESULT powenetics_device::stop(void) noexcept {
 }
 
 
+/*
+ * powenetics_device::thread_configuration
+ */
+HRESULT powenetics_device::thread_configuration(
+        _In_ const powenetics_thread_configuration& config) noexcept {
+    auto retval = ::check_thread_configuration(config);
+
+    // The configuration is applied only when the streaming thread starts, so
+    // it must not be changed while streaming.
+    if (SUCCEEDED(retval)) {
+        retval = this->check_stopped();
+    }
+
+    if (SUCCEEDED(retval)) {
+        this->_thread_config = config;
+    }
+
+    return retval;
+}
+
+
+/*
+ * powenetics_device::timestamping
+ */
+HRESULT powenetics_device::timestamping(
+        _In_ const powenetics_timestamping timestamping) noexcept {
+    switch (timestamping) {
+        case powenetics_timestamping::per_sample:
+        case powenetics_timestamping::interpolated:
+            break;
+
+        default:
+            return E_INVALIDARG;
+    }
+
+    // The streaming thread reads the mode only when it starts, so it must
+    // not be changed while streaming.
+    auto retval = this->check_stopped();
+
+    if (SUCCEEDED(retval)) {
+        this->_timestamping = timestamping;
+    }
+
+    return retval;
+}
+
+
 /*
  * powenetics_device::write
  */
@@ -637,7 +1271,7 @@ HRESULT powenetics_device::write(_In_reads_(cnt) const byte_type *data,
     auto rem = cnt;
 
     while (rem > 0) {
-        auto written = ::write(this->_handle, cur, sizeof(rem));
+        auto written = ::write(this->_handle, cur, rem);
 
         if (written < 0) {
             auto retval = static_cast<HRESULT>(-errno);
@@ -687,12 +1321,591 @@ HRESULT powenetics_device::check_valid(void) noexcept {
 }
 
 
+/*
+ * powenetics_device::collect_statistics
+ */
+template<class TParser>
+void powenetics_device::collect_statistics(
+        _Inout_ TParser& parser) noexcept {
+    const auto statistics = parser.collect_statistics();
+    add(this->_segments_parsed, statistics.segments_parsed);
+    add(this->_segments_rejected, statistics.segments_rejected);
+    add(this->_bytes_discarded, statistics.bytes_discarded);
+    add(this->_carry_overs, statistics.carry_overs);
+    add(this->_sequence_gaps, statistics.sequence_gaps);
+    add(this->_samples_missing, statistics.samples_missing);
+    this->_profile.store(parser.profile(),
+        std::memory_order::memory_order_relaxed);
+
+    {
+        // The sums are too wide for atomics, but we only copy them once per
+        // read, so the lock is hardly ever contended.
+        std::lock_guard<std::mutex> l(this->_energy_lock);
+        this->_energy = parser.energy();
+    }
+}
+
+
+/*
+ * powenetics_device::deliver
+ */
+void powenetics_device::deliver(_In_ const powenetics_sample& sample) {
+    if (this->_dispatch_queue != nullptr) {
+        dispatch_event event;
+        event.kind = dispatch_kind::sample;
+        event.follows_end_of_batch = false;
+        event.sample = sample;
+        this->enqueue(event);
+
+    } else if (this->_callback != nullptr) {
+        this->_callback(this, &sample, this->_context);
+    }
+}
+
+
+/*
+ * powenetics_device::deliver
+ */
+void powenetics_device::deliver(_In_ const powenetics_raw_sample& sample) {
+    if (this->_dispatch_queue != nullptr) {
+        dispatch_event event;
+        event.kind = dispatch_kind::raw_sample;
+        event.follows_end_of_batch = false;
+        event.raw_sample = sample;
+        this->enqueue(event);
+
+    } else {
+        this->_raw_callback(this, &sample, this->_context);
+    }
+}
+
+
+/*
+ * powenetics_device::deliver
+ */
+void powenetics_device::deliver(_In_ const powenetics_segment& segment) {
+    if (this->_dispatch_queue != nullptr) {
+        // The bytes of the segment are only valid until we return, so we
+        // must copy them along with the segment.
+        dispatch_event event;
+        event.kind = dispatch_kind::segment;
+        event.follows_end_of_batch = false;
+        event.segment.segment = segment;
+        ::memcpy(event.segment.data, segment.data,
+            sizeof(event.segment.data));
+        this->enqueue(event);
+
+    } else {
+        this->_segment_callback(this, &segment, this->_context);
+    }
+}
+
+
+/*
+ * powenetics_device::deliver_batch
+ */
+void powenetics_device::deliver_batch(void) {
+    assert(this->_batch_callback != nullptr);
+    if (!this->_batch.empty()) {
+        if (this->_dispatch_queue != nullptr) {
+            // The dispatch thread reassembles the batch from the samples and
+            // delivers it once it sees the end.
+            dispatch_event event;
+            event.kind = dispatch_kind::sample;
+            event.follows_end_of_batch = false;
+            for (auto& s : this->_batch) {
+                event.sample = s;
+                this->enqueue(event);
+            }
+
+            event.kind = dispatch_kind::end_of_batch;
+            this->enqueue(event);
+
+        } else {
+            this->_batch_callback(this, this->_batch.data(),
+                this->_batch.size(), this->_context);
+        }
+
+        this->_batch.clear();
+    }
+}
+
+
+/*
+ * powenetics_device::enqueue
+ */
+void powenetics_device::enqueue(_In_ const dispatch_event& event) noexcept {
+    assert(this->_dispatch_queue != nullptr);
+    auto pushed = this->_dispatch_queue->push(event, [this](void) {
+        return this->check_running();
+    });
+
+    if (!pushed && (overflow_weight(event) > 0)) {
+        add(this->_samples_dropped, 1);
+    }
+}
+
+
+/*
+ * powenetics_device::launch
+ */
+HRESULT powenetics_device::launch(void) noexcept {
+    assert(this->_state.load() == stream_state::starting);
+    assert(!this->_thread.joinable());
+    assert(this->_session_factory != nullptr);
+
+    // Create the session here rather than on the thread serving the device,
+    // such that we can report if we run out of memory.
+    try {
+        this->_session = this->_session_factory(*this);
+        this->_launched = std::promise<HRESULT>();
+    } catch (std::bad_alloc) {
+        _powenetics_debug("Insufficient memory for streaming session.\r\n");
+        this->_state.store(stream_state::stopped,
+            std::memory_order::memory_order_release);
+        return E_OUTOFMEMORY;
+    }
+
+    {
+        auto retval = this->start_dispatch();
+        if (FAILED(retval)) {
+            this->_session.reset();
+            this->_state.store(stream_state::stopped,
+                std::memory_order::memory_order_release);
+            return retval;
+        }
+    }
+
+    if (this->_reactor != nullptr) {
+        // The reactor does not start a thread that could transition the state
+        // once it is up, so the device is running as soon as it is attached.
+        this->_state.store(stream_state::running,
+            std::memory_order::memory_order_release);
+
+        auto retval = this->_reactor->attach(*this);
+        if (FAILED(retval)) {
+            this->_session.reset();
+            this->stop_dispatch();
+            this->_state.store(stream_state::stopped,
+                std::memory_order::memory_order_release);
+            return retval;
+        }
+
+    } else {
+        // The thread configures itself before it starts reading, such that
+        // we can report if this fails before the device sends any data.
+        auto launched = this->_launched.get_future();
+        this->_thread = std::thread(&powenetics_device::do_read, this);
+
+        auto retval = launched.get();
+        if (FAILED(retval)) {
+            // The thread has already retired the session.
+            this->_thread.join();
+            return retval;
+        }
+    }
+
+    auto retval = this->write(commands_v2::calibration_ok);
+
+    if (SUCCEEDED(retval)) {
+        retval = this->write(commands_v2::stream_mode);
+    }
+
+    return retval;
+}
+
+
+/*
+ * powenetics_device::pop_samples
+ */
+std::size_t powenetics_device::pop_samples(
+        _Out_writes_bytes_(cnt * sample_size<powenetics_sample>(version))
+        void *dst,
+        _In_ const std::size_t cnt,
+        _In_ const std::uint32_t version) noexcept {
+    assert(this->_queue != nullptr);
+    assert(dst != nullptr);
+    auto& queue = *this->_queue;
+    std::uint64_t dropped = 0;
+    std::size_t retval = 0;
+
+    if (version == sample_version) {
+        retval = queue.pop(static_cast<powenetics_sample *>(dst), cnt,
+            dropped);
+        add(this->_samples_dropped, dropped);
+        return retval;
+    }
+
+    // Samples of an older version are smaller than the ones in the queue, so
+    // we need to take them out in small portions and copy the members the
+    // caller knows.
+    const auto size = ::sample_size<powenetics_sample>(version);
+    auto cur = static_cast<std::uint8_t *>(dst);
+    powenetics_sample buffer[16];
+
+    while (retval < cnt) {
+        const auto max = (std::min)(std::size(buffer), cnt - retval);
+        const auto popped = queue.pop(buffer, max, dropped);
+        add(this->_samples_dropped, dropped);
+
+        for (std::size_t i = 0; i < popped; ++i, cur += size) {
+            ::store_sample(cur, buffer[i], version);
+        }
+
+        retval += popped;
+        if (popped < max) {
+            break;
+        }
+    }
+
+    return retval;
+}
+
+
+/*
+ * powenetics_device::prepare_start
+ */
+HRESULT powenetics_device::prepare_start(void) noexcept {
+    auto retval = this->check_valid();
+
+    if (SUCCEEDED(retval)) {
+        auto expected = stream_state::stopped;
+        auto succeeded = this->_state.compare_exchange_strong(expected,
+            stream_state::starting, std::memory_order::memory_order_acq_rel);
+        if (!succeeded) {
+            _powenetics_debug("The Powenetics device is already streaming "
+                "data.\r\n");
+            retval = E_NOT_VALID_STATE;
+        }
+    }
+
+    if (SUCCEEDED(retval) && this->_thread.joinable()) {
+        // The thread might have exited on its own due to an I/O error, in
+        // which case we need to reclaim it before we can start a new one.
+        this->_thread.join();
+    }
+
+#if !defined(_WIN32)
+    if (SUCCEEDED(retval)) {
+        // Discard a wake-up that the previous thread has not consumed.
+        this->_wake.clear();
+    }
+#endif /* !defined(_WIN32) */
+
+    return retval;
+}
+
+
+/*
+ * powenetics_device::publish_dispatch
+ */
+void powenetics_device::publish_dispatch(void) noexcept {
+    assert(this->_dispatch_queue != nullptr);
+    const auto depth = this->_dispatch_queue->size();
+    const auto order = std::memory_order::memory_order_relaxed;
+
+    // Only the thread serving the device writes the depth, so we do not need
+    // to CAS the maximum.
+    this->_dispatch_depth.store(depth, order);
+    if (depth > this->_dispatch_depth_max.load(order)) {
+        this->_dispatch_depth_max.store(depth, order);
+    }
+
+    this->_dispatch_signal.notify();
+}
+
+
+/*
+ * powenetics_device::receive
+ */
+bool powenetics_device::receive(_Out_writes_(cnt) byte_type *dst,
+        _Inout_ std::size_t& cnt) noexcept {
+    if (!this->check_running()) {
+        return false;
+    }
+
+#if defined(_WIN32)
+    return SUCCEEDED(this->read(dst, cnt));
+
+#else /* defined(_WIN32) */
+    std::array<pollfd, 2> fds;
+    fds[0].fd = this->_handle;
+    fds[0].events = POLLIN;
+    fds[1].fd = this->_wake.handle();
+    fds[1].events = POLLIN;
+
+    const auto status = ::poll(fds.data(), fds.size(), housekeeping_interval);
+    if (status < 0) {
+        // Being interrupted by a signal is the same as a timeout for us.
+        cnt = 0;
+        return (errno == EINTR) && this->check_running();
+    }
+
+    if (fds[1].revents != 0) {
+        // The event is only signalled if the thread should exit.
+        cnt = 0;
+        return false;
+    }
+
+    if (status == 0) {
+        cnt = 0;
+        return true;
+    }
+
+    if ((fds[0].revents & POLLIN) == 0) {
+        // The port has been closed or the device has been unplugged.
+        _powenetics_debug("Polling the COM port failed.\r\n");
+        cnt = 0;
+        return false;
+    }
+
+    return SUCCEEDED(this->read(dst, cnt));
+#endif /* defined(_WIN32) */
+}
+
+
+/// <summary>
+/// The implementation of <see cref="stream_session" /> for the parser
+/// <typeparamref name="TParser" />, which delivers the samples to the
+/// callbacks of the device.
+/// </summary>
+/// <remarks>
+/// The session accesses the callback configuration of the device, which the
+/// thread serving the device owns while it is streaming.
+/// </remarks>
+template<class TParser>
+class powenetics_device::session final : public stream_session {
+
+public:
+
+    static_assert(is_stream_parser<TParser>::value, "The session can only be "
+        "instantiated for types satisfying the parser concept.");
+
+    /// <summary>
+    /// Initialises a new instance for the given <paramref name="device" />.
+    /// </summary>
+    /// <remarks>
+    /// The constructor applies the clock and the timestamping of the device
+    /// to the parser and resets the energy the device has integrated.
+    /// </remarks>
+    explicit session(_In_ powenetics_device& device);
+
+    /// <inheritdoc />
+    void finish(void) override;
+
+    /// <inheritdoc />
+    void process(_In_reads_(cnt) const byte_type *data,
+        _In_ const std::size_t cnt) override;
+
+private:
+
+    typedef std::chrono::steady_clock clock_type;
+
+    powenetics_device& _device;
+    clock_type::time_point _first;
+    TParser _parser;
+    bool _reported;
+    clock_type::time_point _silence;
+};
+
+
+/*
+ * powenetics_device::session<TParser>::session
+ */
+template<class TParser>
+powenetics_device::session<TParser>::session(
+        _In_ powenetics_device& device)
+    : _device(device),
+    _reported(false),
+    _silence(clock_type::time_point::min()) {
+    this->_parser.clock(::select_clock(device._clock));
+    this->_parser.timestamping(device._timestamping);
+
+    std::lock_guard<std::mutex> l(device._energy_lock);
+    device._energy.reset();
+    device._energy_frequency = ::clock_frequency(device._clock);
+}
+
+
+/*
+ * powenetics_device::session<TParser>::finish
+ */
+template<class TParser>
+void powenetics_device::session<TParser>::finish(void) {
+    if (this->_device._batch_callback != nullptr) {
+        // Deliver what is left before we report that we stopped.
+        this->_device.deliver_batch();
+    }
+}
+
+
+/*
+ * powenetics_device::session<TParser>::process
+ */
+template<class TParser>
+void powenetics_device::session<TParser>::process(
+        _In_reads_(cnt) const byte_type *data,
+        _In_ const std::size_t cnt) {
+    auto& device = this->_device;
+
+    if (cnt > 0) {
+        received(this->_parser);
+        this->_silence = clock_type::time_point::min();
+
+        if (device._batch_callback != nullptr) {
+            // Batched delivery: collect the samples and deliver them once one
+            // of the limits is reached.
+            this->_parser.push_back(data, cnt,
+                    [this, &device](const powenetics_sample &sample) {
+                if (device._batch.empty()) {
+                    this->_first = clock_type::now();
+                }
+
+                device._batch.push_back(sample);
+
+                if (device._batch.size() == device._batch_config.samples) {
+                    device.deliver_batch();
+                }
+            });
+
+        } else if (device._segment_callback != nullptr) {
+            // Segment delivery: the parser only checks the framing, but does
+            // not decode the readings at all.
+            this->_parser.template push_back<powenetics_segment>(data, cnt,
+                    [&device](const powenetics_segment &segment) {
+                device.deliver(segment);
+            });
+
+        } else if (device._raw_callback != nullptr) {
+            // Raw delivery: the parser skips the conversion to floating point.
+            this->_parser.template push_back<powenetics_raw_sample>(data, cnt,
+                    [&device](const powenetics_raw_sample &sample) {
+                device.deliver(sample);
+            });
+
+        } else if (device._queued) {
+            // Queued delivery: the samples are handed over to the consumer.
+            // What happens to samples that do not fit is up to the overflow
+            // policy of the queue.
+            auto& queue = *device._queue;
+            std::uint64_t dropped = 0;
+            this->_parser.push_back(data, cnt,
+                    [&device, &queue, &dropped](
+                    const powenetics_sample &sample) {
+                auto pushed = queue.push(sample, [&device](void) {
+                    return device.check_running();
+                });
+                if (!pushed) {
+                    ++dropped;
+                }
+            });
+
+            add(device._samples_dropped, dropped);
+            device._queue_signal.notify();
+
+        } else {
+            this->_parser.push_back(data, cnt,
+                    [&device](const powenetics_sample &sample) {
+                device.deliver(sample);
+            });
+        }
+
+    } else {
+        // The device did not send anything since the last housekeeping, so
+        // check whether it has gone quiet.
+        const auto now = clock_type::now();
+        if (this->_silence == clock_type::time_point::min()) {
+            this->_silence = now;
+            this->_reported = false;
+
+        } else if (!this->_reported
+                && (now - this->_silence >= watchdog_timeout)) {
+            _powenetics_debug("The Powenetics device has not sent any data "
+                "for a second.\r\n");
+            this->_reported = true;
+        }
+    }
+
+    device.collect_statistics(this->_parser);
+
+    if (device._batch_callback != nullptr) {
+        const auto& config = device._batch_config;
+
+        if ((config.samples == 0) && (config.window == 0)) {
+            device.deliver_batch();
+
+        } else if ((config.window > 0) && !device._batch.empty()) {
+            const std::chrono::milliseconds window(config.window);
+            const auto dt = clock_type::now() - this->_first;
+            if (dt >= window) {
+                device.deliver_batch();
+            }
+        }
+    }
+
+    if (device._dispatch_queue != nullptr) {
+        device.publish_dispatch();
+    }
+}
+
+
+/*
+ * powenetics_device::make_session
+ */
+template<class TParser>
+std::unique_ptr<stream_session> powenetics_device::make_session(
+        _In_ powenetics_device& device) {
+    return std::unique_ptr<stream_session>(new session<TParser>(device));
+}
+
+
+/*
+ * powenetics_device::select_session
+ */
+powenetics_device::session_factory powenetics_device::select_session(
+        _In_ const std::uint32_t protocol,
+        _In_ const powenetics_parser parser) noexcept {
+    switch (protocol) {
+        case 2:
+            switch (parser) {
+                case powenetics_parser::stream:
+                    return &powenetics_device::make_session<stream_parser_v2>;
+
+                case powenetics_parser::columnar:
+                    return &powenetics_device::make_session<
+                        columnar_parser_v2>;
+
+                case powenetics_parser::resumable:
+                    return &powenetics_device::make_session<
+                        resumable_parser_v2>;
+
+                default:
+                    return nullptr;
+            }
+
+        default:
+            return nullptr;
+    }
+}
+
+
 /*
  * powenetics_device::do_read
  */
 void powenetics_device::do_read(void) {
     set_thread_name("powenetics sampler");
 
+    {
+        auto hr = ::apply_thread_configuration(this->_thread_config);
+        if (FAILED(hr)) {
+            // We cannot run as requested, so we exit before anything is read
+            // and let 'launch' report the problem.
+            this->retire();
+            this->_launched.set_value(hr);
+            return;
+        }
+    }
+
     // Signal to everyone that we are now running. If this fails (with a strong
     // CAS), someone else has manipulated the '_state' variable in the meantime.
     // This is illegal. No one may change the state during startup except for
@@ -708,28 +1921,241 @@ void powenetics_device::do_read(void) {
         }
     }
 
+    this->_launched.set_value(S_OK);
+
+#if defined(POWENETICS_IO_URING)
+    if (this->_reader == powenetics_reader::io_uring) {
+        uring_reader reader;
+        auto hr = reader.open(this->_handle, this->_wake.handle(),
+            uring_reader::default_depth, read_buffer_size);
+
+        if (SUCCEEDED(hr)) {
+            this->do_read_uring(reader);
+
+            // Make sure that the kernel has given up all reads before we
+            // report that we are done, because the caller might use the
+            // handle afterwards.
+            reader.close();
+            this->retire();
+            return;
+        }
+
+        _powenetics_debug("io_uring is not available, falling back to poll "
+            "and read.\r\n");
+    }
+#endif /* defined(POWENETICS_IO_URING) */
+
     std::vector<byte_type> buffer;
-    buffer.resize(4 * 1024);
+    buffer.resize(read_buffer_size);
     auto cnt = buffer.size();
-    stream_parser_v2 parser;
-
-    while (this->check_running()
-            && SUCCEEDED(this->read(buffer.data(), cnt))) {
-        parser.push_back(buffer.data(), cnt,
-                [this](const powenetics_sample &sample) {
-            if (this->_callback != nullptr) {
-                this->_callback(this, &sample, this->_context);
-            }
-        });
 
+    // Between the reads, the session does its housekeeping: it publishes the
+    // statistics and, for batched delivery, checks the window. On POSIX
+    // systems, 'receive' returns at least once per housekeeping interval, so
+    // this also happens if the device does not send any data.
+    while (this->receive(buffer.data(), cnt)) {
+        this->_session->process(buffer.data(), cnt);
         cnt = buffer.size();
     }
 
-    // Indicate that we are done. We do not CAS this from
-    // stream_state::stopping, because a request for orderly shutdown is only
-    // one way we can get here, the file handle being closed and the I/O failing
-    // being the other one. In the latter case, the state will still be
-    // stream_state::running at this point.
-    this->_state.store(stream_state::stopped,
-        std::memory_order::memory_order_release);
+    this->retire();
+}
+
+
+
+/*
+ * powenetics_device::do_read_uring
+ */
+void powenetics_device::do_read_uring(_Inout_ uring_reader& reader) {
+    while (this->check_running()) {
+        auto hr = reader.wait(housekeeping_interval);
+        auto received = false;
+
+        // Process all reads that have completed since the last wait before
+        // their buffers are queued again with the next wait.
+        if (SUCCEEDED(hr)) {
+            const byte_type *data;
+            std::size_t cnt;
+
+            while ((hr = reader.next(data, cnt)) == S_OK) {
+                add(this->_reads, 1);
+                add(this->_bytes_read, cnt);
+                this->_session->process(data, cnt);
+                received = true;
+            }
+        }
+
+        if (FAILED(hr)) {
+            _powenetics_debug("Reading from the COM port via io_uring "
+                "failed.\r\n");
+            break;
+        }
+
+        // The event is only signalled if the thread should exit.
+        if (reader.woken()) {
+            break;
+        }
+
+        if (!received) {
+            this->_session->process(nullptr, 0);
+        }
+    }
+}
+
+
+/*
+ * powenetics_device::do_dispatch
+ */
+void powenetics_device::do_dispatch(void) {
+    set_thread_name("powenetics dispatcher");
+
+    auto& queue = *this->_dispatch_queue;
+    std::array<dispatch_event, 64> events;
+
+    while (true) {
+        // Note: we must check the flag before looking at the queue, or we
+        // might miss the events added right before the flag was set.
+        const auto exit = this->_dispatch_exit.load(
+            std::memory_order::memory_order_acquire);
+        std::uint64_t dropped = 0;
+        const auto cnt = queue.pop(events.data(), events.size(), dropped);
+        add(this->_samples_dropped, dropped);
+
+        if (cnt == 0) {
+            if (exit) {
+                break;
+            }
+
+            this->_dispatch_signal.wait(
+                    std::chrono::milliseconds(housekeeping_interval),
+                    [this, &queue](void) {
+                return (!queue.empty() || this->_dispatch_exit.load(
+                    std::memory_order::memory_order_acquire));
+            });
+            continue;
+        }
+
+        for (std::size_t i = 0; i < cnt; ++i) {
+            auto& event = events[i];
+
+            if (event.follows_end_of_batch) {
+                // The end of the previous batch has been evicted from the
+                // queue, so the event carries it.
+                dispatch_event end;
+                end.kind = dispatch_kind::end_of_batch;
+                end.follows_end_of_batch = false;
+                this->invoke(end);
+            }
+
+            this->invoke(event);
+        }
+    }
+}
+
+
+/*
+ * powenetics_device::invoke
+ */
+void powenetics_device::invoke(_Inout_ dispatch_event& event) {
+    typedef std::chrono::steady_clock clock_type;
+    const auto order = std::memory_order::memory_order_relaxed;
+
+    if ((event.kind == dispatch_kind::sample)
+            && (this->_batch_callback != nullptr)) {
+        // Samples of a batch are only collected. Note that the vector does
+        // not grow beyond the largest batch, because an end of a batch that
+        // has been evicted from the queue is carried by the next event.
+        this->_dispatch_batch.push_back(event.sample);
+        return;
+    }
+
+    const auto begin = clock_type::now();
+
+    switch (event.kind) {
+        case dispatch_kind::sample:
+            this->_callback(this, &event.sample, this->_context);
+            break;
+
+        case dispatch_kind::raw_sample:
+            this->_raw_callback(this, &event.raw_sample, this->_context);
+            break;
+
+        case dispatch_kind::segment:
+            event.segment.segment.data = event.segment.data;
+            this->_segment_callback(this, &event.segment.segment,
+                this->_context);
+            break;
+
+        case dispatch_kind::end_of_batch:
+            // The batch might be empty if all of its samples have been
+            // dropped.
+            if (!this->_dispatch_batch.empty()) {
+                this->_batch_callback(this,
+                    this->_dispatch_batch.data(),
+                    this->_dispatch_batch.size(), this->_context);
+                this->_dispatch_batch.clear();
+            }
+            break;
+    }
+
+    // Only this thread writes the maximum, so we do not need to CAS.
+    const auto dt = static_cast<std::uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+        clock_type::now() - begin).count());
+    if (dt > this->_callback_time_max.load(order)) {
+        this->_callback_time_max.store(dt, order);
+    }
+}
+
+
+/*
+ * powenetics_device::start_dispatch
+ */
+HRESULT powenetics_device::start_dispatch(void) noexcept {
+    assert(this->_dispatch_queue == nullptr);
+    assert(!this->_dispatch_thread.joinable());
+
+    if (this->_queued || (this->_dispatch_config.dispatch
+            != powenetics_dispatch::asynchronous)) {
+        // There are no callbacks to be invoked asynchronously.
+        return S_OK;
+    }
+
+    try {
+        this->_dispatch_batch.clear();
+        if (this->_batch_callback != nullptr) {
+            this->_dispatch_batch.reserve(this->_batch.capacity());
+        }
+
+        this->_dispatch_exit.store(false,
+            std::memory_order::memory_order_relaxed);
+        this->_dispatch_queue.reset(new overflow_queue<dispatch_event>(
+            this->_dispatch_config.capacity,
+            this->_dispatch_config.overflow,
+            this->_dispatch_signal));
+        this->_dispatch_thread = std::thread(&powenetics_device::do_dispatch,
+            this);
+        return S_OK;
+
+    } catch (std::bad_alloc) {
+        _powenetics_debug("Insufficient memory for dispatch queue.\r\n");
+        this->_dispatch_queue.reset();
+        return E_OUTOFMEMORY;
+    }
+}
+
+
+/*
+ * powenetics_device::stop_dispatch
+ */
+void powenetics_device::stop_dispatch(void) noexcept {
+    if (this->_dispatch_thread.joinable()) {
+        this->_dispatch_exit.store(true,
+            std::memory_order::memory_order_release);
+        this->_dispatch_signal.notify();
+        this->_dispatch_thread.join();
+    }
+
+    this->_dispatch_queue.reset();
+    this->_dispatch_depth.store(0, std::memory_order::memory_order_relaxed);
 }
@@ -10,17 +10,45 @@
 
 #include <array>
 #include <atomic>
+#include <chrono>
 #include <cinttypes>
+#include <future>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <thread>
 #include <vector>
 
 #include "libpowenetics/api.h"
+#include "libpowenetics/batch.h"
+#include "libpowenetics/connector_profile.h"
+#include "libpowenetics/dispatch.h"
+#include "libpowenetics/energy.h"
+#include "libpowenetics/parser.h"
+#include "libpowenetics/queue.h"
+#include "libpowenetics/raw_sample.h"
+#include "libpowenetics/reader.h"
 #include "libpowenetics/sample.h"
+#include "libpowenetics/scheduling.h"
+#include "libpowenetics/segment.h"
 #include "libpowenetics/serial.h"
-
+#include "libpowenetics/statistics.h"
+#include "libpowenetics/timestamp.h"
+
+#include "consumer_signal.h"
+#include "dispatch_event.h"
+#include "energy_integrator.h"
+#include "overflow_queue.h"
+#include "sample_version.h"
+#include "stream_parser.h"
 #include "stream_parser_v2.h"
+#include "stream_session.h"
 #include "stream_state.h"
+#include "uring_reader.h"
+#include "wake_event.h"
+
+
+struct powenetics_reactor;
 
 
 /// <summary>
@@ -41,11 +69,31 @@ public:
     /// </summary>
     typedef stream_parser_v2::byte_type byte_type;
 
+    /// <summary>
+    /// The type of the native handle of the serial port.
+    /// </summary>
+#if defined(_WIN32)
+    typedef HANDLE handle_type;
+#else /* defined(_WIN32) */
+    typedef int handle_type;
+#endif /* defined(_WIN32) */
+
     /// <summary>
     /// The type of a string.
     /// </summary>
     typedef std::basic_string<powenetics_char> string_type;
 
+    /// <summary>
+    /// The time in milliseconds after which the thread serving the device
+    /// stops waiting for data in order to do its housekeeping.
+    /// </summary>
+    static constexpr int housekeeping_interval = 100;
+
+    /// <summary>
+    /// The size of the buffer the streaming thread reads into in bytes.
+    /// </summary>
+    static constexpr std::size_t read_buffer_size = 4 * 1024;
+
     /// <summary>
     /// Gets the paths of all COM ports on the system that might be used to
     /// connect a Powenetics device.
@@ -74,18 +122,83 @@ public:
         _In_ const powenetics_quantity quantity,
         _In_ const std::uint32_t value) noexcept;
 
+    /// <summary>
+    /// Changes the clock the samples are stamped with the next time
+    /// streaming is started.
+    /// </summary>
+    /// <remarks>
+    /// This method must not be called while the device is streaming.
+    /// </remarks>
+    HRESULT clock(_In_ const powenetics_clock clock) noexcept;
+
     /// <summary>
     /// Close the serial port connection to the device.
     /// </summary>
     HRESULT close(void) noexcept;
 
+    /// <summary>
+    /// Changes the thread the callbacks are invoked on the next time
+    /// streaming is started.
+    /// </summary>
+    /// <remarks>
+    /// This method must not be called while the device is streaming.
+    /// </remarks>
+    HRESULT dispatch(
+        _In_ const powenetics_dispatch_configuration& config) noexcept;
+
+    /// <summary>
+    /// Converts the energy most recently published by the streaming thread
+    /// into Joules.
+    /// </summary>
+    /// <param name="dst">Receives the energy. The version of the structure
+    /// must have been validated by the caller.</param>
+    void energy(_Inout_ powenetics_energy& dst) const noexcept;
+
+    /// <summary>
+    /// Answer the native handle of the serial port.
+    /// </summary>
+    inline handle_type handle(void) const noexcept {
+        return this->_handle;
+    }
+
+    /// <summary>
+    /// Lets the session of a device served by a
+    /// <see cref="powenetics_reactor" /> do its housekeeping.
+    /// </summary>
+    /// <remarks>
+    /// This method must only be called by the reactor thread serving the
+    /// device while the device is <see cref="stream_state::running" />.
+    /// </remarks>
+    void housekeeping(void);
+
     /// <summary>
     /// Opens and configures the specified COM port if the device has not
     /// yet been opened.
     /// </summary>
+    /// <remarks>
+    /// The version of <paramref name="config" /> identifies the protocol of
+    /// the device, which determines the parser the streaming thread uses.
+    /// </remarks>
     HRESULT open(_In_z_ const powenetics_char *com_port,
         _In_ const powenetics_serial_configuration *config) noexcept;
 
+    /// <summary>
+    /// Changes the implementation of the parser that is used the next time
+    /// streaming is started.
+    /// </summary>
+    /// <remarks>
+    /// This method must not be called while the device is streaming.
+    /// </remarks>
+    HRESULT parser(_In_ const powenetics_parser parser) noexcept;
+
+    /// <summary>
+    /// Copies the connector profile most recently detected by the streaming
+    /// thread to <paramref name="dst" />.
+    /// </summary>
+    /// <param name="dst">Receives the profile. The version of the structure
+    /// must have been validated by the caller.</param>
+    void profile(_Inout_ powenetics_connector_profile& dst) const noexcept;
+
     /// <summary>
     /// Reads at mode <paramref name="cnt" /> bytes from the serial port.
     /// </summary>
@@ -101,11 +214,82 @@ public:
     HRESULT read(_Out_writes_(cnt) byte_type *dst,
         _Inout_ std::size_t& cnt) noexcept;
 
+    /// <summary>
+    /// Removes up to <paramref name="cnt" /> samples from the queue the
+    /// device streams to, waiting for at most <paramref name="timeout" />
+    /// milliseconds if the queue is empty.
+    /// </summary>
+    /// <remarks>
+    /// This method must only be called by one thread at a time, which is the
+    /// consumer of the queue, and not concurrently with starting the stream.
+    /// </remarks>
+    /// <param name="dst">A buffer that is able to receive at least
+    /// <paramref name="cnt" /> samples of the version the first element has
+    /// been initialised with, which must be supported.</param>
+    /// <param name="cnt">The size of <paramref name="dst" /> on entry, the
+    /// number of samples written on exit.</param>
+    /// <param name="timeout">The time in milliseconds to wait for samples
+    /// if the queue is empty.</param>
+    /// <returns><c>S_OK</c> if samples have been read, <c>S_FALSE</c> if
+    /// none arrived before the timeout, <c>E_NOT_VALID_STATE</c> if the
+    /// queue is empty and the device is not streaming.</returns>
+    HRESULT read_samples(_Inout_updates_(cnt) powenetics_sample *dst,
+        _Inout_ std::size_t& cnt,
+        _In_ const std::uint32_t timeout) noexcept;
+
+    /// <summary>
+    /// Changes the reactor that serves the device the next time streaming is
+    /// started.
+    /// </summary>
+    /// <remarks>
+    /// This method must not be called while the device is streaming.
+    /// </remarks>
+    /// <param name="reactor">The reactor to serve the device, or
+    /// <c>nullptr</c> for the device to start a streaming thread of its own.
+    /// </param>
+    HRESULT reactor(_In_opt_ powenetics_reactor *reactor) noexcept;
+
+    /// <summary>
+    /// Changes how the streaming thread reads from the serial port the next
+    /// time streaming is started.
+    /// </summary>
+    /// <remarks>
+    /// This method must not be called while the device is streaming.
+    /// </remarks>
+    HRESULT reader(_In_ const powenetics_reader reader) noexcept;
+
     /// <summary>
     /// Instruct the device to clear all calibration.
     /// </summary>
     HRESULT reset_calibration(void) noexcept;
 
+    /// <summary>
+    /// Ends the session of the device and transitions it to
+    /// <see cref="stream_state::stopped" />.
+    /// </summary>
+    /// <remarks>
+    /// This method must only be called by the thread serving the device,
+    /// which must not access the device anymore afterwards.
+    /// </remarks>
+    void retire(void);
+
+    /// <summary>
+    /// Reads once from the serial port and processes the data on behalf of
+    /// the <see cref="powenetics_reactor" /> serving the device.
+    /// </summary>
+    /// <remarks>
+    /// This method must only be called by the reactor thread serving the
+    /// device once the serial port has become readable.
+    /// </remarks>
+    /// <param name="buffer">A buffer the reactor thread reads into, which
+    /// is able to hold at least <paramref name="cnt" /> bytes.</param>
+    /// <param name="cnt">The size of <paramref name="buffer" /> in bytes.
+    /// </param>
+    /// <returns><c>true</c> if the data have been processed, <c>false</c> if
+    /// the I/O failed and the device must be retired.</returns>
+    bool serve(_Out_writes_(cnt) byte_type *buffer,
+        _In_ const std::size_t cnt);
+
     /// <summary>
     /// Start streaming data from the device and deliver it to the given
     /// <paramref name="callback" /> function.
@@ -113,11 +297,75 @@ public:
     HRESULT start(_In_ const powenetics_data_callback callback,
         _In_opt_ void *context) noexcept;
 
+    /// <summary>
+    /// Start streaming data from the device and deliver it in batches to the
+    /// given <paramref name="callback" /> function.
+    /// </summary>
+    HRESULT start(_In_ const powenetics_batch_callback callback,
+        _In_opt_ void *context,
+        _In_ const powenetics_batch_configuration& config) noexcept;
+
+    /// <summary>
+    /// Start streaming data from the device and deliver the raw readings to
+    /// the given <paramref name="callback" /> function.
+    /// </summary>
+    HRESULT start(_In_ const powenetics_raw_data_callback callback,
+        _In_opt_ void *context) noexcept;
+
+    /// <summary>
+    /// Start streaming data from the device and deliver the undecoded
+    /// segments to the given <paramref name="callback" /> function.
+    /// </summary>
+    HRESULT start(_In_ const powenetics_segment_callback callback,
+        _In_opt_ void *context) noexcept;
+
+    /// <summary>
+    /// Start streaming data from the device into a queue the samples can be
+    /// pulled from using <see cref="read_samples" />.
+    /// </summary>
+    HRESULT start(_In_ const powenetics_queue_configuration& config) noexcept;
+
+    /// <summary>
+    /// Answer the current state of streaming.
+    /// </summary>
+    inline stream_state state(void) const noexcept {
+        return this->_state.load(std::memory_order::memory_order_acquire);
+    }
+
+    /// <summary>
+    /// Copies the current values of the stream counters to
+    /// <paramref name="dst" />.
+    /// </summary>
+    /// <param name="dst">Receives the counters. The version of the structure
+    /// must have been validated by the caller.</param>
+    void statistics(_Inout_ powenetics_statistics& dst) const noexcept;
+
     /// <summary>
     /// Asks the streaming thread to stop and waits for it exit.
     /// </summary>
     HRESULT stop(void) noexcept;
 
+    /// <summary>
+    /// Changes how the streaming thread is scheduled the next time streaming
+    /// is started.
+    /// </summary>
+    /// <remarks>
+    /// This method must not be called while the device is streaming. The
+    /// configuration has no effect if the device is served by a reactor.
+    /// </remarks>
+    HRESULT thread_configuration(
+        _In_ const powenetics_thread_configuration& config) noexcept;
+
+    /// <summary>
+    /// Changes how the samples are stamped the next time streaming is
+    /// started.
+    /// </summary>
+    /// <remarks>
+    /// This method must not be called while the device is streaming.
+    /// </remarks>
+    HRESULT timestamping(
+        _In_ const powenetics_timestamping timestamping) noexcept;
+
     /// <summary>
     /// Synchronously write the given data to the serial port.
     /// </summary>
@@ -150,18 +398,19 @@ public:
 
 private:
 
-#if defined(_WIN32)
-    typedef HANDLE handle_type;
-#else /* defined(_WIN32) */
-    typedef int handle_type;
-#endif /* defined(_WIN32) */
-
 #if defined(_WIN32)
     static constexpr handle_type invalid_handle = INVALID_HANDLE_VALUE;
 #else /* defined(_WIN32) */
     static constexpr handle_type invalid_handle = -1;
 #endif /* defined(_WIN32) */
 
+    /// <summary>
+    /// The time after which a session reports that the device has gone
+    /// quiet.
+    /// </summary>
+    static constexpr std::chrono::milliseconds watchdog_timeout
+        = std::chrono::milliseconds(1000);
+
     /// <summary>
     /// Check whether the thread is still in
     ///  <see cref="stream_state::running" />.
@@ -171,6 +420,59 @@ private:
         return (state == stream_state::running);
     }
 
+    /// <summary>
+    /// The type of the counters that can be updated by the streaming thread
+    /// while other threads are reading them.
+    /// </summary>
+    typedef std::atomic<std::uint64_t> counter_type;
+
+    /// <summary>
+    /// Adds <paramref name="value" /> to <paramref name="counter" />.
+    /// </summary>
+    /// <remarks>
+    /// The counters do not synchronise any other data, so relaxed ordering
+    /// is sufficient.
+    /// </remarks>
+    static inline void add(_Inout_ counter_type& counter,
+            _In_ const std::uint64_t value) noexcept {
+        counter.fetch_add(value, std::memory_order::memory_order_relaxed);
+    }
+
+    /// <summary>
+    /// The implementation of <see cref="stream_session" /> for the parser
+    /// <typeparamref name="TParser" />, which delivers the samples to the
+    /// callbacks of the device.
+    /// </summary>
+    template<class TParser> class session;
+
+    /// <summary>
+    /// The type of the function creating the session when streaming starts.
+    /// </summary>
+    typedef std::unique_ptr<stream_session> (*session_factory)(
+        _In_ powenetics_device& device);
+
+    /// <summary>
+    /// Creates a <see cref="session" /> for <paramref name="device" />.
+    /// </summary>
+    /// <typeparam name="TParser">The type of the parser, which must satisfy
+    /// <see cref="is_stream_parser" />.</typeparam>
+    template<class TParser>
+    static std::unique_ptr<stream_session> make_session(
+        _In_ powenetics_device& device);
+
+    /// <summary>
+    /// Answer the instantiation of <see cref="make_session" /> for the parser
+    /// of the given <paramref name="protocol" />.
+    /// </summary>
+    /// <param name="protocol">The version of the protocol, which is the
+    /// version of the serial configuration the device was opened with.
+    /// </param>
+    /// <param name="parser">The implementation of the parser.</param>
+    /// <returns>The factory, or <c>nullptr</c> if there is no such parser for
+    /// the protocol.</returns>
+    static session_factory select_session(_In_ const std::uint32_t protocol,
+        _In_ const powenetics_parser parser) noexcept;
+
     /// <summary>
     /// Checks that the streaming thread is stopped.
     /// </summary>
@@ -181,23 +483,235 @@ private:
     /// </summary>
     HRESULT check_valid(void) noexcept;
 
+    /// <summary>
+    /// Adds the counters of <paramref name="parser" /> to the ones of the
+    /// device and resets the ones of the parser. Furthermore, publishes the
+    /// connector profile the parser has detected and the energy it has
+    /// integrated.
+    /// </summary>
+    template<class TParser>
+    void collect_statistics(_Inout_ TParser& parser) noexcept;
+
+    /// <summary>
+    /// Delivers <paramref name="sample" /> to the <see cref="_callback" />,
+    /// either directly or via the dispatch thread.
+    /// </summary>
+    void deliver(_In_ const powenetics_sample& sample);
+
+    /// <summary>
+    /// Delivers <paramref name="sample" /> to the
+    /// <see cref="_raw_callback" />, either directly or via the dispatch
+    /// thread.
+    /// </summary>
+    void deliver(_In_ const powenetics_raw_sample& sample);
+
+    /// <summary>
+    /// Delivers <paramref name="segment" /> to the
+    /// <see cref="_segment_callback" />, either directly or via the dispatch
+    /// thread.
+    /// </summary>
+    void deliver(_In_ const powenetics_segment& segment);
+
+    /// <summary>
+    /// Delivers all samples in <see cref="_batch" /> to the
+    /// <see cref="_batch_callback" />, either directly or via the dispatch
+    /// thread, and empties the batch.
+    /// </summary>
+    void deliver_batch(void);
+
+    /// <summary>
+    /// Hands <paramref name="event" /> over to the dispatch thread, or counts
+    /// it as dropped if the overflow policy of the queue discards it.
+    /// </summary>
+    void enqueue(_In_ const dispatch_event& event) noexcept;
+
+    /// <summary>
+    /// Removes up to <paramref name="cnt" /> samples from the queue and
+    /// stores them in the given version to <paramref name="dst" />.
+    /// </summary>
+    /// <param name="dst">A buffer that is able to receive at least
+    /// <paramref name="cnt" /> samples of version
+    /// <paramref name="version" />.</param>
+    /// <param name="cnt">The maximum number of samples to remove.</param>
+    /// <param name="version">The version of the samples in
+    /// <paramref name="dst" />, which must be supported.</param>
+    /// <returns>The number of samples that have been written.</returns>
+    std::size_t pop_samples(
+        _Out_writes_bytes_(cnt * sample_size<powenetics_sample>(version))
+        void *dst,
+        _In_ const std::size_t cnt,
+        _In_ const std::uint32_t version) noexcept;
+
+    /// <summary>
+    /// Transitions the device from <see cref="stream_state::stopped" /> to
+    /// <see cref="stream_state::starting" />.
+    /// </summary>
+    /// <remarks>
+    /// If this method succeeds, the caller owns the callback configuration and
+    /// must call <see cref="launch" /> afterwards.
+    /// </remarks>
+    HRESULT prepare_start(void) noexcept;
+
+    /// <summary>
+    /// Tells <paramref name="parser" /> the time at which a read completed if
+    /// it needs this information for stamping the samples.
+    /// </summary>
+    template<class TParser>
+    static inline void received(_Inout_ TParser& parser) noexcept {
+        if (parser.timestamping() == powenetics_timestamping::interpolated) {
+            parser.received(parser.now());
+        }
+    }
+
+    /// <summary>
+    /// Creates the session, hands the device over to the streaming thread or
+    /// the reactor and instructs the device to send data.
+    /// </summary>
+    HRESULT launch(void) noexcept;
+
+    /// <summary>
+    /// Publishes the depth of the <see cref="_dispatch_queue" /> and wakes
+    /// the dispatch thread if it is waiting.
+    /// </summary>
+    /// <remarks>
+    /// This method is called by the thread serving the device once per read
+    /// rather than once per sample.
+    /// </remarks>
+    void publish_dispatch(void) noexcept;
+
+    /// <summary>
+    /// Waits for data from the device and reads them on behalf of the
+    /// streaming thread.
+    /// </summary>
+    /// <remarks>
+    /// <para>On POSIX systems, the method polls the serial port together with
+    /// <see cref="_wake" />, so <see cref="stop" /> can interrupt the wait
+    /// at any time. If no data arrive within the
+    /// <see cref="housekeeping_interval" />, the method succeeds without
+    /// reading anything, such that the streaming thread can do periodic work
+    /// even if the device has gone quiet.</para>
+    /// <para>On Windows, the method blocks in the read like
+    /// <see cref="read" />.</para>
+    /// </remarks>
+    /// <param name="dst">A buffer that is able to receive at least
+    /// <paramref name="cnt" /> bytes.</param>
+    /// <param name="cnt">The size of <paramref name="dst" /> on entry, the
+    /// number of bytes read on exit, which may be zero.</param>
+    /// <returns><c>true</c> if the streaming thread should process the data
+    /// and continue, <c>false</c> if it should exit, because it has been
+    /// stopped or because the I/O failed.</returns>
+    bool receive(_Out_writes_(cnt) byte_type *dst,
+        _Inout_ std::size_t& cnt) noexcept;
+
     /// <summary>
     /// The method executed in <see cref="_thread" /> to continuously read data
     /// from the serial port.
     /// </summary>
     /// <remarks>
     /// This thread continues reading data from <see cref="_handle" /> and
-    /// processes these until one of the following conditions is met: the
-    /// I/O failes due to <see cref="_handle" /> being closer, or the
-    /// <see cref="_state" /> is set to <see cref="stream_state::stopping" />.
+    /// passes them to the <see cref="_session" /> until one of the following
+    /// conditions is met: the I/O failes due to <see cref="_handle" /> being
+    /// closer, or the <see cref="_state" /> is set to
+    /// <see cref="stream_state::stopping" />.
     /// </remarks>
     void do_read(void);
 
+    /// <summary>
+    /// Continuously reads data from the serial port using
+    /// <paramref name="reader" /> and passes them to the
+    /// <see cref="_session" />.
+    /// </summary>
+    /// <remarks>
+    /// This method is called by <see cref="do_read" /> if the device is
+    /// configured to use <see cref="powenetics_reader::io_uring" /> and the
+    /// ring could be set up. It returns under the same conditions as the
+    /// loop using <see cref="receive" />, but does not retire the session.
+    /// </remarks>
+    /// <param name="reader">A reader that has been opened for
+    /// <see cref="_handle" /> and <see cref="_wake" /> on the calling
+    /// thread.</param>
+    void do_read_uring(_Inout_ uring_reader& reader);
+
+    /// <summary>
+    /// The method executed in <see cref="_dispatch_thread" /> to invoke the
+    /// callbacks for the events in the <see cref="_dispatch_queue" />.
+    /// </summary>
+    /// <remarks>
+    /// The thread exits once <see cref="_dispatch_exit" /> is set and all
+    /// events have been delivered.
+    /// </remarks>
+    void do_dispatch(void);
+
+    /// <summary>
+    /// Invokes the callback for <paramref name="event" /> on the
+    /// <see cref="_dispatch_thread" /> and tracks how long it took.
+    /// </summary>
+    /// <remarks>
+    /// Samples are only collected if they are delivered in batches, and the
+    /// batch is delivered once its end is invoked.
+    /// </remarks>
+    void invoke(_Inout_ dispatch_event& event);
+
+    /// <summary>
+    /// Starts the dispatch thread if the callbacks should be invoked
+    /// asynchronously.
+    /// </summary>
+    HRESULT start_dispatch(void) noexcept;
+
+    /// <summary>
+    /// Waits for the dispatch thread to deliver all events and to exit if
+    /// it is running.
+    /// </summary>
+    void stop_dispatch(void) noexcept;
+
+    std::vector<powenetics_sample> _batch;
+    powenetics_batch_callback _batch_callback;
+    powenetics_batch_configuration _batch_config;
+    counter_type _bytes_discarded;
+    counter_type _bytes_read;
     powenetics_data_callback _callback;
+    counter_type _callback_time_max;
+    counter_type _carry_overs;
+    powenetics_clock _clock;
     void *_context;
+    std::vector<powenetics_sample> _dispatch_batch;
+    powenetics_dispatch_configuration _dispatch_config;
+    counter_type _dispatch_depth;
+    counter_type _dispatch_depth_max;
+    std::atomic<bool> _dispatch_exit;
+    std::unique_ptr<overflow_queue<dispatch_event>> _dispatch_queue;
+    consumer_signal _dispatch_signal;
+    std::thread _dispatch_thread;
+    energy_integrator _energy;
+    std::uint64_t _energy_frequency;
+    mutable std::mutex _energy_lock;
     handle_type _handle;
+    std::promise<HRESULT> _launched;
+    powenetics_parser _parser;
+    std::atomic<connector_profile> _profile;
+    std::uint32_t _protocol;
+    std::unique_ptr<overflow_queue<powenetics_sample>> _queue;
+    consumer_signal _queue_signal;
+    bool _queued;
+    powenetics_raw_data_callback _raw_callback;
+    powenetics_reactor *_reactor;
+    powenetics_reader _reader;
+    counter_type _reads;
+    counter_type _samples_dropped;
+    counter_type _samples_missing;
+    counter_type _segments_parsed;
+    powenetics_segment_callback _segment_callback;
+    counter_type _segments_rejected;
+    counter_type _sequence_gaps;
+    std::unique_ptr<stream_session> _session;
+    session_factory _session_factory;
     std::atomic<stream_state> _state;
     std::thread _thread;
+    powenetics_thread_configuration _thread_config;
+    powenetics_timestamping _timestamping;
+#if !defined(_WIN32)
+    wake_event _wake;
+#endif /* !defined(_WIN32) */
 };
 
 #endif /* !defined(_LIBPOWENETICS_DEVICE_H) */
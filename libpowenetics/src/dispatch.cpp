@@ -0,0 +1,29 @@
+﻿// <copyright file="dispatch.cpp" company="Visualisierungsinstitut der Universität Stuttgart">
+// Copyright © 2026 Visualisierungsinstitut der Universität Stuttgart.
+// Licensed under the MIT licence. See LICENCE file for details.
+// </copyright>
+// <author>Christoph Müller</author>
+
+#include "libpowenetics/dispatch.h"
+
+
+/*
+ * ::powenetics_initialise_dispatch_configuration
+ */
+HRESULT LIBPOWENETICS_API powenetics_initialise_dispatch_configuration(
+        _In_ powenetics_dispatch_configuration *config) {
+    if (config == nullptr) {
+        return E_POINTER;
+    }
+
+    switch (config->version) {
+        case 2:
+            config->dispatch = powenetics_dispatch::synchronous;
+            config->capacity = 16384;
+            config->overflow = powenetics_overflow::drop_newest;
+            return S_OK;
+
+        default:
+            return E_INVALIDARG;
+    }
+}
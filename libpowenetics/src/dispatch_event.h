@@ -0,0 +1,155 @@
+﻿// <copyright file="dispatch_event.h" company="Visualisierungsinstitut der Universität Stuttgart">
+// Copyright © 2026 Visualisierungsinstitut der Universität Stuttgart.
+// Licensed under the MIT licence. See LICENCE file for details.
+// </copyright>
+// <author>Christoph Müller</author>
+
+#if !defined(_LIBPOWENETICS_DISPATCH_EVENT_H)
+#define _LIBPOWENETICS_DISPATCH_EVENT_H
+#pragma once
+
+#include <cinttypes>
+
+#include "libpowenetics/raw_sample.h"
+#include "libpowenetics/sample.h"
+#include "libpowenetics/segment.h"
+
+#include "overflow_queue.h"
+
+
+/// <summary>
+/// Identifies what a <see cref="dispatch_event" /> holds.
+/// </summary>
+enum class dispatch_kind : std::uint8_t {
+
+    /// <summary>
+    /// The event holds a <see cref="powenetics_sample" />, which is either
+    /// delivered on its own or appended to the batch being assembled.
+    /// </summary>
+    sample,
+
+    /// <summary>
+    /// The event holds a <see cref="powenetics_raw_sample" />.
+    /// </summary>
+    raw_sample,
+
+    /// <summary>
+    /// The event holds a <see cref="powenetics_segment" /> along with a copy
+    /// of its bytes.
+    /// </summary>
+    segment,
+
+    /// <summary>
+    /// The event marks that the batch assembled from the preceding samples
+    /// is complete and must be delivered.
+    /// </summary>
+    end_of_batch
+};
+
+
+/// <summary>
+/// The data the thread reading from a device hands over to the thread
+/// invoking the callbacks.
+/// </summary>
+/// <remarks>
+/// The event is trivially copyable, such that it can be transferred through
+/// an <see cref="overflow_queue" />.
+/// </remarks>
+struct dispatch_event final {
+
+    /// <summary>
+    /// A segment, whose bytes are only valid during the callback on the
+    /// thread reading from the device and must therefore be copied.
+    /// </summary>
+    struct segment_type {
+        powenetics_segment segment;
+        std::uint8_t data[POWENETICS_SEGMENT_LENGTH];
+    };
+
+    /// <summary>
+    /// Determines which member of the union is valid.
+    /// </summary>
+    dispatch_kind kind;
+
+    /// <summary>
+    /// Indicates that the end of a batch preceded the event, but has been
+    /// evicted from the queue, such that the batch must be delivered before
+    /// the event is processed.
+    /// </summary>
+    bool follows_end_of_batch;
+
+    union {
+        powenetics_raw_sample raw_sample;
+        powenetics_sample sample;
+        segment_type segment;
+    };
+};
+
+
+/// <summary>
+/// Answer how many samples are lost if <paramref name="event" /> is dropped
+/// from an <see cref="overflow_queue" />.
+/// </summary>
+/// <remarks>
+/// The end of a batch does not represent any data, so it is never
+/// decimated and not counted if it is dropped. Instead, the next event is
+/// made to carry it using <see cref="overflow_carry_marker" />.
+/// </remarks>
+inline std::uint64_t overflow_weight(
+        _In_ const dispatch_event& event) noexcept {
+    switch (event.kind) {
+        case dispatch_kind::sample:
+            return overflow_weight(event.sample);
+
+        case dispatch_kind::raw_sample:
+            return overflow_weight(event.raw_sample);
+
+        case dispatch_kind::segment:
+            return overflow_weight(event.segment.segment);
+
+        default:
+            return 0;
+    }
+}
+
+
+/// <summary>
+/// Marks <paramref name="cnt" /> dropped samples in the data held by
+/// <paramref name="event" />.
+/// </summary>
+/// <returns><c>true</c> if the event has been marked, <c>false</c> if it is
+/// the end of a batch, which cannot carry the mark.</returns>
+inline bool overflow_mark(_Inout_ dispatch_event& event,
+        _In_ const std::uint64_t cnt) noexcept {
+    switch (event.kind) {
+        case dispatch_kind::sample:
+            return overflow_mark(event.sample, cnt);
+
+        case dispatch_kind::raw_sample:
+            return overflow_mark(event.raw_sample, cnt);
+
+        case dispatch_kind::segment:
+            return overflow_mark(event.segment.segment, cnt);
+
+        default:
+            return false;
+    }
+}
+
+
+/// <summary>
+/// Makes <paramref name="event" /> carry the end of a batch that preceded it,
+/// but has been dropped from an <see cref="overflow_queue" />.
+/// </summary>
+/// <returns><c>true</c> if the event carries the end of the batch,
+/// <c>false</c> if it is the end of a batch itself.</returns>
+inline bool overflow_carry_marker(_Inout_ dispatch_event& event) noexcept {
+    if (event.kind == dispatch_kind::end_of_batch) {
+        return false;
+    }
+
+    event.follows_end_of_batch = true;
+    return true;
+}
+
+#endif /* !defined(_LIBPOWENETICS_DISPATCH_EVENT_H) */
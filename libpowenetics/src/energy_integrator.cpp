@@ -0,0 +1,151 @@
+﻿// <copyright file="energy_integrator.cpp" company="Visualisierungsinstitut der Universität Stuttgart">
+// Copyright © 2026 Visualisierungsinstitut der Universität Stuttgart.
+// Licensed under the MIT licence. See LICENCE file for details.
+// </copyright>
+// <author>Christoph Müller</author>
+
+#include "energy_integrator.h"
+
+#include <cassert>
+
+
+/*
+ * energy_integrator::multiply_add
+ */
+void energy_integrator::multiply_add(_Inout_ accumulator_type& dst,
+        _In_ const std::uint64_t lhs,
+        _In_ const std::uint64_t rhs) noexcept {
+    // Multiply the 32-bit halves, which cannot overflow, and propagate the
+    // carries of the partial products into the high word.
+    const std::uint64_t mask = 0xFFFFFFFF;
+    const auto ll = (lhs & mask) * (rhs & mask);
+    const auto lh = (lhs & mask) * (rhs >> 32);
+    const auto hl = (lhs >> 32) * (rhs & mask);
+    const auto hh = (lhs >> 32) * (rhs >> 32);
+    const auto mid = (ll >> 32) + (lh & mask) + (hl & mask);
+
+    const auto low = (mid << 32) | (ll & mask);
+    const auto high = hh + (lh >> 32) + (hl >> 32) + (mid >> 32);
+
+    dst.low += low;
+    dst.high += high + ((dst.low < low) ? 1 : 0);
+}
+
+
+/*
+ * energy_integrator::to_double
+ */
+double energy_integrator::to_double(
+        _In_ const accumulator_type& value) noexcept {
+    const double word = 18446744073709551616.0;
+    return static_cast<double>(value.high) * word
+        + static_cast<double>(value.low);
+}
+
+
+/*
+ * energy_integrator::energy_integrator
+ */
+energy_integrator::energy_integrator(void) noexcept {
+    this->reset();
+}
+
+
+/*
+ * energy_integrator::energy
+ */
+void energy_integrator::energy(_Inout_ powenetics_energy& dst,
+        _In_ const std::uint64_t frequency) const noexcept {
+    assert(dst.version == 2);
+    accumulator_type total = { 0, 0 };
+    for (auto& a : this->_accumulators) {
+        total.low += a.low;
+        total.high += a.high + ((total.low < a.low) ? 1 : 0);
+    }
+
+    // The sums are twice the energy in mV·mA·tick, ie µW·tick. The divisor
+    // is exact for all realistic clock rates, so the only rounding errors are
+    // the ones of the conversion of the sum and of the division.
+    const auto divisor = 2.0e6 * static_cast<double>(frequency);
+    auto joules = [divisor](const accumulator_type& value) {
+        return (divisor > 0.0) ? to_double(value) / divisor : 0.0;
+    };
+
+    dst.atx_12v = joules(this->_accumulators[0]);
+    dst.atx_3_3v = joules(this->_accumulators[1]);
+    dst.atx_5v = joules(this->_accumulators[2]);
+    dst.atx_stb = joules(this->_accumulators[3]);
+    dst.eps1 = joules(this->_accumulators[4]);
+    dst.eps2 = joules(this->_accumulators[5]);
+    dst.eps3 = joules(this->_accumulators[6]);
+    dst.pcie_12v1 = joules(this->_accumulators[7]);
+    dst.pcie_12v2 = joules(this->_accumulators[8]);
+    dst.pcie_12v3 = joules(this->_accumulators[9]);
+    dst.peg_12v = joules(this->_accumulators[10]);
+    dst.peg_3_3v = joules(this->_accumulators[11]);
+    dst.total = joules(total);
+    dst.duration = (frequency > 0)
+        ? static_cast<double>(this->_duration) / frequency
+        : 0.0;
+    dst.samples = this->_samples;
+}
+
+
+/*
+ * energy_integrator::integrate
+ */
+void energy_integrator::integrate(
+        _In_ const powenetics_raw_sample& sample) noexcept {
+    auto power = [&sample](const std::size_t rail) {
+        auto& reading = sample.*readings[rail];
+        return static_cast<std::uint64_t>(reading.voltage) * reading.current;
+    };
+
+    const auto dt = static_cast<std::uint64_t>(sample.timestamp)
+        - static_cast<std::uint64_t>(this->_timestamp);
+
+    if ((this->_samples == 0) || (sample.timestamp <= this->_timestamp)) {
+        // There is no interval to integrate, but the sample is the begin of
+        // the next one.
+        for (std::size_t r = 0; r < rails; ++r) {
+            this->_power[r] = power(r);
+        }
+
+    } else if (dt <= max_short_interval) {
+        for (std::size_t r = 0; r < rails; ++r) {
+            const auto p = power(r);
+            const auto v = (this->_power[r] + p) * dt;
+            auto& a = this->_accumulators[r];
+            a.low += v;
+            a.high += (a.low < v) ? 1 : 0;
+            this->_power[r] = p;
+        }
+        this->_duration += dt;
+
+    } else {
+        for (std::size_t r = 0; r < rails; ++r) {
+            const auto p = power(r);
+            multiply_add(this->_accumulators[r], this->_power[r] + p, dt);
+            this->_power[r] = p;
+        }
+        this->_duration += dt;
+    }
+
+    this->_timestamp = sample.timestamp;
+    ++this->_samples;
+}
+
+
+/*
+ * energy_integrator::reset
+ */
+void energy_integrator::reset(void) noexcept {
+    for (auto& a : this->_accumulators) {
+        a.low = 0;
+        a.high = 0;
+    }
+    this->_duration = 0;
+    this->_power.fill(0);
+    this->_samples = 0;
+    this->_timestamp = 0;
+}
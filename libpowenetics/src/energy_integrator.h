@@ -0,0 +1,179 @@
+﻿// <copyright file="energy_integrator.h" company="Visualisierungsinstitut der Universität Stuttgart">
+// Copyright © 2026 Visualisierungsinstitut der Universität Stuttgart.
+// Licensed under the MIT licence. See LICENCE file for details.
+// </copyright>
+// <author>Christoph Müller</author>
+
+#if !defined(_LIBPOWENETICS_ENERGY_INTEGRATOR_H)
+#define _LIBPOWENETICS_ENERGY_INTEGRATOR_H
+#pragma once
+
+#include <array>
+#include <cinttypes>
+
+#include "libpowenetics/api.h"
+#include "libpowenetics/energy.h"
+#include "libpowenetics/raw_sample.h"
+#include "libpowenetics/timestamp.h"
+
+
+/// <summary>
+/// Integrates the power of each rail over the timestamps of the raw samples
+/// in fixed-point arithmetic.
+/// </summary>
+/// <remarks>
+/// <para>The power of a rail is the product of the millivolt and milliampere
+/// readings, which is exact in 64 bits. The integrator applies the
+/// trapezoidal rule to consecutive samples, ie it adds the sum of the
+/// previous and the current power multiplied by the number of clock ticks
+/// between the samples. The sums are therefore twice the energy in units of
+/// mV·mA·tick.</para>
+/// <para>A 64-bit sum overflows within an hour of a single rail drawing a few
+/// hundred Watts if the timestamps are in units of 100ns, and much faster for
+/// the TSC, so the sums are 128-bit integers made of two 64-bit words. The
+/// product for a single interval normally fits into 64 bits, such that an
+/// update is a multiplication and an addition with carry per rail.</para>
+/// <para>The integrator does not allocate any memory.</para>
+/// </remarks>
+class LIBPOWENETICS_TEST_API energy_integrator final {
+
+public:
+
+    /// <summary>
+    /// A 128-bit unsigned integer.
+    /// </summary>
+    struct accumulator_type {
+
+        /// <summary>
+        /// The least significant 64 bits.
+        /// </summary>
+        std::uint64_t low;
+
+        /// <summary>
+        /// The most significant 64 bits.
+        /// </summary>
+        std::uint64_t high;
+    };
+
+    /// <summary>
+    /// The number of rails in a sample, in the order of the fields of
+    /// <see cref="powenetics_raw_sample" />.
+    /// </summary>
+    static constexpr std::size_t rails = 12;
+
+    /// <summary>
+    /// Adds the product of <paramref name="lhs" /> and
+    /// <paramref name="rhs" /> to <paramref name="dst" />.
+    /// </summary>
+    /// <param name="dst">The accumulator to add to.</param>
+    /// <param name="lhs">The first factor.</param>
+    /// <param name="rhs">The second factor.</param>
+    static void multiply_add(_Inout_ accumulator_type& dst,
+        _In_ const std::uint64_t lhs,
+        _In_ const std::uint64_t rhs) noexcept;
+
+    /// <summary>
+    /// Converts <paramref name="value" /> to floating point.
+    /// </summary>
+    /// <param name="value">The value to be converted.</param>
+    /// <returns>The nearest double to <paramref name="value" />.</returns>
+    static double to_double(_In_ const accumulator_type& value) noexcept;
+
+    /// <summary>
+    /// Initialises a new instance.
+    /// </summary>
+    energy_integrator(void) noexcept;
+
+    /// <summary>
+    /// Answer the sum of the given <paramref name="rail" />.
+    /// </summary>
+    /// <param name="rail">The index of the rail, which must be less than
+    /// <see cref="rails" />.</param>
+    /// <returns>Twice the energy of the rail in mV·mA·tick.</returns>
+    inline const accumulator_type& accumulator(
+            _In_ const std::size_t rail) const noexcept {
+        return this->_accumulators[rail];
+    }
+
+    /// <summary>
+    /// Answer the number of clock ticks that have been integrated.
+    /// </summary>
+    inline std::uint64_t duration(void) const noexcept {
+        return this->_duration;
+    }
+
+    /// <summary>
+    /// Converts the sums into Joules.
+    /// </summary>
+    /// <param name="dst">Receives the energy. The version of the structure
+    /// must have been validated by the caller.</param>
+    /// <param name="frequency">The number of ticks per second of the clock
+    /// the samples have been stamped with.</param>
+    void energy(_Inout_ powenetics_energy& dst,
+        _In_ const std::uint64_t frequency) const noexcept;
+
+    /// <summary>
+    /// Adds the interval between the previous sample and
+    /// <paramref name="sample" /> to the sums.
+    /// </summary>
+    /// <remarks>
+    /// The first sample only starts the integration. If the timestamp of
+    /// <paramref name="sample" /> is not later than the one of the previous
+    /// sample, the interval is skipped. Gaps in the sequence of samples are
+    /// bridged by linear interpolation of the power.
+    /// </remarks>
+    /// <param name="sample">The sample, of which the timestamp must have been
+    /// set.</param>
+    void integrate(_In_ const powenetics_raw_sample& sample) noexcept;
+
+    /// <summary>
+    /// Discards all sums.
+    /// </summary>
+    void reset(void) noexcept;
+
+    /// <summary>
+    /// Answer the number of samples that have been integrated.
+    /// </summary>
+    inline std::uint64_t samples(void) const noexcept {
+        return this->_samples;
+    }
+
+private:
+
+    /// <summary>
+    /// The largest number of ticks between two samples for which the product
+    /// with the sum of two powers is guaranteed to fit into 64 bits.
+    /// </summary>
+    /// <remarks>
+    /// A power is less than 2^40 as it is the product of a 16-bit and a
+    /// 24-bit reading, so the sum of two is less than 2^41.
+    /// </remarks>
+    static constexpr std::uint64_t max_short_interval = (1ull << 23) - 1;
+
+    /// <summary>
+    /// The readings of the rails in the order of the accumulators.
+    /// </summary>
+    static constexpr powenetics_raw_voltage_current powenetics_raw_sample::*
+    readings[rails] = {
+        &powenetics_raw_sample::atx_12v,
+        &powenetics_raw_sample::atx_3_3v,
+        &powenetics_raw_sample::atx_5v,
+        &powenetics_raw_sample::atx_stb,
+        &powenetics_raw_sample::eps1,
+        &powenetics_raw_sample::eps2,
+        &powenetics_raw_sample::eps3,
+        &powenetics_raw_sample::pcie_12v1,
+        &powenetics_raw_sample::pcie_12v2,
+        &powenetics_raw_sample::pcie_12v3,
+        &powenetics_raw_sample::peg_12v,
+        &powenetics_raw_sample::peg_3_3v
+    };
+
+    std::array<accumulator_type, rails> _accumulators;
+    std::uint64_t _duration;
+    std::array<std::uint64_t, rails> _power;
+    std::uint64_t _samples;
+    powenetics_timestamp _timestamp;
+};
+
+#endif /* !defined(_LIBPOWENETICS_ENERGY_INTEGRATOR_H) */
@@ -0,0 +1,44 @@
+﻿// <copyright file="framing_state.h" company="Visualisierungsinstitut der Universität Stuttgart">
+// Copyright © 2026 Visualisierungsinstitut der Universität Stuttgart.
+// Licensed under the MIT licence. See LICENCE file for details.
+// </copyright>
+// <author>Christoph Müller</author>
+
+#if !defined(_LIBPOWENETICS_FRAMING_STATE_H)
+#define _LIBPOWENETICS_FRAMING_STATE_H
+#pragma once
+
+
+/// <summary>
+/// Tracks how confident <see cref="stream_parser_v2" /> is that it knows the
+/// segment boundaries in the data stream.
+/// </summary>
+enum class framing_state {
+
+    /// <summary>
+    /// The parser has not seen a delimiter yet or lost track of the segments
+    /// and searches for the next delimiter.
+    /// </summary>
+    hunting,
+
+    /// <summary>
+    /// The parser has found a delimiter and checks whether the data following
+    /// it form segments of the expected length. The parser transitions to
+    /// <see cref="locked" /> once two consecutive segments have been framed
+    /// correctly and carry consecutive sequence numbers. While acquiring, the
+    /// parser holds back the last segment until the next one confirms its
+    /// sequence number.
+    /// </summary>
+    acquiring,
+
+    /// <summary>
+    /// The parser knows the segment boundaries and only checks that the
+    /// delimiter is where it is expected. If this check fails, the parser
+    /// falls back to <see cref="acquiring" /> and searches for the next
+    /// delimiter. A correctly framed segment that breaks the sequence is
+    /// delivered, because the device has skipped samples in this case.
+    /// </summary>
+    locked
+};
+
+#endif /* !defined(_LIBPOWENETICS_FRAMING_STATE_H) */
@@ -0,0 +1,417 @@
+﻿// <copyright file="io_reactor.cpp" company="Visualisierungsinstitut der Universität Stuttgart">
+// Copyright © 2026 Visualisierungsinstitut der Universität Stuttgart.
+// Licensed under the MIT licence. See LICENCE file for details.
+// </copyright>
+// <author>Christoph Müller</author>
+
+#include "io_reactor.h"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <chrono>
+#include <new>
+#include <system_error>
+#include <thread>
+
+#if defined(__linux__)
+#include <unistd.h>
+
+#include <sys/epoll.h>
+#endif /* defined(__linux__) */
+
+#include "debug.h"
+#include "device.h"
+#include "thread_name.h"
+#include "wake_event.h"
+
+
+#if defined(__linux__)
+/// <summary>
+/// The state of a single thread of the reactor.
+/// </summary>
+struct powenetics_reactor::worker final {
+
+    /// <summary>
+    /// The devices served by the thread, which is protected by the lock of
+    /// the reactor.
+    /// </summary>
+    std::vector<powenetics_device *> devices;
+
+    /// <summary>
+    /// The <c>epoll</c> instance the thread waits in.
+    /// </summary>
+    int epoll;
+
+    /// <summary>
+    /// Requests the thread to exit once <see cref="wake" /> is signalled.
+    /// </summary>
+    std::atomic<bool> exit;
+
+    /// <summary>
+    /// A copy of <see cref="devices" /> the thread iterates over without
+    /// holding the lock, such that callbacks can start and stop other devices.
+    /// </summary>
+    std::vector<powenetics_device *> snapshot;
+
+    /// <summary>
+    /// The thread itself.
+    /// </summary>
+    std::thread thread;
+
+    /// <summary>
+    /// The event that wakes the thread if devices need to be retired or if
+    /// the thread should exit.
+    /// </summary>
+    wake_event wake;
+
+    inline worker(void) noexcept : epoll(-1), exit(false) { }
+
+    inline ~worker(void) noexcept {
+        if (this->epoll != -1) {
+            ::close(this->epoll);
+        }
+    }
+};
+
+#else /* defined(__linux__) */
+/// <summary>
+/// Placeholder for platforms that do not support the reactor.
+/// </summary>
+struct powenetics_reactor::worker final { };
+#endif /* defined(__linux__) */
+
+
+/*
+ * powenetics_reactor::powenetics_reactor
+ */
+powenetics_reactor::powenetics_reactor(void) noexcept : _users(0) { }
+
+
+/*
+ * powenetics_reactor::~powenetics_reactor
+ */
+powenetics_reactor::~powenetics_reactor(void) noexcept {
+    assert(this->_users.load() == 0);
+    this->close();
+}
+
+
+/*
+ * powenetics_reactor::acquire
+ */
+void powenetics_reactor::acquire(void) noexcept {
+    this->_users.fetch_add(1, std::memory_order::memory_order_relaxed);
+}
+
+
+/*
+ * powenetics_reactor::attach
+ */
+HRESULT powenetics_reactor::attach(_In_ powenetics_device& device) noexcept {
+#if defined(__linux__)
+    assert(device.state() == stream_state::running);
+    std::lock_guard<std::mutex> l(this->_lock);
+
+    if (this->_workers.empty()) {
+        _powenetics_debug("The reactor has not been opened.\r\n");
+        return E_NOT_VALID_STATE;
+    }
+
+    // Assign the device to the thread that serves the fewest devices.
+    auto& w = **std::min_element(this->_workers.begin(),
+        this->_workers.end(),
+        [](const std::unique_ptr<worker>& lhs,
+                const std::unique_ptr<worker>& rhs) {
+            return (lhs->devices.size() < rhs->devices.size());
+        });
+
+    try {
+        w.devices.push_back(&device);
+    } catch (std::bad_alloc) {
+        _powenetics_debug("Insufficient memory for attaching device to "
+            "reactor.\r\n");
+        return E_OUTOFMEMORY;
+    }
+
+    // Once the device is in the epoll instance, the thread might serve it
+    // right away, so the device must have been added to the list before.
+    epoll_event event;
+    event.events = EPOLLIN;
+    event.data.ptr = &device;
+    if (::epoll_ctl(w.epoll, EPOLL_CTL_ADD, device.handle(), &event) != 0) {
+        auto retval = static_cast<HRESULT>(-errno);
+        _powenetics_debug("Adding the COM port to the reactor failed.\r\n");
+        w.devices.pop_back();
+        return retval;
+    }
+
+    return S_OK;
+
+#else /* defined(__linux__) */
+    return E_NOTIMPL;
+#endif /* defined(__linux__) */
+}
+
+
+/*
+ * powenetics_reactor::close
+ */
+HRESULT powenetics_reactor::close(void) noexcept {
+    if (this->_users.load(std::memory_order::memory_order_acquire) > 0) {
+        _powenetics_debug("The reactor cannot be closed while devices are "
+            "assigned to it.\r\n");
+        return E_NOT_VALID_STATE;
+    }
+
+#if defined(__linux__)
+    for (auto& w : this->_workers) {
+        w->exit.store(true, std::memory_order::memory_order_release);
+        w->wake.set();
+    }
+
+    for (auto& w : this->_workers) {
+        if (w->thread.joinable()) {
+            w->thread.join();
+        }
+    }
+#endif /* defined(__linux__) */
+
+    this->_workers.clear();
+    return S_OK;
+}
+
+
+/*
+ * powenetics_reactor::detach
+ */
+void powenetics_reactor::detach(_In_ powenetics_device& device) noexcept {
+#if defined(__linux__)
+    std::unique_lock<std::mutex> l(this->_lock);
+
+    // Wake the thread serving the device, which will notice that the device
+    // is not running anymore. If no thread serves the device, it has been
+    // retired already.
+    for (auto& w : this->_workers) {
+        auto& d = w->devices;
+        if (std::find(d.begin(), d.end(), &device) != d.end()) {
+            assert(device.state() != stream_state::running);
+            w->wake.set();
+            break;
+        }
+    }
+
+    this->_retired.wait(l, [&device](void) {
+        return (device.state() == stream_state::stopped);
+    });
+#endif /* defined(__linux__) */
+}
+
+
+/*
+ * powenetics_reactor::open
+ */
+HRESULT powenetics_reactor::open(_In_ const std::size_t threads) noexcept {
+#if defined(__linux__)
+    assert(threads > 0);
+
+    // Note: the reactor is opened before its handle is published, so nobody
+    // can attach a device while we are starting the threads.
+    if (!this->_workers.empty()) {
+        _powenetics_debug("The reactor has already been opened.\r\n");
+        return E_NOT_VALID_STATE;
+    }
+
+    auto retval = S_OK;
+
+    try {
+        this->_workers.reserve(threads);
+
+        for (std::size_t i = 0; (i < threads) && SUCCEEDED(retval); ++i) {
+            this->_workers.emplace_back(new worker());
+            auto& w = *this->_workers.back();
+
+            w.epoll = ::epoll_create1(EPOLL_CLOEXEC);
+            if (w.epoll == -1) {
+                retval = static_cast<HRESULT>(-errno);
+                _powenetics_debug("Creating the epoll instance of the reactor "
+                    "failed.\r\n");
+            }
+
+            if (SUCCEEDED(retval)) {
+                retval = w.wake.open();
+            }
+
+            // The wake-up event is the only descriptor in the epoll instance
+            // that is not associated with a device.
+            if (SUCCEEDED(retval)) {
+                epoll_event event;
+                event.events = EPOLLIN;
+                event.data.ptr = nullptr;
+                if (::epoll_ctl(w.epoll, EPOLL_CTL_ADD, w.wake.handle(),
+                        &event) != 0) {
+                    retval = static_cast<HRESULT>(-errno);
+                    _powenetics_debug("Adding the wake-up event to the "
+                        "reactor failed.\r\n");
+                }
+            }
+        }
+
+        if (SUCCEEDED(retval)) {
+            for (auto& w : this->_workers) {
+                w->thread = std::thread(&powenetics_reactor::run, this,
+                    std::ref(*w));
+            }
+        }
+
+    } catch (std::bad_alloc) {
+        _powenetics_debug("Insufficient memory for reactor threads.\r\n");
+        retval = E_OUTOFMEMORY;
+    } catch (std::system_error) {
+        _powenetics_debug("Failed to start reactor thread.\r\n");
+        retval = E_FAIL;
+    }
+
+    if (FAILED(retval)) {
+        // Stop the threads that are already running.
+        for (auto& w : this->_workers) {
+            w->exit.store(true, std::memory_order::memory_order_release);
+            w->wake.set();
+            if (w->thread.joinable()) {
+                w->thread.join();
+            }
+        }
+
+        this->_workers.clear();
+    }
+
+    return retval;
+
+#else /* defined(__linux__) */
+    _powenetics_debug("The reactor is only supported on Linux.\r\n");
+    return E_NOTIMPL;
+#endif /* defined(__linux__) */
+}
+
+
+/*
+ * powenetics_reactor::release
+ */
+void powenetics_reactor::release(void) noexcept {
+    assert(this->_users.load() > 0);
+    this->_users.fetch_sub(1, std::memory_order::memory_order_acq_rel);
+}
+
+
+/*
+ * powenetics_reactor::retire
+ */
+void powenetics_reactor::retire(_In_ worker& worker,
+        _In_ powenetics_device& device) {
+#if defined(__linux__)
+    {
+        std::lock_guard<std::mutex> l(this->_lock);
+        auto& d = worker.devices;
+        d.erase(std::remove(d.begin(), d.end(), &device), d.end());
+    }
+
+    // Remove the device from the epoll instance before it is stopped, because
+    // the handle might be closed right afterwards.
+    ::epoll_ctl(worker.epoll, EPOLL_CTL_DEL, device.handle(), nullptr);
+    device.retire();
+
+    // The device must not be accessed anymore from here on. Passing the lock
+    // ensures that a thread in 'detach' is either waiting or will see the new
+    // state when it checks the predicate.
+    { std::lock_guard<std::mutex> l(this->_lock); }
+    this->_retired.notify_all();
+#endif /* defined(__linux__) */
+}
+
+
+/*
+ * powenetics_reactor::run
+ */
+void powenetics_reactor::run(_In_ worker& worker) {
+#if defined(__linux__)
+    typedef std::chrono::steady_clock clock_type;
+    set_thread_name("powenetics reactor");
+
+    const std::chrono::milliseconds interval(
+        powenetics_device::housekeeping_interval);
+    std::vector<powenetics_device::byte_type> buffer(
+        powenetics_device::read_buffer_size);
+    std::array<epoll_event, max_events> events;
+    auto next = clock_type::now() + interval;
+
+    while (!worker.exit.load(std::memory_order::memory_order_acquire)) {
+        auto timeout = std::chrono::duration_cast<std::chrono::milliseconds>(
+            next - clock_type::now()).count();
+        if (timeout < 0) {
+            timeout = 0;
+        }
+
+        auto cnt = ::epoll_wait(worker.epoll, events.data(),
+            static_cast<int>(events.size()), static_cast<int>(timeout));
+        if (cnt < 0) {
+            if (errno != EINTR) {
+                _powenetics_debug("Waiting for the epoll instance of the "
+                    "reactor failed.\r\n");
+            }
+            cnt = 0;
+        }
+
+        // Serve all devices that have become readable. Devices that are not
+        // running anymore are retired below once all events are done.
+        auto scan = false;
+        for (int i = 0; i < cnt; ++i) {
+            auto device = static_cast<powenetics_device *>(
+                events[i].data.ptr);
+
+            if (device == nullptr) {
+                worker.wake.clear();
+                scan = true;
+
+            } else if (device->state() != stream_state::running) {
+                scan = true;
+
+            } else if ((events[i].events & EPOLLIN) == 0) {
+                // The port has been closed or the device has been unplugged.
+                _powenetics_debug("Polling the COM port failed.\r\n");
+                this->retire(worker, *device);
+
+            } else if (!device->serve(buffer.data(), buffer.size())) {
+                this->retire(worker, *device);
+            }
+        }
+
+        // Take a snapshot of the devices, because the callbacks invoked from
+        // here might start or stop other devices on the same reactor.
+        const auto now = clock_type::now();
+        const auto housekeeping = (now >= next);
+        if (housekeeping || scan) {
+            std::lock_guard<std::mutex> l(this->_lock);
+            worker.snapshot = worker.devices;
+        }
+
+        if (housekeeping) {
+            for (auto d : worker.snapshot) {
+                if (d->state() == stream_state::running) {
+                    d->housekeeping();
+                }
+            }
+
+            next = now + interval;
+            scan = true;
+        }
+
+        if (scan) {
+            for (auto d : worker.snapshot) {
+                if (d->state() == stream_state::stopping) {
+                    this->retire(worker, *d);
+                }
+            }
+        }
+    }
+#endif /* defined(__linux__) */
+}
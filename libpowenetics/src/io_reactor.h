@@ -0,0 +1,154 @@
+﻿// <copyright file="io_reactor.h" company="Visualisierungsinstitut der Universität Stuttgart">
+// Copyright © 2026 Visualisierungsinstitut der Universität Stuttgart.
+// Licensed under the MIT licence. See LICENCE file for details.
+// </copyright>
+// <author>Christoph Müller</author>
+
+#if !defined(_LIBPOWENETICS_IO_REACTOR_H)
+#define _LIBPOWENETICS_IO_REACTOR_H
+#pragma once
+
+#include <atomic>
+#include <cinttypes>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "libpowenetics/api.h"
+#include "libpowenetics/reactor.h"
+#include "libpowenetics/types.h"
+
+
+/// <summary>
+/// A fixed set of threads that read and parse the data of many devices.
+/// </summary>
+/// <remarks>
+/// <para>Each thread of the reactor waits for all devices it serves in a
+/// single <c>epoll</c> instance. Once a serial port becomes readable, the
+/// thread reads it once and passes the data to the session of the device,
+/// which delivers the samples to the callbacks of the device. Devices are
+/// assigned to the thread serving the fewest devices when streaming starts.
+/// </para>
+/// <para>Every <see cref="powenetics_device::housekeeping_interval" />, the
+/// threads let the sessions of all devices they serve do their housekeeping,
+/// such that statistics are published and batch windows are honoured even
+/// if a device does not send any data.</para>
+/// <para>The reactor is only available on Linux.</para>
+/// </remarks>
+struct LIBPOWENETICS_TEST_API powenetics_reactor final {
+
+public:
+
+    /// <summary>
+    /// Initialises a new instance, which must be <see cref="open" />ed before
+    /// it can serve any device.
+    /// </summary>
+    powenetics_reactor(void) noexcept;
+
+    powenetics_reactor(const powenetics_reactor&) = delete;
+
+    /// <summary>
+    /// Finalises the instance.
+    /// </summary>
+    ~powenetics_reactor(void) noexcept;
+
+    /// <summary>
+    /// Registers a device that will be served by the reactor, which prevents
+    /// the reactor from being closed until the device has been
+    /// <see cref="release" />d.
+    /// </summary>
+    void acquire(void) noexcept;
+
+    /// <summary>
+    /// Starts serving the given <paramref name="device" />.
+    /// </summary>
+    /// <remarks>
+    /// The session of the device must have been created and the device must
+    /// be <see cref="stream_state::running" />.
+    /// </remarks>
+    /// <param name="device">The device to be served.</param>
+    /// <returns><c>S_OK</c> in case of success, <c>E_NOTIMPL</c> if the
+    /// reactor is not supported on the platform, <c>E_NOT_VALID_STATE</c> if
+    /// the reactor is not open, a negative <c>errno</c> if the device could
+    /// not be added to the <c>epoll</c> instance.</returns>
+    HRESULT attach(_In_ powenetics_device& device) noexcept;
+
+    /// <summary>
+    /// Stops all threads of the reactor.
+    /// </summary>
+    /// <returns><c>S_OK</c> in case of success, <c>E_NOT_VALID_STATE</c> if
+    /// any device is still registered with the reactor.</returns>
+    HRESULT close(void) noexcept;
+
+    /// <summary>
+    /// Waits until the reactor has stopped serving the given
+    /// <paramref name="device" />.
+    /// </summary>
+    /// <remarks>
+    /// The caller must have requested the device to stop by transitioning it
+    /// to <see cref="stream_state::stopping" /> before, or the device must
+    /// have been retired due to an I/O error already. The method must not be
+    /// called from a callback that is running on the reactor.
+    /// </remarks>
+    /// <param name="device">The device to be detached.</param>
+    void detach(_In_ powenetics_device& device) noexcept;
+
+    /// <summary>
+    /// Starts the given number of threads.
+    /// </summary>
+    /// <param name="threads">The number of threads, which must be at least
+    /// one.</param>
+    /// <returns><c>S_OK</c> in case of success, <c>E_NOTIMPL</c> if the
+    /// reactor is not supported on the platform, <c>E_NOT_VALID_STATE</c> if
+    /// the reactor is already open, <c>E_OUTOFMEMORY</c> if the threads could
+    /// not be allocated, <c>E_FAIL</c> if a thread could not be started, or
+    /// a negative <c>errno</c> if creating the <c>epoll</c> instances failed.
+    /// </returns>
+    HRESULT open(_In_ const std::size_t threads) noexcept;
+
+    /// <summary>
+    /// Unregisters a device that has been <see cref="acquire" />d before.
+    /// </summary>
+    void release(void) noexcept;
+
+    /// <summary>
+    /// Answer the number of threads of the reactor.
+    /// </summary>
+    inline std::size_t threads(void) const noexcept {
+        return this->_workers.size();
+    }
+
+    powenetics_reactor& operator =(const powenetics_reactor&) = delete;
+
+private:
+
+    /// <summary>
+    /// The maximum number of events a thread retrieves at once.
+    /// </summary>
+    static constexpr std::size_t max_events = 64;
+
+    /// <summary>
+    /// The state of a single thread of the reactor.
+    /// </summary>
+    struct worker;
+
+    /// <summary>
+    /// Stops serving the given <paramref name="device" />, which must be
+    /// served by <paramref name="worker" />, and wakes any thread waiting in
+    /// <see cref="detach" />.
+    /// </summary>
+    void retire(_In_ worker& worker, _In_ powenetics_device& device);
+
+    /// <summary>
+    /// The method executed by the threads of the reactor.
+    /// </summary>
+    void run(_In_ worker& worker);
+
+    std::mutex _lock;
+    std::condition_variable _retired;
+    std::atomic<std::size_t> _users;
+    std::vector<std::unique_ptr<worker>> _workers;
+};
+
+#endif /* !defined(_LIBPOWENETICS_IO_REACTOR_H) */
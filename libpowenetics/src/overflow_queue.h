@@ -0,0 +1,290 @@
+﻿// <copyright file="overflow_queue.h" company="Visualisierungsinstitut der Universität Stuttgart">
+// Copyright © 2026 Visualisierungsinstitut der Universität Stuttgart.
+// Licensed under the MIT licence. See LICENCE file for details.
+// </copyright>
+// <author>Christoph Müller</author>
+
+#if !defined(_LIBPOWENETICS_OVERFLOW_QUEUE_H)
+#define _LIBPOWENETICS_OVERFLOW_QUEUE_H
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <cinttypes>
+#include <limits>
+
+#include "libpowenetics/api.h"
+#include "libpowenetics/overflow.h"
+#include "libpowenetics/types.h"
+
+#include "consumer_signal.h"
+#include "spsc_queue.h"
+
+
+/// <summary>
+/// Answer how many samples are lost if <paramref name="element" /> is
+/// dropped, which is the element itself and the ones that have been dropped
+/// before it.
+/// </summary>
+/// <remarks>
+/// This overload covers the public sample and segment types. Elements that
+/// do not represent data, which are called markers, must provide an
+/// overload returning zero, which makes the <see cref="overflow_queue" />
+/// never decimate them and never count them as dropped.
+/// </remarks>
+template<class TSample>
+inline std::uint64_t overflow_weight(_In_ const TSample& element) noexcept {
+    return element.dropped + static_cast<std::uint64_t>(1);
+}
+
+
+/// <summary>
+/// Adds <paramref name="cnt" /> to the number of dropped samples marked in
+/// <paramref name="element" />, saturating if the counter overflows.
+/// </summary>
+/// <returns><c>true</c> if the element has been marked, <c>false</c> if it
+/// cannot carry the mark.</returns>
+template<class TSample>
+inline bool overflow_mark(_Inout_ TSample& element,
+        _In_ const std::uint64_t cnt) noexcept {
+    typedef decltype(element.dropped) counter_type;
+    const std::uint64_t max = (std::numeric_limits<counter_type>::max)();
+    element.dropped = static_cast<counter_type>((std::min)(max,
+        element.dropped + cnt));
+    return true;
+}
+
+
+/// <summary>
+/// Makes <paramref name="element" /> carry a marker that preceded it, but
+/// has been dropped.
+/// </summary>
+/// <remarks>
+/// This overload covers the public sample and segment types, which cannot
+/// carry markers, because they are never queued along with markers.
+/// </remarks>
+/// <returns><c>true</c> if the element carries the marker, <c>false</c> if
+/// it cannot carry it.</returns>
+template<class TSample>
+inline bool overflow_carry_marker(_Inout_ TSample&) noexcept {
+    return false;
+}
+
+
+/// <summary>
+/// An <see cref="spsc_queue" /> that applies a
+/// <see cref="powenetics_overflow" /> policy if the consumer falls behind.
+/// </summary>
+/// <remarks>
+/// <para>Each element that is dropped is counted, and the count is marked in
+/// the next element that is handed to the consumer, such that the consumer
+/// knows where the gaps are. The producer marks the elements it drops itself
+/// in the next element it adds. For
+/// <see cref="powenetics_overflow::drop_oldest" />, the producer evicts the
+/// oldest elements from the queue and hands their count over to the
+/// consumer, which marks them in the next element it returns.</para>
+/// <para>Markers that are dropped are not counted, but carried by the next
+/// element representing data that is handed to the consumer, unless another
+/// marker comes first. Therefore, the consumer sees every marker at the same
+/// position relative to the data it receives.</para>
+/// <para>All memory is allocated in the constructor, so the queue never
+/// grows no matter how far the consumer falls behind.</para>
+/// </remarks>
+/// <typeparam name="TElement">The type of the elements, which must be
+/// trivially copyable and for which <see cref="overflow_weight" /> and
+/// <see cref="overflow_mark" /> must be callable.</typeparam>
+template<class TElement> class overflow_queue final {
+
+public:
+
+    /// <summary>
+    /// The type of the elements in the queue.
+    /// </summary>
+    typedef TElement value_type;
+
+    /// <summary>
+    /// The interval in milliseconds in which a producer waiting for room
+    /// re-evaluates whether it may continue to wait.
+    /// </summary>
+    static constexpr int wait_interval = 100;
+
+    /// <summary>
+    /// Initialises a new instance.
+    /// </summary>
+    /// <param name="capacity">The minimum number of elements the queue can
+    /// hold, which is rounded up to the next power of two.</param>
+    /// <param name="policy">Determines what happens if the queue is full.
+    /// </param>
+    /// <param name="data">The signal the consumer waits on while the queue
+    /// is empty. The producer notifies it before it waits for room, because
+    /// it might have filled the queue without notifying the consumer yet.
+    /// The signal must live at least as long as the queue.</param>
+    /// <exception cref="std::bad_alloc">If the memory for the elements could
+    /// not be allocated.</exception>
+    overflow_queue(_In_ const std::size_t capacity,
+        _In_ const powenetics_overflow policy,
+        _In_ consumer_signal& data);
+
+    overflow_queue(const overflow_queue&) = delete;
+
+    /// <summary>
+    /// Answer the number of elements the consumer finds at most in the queue.
+    /// </summary>
+    /// <remarks>
+    /// For <see cref="powenetics_overflow::drop_oldest" />, the queue
+    /// reserves twice the capacity, which allows the producer to evict
+    /// elements while the consumer is copying others.
+    /// </remarks>
+    inline std::size_t capacity(void) const noexcept {
+        return this->_capacity;
+    }
+
+    /// <summary>
+    /// Answer whether the queue is empty.
+    /// </summary>
+    inline bool empty(void) const noexcept {
+        return this->_queue.empty();
+    }
+
+    /// <summary>
+    /// Answer the policy that is applied if the queue is full.
+    /// </summary>
+    inline powenetics_overflow policy(void) const noexcept {
+        return this->_policy;
+    }
+
+    /// <summary>
+    /// Removes up to <paramref name="cnt" /> elements from the queue and
+    /// copies them to <paramref name="dst" />.
+    /// </summary>
+    /// <remarks>
+    /// This method must only be called by the consumer thread.
+    /// </remarks>
+    /// <param name="dst">A buffer that is able to hold at least
+    /// <paramref name="cnt" /> elements.</param>
+    /// <param name="cnt">The maximum number of elements to remove.</param>
+    /// <param name="dropped">Receives the number of elements the producer
+    /// has evicted since the previous call.</param>
+    /// <returns>The number of elements that have been copied to
+    /// <paramref name="dst" />.</returns>
+    std::size_t pop(_Out_writes_(cnt) value_type *dst,
+        _In_ const std::size_t cnt,
+        _Out_ std::uint64_t& dropped) noexcept;
+
+    /// <summary>
+    /// Adds <paramref name="element" /> to the queue unless the policy
+    /// decides to drop it.
+    /// </summary>
+    /// <remarks>
+    /// <para>This method must only be called by the producer thread.</para>
+    /// <para>For <see cref="powenetics_overflow::drop_oldest" />, the method
+    /// evicts the oldest elements until there is room. The element is only
+    /// dropped if the consumer is copying the elements that would need to be
+    /// evicted.</para>
+    /// </remarks>
+    /// <param name="element">The element to be added.</param>
+    /// <param name="may_wait">A function answering whether the producer may
+    /// (still) wait for room in the queue. This is only evaluated for
+    /// <see cref="powenetics_overflow::block" />.</param>
+    /// <returns><c>true</c> if the element has been added, <c>false</c> if
+    /// it has been dropped.</returns>
+    template<class TPredicate>
+    bool push(_In_ const value_type& element, _In_ TPredicate may_wait);
+
+    /// <summary>
+    /// Answer the number of elements in the queue.
+    /// </summary>
+    inline std::size_t size(void) const noexcept {
+        return this->_queue.size();
+    }
+
+    overflow_queue& operator =(const overflow_queue&) = delete;
+
+private:
+
+    /// <summary>
+    /// The state of one side of the queue, which is only accessed by the side
+    /// itself.
+    /// </summary>
+    struct alignas(64) side {
+
+        /// <summary>
+        /// The number of markers dropped by this side that have not yet been
+        /// carried by an element.
+        /// </summary>
+        std::uint64_t markers;
+
+        /// <summary>
+        /// The number of samples dropped by this side that have not yet been
+        /// marked in an element.
+        /// </summary>
+        std::uint64_t pending;
+
+        /// <summary>
+        /// The number of elements the producer has seen since the queue
+        /// became more than half full, which selects the ones retained for
+        /// <see cref="powenetics_overflow::decimate" />.
+        /// </summary>
+        std::uint64_t phase;
+    };
+
+    /// <summary>
+    /// The number of elements, markers and samples the producer has evicted
+    /// for <see cref="powenetics_overflow::drop_oldest" />, which have not yet
+    /// been handed over to the consumer.
+    /// </summary>
+    struct alignas(64) eviction {
+        std::atomic<std::uint64_t> elements;
+        std::atomic<std::uint64_t> markers;
+        std::atomic<std::uint64_t> samples;
+    };
+
+    /// <summary>
+    /// Counts an element the producer has dropped.
+    /// </summary>
+    void drop(_In_ const value_type& element) noexcept;
+
+    /// <summary>
+    /// Evicts the oldest elements from the <see cref="_queue" /> until it
+    /// has room for another element.
+    /// </summary>
+    /// <returns><c>true</c> if there is room, <c>false</c> if the elements
+    /// could not be evicted.</returns>
+    bool make_room(void) noexcept;
+
+    /// <summary>
+    /// Marks the samples and markers dropped by <paramref name="state" /> in
+    /// the first of the given elements that can carry them.
+    /// </summary>
+    static void mark(_Inout_updates_(cnt) value_type *elements,
+        _In_ const std::size_t cnt,
+        _Inout_ side& state) noexcept;
+
+    /// <summary>
+    /// Adds <paramref name="element" /> to the <see cref="_queue" /> and
+    /// marks the samples and markers the producer has dropped before in it.
+    /// </summary>
+    bool try_push(_In_ const value_type& element) noexcept;
+
+    std::size_t _capacity;
+    side _consumer;
+    consumer_signal& _data;
+    eviction _evicted;
+    powenetics_overflow _policy;
+    side _producer;
+    spsc_queue<value_type> _queue;
+
+    /// <summary>
+    /// Allows the producer to sleep while the queue is full for
+    /// <see cref="powenetics_overflow::block" />, in which case the roles of
+    /// producer and consumer are swapped for the signal.
+    /// </summary>
+    consumer_signal _space;
+};
+
+
+#include "overflow_queue.inl"
+
+#endif /* !defined(_LIBPOWENETICS_OVERFLOW_QUEUE_H) */
@@ -0,0 +1,226 @@
+﻿// <copyright file="overflow_queue.inl" company="Visualisierungsinstitut der Universität Stuttgart">
+// Copyright © 2026 Visualisierungsinstitut der Universität Stuttgart.
+// Licensed under the MIT licence. See LICENCE file for details.
+// </copyright>
+// <author>Christoph Müller</author>
+
+
+/*
+ * overflow_queue<TElement>::overflow_queue
+ */
+template<class TElement>
+overflow_queue<TElement>::overflow_queue(_In_ const std::size_t capacity,
+        _In_ const powenetics_overflow policy,
+        _In_ consumer_signal& data)
+    : _data(data),
+    _policy(policy),
+    _queue((policy == powenetics_overflow::drop_oldest)
+        ? 2 * (std::max)(capacity, static_cast<std::size_t>(1))
+        : capacity) {
+    this->_capacity = (policy == powenetics_overflow::drop_oldest)
+        ? this->_queue.capacity() / 2
+        : this->_queue.capacity();
+    this->_consumer.markers = 0;
+    this->_consumer.pending = 0;
+    this->_consumer.phase = 0;
+    this->_evicted.elements.store(0, std::memory_order::memory_order_relaxed);
+    this->_evicted.markers.store(0, std::memory_order::memory_order_relaxed);
+    this->_evicted.samples.store(0, std::memory_order::memory_order_relaxed);
+    this->_producer.markers = 0;
+    this->_producer.pending = 0;
+    this->_producer.phase = 0;
+}
+
+
+/*
+ * overflow_queue<TElement>::pop
+ */
+template<class TElement>
+std::size_t overflow_queue<TElement>::pop(_Out_writes_(cnt) value_type *dst,
+        _In_ const std::size_t cnt,
+        _Out_ std::uint64_t& dropped) noexcept {
+    auto& me = this->_consumer;
+    const auto retval = this->_queue.pop(dst, cnt);
+    dropped = 0;
+
+    if (this->_policy == powenetics_overflow::drop_oldest) {
+        // Take over what the producer has evicted before we took the
+        // elements, such that the gap is marked in front of them. If the
+        // producer is about to publish an eviction, the gap is marked in the
+        // next batch we take.
+        const auto order = std::memory_order::memory_order_acquire;
+        dropped = this->_evicted.elements.exchange(0, order);
+        me.markers += this->_evicted.markers.exchange(0, order);
+        me.pending += this->_evicted.samples.exchange(0, order);
+    }
+
+    overflow_queue::mark(dst, retval, me);
+
+    if ((this->_policy == powenetics_overflow::block) && (retval > 0)) {
+        this->_space.notify();
+    }
+
+    return retval;
+}
+
+
+/*
+ * overflow_queue<TElement>::push
+ */
+template<class TElement>
+template<class TPredicate>
+bool overflow_queue<TElement>::push(_In_ const value_type& element,
+        _In_ TPredicate may_wait) {
+    auto& me = this->_producer;
+    const auto weight = overflow_weight(element);
+
+    if ((this->_policy == powenetics_overflow::decimate) && (weight > 0)) {
+        // Retain every second sample while the queue is more than half full,
+        // starting with the first one that arrives.
+        if (this->_queue.size() > this->_capacity / 2) {
+            if ((me.phase++ & 1) != 0) {
+                me.pending += weight;
+                return false;
+            }
+        } else {
+            me.phase = 0;
+        }
+    }
+
+    if ((this->_policy == powenetics_overflow::drop_oldest)
+            && !this->make_room()) {
+        this->drop(element);
+        return false;
+    }
+
+    auto retval = this->try_push(element);
+
+    while (!retval && (this->_policy == powenetics_overflow::block)
+            && may_wait()) {
+        this->_data.notify();
+        this->_space.wait(std::chrono::milliseconds(wait_interval),
+                [this, &may_wait](void) {
+            return ((this->_queue.size() < this->_queue.capacity())
+                || !may_wait());
+        });
+        retval = this->try_push(element);
+    }
+
+    if (!retval) {
+        this->drop(element);
+    }
+
+    return retval;
+}
+
+
+/*
+ * overflow_queue<TElement>::drop
+ */
+template<class TElement>
+void overflow_queue<TElement>::drop(_In_ const value_type& element) noexcept {
+    const auto weight = overflow_weight(element);
+    if (weight > 0) {
+        this->_producer.pending += weight;
+    } else {
+        ++this->_producer.markers;
+    }
+}
+
+
+/*
+ * overflow_queue<TElement>::make_room
+ */
+template<class TElement>
+bool overflow_queue<TElement>::make_room(void) noexcept {
+    std::uint64_t elements = 0;
+    std::uint64_t markers = 0;
+    std::uint64_t samples = 0;
+    value_type evicted;
+
+    // The queue reserves twice the capacity, but we must not use more than
+    // the capacity in order to evict safely. If the eviction fails, the
+    // consumer has either made room or is still copying the elements we
+    // would need to evict.
+    while (this->_queue.size() >= this->_capacity) {
+        if (!this->_queue.evict(evicted)) {
+            break;
+        }
+
+        // Markers like the end of a batch are not counted as dropped, but
+        // the consumer must learn about them in order to carry them over to
+        // the next element it receives.
+        const auto weight = overflow_weight(evicted);
+        if (weight > 0) {
+            ++elements;
+            samples += weight;
+        } else {
+            ++markers;
+        }
+    }
+
+    if ((elements > 0) || (markers > 0)) {
+        const auto order = std::memory_order::memory_order_release;
+        this->_evicted.samples.fetch_add(samples, order);
+        this->_evicted.markers.fetch_add(markers, order);
+        this->_evicted.elements.fetch_add(elements, order);
+    }
+
+    return (this->_queue.size() < this->_capacity);
+}
+
+
+/*
+ * overflow_queue<TElement>::mark
+ */
+template<class TElement>
+void overflow_queue<TElement>::mark(_Inout_updates_(cnt) value_type *elements,
+        _In_ const std::size_t cnt,
+        _Inout_ side& state) noexcept {
+    for (std::size_t i = 0; (i < cnt)
+            && ((state.markers > 0) || (state.pending > 0)); ++i) {
+        auto& element = elements[i];
+
+        if (overflow_weight(element) == 0) {
+            // A marker that has not been dropped makes up for the ones that
+            // have been dropped before it.
+            state.markers = 0;
+            continue;
+        }
+
+        if ((state.markers > 0) && overflow_carry_marker(element)) {
+            state.markers = 0;
+        }
+
+        if ((state.pending > 0) && overflow_mark(element, state.pending)) {
+            state.pending = 0;
+        }
+    }
+}
+
+
+/*
+ * overflow_queue<TElement>::try_push
+ */
+template<class TElement>
+bool overflow_queue<TElement>::try_push(
+        _In_ const value_type& element) noexcept {
+    auto& me = this->_producer;
+
+    if ((me.markers > 0) || (me.pending > 0)) {
+        // Only forget about what we have dropped if the marked element has
+        // actually been added.
+        auto marked = element;
+        auto state = me;
+        overflow_queue::mark(&marked, 1, state);
+
+        const auto retval = this->_queue.push(marked);
+        if (retval) {
+            me.markers = state.markers;
+            me.pending = state.pending;
+        }
+        return retval;
+    }
+
+    return this->_queue.push(element);
+}
@@ -15,6 +15,7 @@
 #include "commands.h"
 #include "debug.h"
 #include "device.h"
+#include "sample_version.h"
 #include "thread_name.h"
 
 
@@ -44,6 +45,75 @@ HRESULT powenetics_close(_In_ const powenetics_handle handle) {
 }
 
 
+/*
+ * ::powenetics_get_connector_profile
+ */
+HRESULT powenetics_get_connector_profile(_In_ const powenetics_handle handle,
+        _Inout_ powenetics_connector_profile *profile) {
+    if (handle == nullptr) {
+        return E_HANDLE;
+    }
+    if (profile == nullptr) {
+        return E_POINTER;
+    }
+
+    switch (profile->version) {
+        case 2:
+            handle->profile(*profile);
+            return S_OK;
+
+        default:
+            return E_INVALIDARG;
+    }
+}
+
+
+/*
+ * ::powenetics_get_energy
+ */
+HRESULT powenetics_get_energy(_In_ const powenetics_handle handle,
+        _Inout_ powenetics_energy *energy) {
+    if (handle == nullptr) {
+        return E_HANDLE;
+    }
+    if (energy == nullptr) {
+        return E_POINTER;
+    }
+
+    switch (energy->version) {
+        case 2:
+            handle->energy(*energy);
+            return S_OK;
+
+        default:
+            return E_INVALIDARG;
+    }
+}
+
+
+/*
+ * ::powenetics_get_statistics
+ */
+HRESULT powenetics_get_statistics(_In_ const powenetics_handle handle,
+        _Inout_ powenetics_statistics *statistics) {
+    if (handle == nullptr) {
+        return E_HANDLE;
+    }
+    if (statistics == nullptr) {
+        return E_POINTER;
+    }
+
+    switch (statistics->version) {
+        case 2:
+            handle->statistics(*statistics);
+            return S_OK;
+
+        default:
+            return E_INVALIDARG;
+    }
+}
+
+
 /*
  * ::powenetics_open
  */
@@ -232,6 +302,28 @@ HRESULT LIBPOWENETICS_API powenetics_probe(
 }
 
 
+/*
+ * ::powenetics_read_samples
+ */
+HRESULT powenetics_read_samples(_In_ const powenetics_handle handle,
+        _Inout_updates_(*cnt) powenetics_sample *dst,
+        _Inout_ size_t *cnt,
+        _In_ const uint32_t timeout) {
+    if (handle == nullptr) {
+        return E_HANDLE;
+    }
+    if ((dst == nullptr) || (cnt == nullptr)) {
+        return E_POINTER;
+    }
+    if (!::is_sample_version(dst->version)) {
+        _powenetics_debug("Unsupported version of sample buffer.\r\n");
+        return E_INVALIDARG;
+    }
+
+    return handle->read_samples(dst, *cnt, timeout);
+}
+
+
 /*
  * powenetics_reset_calibration
  */
@@ -242,6 +334,120 @@ HRESULT powenetics_reset_calibration(_In_ const powenetics_handle handle) {
 }
 
 
+/*
+ * ::powenetics_set_clock
+ */
+HRESULT powenetics_set_clock(_In_ const powenetics_handle handle,
+        _In_ const powenetics_clock clock) {
+    return (handle == nullptr)
+        ? E_HANDLE
+        : handle->clock(clock);
+}
+
+
+/*
+ * ::powenetics_set_dispatch
+ */
+HRESULT powenetics_set_dispatch(_In_ const powenetics_handle handle,
+        _In_opt_ const powenetics_dispatch_configuration *config) {
+    if (handle == nullptr) {
+        return E_HANDLE;
+    }
+
+    powenetics_dispatch_configuration dft_conf;
+    if (config == nullptr) {
+        dft_conf.version = 2;
+        auto retval = powenetics_initialise_dispatch_configuration(&dft_conf);
+        if (retval != S_OK) {
+            _powenetics_debug("Failed to initialise default dispatch "
+                "configuration.\r\n");
+            return retval;
+        }
+
+        config = &dft_conf;
+    }
+
+    if (config->version != 2) {
+        _powenetics_debug("Unsupported version of dispatch "
+            "configuration.\r\n");
+        return E_INVALIDARG;
+    }
+
+    return handle->dispatch(*config);
+}
+
+
+/*
+ * ::powenetics_set_parser
+ */
+HRESULT powenetics_set_parser(_In_ const powenetics_handle handle,
+        _In_ const powenetics_parser parser) {
+    return (handle == nullptr)
+        ? E_HANDLE
+        : handle->parser(parser);
+}
+
+
+/*
+ * ::powenetics_set_reactor
+ */
+HRESULT powenetics_set_reactor(_In_ const powenetics_handle handle,
+        _In_opt_ const powenetics_reactor_handle reactor) {
+    return (handle == nullptr)
+        ? E_HANDLE
+        : handle->reactor(reactor);
+}
+
+
+/*
+ * ::powenetics_set_reader
+ */
+HRESULT powenetics_set_reader(_In_ const powenetics_handle handle,
+        _In_ const powenetics_reader reader) {
+    return (handle == nullptr)
+        ? E_HANDLE
+        : handle->reader(reader);
+}
+
+
+/*
+ * ::powenetics_set_thread_configuration
+ */
+HRESULT powenetics_set_thread_configuration(
+        _In_ const powenetics_handle handle,
+        _In_opt_ const powenetics_thread_configuration *config) {
+    if (handle == nullptr) {
+        return E_HANDLE;
+    }
+
+    powenetics_thread_configuration dft_conf;
+    if (config == nullptr) {
+        dft_conf.version = 2;
+        auto retval = powenetics_initialise_thread_configuration(&dft_conf);
+        if (retval != S_OK) {
+            _powenetics_debug("Failed to initialise default thread "
+                "configuration.\r\n");
+            return retval;
+        }
+
+        config = &dft_conf;
+    }
+
+    return handle->thread_configuration(*config);
+}
+
+
+/*
+ * ::powenetics_set_timestamping
+ */
+HRESULT powenetics_set_timestamping(_In_ const powenetics_handle handle,
+        _In_ const powenetics_timestamping timestamping) {
+    return (handle == nullptr)
+        ? E_HANDLE
+        : handle->timestamping(timestamping);
+}
+
+
 /*
  * ::powenetics_start_streaming
  */
@@ -254,6 +460,96 @@ HRESULT powenetics_start_streaming(_In_ const powenetics_handle handle,
 }
 
 
+/*
+ * ::powenetics_start_streaming_batched
+ */
+HRESULT powenetics_start_streaming_batched(
+        _In_ const powenetics_handle handle,
+        _In_ const powenetics_batch_callback callback,
+        _In_opt_ void *context,
+        _In_opt_ const powenetics_batch_configuration *config) {
+    if (handle == nullptr) {
+        return E_HANDLE;
+    }
+
+    powenetics_batch_configuration dft_conf;
+    if (config == nullptr) {
+        dft_conf.version = 2;
+        auto retval = powenetics_initialise_batch_configuration(&dft_conf);
+        if (retval != S_OK) {
+            _powenetics_debug("Failed to initialise default batch "
+                "configuration.\r\n");
+            return retval;
+        }
+
+        config = &dft_conf;
+    }
+
+    if (config->version != 2) {
+        _powenetics_debug("Unsupported version of batch configuration.\r\n");
+        return E_INVALIDARG;
+    }
+
+    return handle->start(callback, context, *config);
+}
+
+
+/*
+ * ::powenetics_start_streaming_queued
+ */
+HRESULT powenetics_start_streaming_queued(_In_ const powenetics_handle handle,
+        _In_opt_ const powenetics_queue_configuration *config) {
+    if (handle == nullptr) {
+        return E_HANDLE;
+    }
+
+    powenetics_queue_configuration dft_conf;
+    if (config == nullptr) {
+        dft_conf.version = 2;
+        auto retval = powenetics_initialise_queue_configuration(&dft_conf);
+        if (retval != S_OK) {
+            _powenetics_debug("Failed to initialise default queue "
+                "configuration.\r\n");
+            return retval;
+        }
+
+        config = &dft_conf;
+    }
+
+    if (config->version != 2) {
+        _powenetics_debug("Unsupported version of queue configuration.\r\n");
+        return E_INVALIDARG;
+    }
+
+    return handle->start(*config);
+}
+
+
+/*
+ * ::powenetics_start_streaming_raw
+ */
+HRESULT powenetics_start_streaming_raw(_In_ const powenetics_handle handle,
+        _In_ const powenetics_raw_data_callback callback,
+        _In_opt_ void *context) {
+    return (handle == nullptr)
+        ? E_HANDLE
+        : handle->start(callback, context);
+}
+
+
+/*
+ * ::powenetics_start_streaming_segments
+ */
+HRESULT powenetics_start_streaming_segments(
+        _In_ const powenetics_handle handle,
+        _In_ const powenetics_segment_callback callback,
+        _In_opt_ void *context) {
+    return (handle == nullptr)
+        ? E_HANDLE
+        : handle->start(callback, context);
+}
+
+
 /*
  * ::powenetics_stop_streaming
  */
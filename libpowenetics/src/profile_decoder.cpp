@@ -0,0 +1,180 @@
+﻿// <copyright file="profile_decoder.cpp" company="Visualisierungsinstitut der Universität Stuttgart">
+// Copyright © 2026 Visualisierungsinstitut der Universität Stuttgart.
+// Licensed under the MIT licence. See LICENCE file for details.
+// </copyright>
+// <author>Christoph Müller</author>
+
+#include "profile_decoder.h"
+
+#include <cassert>
+
+
+/// <summary>
+/// The voltage in millivolts which must be exceeded for the current of a
+/// channel to be valid.
+/// </summary>
+static constexpr std::uint16_t discard_threshold = 1000;
+
+
+/// <summary>
+/// Answer the offset of the one-based <paramref name="channel" /> from the
+/// begin of a segment.
+/// </summary>
+static constexpr std::size_t offset(_In_ const std::size_t channel) noexcept {
+    return sizeof(std::uint16_t) + 5 * (channel - 1);
+}
+
+
+/// <summary>
+/// Reads the big-endian voltage of the channel starting at
+/// <paramref name="data" />.
+/// </summary>
+static inline std::uint16_t read_voltage(
+        _In_reads_(5) const std::uint8_t *data) noexcept {
+    return static_cast<std::uint16_t>((data[0] << 8) | data[1]);
+}
+
+
+/// <summary>
+/// Reads the big-endian 24-bit current of the channel starting at
+/// <paramref name="data" />.
+/// </summary>
+static inline std::uint32_t read_current(
+        _In_reads_(5) const std::uint8_t *data) noexcept {
+    return (static_cast<std::uint32_t>(data[2]) << 16)
+        | (static_cast<std::uint32_t>(data[3]) << 8)
+        | data[4];
+}
+
+
+/// <summary>
+/// Reads a channel the profile does not make any assumptions about, clearing
+/// the current without a branch if the voltage is too low.
+/// </summary>
+static inline powenetics_raw_voltage_current read_checked(
+        _In_reads_(5) const std::uint8_t *data) noexcept {
+    powenetics_raw_voltage_current retval;
+    retval.voltage = read_voltage(data);
+    const auto valid = 0u - static_cast<std::uint32_t>(
+        retval.voltage > discard_threshold);
+    retval.current = read_current(data) & valid;
+    return retval;
+}
+
+
+/// <summary>
+/// Reads a channel of which the profile determines whether it is supplied.
+/// </summary>
+template<bool Supplied>
+static inline powenetics_raw_voltage_current read_profiled(
+        _In_reads_(5) const std::uint8_t *data) noexcept {
+    powenetics_raw_voltage_current retval;
+    retval.voltage = read_voltage(data);
+    retval.current = Supplied ? read_current(data) : 0;
+    return retval;
+}
+
+
+/// <summary>
+/// Decodes the channels of <paramref name="segment" /> with the channel
+/// mapping fixed for <typeparamref name="Profile" />.
+/// </summary>
+template<connector_profile Profile>
+static bool decode_segment(_Out_ powenetics_raw_sample& dst,
+        _In_reads_(67) const std::uint8_t *segment) {
+    constexpr bool atx_10pin = ((Profile & connector_profile_atx_10pin) != 0);
+    constexpr bool pcie_12v1 = ((Profile & connector_profile_pcie_12v1) != 0);
+    constexpr bool pcie_12v2 = ((Profile & connector_profile_pcie_12v2) != 0);
+    constexpr bool pcie_12v3 = ((Profile & connector_profile_pcie_12v3) != 0);
+
+    // Channel 1: ATX 3.3V, which the 10-pin connector does not have.
+    if (atx_10pin) {
+        dst.atx_3_3v = read_profiled<false>(segment + offset(1));
+    } else {
+        dst.atx_3_3v = read_checked(segment + offset(1));
+    }
+
+    // Channel 2: ATX 5V STB, only on 24-pin connectors.
+    if (!atx_10pin) {
+        dst.atx_stb = read_checked(segment + offset(2));
+    }
+
+    // Channels 3 to 5: ATX 12V, ATX 5V, EPS #1
+    dst.atx_12v = read_checked(segment + offset(3));
+    dst.atx_5v = read_checked(segment + offset(4));
+    dst.eps1 = read_checked(segment + offset(5));
+
+    // Channel 6: ATX 12V STB, only on 10-pin connectors.
+    if (atx_10pin) {
+        dst.atx_stb = read_checked(segment + offset(6));
+    }
+
+    // Channels 7 to 13.
+    dst.eps3 = read_checked(segment + offset(7));
+    dst.eps2 = read_checked(segment + offset(8));
+    dst.pcie_12v3 = read_profiled<pcie_12v3>(segment + offset(9));
+    dst.pcie_12v2 = read_profiled<pcie_12v2>(segment + offset(10));
+    dst.peg_3_3v = read_checked(segment + offset(11));
+    dst.peg_12v = read_checked(segment + offset(12));
+    dst.pcie_12v1 = read_profiled<pcie_12v1>(segment + offset(13));
+
+    // The decoder is only valid if the assumptions about the profile hold,
+    // which we check once for all channels at the end.
+    return (::detect_connector_profile(segment) == Profile);
+}
+
+
+/// <summary>
+/// The decoder for <see cref="connector_profile_unknown" />, which rejects
+/// all segments.
+/// </summary>
+static bool decode_segment_unknown(_Out_ powenetics_raw_sample&,
+        _In_reads_(67) const std::uint8_t *) {
+    return false;
+}
+
+
+/*
+ * ::detect_connector_profile
+ */
+connector_profile detect_connector_profile(
+        _In_reads_(67) const std::uint8_t *segment) noexcept {
+    assert(segment != nullptr);
+    // Note: The 10-pin connector is detected by a voltage strictly below 1V
+    // whereas the currents are valid for voltages strictly above 1V. This
+    // reproduces the behaviour of the original implementation.
+    const auto atx_3_3v = read_voltage(segment + offset(1));
+    const auto pcie_12v1 = read_voltage(segment + offset(13));
+    const auto pcie_12v2 = read_voltage(segment + offset(10));
+    const auto pcie_12v3 = read_voltage(segment + offset(9));
+
+    return static_cast<connector_profile>(
+        ((atx_3_3v < discard_threshold) ? connector_profile_atx_10pin : 0)
+        | ((pcie_12v1 > discard_threshold) ? connector_profile_pcie_12v1 : 0)
+        | ((pcie_12v2 > discard_threshold) ? connector_profile_pcie_12v2 : 0)
+        | ((pcie_12v3 > discard_threshold) ? connector_profile_pcie_12v3 : 0));
+}
+
+
+/*
+ * ::select_profile_decoder
+ */
+profile_decoder select_profile_decoder(
+        _In_ const connector_profile profile) noexcept {
+    static const profile_decoder decoders[] = {
+        ::decode_segment<0x00>, ::decode_segment<0x01>,
+        ::decode_segment<0x02>, ::decode_segment<0x03>,
+        ::decode_segment<0x04>, ::decode_segment<0x05>,
+        ::decode_segment<0x06>, ::decode_segment<0x07>,
+        ::decode_segment<0x08>, ::decode_segment<0x09>,
+        ::decode_segment<0x0A>, ::decode_segment<0x0B>,
+        ::decode_segment<0x0C>, ::decode_segment<0x0D>,
+        ::decode_segment<0x0E>, ::decode_segment<0x0F>
+    };
+    static_assert(sizeof(decoders) / sizeof(*decoders) == connector_profiles,
+        "A decoder must be instantiated for each connector profile.");
+
+    return (profile < connector_profiles)
+        ? decoders[profile]
+        : ::decode_segment_unknown;
+}
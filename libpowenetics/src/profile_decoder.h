@@ -0,0 +1,103 @@
+﻿// <copyright file="profile_decoder.h" company="Visualisierungsinstitut der Universität Stuttgart">
+// Copyright © 2026 Visualisierungsinstitut der Universität Stuttgart.
+// Licensed under the MIT licence. See LICENCE file for details.
+// </copyright>
+// <author>Christoph Müller</author>
+
+#if !defined(_LIBPOWENETICS_PROFILE_DECODER_H)
+#define _LIBPOWENETICS_PROFILE_DECODER_H
+#pragma once
+
+#include <cinttypes>
+
+#include "libpowenetics/api.h"
+#include "libpowenetics/raw_sample.h"
+
+
+/// <summary>
+/// Describes which connectors are attached to the Powenetics v2 device as a
+/// combination of the <c>connector_profile_*</c> flags.
+/// </summary>
+/// <remarks>
+/// The profile determines how the channels in a segment are mapped to the
+/// members of <see cref="powenetics_raw_sample" /> and for which channels the
+/// current needs to be checked against the voltage.
+/// </remarks>
+typedef std::uint8_t connector_profile;
+
+/// <summary>
+/// The flag indicating that a 10-pin ATX connector is attached, which has no
+/// 3.3V rail and reports 12V standby power on channel 6.
+/// </summary>
+constexpr connector_profile connector_profile_atx_10pin = 0x01;
+
+/// <summary>
+/// The flag indicating that PCIe connector #1 is supplied with power.
+/// </summary>
+constexpr connector_profile connector_profile_pcie_12v1 = 0x02;
+
+/// <summary>
+/// The flag indicating that PCIe connector #2 is supplied with power.
+/// </summary>
+constexpr connector_profile connector_profile_pcie_12v2 = 0x04;
+
+/// <summary>
+/// The flag indicating that PCIe connector #3 is supplied with power.
+/// </summary>
+constexpr connector_profile connector_profile_pcie_12v3 = 0x08;
+
+/// <summary>
+/// The number of distinct profiles that can be described by the flags.
+/// </summary>
+constexpr std::size_t connector_profiles = 16;
+
+/// <summary>
+/// The value indicating that the profile has not yet been determined.
+/// </summary>
+constexpr connector_profile connector_profile_unknown = 0x80;
+
+
+/// <summary>
+/// The signature of a function decoding the channels of a single segment
+/// for a specific connector profile.
+/// </summary>
+/// <remarks>
+/// <para>The function only fills the readings of <paramref name="dst" />, but
+/// not any of the metadata like the sequence number.</para>
+/// <para>The function checks whether the segment matches the profile it has
+/// been compiled for. If it does not, the content of
+/// <paramref name="dst" /> is undefined and the segment must be decoded again
+/// with the decoder for the actual profile, which can be obtained from
+/// <see cref="detect_connector_profile" />.</para>
+/// </remarks>
+/// <param name="dst">Receives the readings.</param>
+/// <param name="segment">The begin of the segment, which is the first byte
+/// of the sequence number.</param>
+/// <returns><c>true</c> if the segment has been decoded, <c>false</c> if the
+/// segment does not match the profile of the decoder.</returns>
+typedef bool (*profile_decoder)(_Out_ powenetics_raw_sample& dst,
+    _In_reads_(67) const std::uint8_t *segment);
+
+
+/// <summary>
+/// Determines the connector profile from the readings in the given segment.
+/// </summary>
+/// <param name="segment">The begin of the segment, which is the first byte
+/// of the sequence number.</param>
+/// <returns>The profile, which is never
+/// <see cref="connector_profile_unknown" />.</returns>
+connector_profile LIBPOWENETICS_TEST_API detect_connector_profile(
+    _In_reads_(67) const std::uint8_t *segment) noexcept;
+
+/// <summary>
+/// Answer the decoder compiled for the given connector profile.
+/// </summary>
+/// <param name="profile">The profile to get the decoder for. If this is
+/// <see cref="connector_profile_unknown" />, the decoder returned never
+/// accepts a segment.</param>
+/// <returns>A pointer to the decoder, which is never <c>nullptr</c>.
+/// </returns>
+profile_decoder LIBPOWENETICS_TEST_API select_profile_decoder(
+    _In_ const connector_profile profile) noexcept;
+
+#endif /* !defined(_LIBPOWENETICS_PROFILE_DECODER_H) */
@@ -0,0 +1,28 @@
+﻿// <copyright file="queue.cpp" company="Visualisierungsinstitut der Universität Stuttgart">
+// Copyright © 2026 Visualisierungsinstitut der Universität Stuttgart.
+// Licensed under the MIT licence. See LICENCE file for details.
+// </copyright>
+// <author>Christoph Müller</author>
+
+#include "libpowenetics/queue.h"
+
+
+/*
+ * ::powenetics_initialise_queue_configuration
+ */
+HRESULT LIBPOWENETICS_API powenetics_initialise_queue_configuration(
+        _In_ powenetics_queue_configuration *config) {
+    if (config == nullptr) {
+        return E_POINTER;
+    }
+
+    switch (config->version) {
+        case 2:
+            config->capacity = 16384;
+            config->overflow = powenetics_overflow::drop_newest;
+            return S_OK;
+
+        default:
+            return E_INVALIDARG;
+    }
+}
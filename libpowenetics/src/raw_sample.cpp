@@ -0,0 +1,67 @@
+﻿// <copyright file="raw_sample.cpp" company="Visualisierungsinstitut der Universität Stuttgart">
+// Copyright © 2026 Visualisierungsinstitut der Universität Stuttgart.
+// Licensed under the MIT licence. See LICENCE file for details.
+// </copyright>
+// <author>Christoph Müller</author>
+
+#include "libpowenetics/raw_sample.h"
+
+#include <cstring>
+
+#include "convert.h"
+
+
+/*
+ * ::powenetics_convert_raw_sample
+ */
+HRESULT LIBPOWENETICS_API powenetics_convert_raw_sample(
+        _Inout_ powenetics_sample *dst,
+        _In_ const powenetics_raw_sample *src) {
+    return ::powenetics_convert_raw_samples(dst, src, 1);
+}
+
+
+/*
+ * ::powenetics_convert_raw_samples
+ */
+HRESULT LIBPOWENETICS_API powenetics_convert_raw_samples(
+        _Inout_updates_(cnt) powenetics_sample *dst,
+        _In_reads_(cnt) const powenetics_raw_sample *src,
+        _In_ const size_t cnt) {
+    if (cnt == 0) {
+        return S_OK;
+    }
+    if ((dst == nullptr) || (src == nullptr)) {
+        return E_POINTER;
+    }
+
+    // The version of the first element determines the layout of the whole
+    // array, because the elements of older versions are smaller.
+    const auto dst_version = dst->version;
+    const auto src_version = src->version;
+    if (!::is_sample_version(dst_version)
+            || !::is_sample_version(src_version)) {
+        return E_INVALIDARG;
+    }
+
+    const auto dst_size = ::sample_size<powenetics_sample>(dst_version);
+    const auto src_size = ::sample_size<powenetics_raw_sample>(src_version);
+    auto d = reinterpret_cast<std::uint8_t *>(dst);
+    auto s = reinterpret_cast<const std::uint8_t *>(src);
+
+    for (std::size_t i = 0; i < cnt; ++i, d += dst_size, s += src_size) {
+        // Members that the version of the source does not have are zero.
+        powenetics_raw_sample raw { };
+        std::memcpy(&raw, s, src_size);
+        if (raw.version != src_version) {
+            return E_INVALIDARG;
+        }
+        raw.version = sample_version;
+
+        powenetics_sample sample;
+        ::to_sample(sample, raw);
+        ::store_sample(d, sample, dst_version);
+    }
+
+    return S_OK;
+}
@@ -0,0 +1,66 @@
+﻿// <copyright file="reactor.cpp" company="Visualisierungsinstitut der Universität Stuttgart">
+// Copyright © 2026 Visualisierungsinstitut der Universität Stuttgart.
+// Licensed under the MIT licence. See LICENCE file for details.
+// </copyright>
+// <author>Christoph Müller</author>
+
+#include "libpowenetics/reactor.h"
+
+#include <memory>
+#include <new>
+
+#include "debug.h"
+#include "io_reactor.h"
+
+
+/*
+ * ::powenetics_create_reactor
+ */
+HRESULT LIBPOWENETICS_API powenetics_create_reactor(
+        _Out_ powenetics_reactor_handle *out_reactor,
+        _In_ const size_t threads) {
+    if (out_reactor == nullptr) {
+        _powenetics_debug("Invalid storage location for reactor "
+            "provided.\r\n");
+        return E_POINTER;
+    }
+
+    *out_reactor = nullptr;
+
+    if (threads == 0) {
+        _powenetics_debug("A reactor requires at least one thread.\r\n");
+        return E_INVALIDARG;
+    }
+
+    std::unique_ptr<powenetics_reactor> reactor(
+        new (std::nothrow) powenetics_reactor());
+    if (reactor == nullptr) {
+        _powenetics_debug("Insufficient memory for powenetics_reactor.\r\n");
+        return E_OUTOFMEMORY;
+    }
+
+    auto retval = reactor->open(threads);
+    if (SUCCEEDED(retval)) {
+        *out_reactor = reactor.release();
+    }
+
+    return retval;
+}
+
+
+/*
+ * ::powenetics_destroy_reactor
+ */
+HRESULT LIBPOWENETICS_API powenetics_destroy_reactor(
+        _In_ const powenetics_reactor_handle reactor) {
+    if (reactor == nullptr) {
+        return E_HANDLE;
+    }
+
+    auto retval = reactor->close();
+    if (SUCCEEDED(retval)) {
+        delete reactor;
+    }
+
+    return retval;
+}
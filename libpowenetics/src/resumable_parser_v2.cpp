@@ -0,0 +1,97 @@
+﻿// <copyright file="resumable_parser_v2.cpp" company="Visualisierungsinstitut der Universität Stuttgart">
+// Copyright © 2026 Visualisierungsinstitut der Universität Stuttgart.
+// Licensed under the MIT licence. See LICENCE file for details.
+// </copyright>
+// <author>Christoph Müller</author>
+
+#include "resumable_parser_v2.h"
+
+#include "debug.h"
+
+
+/*
+ * resumable_parser_v2::resumable_parser_v2
+ */
+resumable_parser_v2::resumable_parser_v2(void) noexcept
+    : _cnt(0),
+    _state(state_type::hunting),
+    _statistics() { }
+
+
+/*
+ * resumable_parser_v2::flush
+ */
+void resumable_parser_v2::flush(void) noexcept {
+    switch (this->_state) {
+        case state_type::delimiter_seen:
+            ++this->_statistics.bytes_discarded;
+            break;
+
+        case state_type::collecting:
+            this->_statistics.bytes_discarded += this->_cnt;
+            break;
+
+        default:
+            break;
+    }
+
+    if (this->_continuity.held()) {
+        this->reject_held();
+    }
+    this->_continuity.reset();
+
+    this->_cnt = 0;
+    this->_state = state_type::hunting;
+}
+
+
+/*
+ * resumable_parser_v2::reject_held
+ */
+void resumable_parser_v2::reject_held(void) noexcept {
+    _powenetics_debug("Discarding segment breaking the sequence.\r\n");
+    ++this->_statistics.segments_rejected;
+    this->_statistics.bytes_discarded += sample_sequencer::segment_length;
+}
+
+
+/*
+ * resumable_parser_v2::resync
+ */
+void resumable_parser_v2::resync(void) noexcept {
+    assert(this->_cnt == scratch_size);
+    auto& delimiter = responses_v2::segment_delimiter;
+    _powenetics_debug("Discarding invalid segment.\r\n");
+    ++this->_statistics.segments_rejected;
+    this->_continuity.interrupt();
+
+    // Search the first delimiter in the scratch area. The position of the
+    // delimiter we expected cannot match, because we would not be here if it
+    // did.
+    for (std::size_t i = 0; i + 1 < scratch_size; ++i) {
+        if ((this->_scratch[i] == delimiter.front())
+                && (this->_scratch[i + 1] == delimiter.back())) {
+            // The bytes before the delimiter are lost, the ones after it are
+            // the begin of the next segment candidate.
+            const auto begin = i + delimiter.size();
+            this->_statistics.bytes_discarded += i;
+            std::copy(this->_scratch.begin() + begin, this->_scratch.end(),
+                this->_scratch.begin());
+            this->_cnt = scratch_size - begin;
+            return;
+        }
+    }
+
+    // There is no delimiter in the scratch area, so we need to start hunting
+    // again. Make sure that we do not lose the first half of a delimiter at
+    // the very end.
+    this->_cnt = 0;
+
+    if (this->_scratch.back() == delimiter.front()) {
+        this->_statistics.bytes_discarded += scratch_size - 1;
+        this->_state = state_type::delimiter_seen;
+    } else {
+        this->_statistics.bytes_discarded += scratch_size;
+        this->_state = state_type::hunting;
+    }
+}
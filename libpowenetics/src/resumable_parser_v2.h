@@ -0,0 +1,237 @@
+﻿// <copyright file="resumable_parser_v2.h" company="Visualisierungsinstitut der Universität Stuttgart">
+// Copyright © 2026 Visualisierungsinstitut der Universität Stuttgart.
+// Licensed under the MIT licence. See LICENCE file for details.
+// </copyright>
+// <author>Christoph Müller</author>
+
+#if !defined(_LIBPOWENETICS_RESUMABLE_PARSER_V2_H)
+#define _LIBPOWENETICS_RESUMABLE_PARSER_V2_H
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cinttypes>
+
+#include "libpowenetics/api.h"
+#include "libpowenetics/raw_sample.h"
+#include "libpowenetics/sample.h"
+#include "libpowenetics/timestamp.h"
+
+#include "continuity_filter.h"
+#include "responses.h"
+#include "sample_sequencer.h"
+
+
+/// <summary>
+/// Parses the data stream of a Powenetics v2 device with an explicit state
+/// machine that consumes the input byte by byte.
+/// </summary>
+/// <remarks>
+/// <para>The only data the parser retains between two calls are its state and
+/// a scratch area for one segment and the delimiter following it, and a copy
+/// of the segment held back until its sequence number is confirmed. The parser
+/// has no member that allocates memory, so it does not make any heap
+/// allocation at all. This makes the parser suitable for embedded systems and
+/// for threads that must not touch the allocator.</para>
+/// <para>Each byte is processed in constant time with two exceptions: the byte
+/// completing a segment causes the segment to be decoded and delivered, and if
+/// the segment is not followed by a delimiter, the parser searches the
+/// scratch area for the next delimiter and moves the bytes following it to
+/// the front. Both are bounded by the size of the scratch area, so the
+/// latency per byte does not depend on the input.</para>
+/// <para>The parser delivers the same samples and maintains the same
+/// statistics as <see cref="stream_parser_v2" />, but it copies every
+/// segment into the scratch area instead of decoding it in-place.</para>
+/// <para>The parser is <i>not thread-safe!</i> Make sure to enqueue new data
+/// always from the same thread or serialise the operation somehow.</para>
+/// </remarks>
+class LIBPOWENETICS_TEST_API resumable_parser_v2 final {
+
+public:
+
+    /// <summary>
+    /// The type used to represent a single byte.
+    /// </summary>
+    typedef sample_sequencer::byte_type byte_type;
+
+    /// <summary>
+    /// The states of the parser.
+    /// </summary>
+    enum class state_type {
+
+        /// <summary>
+        /// The parser is not synchronised with the stream and waits for the
+        /// first byte of a delimiter.
+        /// </summary>
+        hunting,
+
+        /// <summary>
+        /// The parser has seen the first byte of a delimiter and waits for the
+        /// second one.
+        /// </summary>
+        delimiter_seen,
+
+        /// <summary>
+        /// The parser has seen a delimiter and collects the payload of a
+        /// segment and the delimiter that must follow it in the scratch area.
+        /// </summary>
+        collecting
+    };
+
+    /// <summary>
+    /// The counters the parser maintains about the health of the stream.
+    /// </summary>
+    typedef parser_statistics statistics_type;
+
+    /// <summary>
+    /// The size of the scratch area, which holds a full segment and the
+    /// delimiter that terminates it.
+    /// </summary>
+    static constexpr std::size_t scratch_size
+        = sample_sequencer::segment_length
+        + responses_v2::segment_delimiter.size();
+
+    /// <summary>
+    /// Initialises a new instance.
+    /// </summary>
+    resumable_parser_v2(void) noexcept;
+
+    /// <summary>
+    /// Changes the clock the samples are stamped with.
+    /// </summary>
+    inline void clock(_In_ const clock_function clock) noexcept {
+        this->_sequencer.clock(clock);
+    }
+
+    /// <summary>
+    /// Answer the counters accumulated since the last call and reset them.
+    /// </summary>
+    inline statistics_type collect_statistics(void) noexcept {
+        auto retval = this->_statistics;
+        this->_statistics = statistics_type();
+        this->_sequencer.collect_statistics(retval);
+        return retval;
+    }
+
+    /// <summary>
+    /// Answer the energy integrated from all samples delivered so far.
+    /// </summary>
+    inline const energy_integrator& energy(void) const noexcept {
+        return this->_sequencer.energy();
+    }
+
+    /// <summary>
+    /// Discards a partial segment or delimiter from previous calls and a
+    /// segment that has been held back, and starts hunting for the next
+    /// delimiter.
+    /// </summary>
+    void flush(void) noexcept;
+
+    /// <summary>
+    /// Reads the clock the samples are stamped with.
+    /// </summary>
+    inline powenetics_timestamp now(void) const {
+        return this->_sequencer.now();
+    }
+
+    /// <summary>
+    /// Answer the connector profile detected from the most recent segment.
+    /// </summary>
+    inline connector_profile profile(void) const noexcept {
+        return this->_sequencer.profile();
+    }
+
+    /// <summary>
+    /// Feeds the given <paramref name="data" /> through the state machine and
+    /// delivers the samples of all segments completed by them to
+    /// <paramref name="callback" />.
+    /// </summary>
+    /// <typeparam name="TSample">The type of the samples to be delivered,
+    /// which must be <see cref="powenetics_sample" />,
+    /// <see cref="powenetics_raw_sample" /> or
+    /// <see cref="powenetics_segment" />.</typeparam>
+    /// <typeparam name="TCallback">The type of the callback functor to be
+    /// invoked, which must accept a single <typeparamref name="TSample" />.
+    /// </typeparam>
+    /// <param name="data">The data to be parsed, which must be a
+    /// non-<c>nullptr</c> pointer to <paramref name="cnt" /> bytes of data
+    /// received from the device.</param>
+    /// <param name="cnt">The size of <paramref name="data" /> in bytes.</param>
+    /// <param name="callback">The callback to be invoked for each sample.
+    /// </param>
+    /// <returns><c>true</c> if a partial segment or delimiter is retained
+    /// until the next call.</returns>
+    template<class TSample = powenetics_sample, class TCallback>
+    bool push_back(
+        _In_reads_(cnt) const byte_type *data,
+        _In_ const std::size_t cnt,
+        _In_ TCallback&& callback);
+
+    /// <summary>
+    /// Sets the host time at which the data passed to the next call to
+    /// <see cref="push_back" /> have been received.
+    /// </summary>
+    inline void received(_In_ const powenetics_timestamp timestamp) noexcept {
+        this->_sequencer.received(timestamp);
+    }
+
+    /// <summary>
+    /// Answer the current state of the parser.
+    /// </summary>
+    inline state_type state(void) const noexcept {
+        return this->_state;
+    }
+
+    /// <summary>
+    /// Answer how the timestamps of the samples are obtained.
+    /// </summary>
+    inline powenetics_timestamping timestamping(void) const noexcept {
+        return this->_sequencer.timestamping();
+    }
+
+    /// <summary>
+    /// Changes how the timestamps of the samples are obtained.
+    /// </summary>
+    inline void timestamping(
+            _In_ const powenetics_timestamping timestamping) noexcept {
+        this->_sequencer.timestamping(timestamping);
+    }
+
+private:
+
+    /// <summary>
+    /// Handles a full scratch area, which is either delivered as a segment or
+    /// rejected, in which case the parser resynchronises within the scratch
+    /// area.
+    /// </summary>
+    template<class TSample, class TCallback>
+    void complete(_In_ TCallback& callback);
+
+    /// <summary>
+    /// Counts the segment held back as rejected.
+    /// </summary>
+    void reject_held(void) noexcept;
+
+    /// <summary>
+    /// Searches the next delimiter in the scratch area after the segment in it
+    /// failed the framing check and updates the state accordingly.
+    /// </summary>
+    void resync(void) noexcept;
+
+    std::size_t _cnt;
+    continuity_filter _continuity;
+
+    /// <summary>
+    /// A copy of the segment held back by <see cref="_continuity" />.
+    /// </summary>
+    std::array<byte_type, sample_sequencer::segment_length> _held;
+    std::array<byte_type, scratch_size> _scratch;
+    sample_sequencer _sequencer;
+    state_type _state;
+    statistics_type _statistics;
+};
+
+#include "resumable_parser_v2.inl"
+
+#endif /* !defined(_LIBPOWENETICS_RESUMABLE_PARSER_V2_H) */
@@ -0,0 +1,115 @@
+﻿// <copyright file="resumable_parser_v2.inl" company="Visualisierungsinstitut der Universität Stuttgart">
+// Copyright © 2026 Visualisierungsinstitut der Universität Stuttgart.
+// Licensed under the MIT licence. See LICENCE file for details.
+// </copyright>
+// <author>Christoph Müller</author>
+
+
+/*
+ * resumable_parser_v2::push_back
+ */
+template<class TSample, class TCallback>
+bool resumable_parser_v2::push_back(_In_reads_(cnt) const byte_type *data,
+        _In_ const std::size_t cnt,
+        _In_ TCallback&& callback) {
+    assert(data != nullptr);
+    auto& delimiter = responses_v2::segment_delimiter;
+    auto cur = data;
+    const auto end = data + cnt;
+
+    while (cur < end) {
+        switch (this->_state) {
+            case state_type::hunting:
+                if (*cur == delimiter.front()) {
+                    this->_state = state_type::delimiter_seen;
+                } else {
+                    ++this->_statistics.bytes_discarded;
+                }
+                ++cur;
+                break;
+
+            case state_type::delimiter_seen:
+                if (*cur == delimiter.back()) {
+                    this->_cnt = 0;
+                    this->_state = state_type::collecting;
+                } else if (*cur == delimiter.front()) {
+                    // The previous byte was not the begin of a delimiter, but
+                    // this one might be.
+                    ++this->_statistics.bytes_discarded;
+                } else {
+                    this->_statistics.bytes_discarded += 2;
+                    this->_state = state_type::hunting;
+                }
+                ++cur;
+                break;
+
+            case state_type::collecting: {
+                // Nothing but the last byte can complete the scratch area, so
+                // we can take all bytes up to there at once.
+                const auto cnt_copy = (std::min)(
+                    static_cast<std::size_t>(end - cur),
+                    scratch_size - this->_cnt);
+                std::copy(cur, cur + cnt_copy,
+                    this->_scratch.data() + this->_cnt);
+                this->_cnt += cnt_copy;
+                cur += cnt_copy;
+
+                if (this->_cnt == scratch_size) {
+                    this->complete<TSample>(callback);
+                }
+                } break;
+        }
+    }
+
+    const auto retval = (this->_state == state_type::delimiter_seen)
+        || ((this->_state == state_type::collecting) && (this->_cnt > 0));
+    if (retval) {
+        ++this->_statistics.carry_overs;
+    }
+
+    this->_sequencer.observe();
+
+    return retval;
+}
+
+
+/*
+ * resumable_parser_v2::complete
+ */
+template<class TSample, class TCallback>
+void resumable_parser_v2::complete(_In_ TCallback& callback) {
+    assert(this->_state == state_type::collecting);
+    assert(this->_cnt == scratch_size);
+    auto& delimiter = responses_v2::segment_delimiter;
+    const auto length = sample_sequencer::segment_length;
+
+    if ((this->_scratch[length] == delimiter.front())
+            && (this->_scratch[length + 1] == delimiter.back())) {
+        // The delimiter terminating this segment is the begin of the next
+        // one, so we continue collecting from an empty scratch area. The
+        // segment is only delivered once its sequence number has been
+        // confirmed like in stream_parser_v2::emit.
+        const auto held = this->_continuity.held();
+        this->_cnt = 0;
+
+        if (this->_continuity.check(::to_uint16(this->_scratch.data()))) {
+            TSample sample;
+            if (held) {
+                this->_sequencer.sequence(sample, this->_held.data());
+                callback(sample);
+            }
+            this->_sequencer.sequence(sample, this->_scratch.data());
+            callback(sample);
+
+        } else {
+            if (held) {
+                this->reject_held();
+            }
+            std::copy(this->_scratch.begin(), this->_scratch.begin() + length,
+                this->_held.begin());
+        }
+
+    } else {
+        this->resync();
+    }
+}
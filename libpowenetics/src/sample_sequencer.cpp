@@ -0,0 +1,77 @@
+﻿// <copyright file="sample_sequencer.cpp" company="Visualisierungsinstitut der Universität Stuttgart">
+// Copyright © 2026 Visualisierungsinstitut der Universität Stuttgart.
+// Licensed under the MIT licence. See LICENCE file for details.
+// </copyright>
+// <author>Christoph Müller</author>
+
+#include "sample_sequencer.h"
+
+#include "convert.h"
+#include "debug.h"
+
+
+/*
+ * sample_sequencer::sample_sequencer
+ */
+sample_sequencer::sample_sequencer(void) noexcept
+    : _clock(::powenetics_make_timestamp),
+    _decoder(::select_profile_decoder(connector_profile_unknown)),
+    _index(no_index),
+    _observed(no_index),
+    _profile(connector_profile_unknown),
+    _received(0),
+    _sequence_number(0),
+    _statistics(),
+    _timestamping(powenetics_timestamping::per_sample) { }
+
+
+/*
+ * sample_sequencer::parse_segment
+ */
+void sample_sequencer::parse_segment(_Out_ powenetics_raw_sample& dst,
+        _In_reads_(segment_length) const byte_type *segment) noexcept {
+    assert(segment != nullptr);
+    dst.version = sample_version;
+    dst.sequence_number = to_uint16(segment);
+    dst.index = 0;
+    dst.missing = 0;
+    dst.dropped = 0;
+    dst.timestamp = 0;
+    // Note: The original implementation performs down-sampling on user
+    // request at this point. We do not do that in the library. Instead, the
+    // user must do that in the callback if it is desired. The timestamp is
+    // set once the index of the sample is known.
+
+    // The connectors attached to the device do not change while streaming
+    // except for the PCIe rails of a GPU that is powered up or down. We
+    // therefore decode using the decoder specialised for the last profile we
+    // have seen and detect the profile only if the decoder rejects the
+    // segment, which is the case for the very first one, too.
+    if (!this->_decoder(dst, segment)) {
+        this->_profile = ::detect_connector_profile(segment);
+        this->_decoder = ::select_profile_decoder(this->_profile);
+        _powenetics_debug("The connector profile has changed.\r\n");
+
+        const auto decoded = this->_decoder(dst, segment);
+        assert(decoded);
+        (void) decoded;
+    }
+}
+
+
+/*
+ * sample_sequencer::parse_segment
+ */
+void sample_sequencer::parse_segment(_Out_ powenetics_segment& dst,
+        _In_reads_(segment_length) const byte_type *segment) noexcept {
+    assert(segment != nullptr);
+    static_assert(segment_length == POWENETICS_SEGMENT_LENGTH, "The segment "
+        "length of the public API must match the one of the parser.");
+    dst.version = sample_version;
+    dst.sequence_number = to_uint16(segment);
+    dst.timestamp = 0;
+    dst.data = segment;
+    dst.index = 0;
+    dst.missing = 0;
+    dst.dropped = 0;
+}
@@ -0,0 +1,298 @@
+﻿// <copyright file="sample_sequencer.h" company="Visualisierungsinstitut der Universität Stuttgart">
+// Copyright © 2026 Visualisierungsinstitut der Universität Stuttgart.
+// Licensed under the MIT licence. See LICENCE file for details.
+// </copyright>
+// <author>Christoph Müller</author>
+
+#if !defined(_LIBPOWENETICS_SAMPLE_SEQUENCER_H)
+#define _LIBPOWENETICS_SAMPLE_SEQUENCER_H
+#pragma once
+
+#include <cassert>
+#include <cinttypes>
+#include <limits>
+#include <type_traits>
+
+#include "libpowenetics/api.h"
+#include "libpowenetics/raw_sample.h"
+#include "libpowenetics/sample.h"
+#include "libpowenetics/segment.h"
+#include "libpowenetics/timestamp.h"
+
+#include "clock.h"
+#include "convert.h"
+#include "energy_integrator.h"
+#include "profile_decoder.h"
+#include "timestamp_estimator.h"
+
+
+/// <summary>
+/// The counters the parsers maintain about the health of the stream.
+/// </summary>
+struct parser_statistics {
+
+    /// <summary>
+    /// The number of segments that have been delivered.
+    /// </summary>
+    std::uint64_t segments_parsed;
+
+    /// <summary>
+    /// The number of segments that have been discarded, because the
+    /// next delimiter was not where the length of a segment requires it.
+    /// </summary>
+    std::uint64_t segments_rejected;
+
+    /// <summary>
+    /// The number of bytes that have been skipped while searching for a
+    /// delimiter.
+    /// </summary>
+    std::uint64_t bytes_discarded;
+
+    /// <summary>
+    /// The number of calls to <c>push_back</c> that left data in the
+    /// carry-over area for the next call.
+    /// </summary>
+    std::uint64_t carry_overs;
+
+    /// <summary>
+    /// The number of discontinuities in the sequence numbers of the
+    /// segments.
+    /// </summary>
+    std::uint64_t sequence_gaps;
+
+    /// <summary>
+    /// The number of segments missing in the gaps.
+    /// </summary>
+    std::uint64_t samples_missing;
+};
+
+
+/// <summary>
+/// Turns the correctly framed segments a parser has found in the data stream
+/// of a Powenetics v2 device into samples.
+/// </summary>
+/// <remarks>
+/// <para>The sequencer holds everything the parsers share once they know where
+/// a segment is: it decodes the segment using the decoder for the connector
+/// profile, extends the sequence number to the index of the sample and stamps
+/// the sample with the configured clock and timestamping mode. Furthermore, it
+/// integrates the energy of all raw samples it sequences.</para>
+/// <para>The sequencer does not allocate any memory.</para>
+/// </remarks>
+class LIBPOWENETICS_TEST_API sample_sequencer final {
+
+public:
+
+    /// <summary>
+    /// The type used to represent a single byte.
+    /// </summary>
+    typedef std::uint8_t byte_type;
+
+    /// <summary>
+    /// The expected number of bytes in a valid segment.
+    /// </summary>
+    /// <remarks>
+    /// A valid segment comprises a 16-bit sequence number and 13 samples of
+    /// 16-bit voltage data and 24-bit current data.
+    /// </remarks>
+    static constexpr std::size_t segment_length = 67;
+
+    /// <summary>
+    /// Initialises a new instance.
+    /// </summary>
+    sample_sequencer(void) noexcept;
+
+    /// <summary>
+    /// Changes the clock the samples are stamped with.
+    /// </summary>
+    /// <param name="clock">The function reading the clock, which must not be
+    /// <c>nullptr</c>.</param>
+    inline void clock(_In_ const clock_function clock) noexcept {
+        assert(clock != nullptr);
+        this->_clock = clock;
+        this->_estimator.reset();
+    }
+
+    /// <summary>
+    /// Adds the counters maintained by the sequencer to
+    /// <paramref name="dst" /> and resets them.
+    /// </summary>
+    /// <remarks>
+    /// The sequencer only maintains
+    /// <see cref="parser_statistics::segments_parsed" />,
+    /// <see cref="parser_statistics::sequence_gaps" /> and
+    /// <see cref="parser_statistics::samples_missing" />. The other counters
+    /// are the responsibility of the parser.
+    /// </remarks>
+    inline void collect_statistics(_Inout_ parser_statistics& dst) noexcept {
+        dst.segments_parsed += this->_statistics.segments_parsed;
+        dst.sequence_gaps += this->_statistics.sequence_gaps;
+        dst.samples_missing += this->_statistics.samples_missing;
+        this->_statistics.segments_parsed = 0;
+        this->_statistics.sequence_gaps = 0;
+        this->_statistics.samples_missing = 0;
+    }
+
+    /// <summary>
+    /// Answer the energy integrated from all raw samples that have been
+    /// <see cref="sequence" />d.
+    /// </summary>
+    inline const energy_integrator& energy(void) const noexcept {
+        return this->_energy;
+    }
+
+    /// <summary>
+    /// Reads the clock the samples are stamped with.
+    /// </summary>
+    /// <returns>The current time.</returns>
+    inline powenetics_timestamp now(void) const {
+        return this->_clock();
+    }
+
+    /// <summary>
+    /// Passes the index of the most recent sample and the time at which the
+    /// data have been <see cref="received" /> to the timestamp estimator.
+    /// </summary>
+    /// <remarks>
+    /// Parsers must call this method once at the end of each call to
+    /// <c>push_back</c>, after all samples have been
+    /// <see cref="sequence" />d.
+    /// </remarks>
+    inline void observe(void) noexcept {
+        // The most recent sample of this call has been received when the read
+        // completed, which is the observation we fit the timestamps to.
+        if ((this->_timestamping == powenetics_timestamping::interpolated)
+                && (this->_index != this->_observed)) {
+            this->_estimator.observe(this->_index, this->_received);
+            this->_observed = this->_index;
+        }
+    }
+
+    /// <summary>
+    /// Parses the given segment using the decoder for the connector profile
+    /// of the previous segment and switches the decoder if the profile has
+    /// changed.
+    /// </summary>
+    /// <remarks>
+    /// The index and the timestamp of the sample are not set by this method,
+    /// which is the responsibility of <see cref="sequence" />.
+    /// </remarks>
+    /// <param name="dst">The variable receiving the sample.</param>
+    /// <param name="segment">The begin of the segment, excluding the
+    /// delimiter, which must designate at least
+    /// <see cref="segment_length" /> bytes.</param>
+    void parse_segment(_Out_ powenetics_raw_sample& dst,
+        _In_reads_(segment_length) const byte_type *segment) noexcept;
+
+    /// <summary>
+    /// Refers to the given segment without decoding its readings.
+    /// </summary>
+    /// <remarks>
+    /// Only the sequence number is read from the segment, so
+    /// <see cref="profile" /> does not change. <paramref name="dst" /> is only
+    /// valid as long as <paramref name="segment" /> is.
+    /// </remarks>
+    void parse_segment(_Out_ powenetics_segment& dst,
+        _In_reads_(segment_length) const byte_type *segment) noexcept;
+
+    /// <summary>
+    /// Answer the connector profile detected from the most recent segment.
+    /// </summary>
+    /// <returns>The connector profile, which is
+    /// <see cref="connector_profile_unknown" /> until the first segment has
+    /// been parsed.</returns>
+    inline connector_profile profile(void) const noexcept {
+        return this->_profile;
+    }
+
+    /// <summary>
+    /// Sets the host time at which the data passed to the next call to
+    /// <c>push_back</c> of the parser have been received.
+    /// </summary>
+    /// <remarks>
+    /// This information is only used if the timestamps are
+    /// <see cref="powenetics_timestamping::interpolated" />, in which case it
+    /// must be set before each call to <c>push_back</c>.
+    /// </remarks>
+    /// <param name="timestamp">The time at which the read from the device
+    /// completed.</param>
+    inline void received(_In_ const powenetics_timestamp timestamp) noexcept {
+        this->_received = timestamp;
+    }
+
+    /// <summary>
+    /// Assigns the index, the number of missing samples before it and the
+    /// timestamp to a sample that has been parsed from the next segment in the
+    /// stream.
+    /// </summary>
+    /// <remarks>
+    /// Raw samples are integrated into <see cref="energy" />. Samples in Volts
+    /// and Amperes cannot be sequenced by this method, because they must be
+    /// integrated from the raw readings, so they must be sequenced as raw
+    /// samples and converted afterwards.
+    /// </remarks>
+    /// <typeparam name="TSample">The type of the sample, which must be
+    /// <see cref="powenetics_raw_sample" /> or
+    /// <see cref="powenetics_segment" />.</typeparam>
+    /// <param name="sample">The sample, of which the sequence number must have
+    /// been set.</param>
+    template<class TSample> void sequence(_Inout_ TSample& sample);
+
+    /// <summary>
+    /// Parses the given segment into a sample and <see cref="sequence" />s it.
+    /// </summary>
+    /// <typeparam name="TSample">The type of the sample, which must be
+    /// <see cref="powenetics_sample" />, <see cref="powenetics_raw_sample" />
+    /// or <see cref="powenetics_segment" />.</typeparam>
+    /// <param name="dst">The variable receiving the sample.</param>
+    /// <param name="segment">The begin of the segment, excluding the
+    /// delimiter, which must designate at least
+    /// <see cref="segment_length" /> bytes.</param>
+    template<class TSample>
+    void sequence(_Out_ TSample& dst,
+        _In_reads_(segment_length) const byte_type *segment);
+
+    /// <summary>
+    /// Answer how the timestamps of the samples are obtained.
+    /// </summary>
+    /// <returns>The timestamping mode.</returns>
+    inline powenetics_timestamping timestamping(void) const noexcept {
+        return this->_timestamping;
+    }
+
+    /// <summary>
+    /// Changes how the timestamps of the samples are obtained.
+    /// </summary>
+    /// <param name="timestamping">The new timestamping mode.</param>
+    inline void timestamping(
+            _In_ const powenetics_timestamping timestamping) noexcept {
+        this->_timestamping = timestamping;
+        this->_estimator.reset();
+    }
+
+private:
+
+    /// <summary>
+    /// The value of <see cref="_index" /> before the first segment has been
+    /// delivered.
+    /// </summary>
+    static constexpr std::uint64_t no_index = (std::numeric_limits<
+        std::uint64_t>::max)();
+
+    clock_function _clock;
+    profile_decoder _decoder;
+    energy_integrator _energy;
+    timestamp_estimator _estimator;
+    std::uint64_t _index;
+    std::uint64_t _observed;
+    connector_profile _profile;
+    powenetics_timestamp _received;
+    std::uint16_t _sequence_number;
+    parser_statistics _statistics;
+    powenetics_timestamping _timestamping;
+};
+
+
+#include "sample_sequencer.inl"
+
+#endif /* !defined(_LIBPOWENETICS_SAMPLE_SEQUENCER_H) */
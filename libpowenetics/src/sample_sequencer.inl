@@ -0,0 +1,71 @@
+﻿// <copyright file="sample_sequencer.inl" company="Visualisierungsinstitut der Universität Stuttgart">
+// Copyright © 2026 Visualisierungsinstitut der Universität Stuttgart.
+// Licensed under the MIT licence. See LICENCE file for details.
+// </copyright>
+// <author>Christoph Müller</author>
+
+
+/*
+ * sample_sequencer::sequence
+ */
+template<class TSample>
+void sample_sequencer::sequence(_Inout_ TSample& sample) {
+    static_assert(!std::is_same<TSample, powenetics_sample>::value, "Samples "
+        "in Volts and Amperes must be sequenced as raw samples.");
+
+    // Extend the sequence number to the 64-bit index. The difference between
+    // two 16-bit sequence numbers is unambiguous unless more than 65535
+    // segments were lost, which we cannot detect. Note that we interpret a
+    // repeated sequence number as a full wrap-around, because the device
+    // never repeats a sequence number.
+    if (this->_index == no_index) {
+        sample.index = 0;
+        sample.missing = 0;
+    } else {
+        const std::uint32_t delta = static_cast<std::uint16_t>(
+            sample.sequence_number - this->_sequence_number);
+        const auto distance = (delta != 0) ? delta : 0x10000;
+        sample.index = this->_index + distance;
+        sample.missing = distance - 1;
+    }
+
+    if (sample.missing > 0) {
+        ++this->_statistics.sequence_gaps;
+        this->_statistics.samples_missing += sample.missing;
+    }
+
+    this->_index = sample.index;
+    this->_sequence_number = sample.sequence_number;
+    ++this->_statistics.segments_parsed;
+
+    if (this->_timestamping == powenetics_timestamping::interpolated) {
+        sample.timestamp = this->_estimator.estimate(sample.index,
+            this->_received);
+    } else {
+        sample.timestamp = this->_clock();
+    }
+
+    if constexpr (std::is_same<TSample, powenetics_raw_sample>::value) {
+        this->_energy.integrate(sample);
+    }
+}
+
+
+/*
+ * sample_sequencer::sequence
+ */
+template<class TSample>
+void sample_sequencer::sequence(_Out_ TSample& dst,
+        _In_reads_(segment_length) const byte_type *segment) {
+    if constexpr (std::is_same<TSample, powenetics_sample>::value) {
+        // The energy is integrated from the exact readings, so we sequence the
+        // raw sample and convert it afterwards.
+        powenetics_raw_sample raw;
+        this->parse_segment(raw, segment);
+        this->sequence(raw);
+        ::to_sample(dst, raw);
+    } else {
+        this->parse_segment(dst, segment);
+        this->sequence(dst);
+    }
+}
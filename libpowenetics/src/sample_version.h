@@ -0,0 +1,77 @@
+﻿// <copyright file="sample_version.h" company="Visualisierungsinstitut der Universität Stuttgart">
+// Copyright © 2026 Visualisierungsinstitut der Universität Stuttgart.
+// Licensed under the MIT licence. See LICENCE file for details.
+// </copyright>
+// <author>Christoph Müller</author>
+
+#if !defined(_LIBPOWENETICS_SAMPLE_VERSION_H)
+#define _LIBPOWENETICS_SAMPLE_VERSION_H
+#pragma once
+
+#include <cinttypes>
+#include <cstddef>
+#include <cstring>
+
+#include "libpowenetics/api.h"
+#include "libpowenetics/types.h"
+
+
+/// <summary>
+/// The version of <see cref="powenetics_sample" />,
+/// <see cref="powenetics_raw_sample" /> and <see cref="powenetics_segment" />
+/// the library creates.
+/// </summary>
+/// <remarks>
+/// Version 3 has added <c>index</c>, <c>missing</c> and <c>dropped</c> behind
+/// the members of version 2.
+/// </remarks>
+constexpr std::uint32_t sample_version = 3;
+
+
+/// <summary>
+/// Answer whether the library can read and write the given version of a
+/// sample or segment.
+/// </summary>
+inline bool is_sample_version(_In_ const std::uint32_t version) noexcept {
+    return ((version == 2) || (version == sample_version));
+}
+
+
+/// <summary>
+/// Answer the size of the given version of <typeparamref name="TSample" />,
+/// which is the distance between two elements in an array of this version.
+/// </summary>
+/// <remarks>
+/// Version 2 ends right before <c>index</c>, which has the alignment of the
+/// timestamp, so its offset is the size of the old structure including the
+/// padding at its end.
+/// </remarks>
+/// <typeparam name="TSample">The type of the sample or segment.</typeparam>
+/// <param name="version">The version, which must be supported as checked by
+/// <see cref="is_sample_version" />.</param>
+template<class TSample>
+inline std::size_t sample_size(_In_ const std::uint32_t version) noexcept {
+    return (version < sample_version)
+        ? offsetof(TSample, index)
+        : sizeof(TSample);
+}
+
+
+/// <summary>
+/// Copies the members of <paramref name="src" /> that exist in the given
+/// version to <paramref name="dst" /> and sets the version of the copy.
+/// </summary>
+/// <typeparam name="TSample">The type of the sample or segment.</typeparam>
+/// <param name="dst">Receives the copy, which must be able to hold
+/// <see cref="sample_size" /> bytes.</param>
+/// <param name="src">A sample of the current version.</param>
+/// <param name="version">The version to be stored, which must be supported
+/// as checked by <see cref="is_sample_version" />.</param>
+template<class TSample>
+inline void store_sample(_Out_ void *dst, _In_ TSample src,
+        _In_ const std::uint32_t version) noexcept {
+    src.version = version;
+    std::memcpy(dst, &src, sample_size<TSample>(version));
+}
+
+#endif /* !defined(_LIBPOWENETICS_SAMPLE_VERSION_H) */
@@ -0,0 +1,32 @@
+﻿// <copyright file="scheduling.cpp" company="Visualisierungsinstitut der Universität Stuttgart">
+// Copyright © 2026 Visualisierungsinstitut der Universität Stuttgart.
+// Licensed under the MIT licence. See LICENCE file for details.
+// </copyright>
+// <author>Christoph Müller</author>
+
+#include "libpowenetics/scheduling.h"
+
+#include <cstring>
+
+
+/*
+ * ::powenetics_initialise_thread_configuration
+ */
+HRESULT LIBPOWENETICS_API powenetics_initialise_thread_configuration(
+        _In_ powenetics_thread_configuration *config) {
+    if (config == nullptr) {
+        return E_POINTER;
+    }
+
+    switch (config->version) {
+        case 2:
+            ::memset(config->affinity, 0, sizeof(config->affinity));
+            config->scheduling = powenetics_scheduling::inherit;
+            config->priority = 0;
+            config->lock_memory = 0;
+            return S_OK;
+
+        default:
+            return E_INVALIDARG;
+    }
+}
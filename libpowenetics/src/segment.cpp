@@ -0,0 +1,57 @@
+﻿// <copyright file="segment.cpp" company="Visualisierungsinstitut der Universität Stuttgart">
+// Copyright © 2026 Visualisierungsinstitut der Universität Stuttgart.
+// Licensed under the MIT licence. See LICENCE file for details.
+// </copyright>
+// <author>Christoph Müller</author>
+
+#include "libpowenetics/segment.h"
+
+#include <cassert>
+#include <cstring>
+
+#include "profile_decoder.h"
+#include "sample_version.h"
+
+
+/*
+ * ::powenetics_decode_segment
+ */
+HRESULT LIBPOWENETICS_API powenetics_decode_segment(
+        _Inout_ powenetics_raw_sample *dst,
+        _In_ const powenetics_segment *src) {
+    if ((dst == nullptr) || (src == nullptr)) {
+        return E_POINTER;
+    }
+
+    const auto version = dst->version;
+    if (!::is_sample_version(version) || !::is_sample_version(src->version)) {
+        return E_INVALIDARG;
+    }
+    if (src->data == nullptr) {
+        return E_POINTER;
+    }
+
+    // Members that the version of the source does not have are zero.
+    powenetics_segment segment { };
+    std::memcpy(&segment, src, ::sample_size<powenetics_segment>(
+        src->version));
+    powenetics_raw_sample sample;
+
+    // We do not know the profile of the previous segment here, so we always
+    // detect it. The decoder for the detected profile accepts the segment by
+    // definition.
+    const auto profile = ::detect_connector_profile(segment.data);
+    const auto decoded = ::select_profile_decoder(profile)(sample,
+        segment.data);
+    assert(decoded);
+    (void) decoded;
+
+    sample.sequence_number = segment.sequence_number;
+    sample.timestamp = segment.timestamp;
+    sample.index = segment.index;
+    sample.missing = segment.missing;
+    sample.dropped = segment.dropped;
+    ::store_sample(dst, sample, version);
+
+    return S_OK;
+}
@@ -0,0 +1,408 @@
+﻿// <copyright file="segment_decoder.cpp" company="Visualisierungsinstitut der Universität Stuttgart">
+// Copyright © 2026 Visualisierungsinstitut der Universität Stuttgart.
+// Licensed under the MIT licence. See LICENCE file for details.
+// </copyright>
+// <author>Christoph Müller</author>
+
+#include "segment_decoder.h"
+
+#include <cassert>
+#include <cstring>
+
+#if defined(POWENETICS_X86)
+#include <immintrin.h>
+#endif /* defined(POWENETICS_X86) */
+
+
+/// <summary>
+/// The voltage in millivolts which must be exceeded for the current of a
+/// channel to be valid.
+/// </summary>
+static constexpr std::uint16_t discard_threshold = 1000;
+
+
+/// <summary>
+/// Answer the columns starting <paramref name="offset" /> elements behind
+/// <paramref name="columns" />.
+/// </summary>
+static segment_columns advance(_In_ const segment_columns& columns,
+        _In_ const std::size_t offset) noexcept {
+    segment_columns retval;
+    retval.sequence_numbers = columns.sequence_numbers + offset;
+    for (std::size_t c = 0; c < segment_channels; ++c) {
+        retval.voltages[c] = columns.voltages[c] + offset;
+        retval.currents[c] = columns.currents[c] + offset;
+    }
+    return retval;
+}
+
+
+#if defined(POWENETICS_X86)
+/// <summary>
+/// Reads four bytes from an arbitrarily aligned location.
+/// </summary>
+static inline int load_unaligned(_In_reads_(4) const std::uint8_t *src) {
+    int retval;
+    ::memcpy(&retval, src, sizeof(retval));
+    return retval;
+}
+#endif /* defined(POWENETICS_X86) */
+
+
+/*
+ * ::decode_segments_scalar
+ */
+void decode_segments_scalar(_In_ const segment_columns& dst,
+        _In_reads_bytes_(stride * cnt) const std::uint8_t *segments,
+        _In_ const std::size_t stride,
+        _In_ const std::size_t cnt) noexcept {
+    assert((segments != nullptr) || (cnt == 0));
+    assert(stride >= segment_min_stride);
+
+    for (std::size_t i = 0; i < cnt; ++i) {
+        auto cur = segments + i * stride;
+        dst.sequence_numbers[i] = static_cast<std::uint16_t>(
+            (cur[0] << 8) | cur[1]);
+        cur += sizeof(std::uint16_t);
+
+        for (std::size_t c = 0; c < segment_channels; ++c, cur += 5) {
+            const auto voltage = static_cast<std::uint16_t>(
+                (cur[0] << 8) | cur[1]);
+            dst.voltages[c][i] = voltage;
+            dst.currents[c][i] = (voltage > discard_threshold)
+                ? (std::uint32_t(cur[2]) << 16) | (cur[3] << 8) | cur[4]
+                : 0;
+        }
+    }
+}
+
+
+/*
+ * ::scale_currents_scalar
+ */
+void scale_currents_scalar(_Out_writes_(cnt) float *dst,
+        _In_reads_(cnt) const std::uint32_t *src,
+        _In_ const std::size_t cnt) noexcept {
+    assert((dst != nullptr) || (cnt == 0));
+    assert((src != nullptr) || (cnt == 0));
+    for (std::size_t i = 0; i < cnt; ++i) {
+        dst[i] = src[i] / 1000.0f;
+    }
+}
+
+
+/*
+ * ::scale_voltages_scalar
+ */
+void scale_voltages_scalar(_Out_writes_(cnt) float *dst,
+        _In_reads_(cnt) const std::uint16_t *src,
+        _In_ const std::size_t cnt) noexcept {
+    assert((dst != nullptr) || (cnt == 0));
+    assert((src != nullptr) || (cnt == 0));
+    for (std::size_t i = 0; i < cnt; ++i) {
+        dst[i] = src[i] / 1000.0f;
+    }
+}
+
+
+#if defined(POWENETICS_X86)
+/*
+ * ::decode_segments_ssse3
+ */
+POWENETICS_TARGET("ssse3")
+void decode_segments_ssse3(_In_ const segment_columns& dst,
+        _In_reads_bytes_(stride * cnt) const std::uint8_t *segments,
+        _In_ const std::size_t stride,
+        _In_ const std::size_t cnt) noexcept {
+    assert((segments != nullptr) || (cnt == 0));
+    assert(stride >= segment_min_stride);
+    // For each of four segments, we load the four bytes starting at the
+    // voltage of a channel into 'v' and the four bytes starting at the second
+    // byte of the voltage into 'c'. Note that the latter never reads beyond
+    // the last channel. The shuffles swap the big-endian voltages into the
+    // lower 64 bits or into 32-bit lanes for the comparison, and the 24-bit
+    // currents into 32-bit lanes.
+    const auto shuffle_v16 = ::_mm_setr_epi8(1, 0, 5, 4, 9, 8, 13, 12,
+        -1, -1, -1, -1, -1, -1, -1, -1);
+    const auto shuffle_v32 = ::_mm_setr_epi8(1, 0, -1, -1, 5, 4, -1, -1,
+        9, 8, -1, -1, 13, 12, -1, -1);
+    const auto shuffle_c32 = ::_mm_setr_epi8(3, 2, 1, -1, 7, 6, 5, -1,
+        11, 10, 9, -1, 15, 14, 13, -1);
+    const auto threshold = ::_mm_set1_epi32(discard_threshold);
+    constexpr std::size_t width = 4;
+    std::size_t i = 0;
+
+    for (; i + width <= cnt; i += width) {
+        const auto s0 = segments + i * stride;
+        const auto s1 = s0 + stride;
+        const auto s2 = s1 + stride;
+        const auto s3 = s2 + stride;
+
+        dst.sequence_numbers[i + 0] = static_cast<std::uint16_t>(
+            (s0[0] << 8) | s0[1]);
+        dst.sequence_numbers[i + 1] = static_cast<std::uint16_t>(
+            (s1[0] << 8) | s1[1]);
+        dst.sequence_numbers[i + 2] = static_cast<std::uint16_t>(
+            (s2[0] << 8) | s2[1]);
+        dst.sequence_numbers[i + 3] = static_cast<std::uint16_t>(
+            (s3[0] << 8) | s3[1]);
+
+        for (std::size_t c = 0; c < segment_channels; ++c) {
+            const auto o = sizeof(std::uint16_t) + 5 * c;
+            const auto v = ::_mm_setr_epi32(load_unaligned(s0 + o),
+                load_unaligned(s1 + o),
+                load_unaligned(s2 + o),
+                load_unaligned(s3 + o));
+            const auto a = ::_mm_setr_epi32(load_unaligned(s0 + o + 1),
+                load_unaligned(s1 + o + 1),
+                load_unaligned(s2 + o + 1),
+                load_unaligned(s3 + o + 1));
+
+            const auto valid = ::_mm_cmpgt_epi32(
+                ::_mm_shuffle_epi8(v, shuffle_v32), threshold);
+            const auto currents = ::_mm_and_si128(
+                ::_mm_shuffle_epi8(a, shuffle_c32), valid);
+            const auto voltages = ::_mm_shuffle_epi8(v, shuffle_v16);
+
+            ::_mm_storel_epi64(reinterpret_cast<__m128i *>(
+                dst.voltages[c] + i), voltages);
+            ::_mm_storeu_si128(reinterpret_cast<__m128i *>(
+                dst.currents[c] + i), currents);
+        }
+    }
+
+    ::decode_segments_scalar(::advance(dst, i), segments + i * stride,
+        stride, cnt - i);
+}
+
+
+/*
+ * ::decode_segments_avx2
+ */
+POWENETICS_TARGET("avx2")
+void decode_segments_avx2(_In_ const segment_columns& dst,
+        _In_reads_bytes_(stride * cnt) const std::uint8_t *segments,
+        _In_ const std::size_t stride,
+        _In_ const std::size_t cnt) noexcept {
+    assert((segments != nullptr) || (cnt == 0));
+    assert(stride >= segment_min_stride);
+    // This is the same as the SSSE3 implementation, but for eight segments,
+    // which we gather at once. As the shuffles operate on the 128-bit lanes
+    // separately, the voltages end up in the lower halves of both lanes and
+    // must be moved together before storing them. Note that intrinsics with
+    // immediate operands are macros in GCC and cannot be qualified.
+    const auto shuffle_v16 = ::_mm256_setr_epi8(1, 0, 5, 4, 9, 8, 13, 12,
+        -1, -1, -1, -1, -1, -1, -1, -1,
+        1, 0, 5, 4, 9, 8, 13, 12,
+        -1, -1, -1, -1, -1, -1, -1, -1);
+    const auto shuffle_v32 = ::_mm256_setr_epi8(1, 0, -1, -1, 5, 4, -1, -1,
+        9, 8, -1, -1, 13, 12, -1, -1,
+        1, 0, -1, -1, 5, 4, -1, -1,
+        9, 8, -1, -1, 13, 12, -1, -1);
+    const auto shuffle_c32 = ::_mm256_setr_epi8(3, 2, 1, -1, 7, 6, 5, -1,
+        11, 10, 9, -1, 15, 14, 13, -1,
+        3, 2, 1, -1, 7, 6, 5, -1,
+        11, 10, 9, -1, 15, 14, 13, -1);
+    const auto threshold = ::_mm256_set1_epi32(discard_threshold);
+    const auto s = static_cast<int>(stride);
+    const auto offsets = ::_mm256_setr_epi32(0, s, 2 * s, 3 * s, 4 * s,
+        5 * s, 6 * s, 7 * s);
+    constexpr std::size_t width = 8;
+    std::size_t i = 0;
+
+    for (; i + width <= cnt; i += width) {
+        const auto base = segments + i * stride;
+
+        for (std::size_t j = 0; j < width; ++j) {
+            const auto cur = base + j * stride;
+            dst.sequence_numbers[i + j] = static_cast<std::uint16_t>(
+                (cur[0] << 8) | cur[1]);
+        }
+
+        for (std::size_t c = 0; c < segment_channels; ++c) {
+            const auto o = base + sizeof(std::uint16_t) + 5 * c;
+            const auto v = _mm256_i32gather_epi32(
+                reinterpret_cast<const int *>(o), offsets, 1);
+            const auto a = _mm256_i32gather_epi32(
+                reinterpret_cast<const int *>(o + 1), offsets, 1);
+
+            const auto valid = ::_mm256_cmpgt_epi32(
+                ::_mm256_shuffle_epi8(v, shuffle_v32), threshold);
+            const auto currents = ::_mm256_and_si256(
+                ::_mm256_shuffle_epi8(a, shuffle_c32), valid);
+            const auto voltages = _mm256_permute4x64_epi64(
+                ::_mm256_shuffle_epi8(v, shuffle_v16), 0x08);
+
+            ::_mm_storeu_si128(reinterpret_cast<__m128i *>(
+                dst.voltages[c] + i), ::_mm256_castsi256_si128(voltages));
+            ::_mm256_storeu_si256(reinterpret_cast<__m256i *>(
+                dst.currents[c] + i), currents);
+        }
+    }
+
+    // Leave AVX code before continuing with the scalar implementation. See
+    // find_delimiter_avx2 for details.
+    ::_mm256_zeroupper();
+    ::decode_segments_scalar(::advance(dst, i), segments + i * stride,
+        stride, cnt - i);
+}
+
+
+/*
+ * ::scale_currents_avx2
+ */
+POWENETICS_TARGET("avx2")
+void scale_currents_avx2(_Out_writes_(cnt) float *dst,
+        _In_reads_(cnt) const std::uint32_t *src,
+        _In_ const std::size_t cnt) noexcept {
+    assert((dst != nullptr) || (cnt == 0));
+    assert((src != nullptr) || (cnt == 0));
+    // Note: The division yields the same result as the scalar code, which a
+    // multiplication by the reciprocal would not. The currents have only 24
+    // bits, so the conversion as signed integers is exact.
+    const auto scale = ::_mm256_set1_ps(1000.0f);
+    constexpr std::size_t width = 8;
+    std::size_t i = 0;
+
+    for (; i + width <= cnt; i += width) {
+        const auto s = ::_mm256_loadu_si256(
+            reinterpret_cast<const __m256i *>(src + i));
+        const auto d = ::_mm256_div_ps(::_mm256_cvtepi32_ps(s), scale);
+        ::_mm256_storeu_ps(dst + i, d);
+    }
+
+    ::_mm256_zeroupper();
+    ::scale_currents_scalar(dst + i, src + i, cnt - i);
+}
+
+
+/*
+ * ::scale_currents_sse2
+ */
+POWENETICS_TARGET("sse2")
+void scale_currents_sse2(_Out_writes_(cnt) float *dst,
+        _In_reads_(cnt) const std::uint32_t *src,
+        _In_ const std::size_t cnt) noexcept {
+    assert((dst != nullptr) || (cnt == 0));
+    assert((src != nullptr) || (cnt == 0));
+    // See scale_currents_avx2 for why this is exact.
+    const auto scale = ::_mm_set1_ps(1000.0f);
+    constexpr std::size_t width = 4;
+    std::size_t i = 0;
+
+    for (; i + width <= cnt; i += width) {
+        const auto s = ::_mm_loadu_si128(
+            reinterpret_cast<const __m128i *>(src + i));
+        const auto d = ::_mm_div_ps(::_mm_cvtepi32_ps(s), scale);
+        ::_mm_storeu_ps(dst + i, d);
+    }
+
+    ::scale_currents_scalar(dst + i, src + i, cnt - i);
+}
+
+
+/*
+ * ::scale_voltages_avx2
+ */
+POWENETICS_TARGET("avx2")
+void scale_voltages_avx2(_Out_writes_(cnt) float *dst,
+        _In_reads_(cnt) const std::uint16_t *src,
+        _In_ const std::size_t cnt) noexcept {
+    assert((dst != nullptr) || (cnt == 0));
+    assert((src != nullptr) || (cnt == 0));
+    const auto scale = ::_mm256_set1_ps(1000.0f);
+    constexpr std::size_t width = 8;
+    std::size_t i = 0;
+
+    for (; i + width <= cnt; i += width) {
+        const auto s = ::_mm256_cvtepu16_epi32(::_mm_loadu_si128(
+            reinterpret_cast<const __m128i *>(src + i)));
+        const auto d = ::_mm256_div_ps(::_mm256_cvtepi32_ps(s), scale);
+        ::_mm256_storeu_ps(dst + i, d);
+    }
+
+    ::_mm256_zeroupper();
+    ::scale_voltages_scalar(dst + i, src + i, cnt - i);
+}
+
+
+/*
+ * ::scale_voltages_sse2
+ */
+POWENETICS_TARGET("sse2")
+void scale_voltages_sse2(_Out_writes_(cnt) float *dst,
+        _In_reads_(cnt) const std::uint16_t *src,
+        _In_ const std::size_t cnt) noexcept {
+    assert((dst != nullptr) || (cnt == 0));
+    assert((src != nullptr) || (cnt == 0));
+    const auto scale = ::_mm_set1_ps(1000.0f);
+    const auto zero = ::_mm_setzero_si128();
+    constexpr std::size_t width = 8;
+    std::size_t i = 0;
+
+    for (; i + width <= cnt; i += width) {
+        const auto s = ::_mm_loadu_si128(
+            reinterpret_cast<const __m128i *>(src + i));
+        const auto lo = ::_mm_cvtepi32_ps(::_mm_unpacklo_epi16(s, zero));
+        const auto hi = ::_mm_cvtepi32_ps(::_mm_unpackhi_epi16(s, zero));
+        ::_mm_storeu_ps(dst + i, ::_mm_div_ps(lo, scale));
+        ::_mm_storeu_ps(dst + i + 4, ::_mm_div_ps(hi, scale));
+    }
+
+    ::scale_voltages_scalar(dst + i, src + i, cnt - i);
+}
+#endif /* defined(POWENETICS_X86) */
+
+
+/*
+ * ::select_current_scaler
+ */
+current_scaler select_current_scaler(void) noexcept {
+#if defined(POWENETICS_X86)
+    if (::has_cpu_feature(cpu_feature::avx2)) {
+        return ::scale_currents_avx2;
+    }
+
+    if (::has_cpu_feature(cpu_feature::sse2)) {
+        return ::scale_currents_sse2;
+    }
+#endif /* defined(POWENETICS_X86) */
+
+    return ::scale_currents_scalar;
+}
+
+
+/*
+ * ::select_segment_decoder
+ */
+segment_decoder select_segment_decoder(void) noexcept {
+#if defined(POWENETICS_X86)
+    if (::has_cpu_feature(cpu_feature::avx2)) {
+        return ::decode_segments_avx2;
+    }
+
+    if (::has_cpu_feature(cpu_feature::ssse3)) {
+        return ::decode_segments_ssse3;
+    }
+#endif /* defined(POWENETICS_X86) */
+
+    return ::decode_segments_scalar;
+}
+
+
+/*
+ * ::select_voltage_scaler
+ */
+voltage_scaler select_voltage_scaler(void) noexcept {
+#if defined(POWENETICS_X86)
+    if (::has_cpu_feature(cpu_feature::avx2)) {
+        return ::scale_voltages_avx2;
+    }
+
+    if (::has_cpu_feature(cpu_feature::sse2)) {
+        return ::scale_voltages_sse2;
+    }
+#endif /* defined(POWENETICS_X86) */
+
+    return ::scale_voltages_scalar;
+}
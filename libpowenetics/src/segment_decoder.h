@@ -0,0 +1,228 @@
+﻿// <copyright file="segment_decoder.h" company="Visualisierungsinstitut der Universität Stuttgart">
+// Copyright © 2026 Visualisierungsinstitut der Universität Stuttgart.
+// Licensed under the MIT licence. See LICENCE file for details.
+// </copyright>
+// <author>Christoph Müller</author>
+
+#if !defined(_LIBPOWENETICS_SEGMENT_DECODER_H)
+#define _LIBPOWENETICS_SEGMENT_DECODER_H
+#pragma once
+
+#include <cinttypes>
+#include <cstddef>
+
+#include "libpowenetics/api.h"
+
+#include "cpu_features.h"
+
+
+/// <summary>
+/// The number of channels transmitted in a single segment.
+/// </summary>
+constexpr std::size_t segment_channels = 13;
+
+/// <summary>
+/// The minimum number of bytes between the begin of two segments, which is
+/// the 16-bit sequence number followed by 16 bits of voltage and 24 bits of
+/// current for each channel.
+/// </summary>
+constexpr std::size_t segment_min_stride = sizeof(std::uint16_t)
+    + segment_channels * 5;
+
+
+/// <summary>
+/// Designates the column arrays receiving the decoded segments.
+/// </summary>
+/// <remarks>
+/// The columns are in the order of the channels on the wire, ie column 0 is
+/// channel 1 as documented in <see cref="sample_sequencer::parse_segment" />.
+/// All arrays must be able to hold the number of segments being decoded.
+/// </remarks>
+struct segment_columns {
+
+    /// <summary>
+    /// Receives the sequence numbers of the segments.
+    /// </summary>
+    std::uint16_t *sequence_numbers;
+
+    /// <summary>
+    /// Receive the voltages of the channels in millivolts.
+    /// </summary>
+    std::uint16_t *voltages[segment_channels];
+
+    /// <summary>
+    /// Receive the currents of the channels in milliamperes.
+    /// </summary>
+    /// <remarks>
+    /// As in <see cref="stream_parser_v2" />, the current is zero if the
+    /// voltage of the channel does not exceed 1000 mV.
+    /// </remarks>
+    std::uint32_t *currents[segment_channels];
+};
+
+
+/// <summary>
+/// The signature of all functions decoding a batch of segments into columns.
+/// </summary>
+/// <param name="dst">The columns to write the decoded data to.</param>
+/// <param name="segments">A pointer to the begin of the first segment, which
+/// is the first byte of the sequence number.</param>
+/// <param name="stride">The distance between the begin of two consecutive
+/// segments in bytes, which must be at least
+/// <see cref="segment_min_stride" />. For segments that are still framed by
+/// their delimiters, this is the length of the segment plus the length of the
+/// delimiter.</param>
+/// <param name="cnt">The number of segments to be decoded.</param>
+typedef void (*segment_decoder)(_In_ const segment_columns& dst,
+    _In_reads_bytes_(stride * cnt) const std::uint8_t *segments,
+    _In_ const std::size_t stride,
+    _In_ const std::size_t cnt);
+
+/// <summary>
+/// The signature of all functions converting a column of millivolts into
+/// Volts.
+/// </summary>
+typedef void (*voltage_scaler)(_Out_writes_(cnt) float *dst,
+    _In_reads_(cnt) const std::uint16_t *src,
+    _In_ const std::size_t cnt);
+
+/// <summary>
+/// The signature of all functions converting a column of milliamperes into
+/// Amperes.
+/// </summary>
+typedef void (*current_scaler)(_Out_writes_(cnt) float *dst,
+    _In_reads_(cnt) const std::uint32_t *src,
+    _In_ const std::size_t cnt);
+
+
+/// <summary>
+/// Decodes <paramref name="cnt" /> segments one channel after the other.
+/// </summary>
+void LIBPOWENETICS_TEST_API decode_segments_scalar(
+    _In_ const segment_columns& dst,
+    _In_reads_bytes_(stride * cnt) const std::uint8_t *segments,
+    _In_ const std::size_t stride,
+    _In_ const std::size_t cnt) noexcept;
+
+/// <summary>
+/// Converts <paramref name="cnt" /> millivolts into Volts one after the other.
+/// </summary>
+void LIBPOWENETICS_TEST_API scale_voltages_scalar(
+    _Out_writes_(cnt) float *dst,
+    _In_reads_(cnt) const std::uint16_t *src,
+    _In_ const std::size_t cnt) noexcept;
+
+/// <summary>
+/// Converts <paramref name="cnt" /> milliamperes into Amperes one after the
+/// other.
+/// </summary>
+void LIBPOWENETICS_TEST_API scale_currents_scalar(
+    _Out_writes_(cnt) float *dst,
+    _In_reads_(cnt) const std::uint32_t *src,
+    _In_ const std::size_t cnt) noexcept;
+
+#if defined(POWENETICS_X86)
+/// <summary>
+/// Decodes four segments at once by swapping the big-endian readings with a
+/// byte shuffle.
+/// </summary>
+/// <remarks>
+/// This function must only be called if the processor supports
+/// <see cref="cpu_feature::ssse3" />.
+/// </remarks>
+void LIBPOWENETICS_TEST_API decode_segments_ssse3(
+    _In_ const segment_columns& dst,
+    _In_reads_bytes_(stride * cnt) const std::uint8_t *segments,
+    _In_ const std::size_t stride,
+    _In_ const std::size_t cnt) noexcept;
+
+/// <summary>
+/// Decodes eight segments at once by gathering the readings and swapping
+/// them with a byte shuffle.
+/// </summary>
+/// <remarks>
+/// This function must only be called if the processor supports
+/// <see cref="cpu_feature::avx2" />.
+/// </remarks>
+void LIBPOWENETICS_TEST_API decode_segments_avx2(
+    _In_ const segment_columns& dst,
+    _In_reads_bytes_(stride * cnt) const std::uint8_t *segments,
+    _In_ const std::size_t stride,
+    _In_ const std::size_t cnt) noexcept;
+
+/// <summary>
+/// Converts <paramref name="cnt" /> millivolts into Volts, four at a time.
+/// </summary>
+/// <remarks>
+/// This function must only be called if the processor supports
+/// <see cref="cpu_feature::sse2" />.
+/// </remarks>
+void LIBPOWENETICS_TEST_API scale_voltages_sse2(
+    _Out_writes_(cnt) float *dst,
+    _In_reads_(cnt) const std::uint16_t *src,
+    _In_ const std::size_t cnt) noexcept;
+
+/// <summary>
+/// Converts <paramref name="cnt" /> milliamperes into Amperes, four at a
+/// time.
+/// </summary>
+/// <remarks>
+/// This function must only be called if the processor supports
+/// <see cref="cpu_feature::sse2" />.
+/// </remarks>
+void LIBPOWENETICS_TEST_API scale_currents_sse2(
+    _Out_writes_(cnt) float *dst,
+    _In_reads_(cnt) const std::uint32_t *src,
+    _In_ const std::size_t cnt) noexcept;
+
+/// <summary>
+/// Converts <paramref name="cnt" /> millivolts into Volts, eight at a time.
+/// </summary>
+/// <remarks>
+/// This function must only be called if the processor supports
+/// <see cref="cpu_feature::avx2" />.
+/// </remarks>
+void LIBPOWENETICS_TEST_API scale_voltages_avx2(
+    _Out_writes_(cnt) float *dst,
+    _In_reads_(cnt) const std::uint16_t *src,
+    _In_ const std::size_t cnt) noexcept;
+
+/// <summary>
+/// Converts <paramref name="cnt" /> milliamperes into Amperes, eight at a
+/// time.
+/// </summary>
+/// <remarks>
+/// This function must only be called if the processor supports
+/// <see cref="cpu_feature::avx2" />.
+/// </remarks>
+void LIBPOWENETICS_TEST_API scale_currents_avx2(
+    _Out_writes_(cnt) float *dst,
+    _In_reads_(cnt) const std::uint32_t *src,
+    _In_ const std::size_t cnt) noexcept;
+#endif /* defined(POWENETICS_X86) */
+
+/// <summary>
+/// Answer the fastest implementation of the segment decoder that is supported
+/// by the processor the code is running on.
+/// </summary>
+/// <returns>A pointer to the decoder function, which is never
+/// <c>nullptr</c>.</returns>
+segment_decoder LIBPOWENETICS_TEST_API select_segment_decoder(void) noexcept;
+
+/// <summary>
+/// Answer the fastest implementation of the voltage conversion that is
+/// supported by the processor the code is running on.
+/// </summary>
+/// <returns>A pointer to the conversion function, which is never
+/// <c>nullptr</c>.</returns>
+voltage_scaler LIBPOWENETICS_TEST_API select_voltage_scaler(void) noexcept;
+
+/// <summary>
+/// Answer the fastest implementation of the current conversion that is
+/// supported by the processor the code is running on.
+/// </summary>
+/// <returns>A pointer to the conversion function, which is never
+/// <c>nullptr</c>.</returns>
+current_scaler LIBPOWENETICS_TEST_API select_current_scaler(void) noexcept;
+
+#endif /* !defined(_LIBPOWENETICS_SEGMENT_DECODER_H) */
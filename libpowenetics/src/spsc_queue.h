@@ -0,0 +1,201 @@
+﻿// <copyright file="spsc_queue.h" company="Visualisierungsinstitut der Universität Stuttgart">
+// Copyright © 2026 Visualisierungsinstitut der Universität Stuttgart.
+// Licensed under the MIT licence. See LICENCE file for details.
+// </copyright>
+// <author>Christoph Müller</author>
+
+#if !defined(_LIBPOWENETICS_SPSC_QUEUE_H)
+#define _LIBPOWENETICS_SPSC_QUEUE_H
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cinttypes>
+#include <memory>
+#include <type_traits>
+
+#include "libpowenetics/api.h"
+#include "libpowenetics/types.h"
+
+
+/// <summary>
+/// A bounded ring buffer that transfers elements from exactly one producer
+/// thread to exactly one consumer thread without locks.
+/// </summary>
+/// <remarks>
+/// <para>All operations are wait-free: <see cref="push" /> fails rather
+/// than waiting if the queue is full, and <see cref="pop" /> returns
+/// whatever is available. Waiting for data, if needed, is up to the user of
+/// the queue.</para>
+/// <para>The producer may also reclaim the oldest element using
+/// <see cref="evict" />. Therefore, the consumer publishes the position it
+/// copies from and commits what it has copied with a CAS. If the CAS fails,
+/// the producer has evicted some of the copied elements, and the consumer
+/// drops their copies instead of starting over. Each failure means one more
+/// eviction within the elements copied, so the number of attempts is bounded
+/// by the number of elements requested.</para>
+/// <para>The positions of the producer and the consumer live on separate
+/// cache lines, and each side caches the position of the other one, such that
+/// the cache line of the other side is only touched if the cached position
+/// indicates that the queue is full or empty.</para>
+/// </remarks>
+/// <typeparam name="TElement">The type of the elements, which must be
+/// trivially copyable.</typeparam>
+template<class TElement> class spsc_queue final {
+
+public:
+
+    static_assert(std::is_trivially_copyable<TElement>::value, "The elements "
+        "of the queue must be trivially copyable.");
+
+    /// <summary>
+    /// The type of the elements in the queue.
+    /// </summary>
+    typedef TElement value_type;
+
+    /// <summary>
+    /// Initialises a new instance that is able to hold at least
+    /// <paramref name="capacity" /> elements.
+    /// </summary>
+    /// <param name="capacity">The minimum number of elements the queue can
+    /// hold, which is rounded up to the next power of two.</param>
+    /// <exception cref="std::bad_alloc">If the memory for the elements could
+    /// not be allocated.</exception>
+    explicit spsc_queue(_In_ const std::size_t capacity);
+
+    spsc_queue(const spsc_queue&) = delete;
+
+    /// <summary>
+    /// Answer the number of elements the queue can hold.
+    /// </summary>
+    inline std::size_t capacity(void) const noexcept {
+        return this->_mask + 1;
+    }
+
+    /// <summary>
+    /// Answer whether the queue is empty.
+    /// </summary>
+    /// <remarks>
+    /// The answer is only reliable on the consumer thread, because the
+    /// producer might add elements at any time.
+    /// </remarks>
+    inline bool empty(void) const noexcept {
+        return (this->size() == 0);
+    }
+
+    /// <summary>
+    /// Removes the oldest element from the queue on behalf of the producer.
+    /// </summary>
+    /// <remarks>
+    /// <para>This method must only be called by the producer thread.</para>
+    /// <para>A producer using this method must not fill more than half of
+    /// the <see cref="capacity" />. The other half guarantees that the
+    /// producer cannot overwrite the elements the consumer is copying while
+    /// it evicts elements behind the back of the consumer. The method fails
+    /// if evicting the element would violate this.</para>
+    /// </remarks>
+    /// <param name="dst">Receives the element that has been removed.</param>
+    /// <returns><c>true</c> if the element has been removed, <c>false</c> if
+    /// the queue is empty, if the consumer has taken the element first or if
+    /// the consumer is still copying elements the producer could reach after
+    /// the eviction.</returns>
+    bool evict(_Out_ value_type& dst) noexcept;
+
+    /// <summary>
+    /// Removes up to <paramref name="cnt" /> elements from the queue and
+    /// copies them to <paramref name="dst" />.
+    /// </summary>
+    /// <remarks>
+    /// <para>This method must only be called by the consumer thread.</para>
+    /// <para>If the producer evicts elements while they are being copied,
+    /// fewer elements than available are returned, possibly none at all.
+    /// </para>
+    /// </remarks>
+    /// <param name="dst">A buffer that is able to hold at least
+    /// <paramref name="cnt" /> elements.</param>
+    /// <param name="cnt">The maximum number of elements to remove.</param>
+    /// <returns>The number of elements that have been copied to
+    /// <paramref name="dst" />, which is zero if the queue is empty.
+    /// </returns>
+    std::size_t pop(_Out_writes_(cnt) value_type *dst,
+        _In_ const std::size_t cnt) noexcept;
+
+    /// <summary>
+    /// Adds <paramref name="element" /> to the queue if it is not full.
+    /// </summary>
+    /// <remarks>
+    /// This method must only be called by the producer thread.
+    /// </remarks>
+    /// <param name="element">The element to be added.</param>
+    /// <returns><c>true</c> if the element has been added, <c>false</c> if
+    /// the queue is full.</returns>
+    bool push(_In_ const value_type& element) noexcept;
+
+    /// <summary>
+    /// Answer the number of elements in the queue.
+    /// </summary>
+    /// <remarks>
+    /// The answer is a snapshot, which might be outdated as soon as it is
+    /// returned if the other side is active.
+    /// </remarks>
+    inline std::size_t size(void) const noexcept {
+        const auto order = std::memory_order::memory_order_acquire;
+        const auto tail = this->_producer.position.load(order);
+        const auto head = this->_consumer.position.load(order);
+        return tail - head;
+    }
+
+    spsc_queue& operator =(const spsc_queue&) = delete;
+
+private:
+
+    /// <summary>
+    /// The size of a cache line, which separates the state of the producer
+    /// from the state of the consumer.
+    /// </summary>
+    static constexpr std::size_t cache_line_size = 64;
+
+    /// <summary>
+    /// The value of <see cref="_reading" /> while the consumer is not
+    /// copying.
+    /// </summary>
+    static constexpr std::size_t idle = ~static_cast<std::size_t>(0);
+
+    /// <summary>
+    /// The state of one side of the queue.
+    /// </summary>
+    /// <remarks>
+    /// The positions increase monotonically and are only wrapped when the
+    /// buffer is accessed.
+    /// </remarks>
+    struct alignas(cache_line_size) side {
+
+        /// <summary>
+        /// The position the side has advanced to, which is only written by
+        /// the side itself unless the producer evicts elements.
+        /// </summary>
+        std::atomic<std::size_t> position;
+
+        /// <summary>
+        /// The last known position of the other side, which is only
+        /// accessed by the side itself.
+        /// </summary>
+        std::size_t other;
+    };
+
+    std::unique_ptr<value_type[]> _buffer;
+    side _consumer;
+    std::size_t _mask;
+    side _producer;
+
+    /// <summary>
+    /// The position the consumer is copying from, or <see cref="idle" />,
+    /// which the producer checks before it evicts an element.
+    /// </summary>
+    alignas(cache_line_size) std::atomic<std::size_t> _reading;
+};
+
+
+#include "spsc_queue.inl"
+
+#endif /* !defined(_LIBPOWENETICS_SPSC_QUEUE_H) */
@@ -0,0 +1,153 @@
+﻿// <copyright file="spsc_queue.inl" company="Visualisierungsinstitut der Universität Stuttgart">
+// Copyright © 2026 Visualisierungsinstitut der Universität Stuttgart.
+// Licensed under the MIT licence. See LICENCE file for details.
+// </copyright>
+// <author>Christoph Müller</author>
+
+
+/*
+ * spsc_queue<TElement>::spsc_queue
+ */
+template<class TElement>
+spsc_queue<TElement>::spsc_queue(_In_ const std::size_t capacity) {
+    std::size_t size = 1;
+    while (size < capacity) {
+        size <<= 1;
+    }
+
+    this->_buffer.reset(new value_type[size]);
+    this->_consumer.position.store(0, std::memory_order::memory_order_relaxed);
+    this->_consumer.other = 0;
+    this->_mask = size - 1;
+    this->_producer.position.store(0, std::memory_order::memory_order_relaxed);
+    this->_producer.other = 0;
+    this->_reading.store(idle, std::memory_order::memory_order_relaxed);
+}
+
+
+/*
+ * spsc_queue<TElement>::evict
+ */
+template<class TElement>
+bool spsc_queue<TElement>::evict(_Out_ value_type& dst) noexcept {
+    auto& me = this->_producer;
+    const auto tail = me.position.load(std::memory_order::memory_order_relaxed);
+    auto head = this->_consumer.position.load();
+
+    if (head == tail) {
+        return false;
+    }
+
+    // The producer fills at most half of the buffer, so it cannot reach the
+    // element the consumer copies from unless it has evicted another half
+    // since the consumer started. The consumer publishes its position before
+    // it checks that we have not evicted the element in the meantime, and
+    // the sequential consistency of both operations makes sure that we see
+    // it at the latest when we try the second eviction.
+    const auto reading = this->_reading.load();
+    if ((reading != idle) && (head + 1 - reading > this->capacity() / 2)) {
+        return false;
+    }
+
+    // Only the producer writes the elements, so we can copy the element
+    // before we know whether we succeed in removing it.
+    dst = this->_buffer[head & this->_mask];
+    if (!this->_consumer.position.compare_exchange_strong(head, head + 1)) {
+        // The consumer has taken the element in the meantime.
+        me.other = head;
+        return false;
+    }
+
+    me.other = head + 1;
+    return true;
+}
+
+
+/*
+ * spsc_queue<TElement>::pop
+ */
+template<class TElement>
+std::size_t spsc_queue<TElement>::pop(_Out_writes_(cnt) value_type *dst,
+        _In_ const std::size_t cnt) noexcept {
+    auto& me = this->_consumer;
+
+    // Publish where we copy from before we look at where we actually are,
+    // such that the producer does not overwrite the elements while we copy
+    // them. If the producer evicts elements in between, the published
+    // position is behind ours, which only protects more elements than
+    // necessary. See 'evict' for the other side.
+    auto head = me.position.load(std::memory_order::memory_order_relaxed);
+    this->_reading.store(head);
+    head = me.position.load();
+
+    // Only look at the producer if we cannot serve the request from what we
+    // knew it had published before. If the producer has evicted more than
+    // that, we do not know anything.
+    if ((head > me.other) || (me.other - head < cnt)) {
+        me.other = this->_producer.position.load(
+            std::memory_order::memory_order_acquire);
+    }
+
+    auto retval = (std::min)(cnt, me.other - head);
+
+    if (retval > 0) {
+        // The elements might wrap around the end of the buffer, in which case
+        // we need to copy in two chunks.
+        const auto first = head & this->_mask;
+        const auto chunk = (std::min)(retval, this->capacity() - first);
+        std::copy(this->_buffer.get() + first,
+            this->_buffer.get() + first + chunk,
+            dst);
+        std::copy(this->_buffer.get(),
+            this->_buffer.get() + (retval - chunk),
+            dst + chunk);
+
+        // If the producer has evicted some of the elements in the meantime,
+        // the CAS fails. We keep the copies of the elements that are left
+        // rather than copying again, and as every failure means that the
+        // producer has evicted at least one more of them, we give up after at
+        // most 'retval' attempts.
+        const auto end = head + retval;
+        auto expected = head;
+        while (!me.position.compare_exchange_strong(expected, end)) {
+            if (expected >= end) {
+                break;
+            }
+        }
+
+        if (expected >= end) {
+            retval = 0;
+        } else if (expected > head) {
+            const auto evicted = expected - head;
+            std::copy(dst + evicted, dst + retval, dst);
+            retval -= evicted;
+        }
+    }
+
+    this->_reading.store(idle, std::memory_order::memory_order_release);
+    return retval;
+}
+
+
+/*
+ * spsc_queue<TElement>::push
+ */
+template<class TElement>
+bool spsc_queue<TElement>::push(_In_ const value_type& element) noexcept {
+    auto& me = this->_producer;
+    const auto tail = me.position.load(std::memory_order::memory_order_relaxed);
+
+    if (tail - me.other > this->_mask) {
+        // The queue was full when we last looked, so check whether the
+        // consumer has made room in the meantime.
+        me.other = this->_consumer.position.load(
+            std::memory_order::memory_order_acquire);
+        if (tail - me.other > this->_mask) {
+            return false;
+        }
+    }
+
+    this->_buffer[tail & this->_mask] = element;
+    me.position.store(tail + 1, std::memory_order::memory_order_release);
+    return true;
+}
@@ -0,0 +1,116 @@
+﻿// <copyright file="stream_parser.h" company="Visualisierungsinstitut der Universität Stuttgart">
+// Copyright © 2026 Visualisierungsinstitut der Universität Stuttgart.
+// Licensed under the MIT licence. See LICENCE file for details.
+// </copyright>
+// <author>Christoph Müller</author>
+
+#if !defined(_LIBPOWENETICS_STREAM_PARSER_H)
+#define _LIBPOWENETICS_STREAM_PARSER_H
+#pragma once
+
+#include <cinttypes>
+#include <type_traits>
+#include <utility>
+
+#include "libpowenetics/raw_sample.h"
+#include "libpowenetics/sample.h"
+#include "libpowenetics/segment.h"
+#include "libpowenetics/timestamp.h"
+
+#include "clock.h"
+#include "energy_integrator.h"
+#include "profile_decoder.h"
+#include "sample_sequencer.h"
+
+
+/// <summary>
+/// A callback that accepts any sample, which is used to check the parser
+/// concept.
+/// </summary>
+struct stream_parser_probe_callback final {
+    template<class TSample> inline void operator ()(const TSample&) const { }
+};
+
+
+/// <summary>
+/// Determines whether <typeparamref name="TParser" /> satisfies the concept of
+/// a stream parser, which is what the streaming thread of
+/// <see cref="powenetics_device" /> is instantiated for.
+/// </summary>
+/// <remarks>
+/// <para>A stream parser must be default-constructible and provide the
+/// following members, which are all resolved at compile time such that the
+/// streaming thread does not make any virtual call per byte or per sample:
+/// <list type="bullet">
+/// <item><c>byte_type</c>, the type of a byte received from the device.</item>
+/// <item><c>statistics_type</c>, the counters the parser maintains, which
+/// must be <see cref="parser_statistics" />.</item>
+/// <item><c>push_back&lt;TSample&gt;(data, cnt, callback)</c>, which parses
+/// <c>cnt</c> bytes and passes each sample to <c>callback</c>. The parser must
+/// support <see cref="powenetics_sample" />,
+/// <see cref="powenetics_raw_sample" /> and
+/// <see cref="powenetics_segment" />, the latter without decoding the
+/// segment.</item>
+/// <item><c>collect_statistics()</c>, which answers and resets the counters.
+/// </item>
+/// <item><c>energy()</c>, which answers the
+/// <see cref="energy_integrator" /> of all samples delivered so far.</item>
+/// <item><c>profile()</c>, which answers the most recent connector profile.
+/// </item>
+/// <item><c>clock(clock_function)</c>, <c>timestamping(mode)</c>,
+/// <c>timestamping()</c>, <c>received(timestamp)</c> and <c>now()</c>, which
+/// control the timestamps of the samples like in
+/// <see cref="stream_parser_v2" />.</item>
+/// </list></para>
+/// <para>As the library is built as C++17, the concept is checked using this
+/// trait in a <c>static_assert</c> rather than as a C++20 concept.</para>
+/// </remarks>
+template<class TParser, class = void>
+struct is_stream_parser : std::false_type { };
+
+
+/// <summary>
+/// Specialisation for parsers that provide all required members.
+/// </summary>
+template<class TParser>
+struct is_stream_parser<TParser, std::void_t<
+        typename TParser::byte_type,
+        typename TParser::statistics_type,
+        decltype(std::declval<TParser&>().template push_back<
+            powenetics_sample>(
+            std::declval<const typename TParser::byte_type *>(),
+            std::declval<std::size_t>(),
+            stream_parser_probe_callback())),
+        decltype(std::declval<TParser&>().template push_back<
+            powenetics_raw_sample>(
+            std::declval<const typename TParser::byte_type *>(),
+            std::declval<std::size_t>(),
+            stream_parser_probe_callback())),
+        decltype(std::declval<TParser&>().template push_back<
+            powenetics_segment>(
+            std::declval<const typename TParser::byte_type *>(),
+            std::declval<std::size_t>(),
+            stream_parser_probe_callback())),
+        decltype(std::declval<TParser&>().clock(
+            std::declval<clock_function>())),
+        decltype(std::declval<TParser&>().timestamping(
+            std::declval<powenetics_timestamping>())),
+        decltype(std::declval<TParser&>().received(
+            std::declval<powenetics_timestamp>()))>>
+    : std::integral_constant<bool,
+        std::is_default_constructible<TParser>::value
+        && std::is_same<typename TParser::statistics_type,
+            parser_statistics>::value
+        && std::is_same<decltype(std::declval<TParser&>()
+            .collect_statistics()),
+            typename TParser::statistics_type>::value
+        && std::is_same<decltype(std::declval<const TParser&>().energy()),
+            const energy_integrator&>::value
+        && std::is_same<decltype(std::declval<const TParser&>().profile()),
+            connector_profile>::value
+        && std::is_same<decltype(std::declval<const TParser&>()
+            .timestamping()), powenetics_timestamping>::value
+        && std::is_same<decltype(std::declval<const TParser&>().now()),
+            powenetics_timestamp>::value> { };
+
+#endif /* !defined(_LIBPOWENETICS_STREAM_PARSER_H) */
@@ -14,16 +14,23 @@
 #include <cstring>
 #include <functional>
 #include <iterator>
-#include <vector>
+#include <limits>
 
 #include "libpowenetics/api.h"
+#include "libpowenetics/raw_sample.h"
 #include "libpowenetics/sample.h"
+#include "libpowenetics/timestamp.h"
 #include "libpowenetics/types.h"
 
+#include "clock.h"
+#include "continuity_filter.h"
 #include "convert.h"
 #include "debug.h"
 #include "endian.h"
+#include "framing_state.h"
+#include "profile_decoder.h"
 #include "responses.h"
+#include "sample_sequencer.h"
 
 
 /// <summary>
@@ -35,7 +42,28 @@
 /// packet fragmentation by itself. Every time it has assembled a full packet,
 /// it will deliver it to the registered callback.</para>
 /// <para>The parser is stateful and can be used for only one stream as it
-/// buffers unused input until it is called next.</para>
+/// buffers unused input until it is called next. Complete segments are always
+/// parsed in-place from the input. Only the unfinished tail of the input is
+/// retained in a fixed-size carry-over area that can hold at most one segment
+/// and the delimiter following it, so the parser never copies the full input
+/// and never allocates memory.</para>
+/// <para>As all segments have the same length, the parser only searches for a
+/// delimiter when it is not synchronised with the stream. Afterwards, it jumps
+/// from segment to segment and only checks that the next delimiter is where it
+/// is expected. Only if this check fails, the parser searches for the next
+/// delimiter again. This way, bytes in the payload that happen to look like a
+/// delimiter cannot split a segment.</para>
+/// <para>Until the parser is locked, correctly framed segments are only
+/// delivered if their sequence numbers are continuous as decided by a
+/// <see cref="continuity_filter" />. A segment that breaks the sequence is
+/// held back until the next segment confirms it, such that a false lock on
+/// delimiters in the payload does not deliver any data. Once locked, the
+/// parser delivers all correctly framed segments and jumps in the sequence
+/// are reported as gaps.</para>
+/// <para>Splitting the stream into segments is separate from turning the
+/// segments into samples, which is done by a <see cref="sample_sequencer" />.
+/// This allows other parsers like <see cref="columnar_parser_v2" /> to reuse
+/// the framing of this parser with a different decoder.</para>
 /// <para>The parser is <i>not thread-safe!</i> Make sure to enqueue new data
 /// always from the same thread or serialise the operation somehow.</para>
 /// </remarks>
@@ -48,22 +76,108 @@ public:
     /// </summary>
     typedef std::uint8_t byte_type;
 
+    /// <summary>
+    /// The expected number of bytes in a valid segment.
+    /// </summary>
+    /// <remarks>
+    /// A valid segment comprises a 16-bit sequence number and 13 samples of
+    /// 16-bit voltage data and 24-bit current data.
+    /// </remarks>
+    static constexpr std::size_t segment_length
+        = sample_sequencer::segment_length;
+
+    /// <summary>
+    /// The size of the carry-over area, which must be able to hold a full
+    /// segment and the delimiter that terminates it.
+    /// </summary>
+    static constexpr std::size_t carry_capacity = segment_length
+        + responses_v2::segment_delimiter.size();
+
+    /// <summary>
+    /// The counters the parser maintains about the health of the stream.
+    /// </summary>
+    typedef parser_statistics statistics_type;
+
+    /// <summary>
+    /// Initialises a new instance.
+    /// </summary>
+    inline stream_parser_v2(void) noexcept
+        : _cnt_carry(0),
+        _framing(framing_state::hunting),
+        _statistics() { }
+
+    /// <summary>
+    /// Changes the clock the samples are stamped with.
+    /// </summary>
+    /// <param name="clock">The function reading the clock, which must not be
+    /// <c>nullptr</c>.</param>
+    inline void clock(_In_ const clock_function clock) noexcept {
+        this->_sequencer.clock(clock);
+    }
+
+    /// <summary>
+    /// Answer the counters accumulated since the last call and reset them.
+    /// </summary>
+    /// <returns>The counters since the last call.</returns>
+    inline statistics_type collect_statistics(void) noexcept {
+        auto retval = this->_statistics;
+        this->_statistics = statistics_type();
+        this->_sequencer.collect_statistics(retval);
+        return retval;
+    }
+
+    /// <summary>
+    /// Answer the energy integrated from all samples delivered so far.
+    /// </summary>
+    inline const energy_integrator& energy(void) const noexcept {
+        return this->_sequencer.energy();
+    }
+
     /// <summary>
     /// Discards any buffered data from previous calls that could not be
-    /// delivered.
+    /// delivered, including a segment that has been held back.
+    /// </summary>
+    void flush(void) noexcept;
+
+    /// <summary>
+    /// Answer whether and how reliably the parser is synchronised with the
+    /// segments in the data stream.
+    /// </summary>
+    /// <returns>The current framing state.</returns>
+    inline framing_state framing(void) const noexcept {
+        return this->_framing;
+    }
+
+    /// <summary>
+    /// Reads the clock the samples are stamped with.
     /// </summary>
-    inline void flush(void) {
-        this->_buffer.clear();
+    /// <returns>The current time.</returns>
+    inline powenetics_timestamp now(void) const {
+        return this->_sequencer.now();
+    }
+
+    /// <summary>
+    /// Answer the connector profile detected from the most recent segment.
+    /// </summary>
+    /// <returns>The connector profile, which is
+    /// <see cref="connector_profile_unknown" /> until the first segment has
+    /// been parsed.</returns>
+    inline connector_profile profile(void) const noexcept {
+        return this->_sequencer.profile();
     }
 
     /// <summary>
     /// Splits the given <paramref name="data" /> and potentially a remainder
     /// that could not be processed in the previous call into segments, parses
-    /// the data in these segments and delivers the resulting
-    /// <see cref="powenetics_sample" />s to <paramref name="callback" />.
+    /// the data in these segments and delivers the resulting samples to
+    /// <paramref name="callback" />.
     /// </summary>
+    /// <typeparam name="TSample">The type of the samples to be delivered,
+    /// which must be <see cref="powenetics_sample" />,
+    /// <see cref="powenetics_raw_sample" /> or
+    /// <see cref="powenetics_segment" />.</typeparam>
     /// <typeparam name="TCallback">The type of the callback functor to be
-    /// invoked, which must accept a single <see cref="powenetics_sample" />
+    /// invoked, which must accept a single <typeparamref name="TSample" />
     /// in which the information that have been parsed are returned.
     /// </typeparam>
     /// <param name="data">The data to be parsed, which must be a
@@ -74,21 +188,82 @@ public:
     /// was found. This must be a valid functor.</param>
     /// <returns><c>true</c> if data have been buffered until the next call,
     /// because the input could not be fully tokenised.</returns>
-    template<class TCallback> bool push_back(
+    template<class TSample = powenetics_sample, class TCallback>
+    bool push_back(
         _In_reads_(cnt) const byte_type *data,
         _In_ const std::size_t cnt,
         _In_ TCallback&& callback);
 
-private:
+    /// <summary>
+    /// Splits the given <paramref name="data" /> and potentially a remainder
+    /// that could not be processed in the previous call into segments and
+    /// passes the begin of each correctly framed segment to
+    /// <paramref name="callback" /> without decoding it.
+    /// </summary>
+    /// <typeparam name="TCallback">The type of the callback functor, which
+    /// must accept a pointer to the first of <see cref="segment_length" />
+    /// bytes of a segment.</typeparam>
+    /// <param name="data">The data to be parsed, which must be a
+    /// non-<c>nullptr</c> pointer to <paramref name="cnt" /> bytes of data
+    /// received from the device.</param>
+    /// <param name="cnt">The size of <paramref name="data" /> in bytes.</param>
+    /// <param name="callback">The callback to be invoked if a full segment
+    /// was found. The segment passed to the callback is either within
+    /// <paramref name="data" /> or within the carry-over area of the parser,
+    /// in which case it is only valid until the callback returns.</param>
+    /// <returns><c>true</c> if data have been buffered until the next call,
+    /// because the input could not be fully tokenised.</returns>
+    template<class TCallback>
+    bool push_back_segments(
+        _In_reads_(cnt) const byte_type *data,
+        _In_ const std::size_t cnt,
+        _In_ TCallback&& callback);
 
     /// <summary>
-    /// The expected number of bytes in a valid segment.
+    /// Sets the host time at which the data passed to the next call to
+    /// <see cref="push_back" /> have been received.
     /// </summary>
     /// <remarks>
-    /// A valid segment comprises a 16-bit sequence number and 13 samples of
-    /// 16-bit voltage data and 24-bit current data.
+    /// This information is only used if the timestamps are
+    /// <see cref="powenetics_timestamping::interpolated" />, in which case it
+    /// must be set before each call to <see cref="push_back" />.
+    /// </remarks>
+    /// <param name="timestamp">The time at which the read from the device
+    /// completed.</param>
+    inline void received(_In_ const powenetics_timestamp timestamp) noexcept {
+        this->_sequencer.received(timestamp);
+    }
+
+    /// <summary>
+    /// Answer the sequencer that turns the segments into samples.
+    /// </summary>
+    /// <remarks>
+    /// Parsers that only use <see cref="push_back_segments" /> need to decode
+    /// and sequence the segments themselves.
     /// </remarks>
-    static constexpr std::size_t segment_length = 67;
+    /// <returns>The sequencer of the parser.</returns>
+    inline sample_sequencer& sequencer(void) noexcept {
+        return this->_sequencer;
+    }
+
+    /// <summary>
+    /// Answer how the timestamps of the samples are obtained.
+    /// </summary>
+    /// <returns>The timestamping mode.</returns>
+    inline powenetics_timestamping timestamping(void) const noexcept {
+        return this->_sequencer.timestamping();
+    }
+
+    /// <summary>
+    /// Changes how the timestamps of the samples are obtained.
+    /// </summary>
+    /// <param name="timestamping">The new timestamping mode.</param>
+    inline void timestamping(
+            _In_ const powenetics_timestamping timestamping) noexcept {
+        this->_sequencer.timestamping(timestamping);
+    }
+
+private:
 
     /// <summary>
     /// Finds the first occurrence of <paramref name="delimiter" /> in
@@ -102,36 +277,83 @@ private:
         _In_ const std::size_t cnt);
 
     /// <summary>
-    /// Parses the given segment and if it has the expected size, invoke
-    /// the callback.
+    /// Answer whether <paramref name="segment" /> is followed by a delimiter
+    /// directly after <see cref="segment_length" /> bytes.
+    /// </summary>
+    /// <param name="segment">The begin of a segment, which must designate at
+    /// least <see cref="carry_capacity" /> bytes.</param>
+    /// <returns><c>true</c> if the segment is correctly framed.</returns>
+    static inline bool is_framed(
+            _In_reads_(carry_capacity) const byte_type *segment) noexcept {
+        auto& delimiter = responses_v2::segment_delimiter;
+        return ((segment[segment_length] == delimiter.front())
+            && (segment[segment_length + 1] == delimiter.back()));
+    }
+
+    /// <summary>
+    /// Updates the framing state from the sequence number of the correctly
+    /// framed segment starting at <paramref name="segment" /> and delivers
+    /// the segment to <paramref name="callback" /> once its sequence number
+    /// has been confirmed.
+    /// </summary>
+    template<class TCallback> void emit(
+        _In_reads_(segment_length) const byte_type *segment,
+        _In_ TCallback& callback);
+
+    /// <summary>
+    /// Counts the segment held back as rejected.
+    /// </summary>
+    void reject_held(void) noexcept;
+
+    /// <summary>
+    /// Searches the next delimiter after the segment starting at
+    /// <paramref name="begin" /> failed the framing check.
     /// </summary>
-    /// <param name="dst">The variable receiving the sample, provided the data
-    /// are valid.</param>
-    /// <param name="begin">The begin of the sample, excluding the delimitor.
-    /// </param>
-    /// <param name="end">The end of the sample. This pointer is not valid any
-    /// more.</param>
-    /// <returns><c>true</c> if <paramref name="dst" /> was written,
-    /// <c>false</c> otherwise.</returns>
-    static bool parse_segment(_Out_ powenetics_sample& dst,
+    /// <returns>The begin of the next segment candidate, or <c>nullptr</c> if
+    /// there is no delimiter before <paramref name="end" />, in which case the
+    /// parser is not synchronised any more.</returns>
+    _Ret_maybenull_ const byte_type *resync(
         _In_reads_(end - begin) const byte_type *begin,
         _In_ const byte_type *end) noexcept;
 
     /// <summary>
-    /// Parse <paramref name="data" /> as voltage and current and advance
-    /// data past the data that have been parsed.
+    /// Completes the segment in the carry-over area from the previous call
+    /// with the begin of <paramref name="data" />.
     /// </summary>
-    /// <param name="data">The pointer to the begin of the sample, which must
-    /// designate at least 5 bytes.</param>
-    /// <param name="discard_threshold">The voltage threshold which must be
-    /// exceeded in order to generate a valid current reading. Otherwise,
-    /// the current reading will be set to zero.</param>
-    /// <returns>The parsed values.</returns>
-    static powenetics_voltage_current parse_value(
-        _In_reads_(5) _Out_ const byte_type *& data,
-        _In_ const float discard_threshold = 1.0f) noexcept;
+    /// <remarks>
+    /// The method copies at most as many bytes from <paramref name="data" />
+    /// as are needed to check the framing of the segment being assembled.
+    /// </remarks>
+    /// <returns>The position in <paramref name="data" /> from which on the
+    /// input must be tokenised in-place, or <c>nullptr</c> if all of
+    /// <paramref name="data" /> has been consumed.</returns>
+    template<class TCallback>
+    _Ret_maybenull_ const byte_type *resume(
+        _In_reads_(cnt) const byte_type *data,
+        _In_ const std::size_t cnt,
+        _In_ TCallback& callback);
 
-    std::vector<byte_type> _buffer;
+    /// <summary>
+    /// Tokenises the range between <paramref name="begin" /> and
+    /// <paramref name="end" /> in-place and retains the unfinished tail in the
+    /// carry-over area.
+    /// </summary>
+    template<class TCallback> void tokenise(
+        _In_reads_(end - begin) const byte_type *begin,
+        _In_ const byte_type *end,
+        _In_ TCallback& callback);
+
+    std::array<byte_type, carry_capacity> _carry;
+    std::size_t _cnt_carry;
+    continuity_filter _continuity;
+    framing_state _framing;
+
+    /// <summary>
+    /// A copy of the segment held back by <see cref="_continuity" />.
+    /// </summary>
+    std::array<byte_type, segment_length> _held;
+    sample_sequencer _sequencer;
+    statistics_type _statistics;
 };
 
 #include "stream_parser_v2.inl"
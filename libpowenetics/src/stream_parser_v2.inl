@@ -1,5 +1,5 @@
 ﻿// <copyright file="stream_parser_v2.inl" company="Visualisierungsinstitut der Universität Stuttgart">
-// Copyright © 2023 - 2024 Visualisierungsinstitut der Universität Stuttgart.
+// Copyright © 2023 - 2026 Visualisierungsinstitut der Universität Stuttgart.
 // Licensed under the MIT licence. See LICENCE file for details.
 // </copyright>
 // <author>Christoph Müller</author>
@@ -8,75 +8,219 @@
 /*
  * stream_parser_v2::push_back
  */
-template<class TCallback>
+template<class TSample, class TCallback>
 bool stream_parser_v2::push_back(_In_reads_(cnt) const byte_type *data,
         _In_ const std::size_t cnt,
         _In_ TCallback&& callback) {
+    const auto retval = this->push_back_segments(data, cnt,
+            [this, &callback](const byte_type *segment) {
+        TSample sample;
+        this->_sequencer.sequence(sample, segment);
+        callback(sample);
+    });
+
+    this->_sequencer.observe();
+
+    return retval;
+}
+
+
+/*
+ * stream_parser_v2::push_back_segments
+ */
+template<class TCallback>
+bool stream_parser_v2::push_back_segments(
+        _In_reads_(cnt) const byte_type *data,
+        _In_ const std::size_t cnt,
+        _In_ TCallback&& callback) {
+    assert(data != nullptr);
+    auto cur = data;
+
+    if (this->_cnt_carry > 0) {
+        // If we have an unfinished segment from the previous call, complete it
+        // first. This only copies the bytes missing in the carry-over area, the
+        // rest of the input is processed in-place.
+        cur = this->resume(data, cnt, callback);
+    }
+
+    if (cur != nullptr) {
+        this->tokenise(cur, data + cnt, callback);
+    }
+
+    const auto retval = (this->_cnt_carry > 0);
+    if (retval) {
+        ++this->_statistics.carry_overs;
+    }
+
+    return retval;
+}
+
+
+/*
+ * stream_parser_v2::emit
+ */
+template<class TCallback>
+void stream_parser_v2::emit(
+        _In_reads_(segment_length) const byte_type *segment,
+        _In_ TCallback& callback) {
+    // Two consecutive, correctly framed segments with consecutive sequence
+    // numbers lock the parser. Until then, a break in the sequence indicates
+    // that we are following delimiters in the payload, so we hold the segment
+    // back until the next one confirms it. Once locked, the parser delivers
+    // every segment it finds where it expects it and leaves reporting jumps
+    // in the sequence as gaps to the sequencer.
+    const auto held = this->_continuity.held();
+
+    if (this->_continuity.check(::to_uint16(segment))) {
+        this->_framing = framing_state::locked;
+        if (held) {
+            callback(this->_held.data());
+        }
+        callback(segment);
+
+    } else {
+        this->_framing = framing_state::acquiring;
+        if (held) {
+            this->reject_held();
+        }
+        std::copy(segment, segment + segment_length, this->_held.begin());
+    }
+}
+
+
+/*
+ * stream_parser_v2::resume
+ */
+template<class TCallback>
+_Ret_maybenull_ const stream_parser_v2::byte_type *stream_parser_v2::resume(
+        _In_reads_(cnt) const byte_type *data,
+        _In_ const std::size_t cnt,
+        _In_ TCallback& callback) {
     assert(data != nullptr);
     auto& delimiter = responses_v2::segment_delimiter;
+    auto cur = data;
     const auto end = data + cnt;
+    auto carry = this->_carry.data();
 
-    if (this->_buffer.empty()) {
-        // If the buffer is empty, we first check the input in-place without
-        // buffering it. Whatever is not part of a segment will be pushed to
-        // the _buffer in the end and preserved for the next call.
-        auto cur = find_delimiter(data, cnt);
+    while (this->_cnt_carry > 0) {
+        if (cur == end) {
+            // Nothing to add, so we keep the carry-over for the next call.
+            return nullptr;
+        }
 
-        if (cur == nullptr) {
-            // If we did not find the delimiter, we need to buffer everything
-            // until the next call hopefully provides enough data.
-            assert(this->_buffer.empty());
-            this->_buffer.reserve(cnt);
-            std::copy(data, data + cnt, std::back_inserter(this->_buffer));
+        if (this->_framing == framing_state::hunting) {
+            // If we are not synchronised, the only thing we keep is the first
+            // half of a delimiter at the end of the previous input. If the
+            // input starts with the second half, we are in sync from the
+            // second byte on. Otherwise, we need to search from the start.
+            assert(this->_cnt_carry == 1);
+            assert(this->_carry.front() == delimiter.front());
+            this->_cnt_carry = 0;
+
+            if (*cur == delimiter.back()) {
+                this->_framing = framing_state::acquiring;
+                ++cur;
+            } else {
+                ++this->_statistics.bytes_discarded;
+            }
+
+            return cur;
+        }
+
+        // If we are synchronised, the carry-over is the begin of a segment.
+        // Copy as much of the input as is required to check the framing.
+        const auto cnt_copy = (std::min)(static_cast<std::size_t>(end - cur),
+            this->_carry.size() - this->_cnt_carry);
+        std::copy(cur, cur + cnt_copy, carry + this->_cnt_carry);
+        this->_cnt_carry += cnt_copy;
+        cur += cnt_copy;
+
+        if (this->_cnt_carry < this->_carry.size()) {
+            // We consumed all of the input, but the segment is incomplete.
+            assert(cur == end);
+            return nullptr;
+        }
+
+        this->_cnt_carry = 0;
+
+        if (is_framed(carry)) {
+            // The delimiter is where we expect it, so the segment is complete
+            // and the input continues with the next segment.
+            this->emit(carry, callback);
 
         } else {
-            // If buffer is empty and we found the separator, it must be at
-            // the begin of the data. Otherwise, we have at least some rubbish
-            // data at the begin which we need to discard, because we have no
-            // way to interpret it without the marker at the start of the
-            // segment.
-
-            while (cur != nullptr) {
-                assert(cur[0] == delimiter.front());
-                assert(cur[1] == delimiter.back());
-                auto next = find_delimiter(cur + delimiter.size(), end - cur);
-
-                if (next != nullptr) {
-                    // We found a segment between 'cur' and 'next'. We now parse
-                    // the data in the segment and if this yields a sample, we
-                    // deliver it to the callback.
-                    powenetics_sample sample;
-                    sample.version = 2;
-                    if (parse_segment(sample, cur + delimiter.size(), next)) {
-                        callback(sample);
-                    } else {
-                        _powenetics_debug("Discarding invalid segment.\r\n");
-                    }
-
-                } else {
-                    // We did not find the end of the segment after 'cur', so
-                    // preserve the input until the next call.
-                    this->_buffer.reserve(cnt);
-                    assert(cur[0] == delimiter.front());
-                    assert(cur[1] == delimiter.back());
-                    std::copy(cur, end, std::back_inserter(this->_buffer));
-                }
-
-                cur = next;
-            } /* while (cur != nullptr) */
-        } /* if (cur == nullptr) */
-
-        return !this->_buffer.empty();
+            // The framing check failed, so search for the next segment within
+            // the carry-over. If there is one, its begin becomes the new
+            // carry-over, which we need to complete in the next iteration. If
+            // there is none, 'resync' has preserved a potential first half of
+            // a delimiter for us.
+            auto next = this->resync(carry, carry + this->_carry.size());
+            if (next != nullptr) {
+                const auto cnt_move = carry + this->_carry.size() - next;
+                std::copy(next, next + cnt_move, carry);
+                this->_cnt_carry = cnt_move;
+            }
+        }
+    } /* while (this->_cnt_carry > 0) */
 
-    } else {
-        // If the buffer is not empty, we take it and call the method
-        // recursively to parse the concatenated content. This is not the
-        // most performant implementation, but it should suffice for now.
-        auto buffer = std::move(this->_buffer);
-        buffer.reserve(buffer.size() + cnt);
-        std::copy(data, end, std::back_inserter(buffer));
-        assert(this->_buffer.empty());
-        return this->push_back(buffer.data(), buffer.size(),
-            std::forward<TCallback>(callback));
+    return cur;
+}
+
+
+/*
+ * stream_parser_v2::tokenise
+ */
+template<class TCallback>
+void stream_parser_v2::tokenise(
+        _In_reads_(end - begin) const byte_type *begin,
+        _In_ const byte_type *end,
+        _In_ TCallback& callback) {
+    assert(begin != nullptr);
+    assert(end >= begin);
+    assert(this->_cnt_carry == 0);
+    auto& delimiter = responses_v2::segment_delimiter;
+    auto cur = begin;
+
+    if (this->_framing == framing_state::hunting) {
+        // If we are not synchronised, we discard everything up to the first
+        // delimiter, because we have no way to interpret it without the marker
+        // at the start of the segment.
+        cur = find_delimiter(begin, end - begin);
+
+        if (cur == nullptr) {
+            // Preserve a potential first half of the delimiter for the next
+            // call, everything else is rubbish.
+            if ((end > begin) && (end[-1] == delimiter.front())) {
+                this->_carry.front() = delimiter.front();
+                this->_cnt_carry = 1;
+            }
+            this->_statistics.bytes_discarded += (end - begin)
+                - this->_cnt_carry;
+            return;
+        }
+
+        this->_statistics.bytes_discarded += cur - begin;
+
+        cur += delimiter.size();
+        this->_framing = framing_state::acquiring;
+    }
+
+    // At this point, 'cur' is the begin of a segment. Jump from segment to
+    // segment as long as the delimiters are where they are expected to be and
+    // the input holds the full segment and the following delimiter.
+    while (cur != nullptr) {
+        if (static_cast<std::size_t>(end - cur) < this->_carry.size()) {
+            // Retain the unfinished tail of the input for the next call.
+            std::copy(cur, end, this->_carry.data());
+            this->_cnt_carry = end - cur;
+            return;
+        }
+
+        if (is_framed(cur)) {
+            this->emit(cur, callback);
+            cur += this->_carry.size();
+        } else {
+            cur = this->resync(cur, end);
+        }
     }
 }
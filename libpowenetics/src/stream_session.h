@@ -0,0 +1,67 @@
+﻿// <copyright file="stream_session.h" company="Visualisierungsinstitut der Universität Stuttgart">
+// Copyright © 2026 Visualisierungsinstitut der Universität Stuttgart.
+// Licensed under the MIT licence. See LICENCE file for details.
+// </copyright>
+// <author>Christoph Müller</author>
+
+#if !defined(_LIBPOWENETICS_STREAM_SESSION_H)
+#define _LIBPOWENETICS_STREAM_SESSION_H
+#pragma once
+
+#include <cinttypes>
+
+#include "libpowenetics/api.h"
+#include "libpowenetics/types.h"
+
+
+/// <summary>
+/// The state of a device while it is streaming, which turns the data read
+/// from the serial port into the samples delivered to the callbacks.
+/// </summary>
+/// <remarks>
+/// <para>The session separates parsing and delivery from the I/O, such that
+/// the data can either be read by the streaming thread of the device or by a
+/// <see cref="powenetics_reactor" /> serving many devices.</para>
+/// <para>The implementations are instantiated for the parser of the device,
+/// so there is one virtual call per read, but none per byte or sample.</para>
+/// </remarks>
+class LIBPOWENETICS_TEST_API stream_session {
+
+public:
+
+    /// <summary>
+    /// The type used to represent a single byte.
+    /// </summary>
+    typedef std::uint8_t byte_type;
+
+    /// <summary>
+    /// Finalises the instance.
+    /// </summary>
+    virtual ~stream_session(void) = default;
+
+    /// <summary>
+    /// Delivers everything that has been held back before the session ends.
+    /// </summary>
+    virtual void finish(void) = 0;
+
+    /// <summary>
+    /// Parses the given data and delivers the samples, and does the
+    /// housekeeping of the session afterwards.
+    /// </summary>
+    /// <param name="data">The data read from the device.</param>
+    /// <param name="cnt">The number of bytes in <paramref name="data" />.
+    /// If this is zero, the session only does its housekeeping, which should
+    /// be done periodically while the device does not send any data.
+    /// </param>
+    virtual void process(_In_reads_(cnt) const byte_type *data,
+        _In_ const std::size_t cnt) = 0;
+
+protected:
+
+    /// <summary>
+    /// Initialises a new instance.
+    /// </summary>
+    stream_session(void) = default;
+};
+
+#endif /* !defined(_LIBPOWENETICS_STREAM_SESSION_H) */
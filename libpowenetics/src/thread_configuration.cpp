@@ -0,0 +1,178 @@
+﻿// <copyright file="thread_configuration.cpp" company="Visualisierungsinstitut der Universität Stuttgart">
+// Copyright © 2026 Visualisierungsinstitut der Universität Stuttgart.
+// Licensed under the MIT licence. See LICENCE file for details.
+// </copyright>
+// <author>Christoph Müller</author>
+
+#include "thread_configuration.h"
+
+#include <cerrno>
+#include <cinttypes>
+
+#if defined(_WIN32)
+#include <Windows.h>
+#else /* defined(_WIN32) */
+#include <pthread.h>
+#include <sched.h>
+
+#include <sys/mman.h>
+#endif /* defined(_WIN32) */
+
+#include "debug.h"
+
+
+/// <summary>
+/// Answer whether any processor has been selected in
+/// <paramref name="config" />, starting with the one at index
+/// <paramref name="first" />.
+/// </summary>
+static bool has_affinity(_In_ const powenetics_thread_configuration& config,
+        _In_ const std::size_t first = 0) noexcept {
+    const auto cnt = sizeof(config.affinity) / sizeof(*config.affinity);
+    for (auto i = first / 64; i < cnt; ++i) {
+        if (config.affinity[i] != 0) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+
+/*
+ * ::apply_thread_configuration
+ */
+HRESULT apply_thread_configuration(
+        _In_ const powenetics_thread_configuration& config) noexcept {
+#if defined(_WIN32)
+    const auto thread = ::GetCurrentThread();
+
+    if (has_affinity(config)) {
+        const auto mask = static_cast<DWORD_PTR>(config.affinity[0]);
+        if (::SetThreadAffinityMask(thread, mask) == 0) {
+            auto retval = HRESULT_FROM_WIN32(::GetLastError());
+            _powenetics_debug("Setting the affinity of the streaming thread "
+                "failed.\r\n");
+            return retval;
+        }
+    }
+
+    if (config.scheduling != powenetics_scheduling::inherit) {
+        if (!::SetThreadPriority(thread, THREAD_PRIORITY_TIME_CRITICAL)) {
+            auto retval = HRESULT_FROM_WIN32(::GetLastError());
+            _powenetics_debug("Raising the priority of the streaming thread "
+                "failed.\r\n");
+            return retval;
+        }
+    }
+
+#else /* defined(_WIN32) */
+    const auto thread = ::pthread_self();
+
+    if (config.lock_memory != 0) {
+        if (::mlockall(MCL_CURRENT | MCL_FUTURE) != 0) {
+            auto retval = static_cast<HRESULT>(-errno);
+            _powenetics_debug("Locking the memory of the process failed.\r\n");
+            return retval;
+        }
+    }
+
+#if defined(__linux__)
+    if (has_affinity(config)) {
+        cpu_set_t cpus;
+        CPU_ZERO(&cpus);
+
+        for (std::size_t i = 0; i < CPU_SETSIZE; ++i) {
+            if ((config.affinity[i / 64] & (std::uint64_t(1) << (i % 64)))
+                    != 0) {
+                CPU_SET(i, &cpus);
+            }
+        }
+
+        // Note: the pthread functions return the error rather than setting
+        // errno.
+        auto error = ::pthread_setaffinity_np(thread, sizeof(cpus), &cpus);
+        if (error != 0) {
+            _powenetics_debug("Setting the affinity of the streaming thread "
+                "failed.\r\n");
+            return static_cast<HRESULT>(-error);
+        }
+    }
+#endif /* defined(__linux__) */
+
+    if (config.scheduling != powenetics_scheduling::inherit) {
+        const auto policy = (config.scheduling == powenetics_scheduling::fifo)
+            ? SCHED_FIFO
+            : SCHED_RR;
+        sched_param param { };
+        param.sched_priority = config.priority;
+
+        auto error = ::pthread_setschedparam(thread, policy, &param);
+        if (error != 0) {
+            _powenetics_debug("Changing the scheduling policy of the "
+                "streaming thread failed.\r\n");
+            return static_cast<HRESULT>(-error);
+        }
+    }
+#endif /* defined(_WIN32) */
+
+    return S_OK;
+}
+
+
+/*
+ * ::check_thread_configuration
+ */
+HRESULT check_thread_configuration(
+        _In_ const powenetics_thread_configuration& config) noexcept {
+    if (config.version != 2) {
+        _powenetics_debug("Unsupported version of thread configuration.\r\n");
+        return E_INVALIDARG;
+    }
+
+    switch (config.scheduling) {
+        case powenetics_scheduling::inherit:
+        case powenetics_scheduling::fifo:
+        case powenetics_scheduling::round_robin:
+            break;
+
+        default:
+            return E_INVALIDARG;
+    }
+
+#if !defined(_WIN32)
+    if (config.scheduling != powenetics_scheduling::inherit) {
+        const auto policy = (config.scheduling == powenetics_scheduling::fifo)
+            ? SCHED_FIFO
+            : SCHED_RR;
+        if ((config.priority < ::sched_get_priority_min(policy))
+                || (config.priority > ::sched_get_priority_max(policy))) {
+            _powenetics_debug("The real-time priority is out of range.\r\n");
+            return E_INVALIDARG;
+        }
+    }
+#endif /* !defined(_WIN32) */
+
+#if defined(_WIN32)
+    if (has_affinity(config, 64)) {
+        _powenetics_debug("Only processors in the first group can be "
+            "selected.\r\n");
+        return E_NOTIMPL;
+    }
+
+    if (config.lock_memory != 0) {
+        _powenetics_debug("Locking memory is not supported on this "
+            "platform.\r\n");
+        return E_NOTIMPL;
+    }
+
+#elif !defined(__linux__)
+    if (has_affinity(config)) {
+        _powenetics_debug("Setting the affinity of threads is not supported "
+            "on this platform.\r\n");
+        return E_NOTIMPL;
+    }
+#endif /* defined(_WIN32) */
+
+    return S_OK;
+}
@@ -0,0 +1,44 @@
+﻿// <copyright file="thread_configuration.h" company="Visualisierungsinstitut der Universität Stuttgart">
+// Copyright © 2026 Visualisierungsinstitut der Universität Stuttgart.
+// Licensed under the MIT licence. See LICENCE file for details.
+// </copyright>
+// <author>Christoph Müller</author>
+
+#if !defined(_LIBPOWENETICS_THREAD_CONFIGURATION_H)
+#define _LIBPOWENETICS_THREAD_CONFIGURATION_H
+#pragma once
+
+#include "libpowenetics/api.h"
+#include "libpowenetics/scheduling.h"
+
+
+/// <summary>
+/// Applies the given configuration to the calling thread.
+/// </summary>
+/// <remarks>
+/// The memory is locked first, followed by the affinity and the scheduling
+/// policy, such that the thread never runs with real-time priority if the
+/// configuration could not be applied as a whole. However, the steps
+/// that succeeded before a failing one remain in effect.
+/// </remarks>
+/// <param name="config">The configuration to be applied, which must have
+/// been checked using <see cref="check_thread_configuration" />.</param>
+/// <returns><c>S_OK</c> in case of success, a negative <c>errno</c> or
+/// the error from the operating system if the configuration could not be
+/// applied, most likely due to insufficient privileges.</returns>
+HRESULT LIBPOWENETICS_TEST_API apply_thread_configuration(
+    _In_ const powenetics_thread_configuration& config) noexcept;
+
+/// <summary>
+/// Checks whether the given configuration is valid and can be applied on
+/// the platform.
+/// </summary>
+/// <param name="config">The configuration to be checked.</param>
+/// <returns><c>S_OK</c> if the configuration is valid,
+/// <c>E_INVALIDARG</c> if the version, the scheduling policy or the priority
+/// is invalid, <c>E_NOTIMPL</c> if a feature that has been requested is not
+/// supported on the platform.</returns>
+HRESULT LIBPOWENETICS_TEST_API check_thread_configuration(
+    _In_ const powenetics_thread_configuration& config) noexcept;
+
+#endif /* !defined(_LIBPOWENETICS_THREAD_CONFIGURATION_H) */
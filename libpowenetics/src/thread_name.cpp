@@ -1,11 +1,13 @@
 // <copyright file="thread_name.cpp" company="Visualisierungsinstitut der Universitt Stuttgart">
-// Copyright  2022 - 2024 Visualisierungsinstitut der Universitt Stuttgart.
+// Copyright  2022 - 2026 Visualisierungsinstitut der Universitt Stuttgart.
 // Licensed under the MIT licence. See LICENCE file for details.
 // </copyright>
 // <author>Christoph Mller</author>
 
 #include "thread_name.h"
 
+#include <cstring>
+
 // See https://msdn.microsoft.com/de-de/library/xcb2z8hs.aspx?f=255&MSPPError=-2147217396
 
 
@@ -45,6 +47,16 @@ void set_thread_name(_In_ const native_thread_id thread_id,
         } __except (EXCEPTION_EXECUTE_HANDLER) { }
 #pragma warning(pop)
     }
+
+#elif defined(__linux__)
+    if (thread_name != nullptr) {
+        // Linux limits names to 16 characters including the terminator and
+        // rejects longer ones, so we truncate the name.
+        char name[16];
+        ::strncpy(name, thread_name, sizeof(name) - 1);
+        name[sizeof(name) - 1] = 0;
+        ::pthread_setname_np(thread_id, name);
+    }
 #endif /* defined(_WIN32) */
 }
 
@@ -55,5 +67,12 @@ void set_thread_name(_In_ const native_thread_id thread_id,
 void set_thread_name(_In_z_ const char* thread_name) {
 #if defined(_WIN32)
     set_thread_name(::GetCurrentThreadId(), thread_name);
+#elif defined(__APPLE__)
+    if (thread_name != nullptr) {
+        // macOS can only name the calling thread.
+        ::pthread_setname_np(thread_name);
+    }
+#else /* defined(_WIN32) */
+    set_thread_name(::pthread_self(), thread_name);
 #endif /* defined(_WIN32) */
 }
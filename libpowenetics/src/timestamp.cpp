@@ -1,5 +1,5 @@
 ﻿// <copyright file="timestamp.cpp" company="Visualisierungsinstitut der Universität Stuttgart">
-// Copyright © 2023 - 2024 Visualisierungsinstitut der Universität Stuttgart.
+// Copyright © 2023 - 2026 Visualisierungsinstitut der Universität Stuttgart.
 // Licensed under the MIT licence. See LICENCE file for details.
 // </copyright>
 // <author>Christoph Müller</author>
@@ -7,29 +7,36 @@
 #include "libpowenetics/timestamp.h"
 
 #include <chrono>
+#include <cmath>
 
 #if defined(_WIN32)
 #include <Windows.h>
 #endif /* defined(_WIN32) */
 
-
-/// <summary>
-/// The 100ns period defining the reolution of <see cref="FILETIME" />.
-/// </summary>
-typedef std::ratio<1, 10000000> filetime_period;
+#include "clock.h"
 
 
 /// <summary>
-/// The STL representation of <see cref="FILETIME" />.
+/// Checks whether <paramref name="clock" /> is valid and supported.
 /// </summary>
-typedef std::chrono::duration<powenetics_timestamp, filetime_period>
-    filetime_duration;
+static HRESULT check_clock(_In_ const powenetics_clock clock) noexcept {
+    switch (clock) {
+        case powenetics_clock::system_time:
+        case powenetics_clock::monotonic:
+        case powenetics_clock::monotonic_raw:
+        case powenetics_clock::tsc:
+            return (::select_clock(clock) != nullptr) ? S_OK : E_NOTIMPL;
+
+        default:
+            return E_INVALIDARG;
+    }
+}
 
 
 /*
  * ::_powenetics_make_timestamp
  */
-powenetics_timestamp _powenetics_make_timestamp(void) noexcept {
+powenetics_timestamp _powenetics_make_timestamp(void) {
     using namespace std::chrono;
 
     // Make the timestamp.
@@ -51,6 +58,64 @@ powenetics_timestamp _powenetics_make_timestamp(void) noexcept {
 }
 
 
+/*
+ * ::powenetics_convert_timestamp
+ */
+HRESULT powenetics_convert_timestamp(_Out_ powenetics_timestamp *dst,
+        _In_ const powenetics_clock dst_clock,
+        _In_ const powenetics_timestamp timestamp,
+        _In_ const powenetics_clock src_clock) {
+    if (dst == nullptr) {
+        return E_POINTER;
+    }
+
+    auto retval = ::check_clock(dst_clock);
+    if (SUCCEEDED(retval)) {
+        retval = ::check_clock(src_clock);
+    }
+    if (FAILED(retval)) {
+        return retval;
+    }
+
+    if (dst_clock == src_clock) {
+        *dst = timestamp;
+        return S_OK;
+    }
+
+    // Determine the current offset between the clocks by bracketing the
+    // read of the target clock with two reads of the source clock.
+    const auto read_dst = ::select_clock(dst_clock);
+    const auto read_src = ::select_clock(src_clock);
+    const auto s0 = read_src();
+    const auto now = read_dst();
+    const auto s1 = read_src();
+    const auto then = s0 + (s1 - s0) / 2;
+
+    // Scale the distance to the current time into the units of the target.
+    const auto scale = static_cast<double>(::clock_frequency(dst_clock))
+        / static_cast<double>(::clock_frequency(src_clock));
+    const auto dt = static_cast<double>(timestamp - then) * scale;
+    *dst = now + std::llround(dt);
+
+    return S_OK;
+}
+
+
+/*
+ * ::powenetics_get_clock_frequency
+ */
+HRESULT powenetics_get_clock_frequency(_Out_ uint64_t *frequency,
+        _In_ const powenetics_clock clock) {
+    if (frequency == nullptr) {
+        return E_POINTER;
+    }
+
+    const auto retval = ::check_clock(clock);
+    *frequency = SUCCEEDED(retval) ? ::clock_frequency(clock) : 0;
+    return retval;
+}
+
+
 /*
  * ::powenetics_make_timestamp
  */
@@ -68,3 +133,18 @@ powenetics_timestamp powenetics_make_timestamp(void){
     return ::_powenetics_make_timestamp();
 #endif /* defined(_WIN32) */
 }
+
+
+/*
+ * ::powenetics_read_clock
+ */
+HRESULT powenetics_read_clock(_Out_ powenetics_timestamp *timestamp,
+        _In_ const powenetics_clock clock) {
+    if (timestamp == nullptr) {
+        return E_POINTER;
+    }
+
+    const auto retval = ::check_clock(clock);
+    *timestamp = SUCCEEDED(retval) ? ::select_clock(clock)() : 0;
+    return retval;
+}
@@ -0,0 +1,103 @@
+﻿// <copyright file="timestamp_estimator.cpp" company="Visualisierungsinstitut der Universität Stuttgart">
+// Copyright © 2026 Visualisierungsinstitut der Universität Stuttgart.
+// Licensed under the MIT licence. See LICENCE file for details.
+// </copyright>
+// <author>Christoph Müller</author>
+
+#include "timestamp_estimator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+
+/*
+ * timestamp_estimator::timestamp_estimator
+ */
+timestamp_estimator::timestamp_estimator(void) noexcept {
+    this->reset();
+}
+
+
+/*
+ * timestamp_estimator::estimate
+ */
+powenetics_timestamp timestamp_estimator::estimate(
+        _In_ const std::uint64_t index,
+        _In_ const powenetics_timestamp received) noexcept {
+    const auto period = this->period();
+    auto retval = received;
+
+    if (period > 0.0) {
+        // Note: The index must be converted to a signed value before the
+        // conversion to floating point, because the sample might be older
+        // than the first observation.
+        const auto dx = static_cast<double>(static_cast<std::int64_t>(
+            index - this->_x0)) - this->_mx;
+        const auto y = this->_my + period * dx;
+        retval = this->_y0 + std::llround(y);
+        retval = (std::min)(retval, received);
+    }
+
+    retval = (std::max)(retval, this->_last);
+    this->_last = retval;
+    return retval;
+}
+
+
+/*
+ * timestamp_estimator::observe
+ */
+void timestamp_estimator::observe(_In_ const std::uint64_t index,
+        _In_ const powenetics_timestamp received) noexcept {
+    if (this->_observations++ == 0) {
+        this->_x0 = index;
+        this->_y0 = received;
+    }
+
+    const auto x = static_cast<double>(static_cast<std::int64_t>(
+        index - this->_x0));
+    const auto y = static_cast<double>(received - this->_y0);
+
+    // This is West's algorithm for the incremental computation of weighted
+    // moments, where the weights of all previous observations decay by the
+    // forgetting factor. Scaling the weights does not change the means, but
+    // scales the moments.
+    this->_weight = forgetting * this->_weight + 1.0;
+    const auto dx = x - this->_mx;
+    this->_mx += dx / this->_weight;
+    this->_my += (y - this->_my) / this->_weight;
+    this->_cxx = forgetting * this->_cxx + dx * (x - this->_mx);
+    this->_cxy = forgetting * this->_cxy + dx * (y - this->_my);
+}
+
+
+/*
+ * timestamp_estimator::period
+ */
+double timestamp_estimator::period(void) const noexcept {
+    if ((this->_observations < 2) || !(this->_cxx > 0.0)) {
+        return 0.0;
+    }
+
+    // If the clock went backwards or the data are degenerate in any other
+    // way, we rather report that the model is unusable.
+    const auto retval = this->_cxy / this->_cxx;
+    return (retval > 0.0) ? retval : 0.0;
+}
+
+
+/*
+ * timestamp_estimator::reset
+ */
+void timestamp_estimator::reset(void) noexcept {
+    this->_cxx = 0.0;
+    this->_cxy = 0.0;
+    this->_last = (std::numeric_limits<powenetics_timestamp>::min)();
+    this->_mx = 0.0;
+    this->_my = 0.0;
+    this->_observations = 0;
+    this->_weight = 0.0;
+    this->_x0 = 0;
+    this->_y0 = 0;
+}
@@ -0,0 +1,142 @@
+﻿// <copyright file="timestamp_estimator.h" company="Visualisierungsinstitut der Universität Stuttgart">
+// Copyright © 2026 Visualisierungsinstitut der Universität Stuttgart.
+// Licensed under the MIT licence. See LICENCE file for details.
+// </copyright>
+// <author>Christoph Müller</author>
+
+#if !defined(_LIBPOWENETICS_TIMESTAMP_ESTIMATOR_H)
+#define _LIBPOWENETICS_TIMESTAMP_ESTIMATOR_H
+#pragma once
+
+#include <cinttypes>
+
+#include "libpowenetics/api.h"
+#include "libpowenetics/timestamp.h"
+
+
+/// <summary>
+/// Reconstructs the time at which the device took a sample from the index of
+/// the sample and the host times at which reads from the device completed.
+/// </summary>
+/// <remarks>
+/// <para>The estimator fits a linear model of the host time against the
+/// sample index, whose slope is the sampling period of the device as seen by
+/// the host clock and whose intercept is the offset between the clocks. The
+/// model is fitted using exponentially weighted least squares, so it follows
+/// slow drift of the device clock against the host clock while smoothing the
+/// jitter of the I/O.</para>
+/// <para>As the observations are the times the reads completed, the offset
+/// includes the average latency between the device sending a segment and the
+/// read returning it.</para>
+/// </remarks>
+class LIBPOWENETICS_TEST_API timestamp_estimator final {
+
+public:
+
+    /// <summary>
+    /// Initialises a new instance.
+    /// </summary>
+    timestamp_estimator(void) noexcept;
+
+    /// <summary>
+    /// Answer the time at which the sample with the given index has been
+    /// taken.
+    /// </summary>
+    /// <remarks>
+    /// <para>Until the model has been fitted to at least two observations,
+    /// the method returns <paramref name="received" />.</para>
+    /// <para>The result is never later than <paramref name="received" />,
+    /// because a sample cannot be taken after it has been received, and it is
+    /// never earlier than the previous result, such that the timestamps of
+    /// consecutive samples are monotonic.</para>
+    /// </remarks>
+    /// <param name="index">The index of the sample.</param>
+    /// <param name="received">The time at which the read that returned the
+    /// sample completed.</param>
+    /// <returns>The estimated timestamp of the sample.</returns>
+    powenetics_timestamp estimate(_In_ const std::uint64_t index,
+        _In_ const powenetics_timestamp received) noexcept;
+
+    /// <summary>
+    /// Adds the observation that the sample with the given index has been
+    /// received at the given time to the model.
+    /// </summary>
+    /// <param name="index">The index of the most recent sample received by a
+    /// read.</param>
+    /// <param name="received">The time at which the read completed.</param>
+    void observe(_In_ const std::uint64_t index,
+        _In_ const powenetics_timestamp received) noexcept;
+
+    /// <summary>
+    /// Answer the estimated period between two samples in units of 100ns.
+    /// </summary>
+    /// <returns>The sampling period, or zero if the model has not yet been
+    /// fitted.</returns>
+    double period(void) const noexcept;
+
+    /// <summary>
+    /// Discards the model.
+    /// </summary>
+    void reset(void) noexcept;
+
+private:
+
+    /// <summary>
+    /// The factor by which the weight of previous observations is reduced
+    /// with each new observation.
+    /// </summary>
+    /// <remarks>
+    /// The value corresponds to an effective window of about a thousand
+    /// reads, which is several seconds of data.
+    /// </remarks>
+    static constexpr double forgetting = 1.0 - 1.0 / 1024.0;
+
+    /// <summary>
+    /// The second central moment of the index.
+    /// </summary>
+    double _cxx;
+
+    /// <summary>
+    /// The co-moment of the index and the host time.
+    /// </summary>
+    double _cxy;
+
+    /// <summary>
+    /// The previous result of <see cref="estimate" />.
+    /// </summary>
+    powenetics_timestamp _last;
+
+    /// <summary>
+    /// The weighted mean of the index relative to <see cref="_x0" />.
+    /// </summary>
+    double _mx;
+
+    /// <summary>
+    /// The weighted mean of the host time relative to <see cref="_y0" />.
+    /// </summary>
+    double _my;
+
+    /// <summary>
+    /// The number of observations.
+    /// </summary>
+    std::uint64_t _observations;
+
+    /// <summary>
+    /// The sum of the weights of all observations.
+    /// </summary>
+    double _weight;
+
+    /// <summary>
+    /// The index of the first observation, relative to which all indices are
+    /// stored in order to preserve precision.
+    /// </summary>
+    std::uint64_t _x0;
+
+    /// <summary>
+    /// The host time of the first observation, relative to which all times
+    /// are stored in order to preserve precision.
+    /// </summary>
+    powenetics_timestamp _y0;
+};
+
+#endif /* !defined(_LIBPOWENETICS_TIMESTAMP_ESTIMATOR_H) */
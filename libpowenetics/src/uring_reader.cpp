@@ -0,0 +1,653 @@
+﻿// <copyright file="uring_reader.cpp" company="Visualisierungsinstitut der Universität Stuttgart">
+// Copyright © 2026 Visualisierungsinstitut der Universität Stuttgart.
+// Licensed under the MIT licence. See LICENCE file for details.
+// </copyright>
+// <author>Christoph Müller</author>
+
+#include "uring_reader.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cerrno>
+#include <cstring>
+#include <new>
+
+#if defined(POWENETICS_IO_URING)
+#include <poll.h>
+#include <unistd.h>
+
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#endif /* defined(POWENETICS_IO_URING) */
+
+#include "debug.h"
+
+
+#if defined(POWENETICS_IO_URING)
+/// <summary>
+/// The memory mapped from the kernel for the submission and the completion
+/// queue of the ring.
+/// </summary>
+struct uring_reader::ring final {
+
+    /// <summary>
+    /// The completions, which are <see cref="cq_mask" /> + 1 entries.
+    /// </summary>
+    io_uring_cqe *cqes;
+
+    /// <summary>
+    /// The index of the next completion to be reaped, which we update.
+    /// </summary>
+    unsigned int *cq_head;
+
+    /// <summary>
+    /// The mask for wrapping indices into <see cref="cqes" />.
+    /// </summary>
+    unsigned int cq_mask;
+
+    /// <summary>
+    /// The index after the last completion, which the kernel updates.
+    /// </summary>
+    unsigned int *cq_tail;
+
+    /// <summary>
+    /// The mapping of the completion queue, which may be the same as
+    /// <see cref="sq_map" />.
+    /// </summary>
+    void *cq_map;
+
+    /// <summary>
+    /// The size of <see cref="cq_map" /> in bytes.
+    /// </summary>
+    std::size_t cq_size;
+
+    /// <summary>
+    /// The file descriptor of the ring.
+    /// </summary>
+    int handle;
+
+    /// <summary>
+    /// The indirection array of the submission queue.
+    /// </summary>
+    unsigned int *sq_array;
+
+    /// <summary>
+    /// The index of the next submission the kernel consumes.
+    /// </summary>
+    unsigned int *sq_head;
+
+    /// <summary>
+    /// The mapping of the submission queue.
+    /// </summary>
+    void *sq_map;
+
+    /// <summary>
+    /// The mask for wrapping indices into <see cref="sqes" />.
+    /// </summary>
+    unsigned int sq_mask;
+
+    /// <summary>
+    /// The size of <see cref="sq_map" /> in bytes.
+    /// </summary>
+    std::size_t sq_size;
+
+    /// <summary>
+    /// The index after the last submission, which we update.
+    /// </summary>
+    unsigned int *sq_tail;
+
+    /// <summary>
+    /// The submissions.
+    /// </summary>
+    io_uring_sqe *sqes;
+
+    /// <summary>
+    /// The size of <see cref="sqes" /> in bytes.
+    /// </summary>
+    std::size_t sqes_size;
+
+    inline ring(void) noexcept : cqes(nullptr), cq_head(nullptr),
+        cq_mask(0), cq_tail(nullptr), cq_map(MAP_FAILED), cq_size(0),
+        handle(-1), sq_array(nullptr), sq_head(nullptr), sq_map(MAP_FAILED),
+        sq_mask(0), sq_size(0), sq_tail(nullptr), sqes(nullptr),
+        sqes_size(0) { }
+
+    inline ~ring(void) noexcept {
+        if (this->sqes != nullptr) {
+            ::munmap(this->sqes, this->sqes_size);
+        }
+        if ((this->cq_map != MAP_FAILED) && (this->cq_map != this->sq_map)) {
+            ::munmap(this->cq_map, this->cq_size);
+        }
+        if (this->sq_map != MAP_FAILED) {
+            ::munmap(this->sq_map, this->sq_size);
+        }
+        if (this->handle != -1) {
+            ::close(this->handle);
+        }
+    }
+
+    /// <summary>
+    /// Answer the next free submission, which will be submitted once
+    /// <see cref="push" /> has been called.
+    /// </summary>
+    inline io_uring_sqe& sqe(void) noexcept {
+        const auto tail = *this->sq_tail;
+        assert(tail - __atomic_load_n(this->sq_head, __ATOMIC_ACQUIRE)
+            <= this->sq_mask);
+        auto& retval = this->sqes[tail & this->sq_mask];
+        ::memset(&retval, 0, sizeof(retval));
+        return retval;
+    }
+
+    /// <summary>
+    /// Makes the submission returned by <see cref="sqe" /> visible to the
+    /// kernel.
+    /// </summary>
+    inline void push(void) noexcept {
+        const auto tail = *this->sq_tail;
+        this->sq_array[tail & this->sq_mask] = tail & this->sq_mask;
+        __atomic_store_n(this->sq_tail, tail + 1, __ATOMIC_RELEASE);
+    }
+
+    /// <summary>
+    /// Answer the number of submissions the kernel has not yet consumed.
+    /// </summary>
+    inline unsigned int unsubmitted(void) const noexcept {
+        return *this->sq_tail - __atomic_load_n(this->sq_head,
+            __ATOMIC_ACQUIRE);
+    }
+};
+
+#else /* defined(POWENETICS_IO_URING) */
+/// <summary>
+/// Placeholder for platforms that do not support io_uring.
+/// </summary>
+struct uring_reader::ring final { };
+#endif /* defined(POWENETICS_IO_URING) */
+
+
+/*
+ * uring_reader::uring_reader
+ */
+uring_reader::uring_reader(void) noexcept : _calls(0), _current(0),
+    _pending(0), _size(0), _woken(false) { }
+
+
+/*
+ * uring_reader::~uring_reader
+ */
+uring_reader::~uring_reader(void) noexcept {
+    this->close();
+}
+
+
+/*
+ * uring_reader::close
+ */
+void uring_reader::close(void) noexcept {
+#if defined(POWENETICS_IO_URING)
+    if (this->_ring != nullptr) {
+        // Cancel everything in flight and wait until the kernel has posted
+        // the completions. Otherwise, a read that is still queued when the
+        // ring is torn down asynchronously could consume data from the
+        // descriptor that the next user of the descriptor expects. A hard
+        // link starts the next read of the chain even if the previous one has
+        // been cancelled, so we need to cancel again until all reads are gone.
+        auto& r = *this->_ring;
+        std::size_t cancelling = 0;
+        auto supported = true;
+
+        while (supported && ((this->_pending > 0) || (cancelling > 0))) {
+            if (cancelling == 0) {
+                auto& sqe = r.sqe();
+                sqe.opcode = IORING_OP_ASYNC_CANCEL;
+                sqe.fd = -1;
+                sqe.cancel_flags = IORING_ASYNC_CANCEL_ANY;
+                sqe.user_data = cancel_tag;
+                r.push();
+                ++cancelling;
+            }
+
+            if ((this->enter(1, 1000) < 0) && (errno != EINTR)) {
+                // If we cannot wait, the teardown of the ring will cancel
+                // the requests eventually.
+                _powenetics_debug("Cancelling the reads of the io_uring "
+                    "failed.\r\n");
+                break;
+            }
+
+            auto head = *r.cq_head;
+            const auto tail = __atomic_load_n(r.cq_tail, __ATOMIC_ACQUIRE);
+            for (; head != tail; ++head) {
+                const auto& cqe = r.cqes[head & r.cq_mask];
+                if (cqe.user_data == cancel_tag) {
+                    // Likewise, we leave the requests to the teardown if the
+                    // kernel does not support the cancellation.
+                    supported = (cqe.res != -EINVAL);
+                    --cancelling;
+                } else if (this->_pending > 0) {
+                    --this->_pending;
+                }
+            }
+            __atomic_store_n(r.cq_head, head, __ATOMIC_RELEASE);
+        }
+    }
+#endif /* defined(POWENETICS_IO_URING) */
+
+    // Note: unregistering the buffers is implicit when the ring is closed.
+    this->_ring.reset();
+    this->_buffers.clear();
+    this->_buffers.shrink_to_fit();
+    this->_current = 0;
+    this->_pending = 0;
+    this->_results.clear();
+    this->_size = 0;
+    this->_woken = false;
+}
+
+
+/*
+ * uring_reader::next
+ */
+HRESULT uring_reader::next(
+        _Out_ const byte_type *& data,
+        _Out_ std::size_t& cnt) noexcept {
+    data = nullptr;
+    cnt = 0;
+
+#if defined(POWENETICS_IO_URING)
+    if (this->_ring == nullptr) {
+        return E_NOT_VALID_STATE;
+    }
+
+    // The caller is done with the buffer returned last time, so we can read
+    // into all buffers again if it was the last one of the chain.
+    this->requeue();
+
+    // Reap all completions at once. The reads of a chain run one after the
+    // other, but we do not rely on their completions being posted in this
+    // order and only remember the results by buffer.
+    {
+        auto& r = *this->_ring;
+        auto head = *r.cq_head;
+        const auto tail = __atomic_load_n(r.cq_tail, __ATOMIC_ACQUIRE);
+
+        for (; head != tail; ++head) {
+            const auto& cqe = r.cqes[head & r.cq_mask];
+            --this->_pending;
+
+            if (cqe.user_data == wake_tag) {
+                // The wait for the wake-up descriptor is not re-armed,
+                // because the thread is expected to exit.
+                this->_woken = true;
+            } else {
+                assert(cqe.user_data < this->_results.size());
+                this->_results[cqe.user_data] = cqe.res;
+            }
+        }
+
+        __atomic_store_n(r.cq_head, head, __ATOMIC_RELEASE);
+    }
+
+    // Hand out the reads in the order of the buffers, which is the order in
+    // which they consumed the stream.
+    auto retval = S_FALSE;
+    while ((this->_current < this->_results.size())
+            && (this->_results[this->_current] != in_flight)
+            && (retval == S_FALSE)) {
+        const auto buffer = this->_current++;
+        const auto res = this->_results[buffer];
+
+        if (res > 0) {
+            data = this->_buffers.data() + buffer * this->_size;
+            cnt = static_cast<std::size_t>(res);
+            retval = S_OK;
+
+        } else if ((res == -EINTR) || (res == -EAGAIN)) {
+            // The read did not consume anything, so we can skip it.
+
+        } else if (res == 0) {
+            _powenetics_debug("The io_uring read reached the end of the "
+                "stream.\r\n");
+            retval = E_FAIL;
+
+        } else {
+            _powenetics_debug("An io_uring read failed.\r\n");
+            retval = static_cast<HRESULT>(res);
+        }
+    }
+
+    return retval;
+
+#else /* defined(POWENETICS_IO_URING) */
+    return E_NOT_VALID_STATE;
+#endif /* defined(POWENETICS_IO_URING) */
+}
+
+
+/*
+ * uring_reader::open
+ */
+HRESULT uring_reader::open(_In_ const handle_type file,
+        _In_ const handle_type wake,
+        _In_ const std::size_t depth,
+        _In_ const std::size_t size) noexcept {
+#if defined(POWENETICS_IO_URING)
+    assert(depth > 0);
+    assert(size > 0);
+
+    if (this->_ring != nullptr) {
+        _powenetics_debug("The io_uring reader has already been opened.\r\n");
+        return E_NOT_VALID_STATE;
+    }
+
+    try {
+        this->_ring.reset(new ring());
+        this->_buffers.resize(depth * size);
+        this->_results.resize(depth, in_flight);
+    } catch (std::bad_alloc) {
+        _powenetics_debug("Insufficient memory for io_uring reader.\r\n");
+        this->close();
+        return E_OUTOFMEMORY;
+    }
+
+    auto& r = *this->_ring;
+    this->_size = size;
+
+    // The submission queue must hold the chain of reads, the wait for the
+    // wake-up descriptor and the cancellation when closing.
+    io_uring_params params;
+    ::memset(&params, 0, sizeof(params));
+    params.flags = IORING_SETUP_SINGLE_ISSUER | IORING_SETUP_DEFER_TASKRUN;
+    const auto entries = static_cast<unsigned int>(depth + 2);
+
+    // Only the streaming thread uses the ring, so the kernel can defer the
+    // completion work until we wait for it rather than interrupting us.
+    // Older kernels do not know the flags, which are only an optimisation.
+    r.handle = static_cast<int>(::syscall(__NR_io_uring_setup, entries,
+        &params));
+    if ((r.handle == -1) && (errno == EINVAL)) {
+        ::memset(&params, 0, sizeof(params));
+        r.handle = static_cast<int>(::syscall(__NR_io_uring_setup, entries,
+            &params));
+    }
+    if (r.handle == -1) {
+        auto retval = ((errno == ENOSYS) || (errno == EPERM))
+            ? E_NOTIMPL
+            : static_cast<HRESULT>(-errno);
+        _powenetics_debug("Creating the io_uring failed.\r\n");
+        this->close();
+        return retval;
+    }
+
+    // We need to wait with a timeout, which was added in Linux 5.11.
+    if ((params.features & IORING_FEAT_EXT_ARG) == 0) {
+        _powenetics_debug("The kernel does not support waiting for the "
+            "io_uring with a timeout.\r\n");
+        this->close();
+        return E_NOTIMPL;
+    }
+
+    r.sq_size = params.sq_off.array + params.sq_entries * sizeof(unsigned int);
+    r.cq_size = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    if ((params.features & IORING_FEAT_SINGLE_MMAP) != 0) {
+        r.sq_size = r.cq_size = (std::max)(r.sq_size, r.cq_size);
+    }
+
+    r.sq_map = ::mmap(nullptr, r.sq_size, PROT_READ | PROT_WRITE,
+        MAP_SHARED | MAP_POPULATE, r.handle, IORING_OFF_SQ_RING);
+    if (r.sq_map == MAP_FAILED) {
+        auto retval = static_cast<HRESULT>(-errno);
+        _powenetics_debug("Mapping the submission queue failed.\r\n");
+        this->close();
+        return retval;
+    }
+
+    if ((params.features & IORING_FEAT_SINGLE_MMAP) != 0) {
+        r.cq_map = r.sq_map;
+    } else {
+        r.cq_map = ::mmap(nullptr, r.cq_size, PROT_READ | PROT_WRITE,
+            MAP_SHARED | MAP_POPULATE, r.handle, IORING_OFF_CQ_RING);
+        if (r.cq_map == MAP_FAILED) {
+            auto retval = static_cast<HRESULT>(-errno);
+            _powenetics_debug("Mapping the completion queue failed.\r\n");
+            this->close();
+            return retval;
+        }
+    }
+
+    r.sqes_size = params.sq_entries * sizeof(io_uring_sqe);
+    {
+        auto sqes = ::mmap(nullptr, r.sqes_size, PROT_READ | PROT_WRITE,
+            MAP_SHARED | MAP_POPULATE, r.handle, IORING_OFF_SQES);
+        if (sqes == MAP_FAILED) {
+            auto retval = static_cast<HRESULT>(-errno);
+            _powenetics_debug("Mapping the submissions failed.\r\n");
+            this->close();
+            return retval;
+        }
+        r.sqes = static_cast<io_uring_sqe *>(sqes);
+    }
+
+    {
+        auto sq = static_cast<std::uint8_t *>(r.sq_map);
+        r.sq_array = reinterpret_cast<unsigned int *>(sq
+            + params.sq_off.array);
+        r.sq_head = reinterpret_cast<unsigned int *>(sq + params.sq_off.head);
+        r.sq_mask = *reinterpret_cast<unsigned int *>(sq
+            + params.sq_off.ring_mask);
+        r.sq_tail = reinterpret_cast<unsigned int *>(sq + params.sq_off.tail);
+
+        auto cq = static_cast<std::uint8_t *>(r.cq_map);
+        r.cqes = reinterpret_cast<io_uring_cqe *>(cq + params.cq_off.cqes);
+        r.cq_head = reinterpret_cast<unsigned int *>(cq + params.cq_off.head);
+        r.cq_mask = *reinterpret_cast<unsigned int *>(cq
+            + params.cq_off.ring_mask);
+        r.cq_tail = reinterpret_cast<unsigned int *>(cq + params.cq_off.tail);
+    }
+
+    // Register the buffers such that the kernel does not need to map them
+    // for every read, and the descriptor such that it does not need to look
+    // it up for every read.
+    try {
+        std::vector<iovec> iovecs(depth);
+        for (std::size_t i = 0; i < depth; ++i) {
+            iovecs[i].iov_base = this->_buffers.data() + i * size;
+            iovecs[i].iov_len = size;
+        }
+
+        if (::syscall(__NR_io_uring_register, r.handle,
+                IORING_REGISTER_BUFFERS, iovecs.data(),
+                static_cast<unsigned int>(iovecs.size())) != 0) {
+            auto retval = static_cast<HRESULT>(-errno);
+            _powenetics_debug("Registering the io_uring buffers failed.\r\n");
+            this->close();
+            return retval;
+        }
+    } catch (std::bad_alloc) {
+        _powenetics_debug("Insufficient memory for io_uring buffers.\r\n");
+        this->close();
+        return E_OUTOFMEMORY;
+    }
+
+    if (::syscall(__NR_io_uring_register, r.handle, IORING_REGISTER_FILES,
+            &file, 1) != 0) {
+        auto retval = static_cast<HRESULT>(-errno);
+        _powenetics_debug("Registering the descriptor with the io_uring "
+            "failed.\r\n");
+        this->close();
+        return retval;
+    }
+
+    // Pretend that the caller has taken all buffers to queue the first chain.
+    this->_current = depth;
+    this->requeue();
+
+    if (wake != -1) {
+        auto& sqe = r.sqe();
+        sqe.opcode = IORING_OP_POLL_ADD;
+        sqe.fd = wake;
+        sqe.poll32_events = POLLIN;
+        sqe.user_data = wake_tag;
+        r.push();
+        ++this->_pending;
+    }
+
+    if ((this->enter(0, 0) < 0) && (errno != EINTR)) {
+        auto retval = static_cast<HRESULT>(-errno);
+        _powenetics_debug("Submitting the initial io_uring reads "
+            "failed.\r\n");
+        this->close();
+        return retval;
+    }
+
+    return S_OK;
+
+#else /* defined(POWENETICS_IO_URING) */
+    _powenetics_debug("io_uring is only supported on Linux.\r\n");
+    return E_NOTIMPL;
+#endif /* defined(POWENETICS_IO_URING) */
+}
+
+
+/*
+ * uring_reader::wait
+ */
+HRESULT uring_reader::wait(_In_ const int timeout) noexcept {
+#if defined(POWENETICS_IO_URING)
+    if (this->_ring == nullptr) {
+        return E_NOT_VALID_STATE;
+    }
+
+    // Queue the next chain if all buffers have been taken, such that a caller
+    // that only waits keeps reading.
+    this->requeue();
+
+    auto& r = *this->_ring;
+    const auto ready = ((this->_current < this->_results.size())
+        && (this->_results[this->_current] != in_flight))
+        || (*r.cq_head != __atomic_load_n(r.cq_tail, __ATOMIC_ACQUIRE));
+    if (ready && (r.unsubmitted() == 0)) {
+        return S_OK;
+    }
+
+    if (this->enter(ready ? 0 : 1, ready ? 0 : timeout) < 0) {
+        // Timeouts and signals are expected, everything else is an error.
+        switch (errno) {
+            case EINTR:
+            case ETIME:
+            case EBUSY:
+                return S_OK;
+
+            default: {
+                auto retval = static_cast<HRESULT>(-errno);
+                _powenetics_debug("Waiting for the io_uring failed.\r\n");
+                return retval;
+            }
+        }
+    }
+
+    return S_OK;
+
+#else /* defined(POWENETICS_IO_URING) */
+    return E_NOT_VALID_STATE;
+#endif /* defined(POWENETICS_IO_URING) */
+}
+
+
+/*
+ * uring_reader::enter
+ */
+int uring_reader::enter(_In_ const unsigned int min_complete,
+        _In_ const int timeout) noexcept {
+#if defined(POWENETICS_IO_URING)
+    assert(this->_ring != nullptr);
+    auto& r = *this->_ring;
+    const auto submit = r.unsubmitted();
+    auto flags = IORING_ENTER_EXT_ARG;
+
+    if ((submit == 0) && (min_complete == 0)) {
+        return 0;
+    }
+
+    if (min_complete > 0) {
+        flags |= IORING_ENTER_GETEVENTS;
+    }
+
+    __kernel_timespec ts;
+    ts.tv_sec = timeout / 1000;
+    ts.tv_nsec = (timeout % 1000) * 1000 * 1000;
+
+    io_uring_getevents_arg arg;
+    ::memset(&arg, 0, sizeof(arg));
+    if (timeout >= 0) {
+        arg.ts = reinterpret_cast<std::uint64_t>(&ts);
+    }
+
+    ++this->_calls;
+    return static_cast<int>(::syscall(__NR_io_uring_enter, r.handle, submit,
+        min_complete, flags, &arg, sizeof(arg)));
+
+#else /* defined(POWENETICS_IO_URING) */
+    return -1;
+#endif /* defined(POWENETICS_IO_URING) */
+}
+
+
+/*
+ * uring_reader::queue
+ */
+void uring_reader::queue(_In_ const std::size_t buffer,
+        _In_ const bool link) noexcept {
+#if defined(POWENETICS_IO_URING)
+    assert(this->_ring != nullptr);
+    auto& r = *this->_ring;
+    auto& sqe = r.sqe();
+
+    // The descriptor and the buffer are addressed by their index in the
+    // registered tables, and reading from the offset -1 continues at the
+    // current position like 'read' does. A hard link, unlike a normal one,
+    // is not broken if the read returns less than requested, which is the
+    // rule for terminals.
+    sqe.opcode = IORING_OP_READ_FIXED;
+    sqe.flags = IOSQE_FIXED_FILE;
+    if (link) {
+        sqe.flags |= IOSQE_IO_HARDLINK;
+    }
+    sqe.fd = 0;
+    sqe.off = static_cast<std::uint64_t>(-1);
+    sqe.addr = reinterpret_cast<std::uint64_t>(this->_buffers.data()
+        + buffer * this->_size);
+    sqe.len = static_cast<std::uint32_t>(this->_size);
+    sqe.buf_index = static_cast<std::uint16_t>(buffer);
+    sqe.user_data = buffer;
+    this->_results[buffer] = in_flight;
+    r.push();
+    ++this->_pending;
+#endif /* defined(POWENETICS_IO_URING) */
+}
+
+
+/*
+ * uring_reader::requeue
+ */
+void uring_reader::requeue(void) noexcept {
+#if defined(POWENETICS_IO_URING)
+    const auto depth = this->_results.size();
+
+    // All reads of the previous chain must have completed before the next
+    // chain starts, because reads from different chains could otherwise run
+    // concurrently and complete out of order. Handing out a read implies
+    // that all reads before it have completed, so this is the case once the
+    // caller has taken the last buffer.
+    if ((depth > 0) && (this->_current == depth)) {
+        for (std::size_t i = 0; i < depth; ++i) {
+            this->queue(i, i + 1 < depth);
+        }
+        this->_current = 0;
+    }
+#endif /* defined(POWENETICS_IO_URING) */
+}
@@ -0,0 +1,224 @@
+﻿// <copyright file="uring_reader.h" company="Visualisierungsinstitut der Universität Stuttgart">
+// Copyright © 2026 Visualisierungsinstitut der Universität Stuttgart.
+// Licensed under the MIT licence. See LICENCE file for details.
+// </copyright>
+// <author>Christoph Müller</author>
+
+#if !defined(_LIBPOWENETICS_URING_READER_H)
+#define _LIBPOWENETICS_URING_READER_H
+#pragma once
+
+#include <cinttypes>
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <vector>
+
+#include "libpowenetics/api.h"
+#include "libpowenetics/types.h"
+
+
+// Enables the reader if we are building for Linux with kernel headers that
+// know about io_uring.
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#define POWENETICS_IO_URING (1)
+#endif /* __has_include(<linux/io_uring.h>) */
+#endif /* defined(__linux__) && defined(__has_include) */
+
+
+/// <summary>
+/// Reads a stream from a file descriptor via an <c>io_uring</c>.
+/// </summary>
+/// <remarks>
+/// <para>The reader registers the descriptor and a fixed set of buffers with
+/// the kernel and keeps a read into each of the buffers in flight. Completed
+/// reads are reaped in batches, and the buffers are queued again with the
+/// next wait, so reading and waiting cost a single system call no matter how
+/// many reads have completed in the meantime.</para>
+/// <para>The kernel serves reads from terminals on its worker threads, which
+/// may complete independent reads from the same descriptor in any order.
+/// The reads are therefore submitted as a chain of hard links, which the
+/// kernel runs one after the other in the order of the buffers, even if a
+/// read returns less than requested. A new chain is only submitted once all
+/// reads of the previous one have completed and have been taken, and the
+/// reads are handed out in the order of the buffers rather than in the
+/// order of their completions.</para>
+/// <para>The reader must be opened and used on the same thread. It is only
+/// available on Linux 5.11 or later. Otherwise, <see cref="open" /> fails and
+/// the caller must fall back to <c>poll</c> and <c>read</c>.</para>
+/// </remarks>
+class LIBPOWENETICS_TEST_API uring_reader final {
+
+public:
+
+    /// <summary>
+    /// The type used to represent a single byte.
+    /// </summary>
+    typedef std::uint8_t byte_type;
+
+    /// <summary>
+    /// The type of a file descriptor.
+    /// </summary>
+    typedef int handle_type;
+
+    /// <summary>
+    /// The number of reads kept in flight unless specified otherwise.
+    /// </summary>
+    static constexpr std::size_t default_depth = 8;
+
+    /// <summary>
+    /// Initialises a new instance, which must be <see cref="open" />ed before
+    /// it can be used.
+    /// </summary>
+    uring_reader(void) noexcept;
+
+    uring_reader(const uring_reader&) = delete;
+
+    /// <summary>
+    /// Finalises the instance.
+    /// </summary>
+    ~uring_reader(void) noexcept;
+
+    /// <summary>
+    /// Answer the number of times the reader has entered the kernel to submit
+    /// reads or to wait for their completion.
+    /// </summary>
+    inline std::uint64_t calls(void) const noexcept {
+        return this->_calls;
+    }
+
+    /// <summary>
+    /// Cancels the reads in flight and releases the ring and the buffers.
+    /// </summary>
+    /// <remarks>
+    /// The method waits until the kernel has given up all reads, such that no
+    /// data is consumed from the descriptor once it returns.
+    /// </remarks>
+    void close(void) noexcept;
+
+    /// <summary>
+    /// Takes the next completed read in the order of the stream.
+    /// </summary>
+    /// <remarks>
+    /// The data returned remain valid until the method or
+    /// <see cref="wait" /> is called again or until the reader is closed.
+    /// The buffer is queued for the next chain of reads afterwards.
+    /// </remarks>
+    /// <param name="data">Receives a pointer to the data that have been
+    /// read, or <c>nullptr</c> if no read has completed.</param>
+    /// <param name="cnt">Receives the number of bytes in
+    /// <paramref name="data" />.</param>
+    /// <returns><c>S_OK</c> if a read has completed, <c>S_FALSE</c> if the
+    /// next read in the order of the stream has not yet completed, <c>E_FAIL</c> if the end of the
+    /// stream has been reached, a negative <c>errno</c> if a read failed.
+    /// </returns>
+    HRESULT next(_Out_ const byte_type *& data,
+        _Out_ std::size_t& cnt) noexcept;
+
+    /// <summary>
+    /// Creates the ring, registers the buffers and the descriptor and queues
+    /// the initial chain of reads.
+    /// </summary>
+    /// <param name="file">The descriptor to read from. The caller remains
+    /// the owner of the descriptor, which must remain open until the reader
+    /// is closed.</param>
+    /// <param name="wake">A descriptor which becomes readable if the thread
+    /// waiting for data should exit, or -1 if there is none.</param>
+    /// <param name="depth">The number of reads kept in flight, which must be
+    /// at least one.</param>
+    /// <param name="size">The size of each of the buffers in bytes, which is
+    /// the maximum amount of data a single read can return.</param>
+    /// <returns><c>S_OK</c> in case of success, <c>E_NOTIMPL</c> if
+    /// <c>io_uring</c> is not supported on the platform or by the kernel,
+    /// <c>E_NOT_VALID_STATE</c> if the reader is already open,
+    /// <c>E_OUTOFMEMORY</c> if the buffers could not be allocated, a
+    /// negative <c>errno</c> if setting up the ring failed.</returns>
+    HRESULT open(_In_ const handle_type file,
+        _In_ const handle_type wake,
+        _In_ const std::size_t depth,
+        _In_ const std::size_t size) noexcept;
+
+    /// <summary>
+    /// Queues the next chain of reads if all buffers have been taken and
+    /// waits until at least one read has completed.
+    /// </summary>
+    /// <remarks>
+    /// The method returns right away if there are completed reads that have
+    /// not yet been taken.
+    /// </remarks>
+    /// <param name="timeout">The time in milliseconds after which the method
+    /// returns even if no read has completed, or a negative value for waiting
+    /// indefinitely.</param>
+    /// <returns><c>S_OK</c> if reads have completed, if the wake-up
+    /// descriptor has been signalled or if the timeout expired,
+    /// <c>E_NOT_VALID_STATE</c> if the reader is not open, a negative
+    /// <c>errno</c> if waiting failed.</returns>
+    HRESULT wait(_In_ const int timeout) noexcept;
+
+    /// <summary>
+    /// Answer whether the wake-up descriptor has become readable.
+    /// </summary>
+    inline bool woken(void) const noexcept {
+        return this->_woken;
+    }
+
+    uring_reader& operator =(const uring_reader&) = delete;
+
+private:
+
+    /// <summary>
+    /// The state of the ring shared with the kernel.
+    /// </summary>
+    struct ring;
+
+    /// <summary>
+    /// The tag identifying the completion of the cancellation when closing.
+    /// </summary>
+    static constexpr std::uint64_t cancel_tag = ~static_cast<std::uint64_t>(1);
+
+    /// <summary>
+    /// The result of a read whose completion has not yet been reaped.
+    /// </summary>
+    static constexpr std::int32_t in_flight
+        = (std::numeric_limits<std::int32_t>::min)();
+
+    /// <summary>
+    /// The tag identifying the completion of the wait for the wake-up
+    /// descriptor.
+    /// </summary>
+    static constexpr std::uint64_t wake_tag = ~static_cast<std::uint64_t>(0);
+
+    /// <summary>
+    /// Enters the kernel to submit all prepared requests and to wait for
+    /// <paramref name="min_complete" /> completions.
+    /// </summary>
+    int enter(_In_ const unsigned int min_complete,
+        _In_ const int timeout) noexcept;
+
+    /// <summary>
+    /// Prepares a read into the buffer with the given index, which will be
+    /// submitted with the next call to <see cref="wait" />.
+    /// </summary>
+    /// <param name="buffer">The index of the buffer to read into.</param>
+    /// <param name="link">If <c>true</c>, the kernel starts the read that is
+    /// prepared next only after this one has completed.</param>
+    void queue(_In_ const std::size_t buffer, _In_ const bool link) noexcept;
+
+    /// <summary>
+    /// Queues a chain of reads into all buffers if all reads of the previous
+    /// chain have been taken.
+    /// </summary>
+    void requeue(void) noexcept;
+
+    std::vector<byte_type> _buffers;
+    std::uint64_t _calls;
+    std::size_t _current;
+    std::size_t _pending;
+    std::vector<std::int32_t> _results;
+    std::unique_ptr<ring> _ring;
+    std::size_t _size;
+    bool _woken;
+};
+
+#endif /* !defined(_LIBPOWENETICS_URING_READER_H) */
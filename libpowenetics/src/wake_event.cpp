@@ -0,0 +1,124 @@
+﻿// <copyright file="wake_event.cpp" company="Visualisierungsinstitut der Universität Stuttgart">
+// Copyright © 2026 Visualisierungsinstitut der Universität Stuttgart.
+// Licensed under the MIT licence. See LICENCE file for details.
+// </copyright>
+// <author>Christoph Müller</author>
+
+#include "wake_event.h"
+
+#if !defined(_WIN32)
+#include <cerrno>
+#include <cinttypes>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#if defined(__linux__)
+#include <sys/eventfd.h>
+#endif /* defined(__linux__) */
+
+#include "debug.h"
+
+
+/*
+ * wake_event::wake_event
+ */
+wake_event::wake_event(void) noexcept : _read(-1), _write(-1) { }
+
+
+/*
+ * wake_event::~wake_event
+ */
+wake_event::~wake_event(void) noexcept {
+    this->close();
+}
+
+
+/*
+ * wake_event::clear
+ */
+void wake_event::clear(void) noexcept {
+    if (this->_read != -1) {
+        // Both, the eventfd and the pipe are non-blocking, so we can drain
+        // them until they report that they would block.
+        std::uint64_t buffer;
+        while (::read(this->_read, &buffer, sizeof(buffer)) > 0);
+    }
+}
+
+
+/*
+ * wake_event::close
+ */
+void wake_event::close(void) noexcept {
+    if (this->_write != this->_read) {
+        ::close(this->_write);
+    }
+    if (this->_read != -1) {
+        ::close(this->_read);
+    }
+
+    this->_read = -1;
+    this->_write = -1;
+}
+
+
+/*
+ * wake_event::open
+ */
+HRESULT wake_event::open(void) noexcept {
+    if (this->_read != -1) {
+        return S_OK;
+    }
+
+#if defined(__linux__)
+    this->_read = ::eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (this->_read == -1) {
+        auto retval = static_cast<HRESULT>(-errno);
+        _powenetics_debug("Creating the eventfd failed.\r\n");
+        return retval;
+    }
+
+    this->_write = this->_read;
+
+#else /* defined(__linux__) */
+    int fds[2];
+    if (::pipe(fds) != 0) {
+        auto retval = static_cast<HRESULT>(-errno);
+        _powenetics_debug("Creating the wake-up pipe failed.\r\n");
+        return retval;
+    }
+
+    for (auto fd : fds) {
+        ::fcntl(fd, F_SETFD, FD_CLOEXEC);
+        ::fcntl(fd, F_SETFL, ::fcntl(fd, F_GETFL) | O_NONBLOCK);
+    }
+
+    this->_read = fds[0];
+    this->_write = fds[1];
+#endif /* defined(__linux__) */
+
+    return S_OK;
+}
+
+
+/*
+ * wake_event::set
+ */
+HRESULT wake_event::set(void) noexcept {
+    if (this->_write == -1) {
+        return E_NOT_VALID_STATE;
+    }
+
+    // Note: If the eventfd counter or the pipe is full, the event is already
+    // signalled, so EAGAIN is not an error.
+    const std::uint64_t value = 1;
+    const auto size = (this->_write == this->_read) ? sizeof(value) : 1;
+    if ((::write(this->_write, &value, size) < 0) && (errno != EAGAIN)) {
+        return static_cast<HRESULT>(-errno);
+    }
+
+    return S_OK;
+}
+
+#endif /* !defined(_WIN32) */
@@ -0,0 +1,92 @@
+﻿// <copyright file="wake_event.h" company="Visualisierungsinstitut der Universität Stuttgart">
+// Copyright © 2026 Visualisierungsinstitut der Universität Stuttgart.
+// Licensed under the MIT licence. See LICENCE file for details.
+// </copyright>
+// <author>Christoph Müller</author>
+
+#if !defined(_LIBPOWENETICS_WAKE_EVENT_H)
+#define _LIBPOWENETICS_WAKE_EVENT_H
+#pragma once
+
+#if !defined(_WIN32)
+#include "libpowenetics/api.h"
+#include "libpowenetics/types.h"
+
+
+/// <summary>
+/// A file descriptor that can be signalled from any thread in order to wake
+/// a thread waiting for it in <c>poll</c> together with other descriptors.
+/// </summary>
+/// <remarks>
+/// <para>The event is an <c>eventfd</c> on Linux and a pipe on other POSIX
+/// systems. It remains signalled until it is <see cref="clear" />ed.</para>
+/// <para>The event is not available on Windows, where closing the handle of
+/// the serial port cancels a pending read.</para>
+/// </remarks>
+class LIBPOWENETICS_TEST_API wake_event final {
+
+public:
+
+    /// <summary>
+    /// The type of a file descriptor.
+    /// </summary>
+    typedef int handle_type;
+
+    /// <summary>
+    /// Initialises a new instance, which must be <see cref="open" />ed before
+    /// it can be used.
+    /// </summary>
+    wake_event(void) noexcept;
+
+    wake_event(const wake_event&) = delete;
+
+    /// <summary>
+    /// Finalises the instance.
+    /// </summary>
+    ~wake_event(void) noexcept;
+
+    /// <summary>
+    /// Resets the event to the non-signalled state.
+    /// </summary>
+    void clear(void) noexcept;
+
+    /// <summary>
+    /// Closes the descriptors of the event if it is open.
+    /// </summary>
+    void close(void) noexcept;
+
+    /// <summary>
+    /// Answer the descriptor that becomes readable once the event is
+    /// signalled.
+    /// </summary>
+    /// <returns>The descriptor to be polled for <c>POLLIN</c>, or -1 if the
+    /// event is not open.</returns>
+    inline handle_type handle(void) const noexcept {
+        return this->_read;
+    }
+
+    /// <summary>
+    /// Creates the descriptors of the event if it is not yet open.
+    /// </summary>
+    /// <returns><c>S_OK</c> in case of success, a negative <c>errno</c>
+    /// otherwise.</returns>
+    HRESULT open(void) noexcept;
+
+    /// <summary>
+    /// Signals the event.
+    /// </summary>
+    /// <returns><c>S_OK</c> in case of success, <c>E_NOT_VALID_STATE</c> if
+    /// the event is not open, a negative <c>errno</c> otherwise.</returns>
+    HRESULT set(void) noexcept;
+
+    wake_event& operator =(const wake_event&) = delete;
+
+private:
+
+    handle_type _read;
+    handle_type _write;
+};
+
+#endif /* !defined(_WIN32) */
+
+#endif /* !defined(_LIBPOWENETICS_WAKE_EVENT_H) */
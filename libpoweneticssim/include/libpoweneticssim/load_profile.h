@@ -0,0 +1,122 @@
+﻿// <copyright file="load_profile.h" company="Visualisierungsinstitut der Universität Stuttgart">
+// Copyright © 2026 Visualisierungsinstitut der Universität Stuttgart.
+// Licensed under the MIT licence. See LICENCE file for details.
+// </copyright>
+// <author>Christoph Müller</author>
+
+#if !defined(_LIBPOWENETICSSIM_LOAD_PROFILE_H)
+#define _LIBPOWENETICSSIM_LOAD_PROFILE_H
+#pragma once
+
+#include <chrono>
+#include <vector>
+
+#include <libpowenetics/api.h>
+#include <libpowenetics/types.h>
+
+
+/// <summary>
+/// A phase of a <see cref="load_profile" />, in which the load changes
+/// linearly from <see cref="begin" /> to <see cref="end" />.
+/// </summary>
+struct load_phase final {
+
+    /// <summary>
+    /// The load at the begin of the phase as a fraction of the peak load,
+    /// which must be within [0, 1].
+    /// </summary>
+    float begin;
+
+    /// <summary>
+    /// The duration of the phase.
+    /// </summary>
+    std::chrono::milliseconds duration;
+
+    /// <summary>
+    /// The load at the end of the phase as a fraction of the peak load,
+    /// which must be within [0, 1].
+    /// </summary>
+    float end;
+};
+
+
+/// <summary>
+/// Describes how the load on the simulated system changes over time.
+/// </summary>
+/// <remarks>
+/// The profile is a sequence of <see cref="load_phase" />s that is repeated
+/// once it has been completed. A profile without any phase represents a
+/// system that is constantly idle.
+/// </remarks>
+class load_profile final {
+
+public:
+
+    /// <summary>
+    /// Parses a load profile from a script.
+    /// </summary>
+    /// <remarks>
+    /// <para>The script is a comma-separated list of phases, each of which is
+    /// specified as <c>duration:load</c> or <c>duration:begin-end</c>. The
+    /// duration is in milliseconds unless it has the suffix <c>s</c> for
+    /// seconds, and the load is a fraction of the peak load. The latter
+    /// form ramps the load linearly within the phase.</para>
+    /// <para>For instance, <c>2s:0.1,500:0.1-0.9,5s:0.9,1s:0.9-0.1</c>
+    /// describes an idle system that is ramped up to almost peak load within
+    /// half a second, runs there for five seconds and gradually returns to
+    /// idle.</para>
+    /// </remarks>
+    /// <param name="dst">Receives the profile.</param>
+    /// <param name="script">The script to be parsed.</param>
+    /// <returns><c>S_OK</c> in case of success, <c>E_INVALIDARG</c> if the
+    /// script is malformed.</returns>
+    static HRESULT parse(_Out_ load_profile& dst,
+        _In_z_ const char *script);
+
+    /// <summary>
+    /// Initialises a new instance representing an idle system.
+    /// </summary>
+    load_profile(void) = default;
+
+    /// <summary>
+    /// Initialises a new instance representing a constant load.
+    /// </summary>
+    /// <param name="load">The load as a fraction of the peak load, which is
+    /// clamped to [0, 1].</param>
+    explicit load_profile(_In_ const float load);
+
+    /// <summary>
+    /// Appends a phase to the profile.
+    /// </summary>
+    /// <param name="phase">The phase to be added. Phases without a duration
+    /// are ignored, and the loads are clamped to [0, 1].</param>
+    void add(_In_ const load_phase& phase);
+
+    /// <summary>
+    /// Answer the duration of one iteration of the profile.
+    /// </summary>
+    inline std::chrono::milliseconds duration(void) const noexcept {
+        return this->_duration;
+    }
+
+    /// <summary>
+    /// Answer the load at the given point in time.
+    /// </summary>
+    /// <param name="time">The time since the profile started.</param>
+    /// <returns>The load as a fraction of the peak load.</returns>
+    float load(_In_ const std::chrono::nanoseconds time) const noexcept;
+
+    /// <summary>
+    /// Answer the phases of the profile.
+    /// </summary>
+    inline const std::vector<load_phase>& phases(void) const noexcept {
+        return this->_phases;
+    }
+
+private:
+
+    std::chrono::milliseconds _duration = std::chrono::milliseconds::zero();
+    std::vector<load_phase> _phases;
+};
+
+#endif /* !defined(_LIBPOWENETICSSIM_LOAD_PROFILE_H) */
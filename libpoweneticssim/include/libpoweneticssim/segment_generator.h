@@ -0,0 +1,188 @@
+﻿// <copyright file="segment_generator.h" company="Visualisierungsinstitut der Universität Stuttgart">
+// Copyright © 2026 Visualisierungsinstitut der Universität Stuttgart.
+// Licensed under the MIT licence. See LICENCE file for details.
+// </copyright>
+// <author>Christoph Müller</author>
+
+#if !defined(_LIBPOWENETICSSIM_SEGMENT_GENERATOR_H)
+#define _LIBPOWENETICSSIM_SEGMENT_GENERATOR_H
+#pragma once
+
+#include <chrono>
+#include <cinttypes>
+#include <random>
+#include <vector>
+
+#include "libpoweneticssim/load_profile.h"
+
+
+/// <summary>
+/// Configures the corruption the <see cref="segment_generator" /> injects
+/// into the data stream.
+/// </summary>
+/// <remarks>
+/// All rates are probabilities per segment, and all of them are zero by
+/// default, which produces a perfect stream.
+/// </remarks>
+struct corruption_configuration final {
+
+    /// <summary>
+    /// The probability of flipping a random bit in the payload of a segment,
+    /// which produces a correctly framed segment with a wrong reading or
+    /// sequence number.
+    /// </summary>
+    double bit_flip_rate = 0.0;
+
+    /// <summary>
+    /// The probability of the current of a channel containing the bytes of
+    /// the segment delimiter, which is evaluated for each channel.
+    /// </summary>
+    double delimiter_rate = 0.0;
+
+    /// <summary>
+    /// The probability of injecting garbage bytes after a segment, which
+    /// breaks the framing of this segment.
+    /// </summary>
+    double garbage_rate = 0.0;
+
+    /// <summary>
+    /// The maximum number of bytes injected if garbage is injected.
+    /// </summary>
+    std::size_t max_garbage = 64;
+
+    /// <summary>
+    /// The probability of the device losing a segment, which becomes visible
+    /// as a gap in the sequence numbers.
+    /// </summary>
+    double skip_rate = 0.0;
+
+    /// <summary>
+    /// The probability of a segment being cut off at a random position.
+    /// </summary>
+    double truncation_rate = 0.0;
+};
+
+
+/// <summary>
+/// Counts the segments the <see cref="segment_generator" /> has produced and
+/// how they have been corrupted.
+/// </summary>
+struct segment_statistics final {
+
+    /// <summary>
+    /// The number of segments in which a bit has been flipped.
+    /// </summary>
+    std::uint64_t bit_flips;
+
+    /// <summary>
+    /// The number of fake delimiters injected in the currents.
+    /// </summary>
+    std::uint64_t delimiters;
+
+    /// <summary>
+    /// The number of segments followed by garbage.
+    /// </summary>
+    std::uint64_t garbage;
+
+    /// <summary>
+    /// The number of segments that have been emitted, including corrupted
+    /// ones.
+    /// </summary>
+    std::uint64_t segments;
+
+    /// <summary>
+    /// The number of sequence numbers that have been skipped, either on
+    /// purpose or because the segment could not be delivered.
+    /// </summary>
+    std::uint64_t skipped;
+
+    /// <summary>
+    /// The number of segments that have been truncated.
+    /// </summary>
+    std::uint64_t truncated;
+};
+
+
+/// <summary>
+/// Produces the segments a Powenetics v2 device streams, with readings
+/// following a <see cref="load_profile" />.
+/// </summary>
+/// <remarks>
+/// The voltages are the nominal ones of the connectors, which sag slightly
+/// under load, and the currents of each channel move between its idle and its
+/// peak current as prescribed by the profile. Both are overlaid with noise,
+/// and the currents additionally perform a bounded random walk, such that the
+/// readings look like those of a real system.
+/// </remarks>
+class segment_generator final {
+
+public:
+
+    /// <summary>
+    /// The number of channels in a segment.
+    /// </summary>
+    static constexpr std::size_t channels = 13;
+
+    /// <summary>
+    /// The size of a segment in bytes, including the delimiter.
+    /// </summary>
+    static constexpr std::size_t segment_size = 2 + 2 + 5 * channels;
+
+    /// <summary>
+    /// Initialises a new instance.
+    /// </summary>
+    /// <param name="profile">The load profile determining the currents.
+    /// </param>
+    /// <param name="corruption">The corruption to be injected.</param>
+    /// <param name="pcie_powered">Determines whether the PCIe connectors are
+    /// powered.</param>
+    /// <param name="seed">The seed for the random number generator, which
+    /// makes streams reproducible.</param>
+    segment_generator(_In_ const load_profile& profile,
+        _In_ const corruption_configuration& corruption,
+        _In_ const bool pcie_powered,
+        _In_ const std::uint32_t seed);
+
+    /// <summary>
+    /// Appends the next segment to <paramref name="dst" />.
+    /// </summary>
+    /// <param name="dst">The buffer receiving the segment and any garbage
+    /// injected after it. If the segment is skipped, nothing is added.
+    /// </param>
+    /// <param name="time">The time since streaming started, which determines
+    /// the load.</param>
+    /// <returns>The number of bytes that have been appended.</returns>
+    std::size_t next(_Inout_ std::vector<std::uint8_t>& dst,
+        _In_ const std::chrono::nanoseconds time);
+
+    /// <summary>
+    /// Resets the sequence number and the readings, which happens if the
+    /// device is restarted.
+    /// </summary>
+    void reset(void) noexcept;
+
+    /// <summary>
+    /// Consumes the next sequence number without producing a segment, which
+    /// is what happens if the device cannot deliver a segment.
+    /// </summary>
+    void skip(void) noexcept;
+
+    /// <summary>
+    /// Answer the statistics of the segments produced so far.
+    /// </summary>
+    inline const segment_statistics& statistics(void) const noexcept {
+        return this->_statistics;
+    }
+
+private:
+
+    corruption_configuration _corruption;
+    float _currents[channels];
+    bool _pcie_powered;
+    load_profile _profile;
+    std::mt19937 _rng;
+    std::uint16_t _sequence_number;
+    segment_statistics _statistics;
+};
+
+#endif /* !defined(_LIBPOWENETICSSIM_SEGMENT_GENERATOR_H) */
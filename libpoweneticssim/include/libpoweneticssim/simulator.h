@@ -0,0 +1,227 @@
+﻿// <copyright file="simulator.h" company="Visualisierungsinstitut der Universität Stuttgart">
+// Copyright © 2026 Visualisierungsinstitut der Universität Stuttgart.
+// Licensed under the MIT licence. See LICENCE file for details.
+// </copyright>
+// <author>Christoph Müller</author>
+
+#if !defined(_LIBPOWENETICSSIM_SIMULATOR_H)
+#define _LIBPOWENETICSSIM_SIMULATOR_H
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cinttypes>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "libpoweneticssim/load_profile.h"
+#include "libpoweneticssim/segment_generator.h"
+
+
+/// <summary>
+/// Configures the behaviour of a <see cref="simulator" />.
+/// </summary>
+struct simulator_configuration final {
+
+    /// <summary>
+    /// The interval in which the simulator writes the segments that have
+    /// become due, which emulates the latency timer of a USB serial
+    /// converter.
+    /// </summary>
+    std::chrono::milliseconds burst_interval = std::chrono::milliseconds(1);
+
+    /// <summary>
+    /// The corruption injected into the data stream.
+    /// </summary>
+    corruption_configuration corruption;
+
+    /// <summary>
+    /// The maximum time worth of segments that is held back if the client
+    /// does not read the pseudo-terminal. Segments exceeding this are lost,
+    /// like on a real serial port.
+    /// </summary>
+    std::chrono::milliseconds max_backlog = std::chrono::milliseconds(100);
+
+    /// <summary>
+    /// Determines whether the PCIe connectors are powered.
+    /// </summary>
+    bool pcie_powered = true;
+
+    /// <summary>
+    /// The load profile determining the currents.
+    /// </summary>
+    load_profile profile;
+
+    /// <summary>
+    /// The number of segments the simulator streams per second, which is
+    /// 1000 for a real device.
+    /// </summary>
+    double rate = 1000.0;
+
+    /// <summary>
+    /// The seed for the random number generator, which makes streams
+    /// reproducible.
+    /// </summary>
+    std::uint32_t seed = 42;
+};
+
+
+/// <summary>
+/// Describes the activity of a <see cref="simulator" />.
+/// </summary>
+struct simulator_statistics final {
+
+    /// <summary>
+    /// The number of bytes that have been written to the pseudo-terminal.
+    /// </summary>
+    std::uint64_t bytes_written;
+
+    /// <summary>
+    /// The number of calibration requests that have been answered.
+    /// </summary>
+    std::uint64_t calibrations;
+
+    /// <summary>
+    /// The number of commands that have been recognised.
+    /// </summary>
+    std::uint64_t commands;
+
+    /// <summary>
+    /// The number of segments that have been lost because the client did not
+    /// read them in time.
+    /// </summary>
+    std::uint64_t overruns;
+
+    /// <summary>
+    /// The statistics of the segments that have been produced.
+    /// </summary>
+    segment_statistics segments;
+
+    /// <summary>
+    /// Indicates whether the simulated device is currently streaming.
+    /// </summary>
+    bool streaming;
+
+    /// <summary>
+    /// The number of bytes received that did not form a known command.
+    /// </summary>
+    std::uint64_t unknown_bytes;
+};
+
+
+/// <summary>
+/// Simulates a Powenetics v2 device behind a pseudo-terminal.
+/// </summary>
+/// <remarks>
+/// <para>The simulator answers the commands the library sends to the device
+/// and streams segments once it has been instructed to do so. Clients can
+/// pass the path of the slave side of the pseudo-terminal to
+/// <see cref="powenetics_open" /> as if it were the serial port of a real
+/// device.</para>
+/// <para>The simulator keeps the slave side open itself, such that clients can
+/// connect and disconnect repeatedly while the simulator is running.</para>
+/// </remarks>
+class simulator final {
+
+public:
+
+    /// <summary>
+    /// Initialises a new instance.
+    /// </summary>
+    simulator(void) noexcept;
+
+    simulator(const simulator&) = delete;
+
+    /// <summary>
+    /// Finalises the instance.
+    /// </summary>
+    ~simulator(void) noexcept;
+
+    /// <summary>
+    /// Answer the path of the slave side of the pseudo-terminal.
+    /// </summary>
+    /// <returns>The path the clients must open, which is empty unless the
+    /// simulator is running.</returns>
+    inline const std::string& path(void) const noexcept {
+        return this->_path;
+    }
+
+    /// <summary>
+    /// Creates the pseudo-terminal and starts the thread simulating the
+    /// device.
+    /// </summary>
+    /// <param name="config">The configuration of the simulated device.
+    /// </param>
+    /// <returns><c>S_OK</c> in case of success, <c>E_INVALIDARG</c> if the
+    /// configuration is invalid, <c>E_NOT_VALID_STATE</c> if the simulator
+    /// is already running, or an error code derived from the system error
+    /// if the pseudo-terminal could not be created.</returns>
+    HRESULT start(_In_ const simulator_configuration& config);
+
+    /// <summary>
+    /// Answer a snapshot of the statistics.
+    /// </summary>
+    simulator_statistics statistics(void) const;
+
+    /// <summary>
+    /// Stops the simulation and closes the pseudo-terminal.
+    /// </summary>
+    /// <remarks>
+    /// It is safe to call this method if the simulator is not running.
+    /// </remarks>
+    void stop(void) noexcept;
+
+    simulator& operator =(const simulator&) = delete;
+
+private:
+
+    typedef std::chrono::steady_clock clock_type;
+
+    /// <summary>
+    /// Processes the commands in <see cref="_input" />, leaving incomplete
+    /// ones for the next call.
+    /// </summary>
+    void process(void);
+
+    /// <summary>
+    /// Reads the commands available on the pseudo-terminal and processes
+    /// them.
+    /// </summary>
+    HRESULT receive(void);
+
+    /// <summary>
+    /// Runs the simulation.
+    /// </summary>
+    void run(void);
+
+    /// <summary>
+    /// Writes as much of <see cref="_output" /> as the pseudo-terminal
+    /// accepts.
+    /// </summary>
+    HRESULT send(void);
+
+    simulator_configuration _config;
+    std::atomic<bool> _exit;
+    std::unique_ptr<segment_generator> _generator;
+    std::vector<std::uint8_t> _input;
+    mutable std::mutex _lock;
+    int _master;
+    std::vector<std::uint8_t> _output;
+    std::string _path;
+    std::uint64_t _produced;
+    int _slave;
+
+    /// <summary>
+    /// The statistics as published for <see cref="statistics" />, which are
+    /// protected by <see cref="_lock" />.
+    /// </summary>
+    simulator_statistics _snapshot;
+    clock_type::time_point _start_time;
+    simulator_statistics _statistics;
+    std::thread _thread;
+};
+
+#endif /* !defined(_LIBPOWENETICSSIM_SIMULATOR_H) */
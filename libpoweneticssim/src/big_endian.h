@@ -0,0 +1,39 @@
+﻿// <copyright file="big_endian.h" company="Visualisierungsinstitut der Universität Stuttgart">
+// Copyright © 2026 Visualisierungsinstitut der Universität Stuttgart.
+// Licensed under the MIT licence. See LICENCE file for details.
+// </copyright>
+// <author>Christoph Müller</author>
+
+#if !defined(_LIBPOWENETICSSIM_BIG_ENDIAN_H)
+#define _LIBPOWENETICSSIM_BIG_ENDIAN_H
+#pragma once
+
+#include <cinttypes>
+
+#include <libpowenetics/api.h>
+#include <libpowenetics/types.h>
+
+
+/// <summary>
+/// Writes <paramref name="src" /> as big-endian 16-bit number like the device
+/// does.
+/// </summary>
+inline void write_uint16(_Out_writes_(2) std::uint8_t *dst,
+        _In_ const std::uint16_t src) noexcept {
+    dst[0] = static_cast<std::uint8_t>(src >> 8);
+    dst[1] = static_cast<std::uint8_t>(src);
+}
+
+
+/// <summary>
+/// Writes the lower 24 bits of <paramref name="src" /> as big-endian number
+/// like the device does.
+/// </summary>
+inline void write_uint24(_Out_writes_(3) std::uint8_t *dst,
+        _In_ const std::uint32_t src) noexcept {
+    dst[0] = static_cast<std::uint8_t>(src >> 16);
+    dst[1] = static_cast<std::uint8_t>(src >> 8);
+    dst[2] = static_cast<std::uint8_t>(src);
+}
+
+#endif /* !defined(_LIBPOWENETICSSIM_BIG_ENDIAN_H) */
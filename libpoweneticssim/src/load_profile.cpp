@@ -0,0 +1,161 @@
+﻿// <copyright file="load_profile.cpp" company="Visualisierungsinstitut der Universität Stuttgart">
+// Copyright © 2026 Visualisierungsinstitut der Universität Stuttgart.
+// Licensed under the MIT licence. See LICENCE file for details.
+// </copyright>
+// <author>Christoph Müller</author>
+
+#include "libpoweneticssim/load_profile.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+
+
+/// <summary>
+/// Parses a load fraction at <paramref name="cur" /> and advances the
+/// pointer behind it.
+/// </summary>
+static bool parse_load(_Out_ float& dst, _Inout_ const char *& cur) {
+    char *end = nullptr;
+    errno = 0;
+    dst = std::strtof(cur, &end);
+
+    if ((end == cur) || (errno != 0) || (dst < 0.0f) || (dst > 1.0f)) {
+        return false;
+    }
+
+    cur = end;
+    return true;
+}
+
+
+/*
+ * load_profile::parse
+ */
+HRESULT load_profile::parse(_Out_ load_profile& dst,
+        _In_z_ const char *script) {
+    dst = load_profile();
+
+    if (script == nullptr) {
+        return E_INVALIDARG;
+    }
+
+    auto cur = script;
+    while (*cur != 0) {
+        load_phase phase;
+
+        // Parse the duration, which is in milliseconds unless specified
+        // otherwise.
+        char *end = nullptr;
+        errno = 0;
+        const auto duration = std::strtoul(cur, &end, 10);
+        if ((end == cur) || (errno != 0) || (duration == 0)) {
+            return E_INVALIDARG;
+        }
+        cur = end;
+
+        if (*cur == 's') {
+            phase.duration = std::chrono::seconds(duration);
+            ++cur;
+        } else {
+            if ((cur[0] == 'm') && (cur[1] == 's')) {
+                cur += 2;
+            }
+            phase.duration = std::chrono::milliseconds(duration);
+        }
+
+        // Parse the load, which is either constant or a linear ramp.
+        if (*cur++ != ':') {
+            return E_INVALIDARG;
+        }
+        if (!::parse_load(phase.begin, cur)) {
+            return E_INVALIDARG;
+        }
+
+        if (*cur == '-') {
+            ++cur;
+            if (!::parse_load(phase.end, cur)) {
+                return E_INVALIDARG;
+            }
+        } else {
+            phase.end = phase.begin;
+        }
+
+        switch (*cur) {
+            case ',':
+                ++cur;
+                if (*cur == 0) {
+                    return E_INVALIDARG;
+                }
+                break;
+
+            case 0:
+                break;
+
+            default:
+                return E_INVALIDARG;
+        }
+
+        dst.add(phase);
+    }
+
+    return S_OK;
+}
+
+
+/*
+ * load_profile::load_profile
+ */
+load_profile::load_profile(_In_ const float load) {
+    this->add({ load, std::chrono::milliseconds(1000), load });
+}
+
+
+/*
+ * load_profile::add
+ */
+void load_profile::add(_In_ const load_phase& phase) {
+    if (phase.duration.count() > 0) {
+        this->_phases.push_back({
+            (std::clamp)(phase.begin, 0.0f, 1.0f),
+            phase.duration,
+            (std::clamp)(phase.end, 0.0f, 1.0f)
+        });
+        this->_duration += phase.duration;
+    }
+}
+
+
+/*
+ * load_profile::load
+ */
+float load_profile::load(_In_ const std::chrono::nanoseconds time) const noexcept {
+    if (this->_phases.empty()) {
+        return 0.0f;
+    }
+
+    // The profile repeats, so we only need the offset into the current
+    // iteration.
+    const auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        this->_duration);
+    auto offset = time % duration;
+    if (offset.count() < 0) {
+        offset += duration;
+    }
+
+    for (auto& p : this->_phases) {
+        const auto length = std::chrono::duration_cast<
+            std::chrono::nanoseconds>(p.duration);
+        if (offset < length) {
+            const auto t = static_cast<float>(offset.count())
+                / static_cast<float>(length.count());
+            return p.begin + t * (p.end - p.begin);
+        }
+
+        offset -= length;
+    }
+
+    // This is unreachable unless rounding bites us, in which case we are at
+    // the very end of the last phase.
+    return this->_phases.back().end;
+}
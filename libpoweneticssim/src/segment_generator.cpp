@@ -0,0 +1,197 @@
+﻿// <copyright file="segment_generator.cpp" company="Visualisierungsinstitut der Universität Stuttgart">
+// Copyright © 2026 Visualisierungsinstitut der Universität Stuttgart.
+// Licensed under the MIT licence. See LICENCE file for details.
+// </copyright>
+// <author>Christoph Müller</author>
+
+#include "libpoweneticssim/segment_generator.h"
+
+#include <algorithm>
+#include <iterator>
+
+#include "responses.h"
+
+#include "big_endian.h"
+
+
+/// <summary>
+/// The electrical characteristics of a channel of the device.
+/// </summary>
+struct channel_characteristics final {
+
+    /// <summary>
+    /// The nominal voltage in millivolts. A zero indicates that the channel
+    /// is not connected.
+    /// </summary>
+    float voltage;
+
+    /// <summary>
+    /// The current in milliamperes drawn by an idle system.
+    /// </summary>
+    float idle;
+
+    /// <summary>
+    /// The current in milliamperes drawn at peak load.
+    /// </summary>
+    float peak;
+
+    /// <summary>
+    /// Indicates whether the channel is a PCIe connector.
+    /// </summary>
+    bool pcie;
+};
+
+
+/// <summary>
+/// The characteristics of the channels in the order they appear in a segment
+/// when a 24-pin ATX connector is attached, which roughly resemble a
+/// workstation with a high-end GPU.
+/// </summary>
+static constexpr channel_characteristics characteristics[] = {
+    {  3300.0f,  500.0f,  3000.0f, false }, // ATX 3.3V
+    {  5000.0f,  200.0f,  1000.0f, false }, // ATX 5V STB
+    { 12000.0f, 1000.0f,  8000.0f, false }, // ATX 12V
+    {  5000.0f,  500.0f,  4000.0f, false }, // ATX 5V
+    { 12000.0f, 1000.0f, 15000.0f, false }, // EPS #1
+    {     0.0f,    0.0f,     0.0f, false }, // ATX 12V STB (10-pin only)
+    { 12000.0f,  500.0f, 10000.0f, false }, // EPS #3
+    { 12000.0f, 1000.0f, 15000.0f, false }, // EPS #2
+    { 12000.0f,  500.0f, 12500.0f, true  }, // PCIe #3
+    { 12000.0f,  500.0f, 12500.0f, true  }, // PCIe #2
+    {  3300.0f,  100.0f,  1000.0f, false }, // PEG 3.3V
+    { 12000.0f,  500.0f,  5500.0f, false }, // PEG 12V
+    { 12000.0f,  500.0f, 12500.0f, true  }  // PCIe #1
+};
+
+static_assert(std::size(characteristics) == segment_generator::channels,
+    "There must be characteristics for each channel.");
+
+
+/*
+ * segment_generator::segment_generator
+ */
+segment_generator::segment_generator(_In_ const load_profile& profile,
+        _In_ const corruption_configuration& corruption,
+        _In_ const bool pcie_powered,
+        _In_ const std::uint32_t seed)
+    : _corruption(corruption),
+        _pcie_powered(pcie_powered),
+        _profile(profile),
+        _rng(seed),
+        _statistics() {
+    this->reset();
+}
+
+
+/*
+ * segment_generator::next
+ */
+std::size_t segment_generator::next(_Inout_ std::vector<std::uint8_t>& dst,
+        _In_ const std::chrono::nanoseconds time) {
+    auto& corruption = this->_corruption;
+    auto& delimiter = responses_v2::segment_delimiter;
+
+    if (std::bernoulli_distribution(corruption.skip_rate)(this->_rng)) {
+        this->skip();
+        return 0;
+    }
+
+    std::uint8_t segment[segment_size];
+    std::copy(delimiter.begin(), delimiter.end(), segment);
+    ::write_uint16(segment + delimiter.size(), this->_sequence_number++);
+
+    const auto load = this->_profile.load(time);
+    std::normal_distribution<float> noise(0.0f, 1.0f);
+    std::uniform_real_distribution<float> step(-1.0f, 1.0f);
+    std::bernoulli_distribution fake_delimiter(corruption.delimiter_rate);
+
+    for (std::size_t c = 0; c < channels; ++c) {
+        auto& ch = characteristics[c];
+        auto cur = segment + delimiter.size() + sizeof(std::uint16_t) + 5 * c;
+        const auto connected = (ch.voltage > 0.0f)
+            && (this->_pcie_powered || !ch.pcie);
+
+        if (connected) {
+            // The voltage sags by up to 2 % under load, and the noise is in
+            // the order of what the ADC of the device shows.
+            const auto voltage = ch.voltage * (1.0f - 0.02f * load)
+                + 0.002f * ch.voltage * noise(this->_rng);
+
+            // The random walk is bounded to a twentieth of the peak current
+            // around the current prescribed by the profile.
+            const auto bound = 0.05f * ch.peak;
+            this->_currents[c] = (std::clamp)(this->_currents[c]
+                + 0.005f * ch.peak * step(this->_rng), -bound, bound);
+            const auto current = ch.idle + load * (ch.peak - ch.idle)
+                + this->_currents[c] + 0.01f * ch.peak * noise(this->_rng);
+
+            ::write_uint16(cur, static_cast<std::uint16_t>(
+                (std::clamp)(voltage, 0.0f, 65535.0f)));
+            ::write_uint24(cur + 2, static_cast<std::uint32_t>(
+                (std::clamp)(current, 0.0f, 16777215.0f)));
+
+        } else {
+            // Open channels show a bit of noise on the voltage only.
+            ::write_uint16(cur, static_cast<std::uint16_t>(
+                (std::clamp)(20.0f * noise(this->_rng), 0.0f, 65535.0f)));
+            ::write_uint24(cur + 2, 0);
+        }
+
+        if (fake_delimiter(this->_rng)) {
+            cur[3] = delimiter.front();
+            cur[4] = delimiter.back();
+            ++this->_statistics.delimiters;
+        }
+    }
+
+    if (std::bernoulli_distribution(corruption.bit_flip_rate)(this->_rng)) {
+        std::uniform_int_distribution<std::size_t> bit(8 * delimiter.size(),
+            8 * segment_size - 1);
+        const auto b = bit(this->_rng);
+        segment[b / 8] ^= static_cast<std::uint8_t>(1 << (b % 8));
+        ++this->_statistics.bit_flips;
+    }
+
+    auto size = segment_size;
+    if (std::bernoulli_distribution(corruption.truncation_rate)(this->_rng)) {
+        size = std::uniform_int_distribution<std::size_t>(delimiter.size(),
+            segment_size - 1)(this->_rng);
+        ++this->_statistics.truncated;
+    }
+
+    dst.insert(dst.end(), segment, segment + size);
+
+    if (std::bernoulli_distribution(corruption.garbage_rate)(this->_rng)) {
+        const auto cnt = std::uniform_int_distribution<std::size_t>(1,
+            (std::max)(corruption.max_garbage, std::size_t(1)))(this->_rng);
+        std::uniform_int_distribution<int> byte(0, 255);
+
+        for (std::size_t i = 0; i < cnt; ++i) {
+            dst.push_back(static_cast<std::uint8_t>(byte(this->_rng)));
+        }
+
+        size += cnt;
+        ++this->_statistics.garbage;
+    }
+
+    ++this->_statistics.segments;
+    return size;
+}
+
+
+/*
+ * segment_generator::reset
+ */
+void segment_generator::reset(void) noexcept {
+    std::fill(std::begin(this->_currents), std::end(this->_currents), 0.0f);
+    this->_sequence_number = 0;
+}
+
+
+/*
+ * segment_generator::skip
+ */
+void segment_generator::skip(void) noexcept {
+    ++this->_sequence_number;
+    ++this->_statistics.skipped;
+}
@@ -0,0 +1,412 @@
+﻿// <copyright file="simulator.cpp" company="Visualisierungsinstitut der Universität Stuttgart">
+// Copyright © 2026 Visualisierungsinstitut der Universität Stuttgart.
+// Licensed under the MIT licence. See LICENCE file for details.
+// </copyright>
+// <author>Christoph Müller</author>
+
+#include "libpoweneticssim/simulator.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cerrno>
+#include <cmath>
+#include <cstdlib>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include "commands.h"
+#include "responses.h"
+
+
+/// <summary>
+/// The value of a file descriptor that is not open.
+/// </summary>
+static constexpr int invalid_handle = -1;
+
+
+/// <summary>
+/// Answer whether <paramref name="input" /> starts with
+/// <paramref name="command" />.
+/// </summary>
+/// <returns>A positive number if the command has been found, zero if the
+/// input is a prefix of the command, and a negative number if the input does
+/// not match the command.</returns>
+template<class TCommand>
+static int match(_In_ const std::vector<std::uint8_t>& input,
+        _In_ const TCommand& command) noexcept {
+    const auto cnt = (std::min)(input.size(), command.size());
+    if (!std::equal(input.begin(), input.begin() + cnt, command.begin())) {
+        return -1;
+    } else {
+        return (cnt == command.size()) ? 1 : 0;
+    }
+}
+
+
+/*
+ * simulator::simulator
+ */
+simulator::simulator(void) noexcept
+    : _exit(false),
+        _master(invalid_handle),
+        _produced(0),
+        _slave(invalid_handle),
+        _snapshot(),
+        _statistics() { }
+
+
+/*
+ * simulator::~simulator
+ */
+simulator::~simulator(void) noexcept {
+    this->stop();
+}
+
+
+/*
+ * simulator::start
+ */
+HRESULT simulator::start(_In_ const simulator_configuration& config) {
+    if (!std::isfinite(config.rate) || (config.rate <= 0.0)
+            || (config.burst_interval.count() <= 0)
+            || (config.max_backlog.count() < 0)) {
+        return E_INVALIDARG;
+    }
+
+    if (this->_thread.joinable()) {
+        return E_NOT_VALID_STATE;
+    }
+
+    this->_config = config;
+    this->_exit.store(false, std::memory_order_release);
+    this->_generator.reset(new segment_generator(config.profile,
+        config.corruption, config.pcie_powered, config.seed));
+    this->_input.clear();
+    this->_output.clear();
+    this->_produced = 0;
+    this->_snapshot = simulator_statistics();
+    this->_statistics = simulator_statistics();
+
+    // Create the pseudo-terminal, which we use in non-blocking mode such that
+    // we can continue to produce segments if the client does not read.
+    this->_master = ::posix_openpt(O_RDWR | O_NOCTTY);
+    if (this->_master == invalid_handle) {
+        return static_cast<HRESULT>(-errno);
+    }
+
+    if ((::grantpt(this->_master) != 0) || (::unlockpt(this->_master) != 0)) {
+        auto retval = static_cast<HRESULT>(-errno);
+        this->stop();
+        return retval;
+    }
+
+    {
+        auto path = ::ptsname(this->_master);
+        if (path == nullptr) {
+            auto retval = static_cast<HRESULT>(-errno);
+            this->stop();
+            return retval;
+        }
+        this->_path = path;
+    }
+
+    {
+        auto flags = ::fcntl(this->_master, F_GETFL);
+        if ((flags == -1) || (::fcntl(this->_master, F_SETFL,
+                flags | O_NONBLOCK) == -1)) {
+            auto retval = static_cast<HRESULT>(-errno);
+            this->stop();
+            return retval;
+        }
+    }
+
+    // Hold the slave side open, because the master side reports an error if
+    // no one has the slave open. Making the line raw disables any processing
+    // of the binary data until the client configures the line itself.
+    this->_slave = ::open(this->_path.c_str(), O_RDWR | O_NOCTTY);
+    if (this->_slave == invalid_handle) {
+        auto retval = static_cast<HRESULT>(-errno);
+        this->stop();
+        return retval;
+    }
+
+    {
+        termios tty;
+        if (::tcgetattr(this->_slave, &tty) != 0) {
+            auto retval = static_cast<HRESULT>(-errno);
+            this->stop();
+            return retval;
+        }
+
+        ::cfmakeraw(&tty);
+
+        if (::tcsetattr(this->_slave, TCSANOW, &tty) != 0) {
+            auto retval = static_cast<HRESULT>(-errno);
+            this->stop();
+            return retval;
+        }
+    }
+
+    this->_thread = std::thread(&simulator::run, this);
+
+    return S_OK;
+}
+
+
+/*
+ * simulator::statistics
+ */
+simulator_statistics simulator::statistics(void) const {
+    std::lock_guard<std::mutex> l(this->_lock);
+    return this->_snapshot;
+}
+
+
+/*
+ * simulator::stop
+ */
+void simulator::stop(void) noexcept {
+    this->_exit.store(true, std::memory_order_release);
+
+    if (this->_thread.joinable()) {
+        this->_thread.join();
+    }
+
+    if (this->_slave != invalid_handle) {
+        ::close(this->_slave);
+        this->_slave = invalid_handle;
+    }
+
+    if (this->_master != invalid_handle) {
+        ::close(this->_master);
+        this->_master = invalid_handle;
+    }
+
+    this->_path.clear();
+}
+
+
+/*
+ * simulator::process
+ */
+void simulator::process(void) {
+    auto& input = this->_input;
+    auto& stats = this->_statistics;
+
+    while (!input.empty()) {
+        if (input.front() != commands_v2::stream_mode.front()) {
+            // Nothing we know starts here, so skip a byte and resynchronise.
+            input.erase(input.begin());
+            ++stats.unknown_bytes;
+            continue;
+        }
+
+        if (input.size() < 2) {
+            return;
+        }
+
+        if (input[1] != commands_v2::stream_mode[1]) {
+            // This is a calibration request, which consists of the channel
+            // and the 24-bit reference current. We accept anything for valid
+            // channels, because we do not measure anything anyway.
+            constexpr std::size_t length = 2 + 3;
+            if (input.size() < length) {
+                return;
+            }
+
+            const auto channel = input[1];
+            auto& response = (channel < segment_generator::channels)
+                ? responses_v2::calibration_success
+                : responses_v2::calibration_error;
+            this->_output.insert(this->_output.end(), response.begin(),
+                response.end());
+            input.erase(input.begin(), input.begin() + length);
+            ++stats.calibrations;
+            ++stats.commands;
+            continue;
+        }
+
+        // All other commands share the prefix of the stream mode command.
+        const auto bootload = ::match(input, commands_v2::bootload_mode);
+        const auto calibration_ok = ::match(input, commands_v2::calibration_ok);
+        const auto clear = ::match(input, commands_v2::clear_calibration);
+        const auto stream = ::match(input, commands_v2::stream_mode);
+
+        if (stream > 0) {
+            if (!stats.streaming) {
+                this->_generator->reset();
+                this->_produced = 0;
+                this->_start_time = clock_type::now();
+                stats.streaming = true;
+            }
+            input.erase(input.begin(),
+                input.begin() + commands_v2::stream_mode.size());
+
+        } else if (bootload > 0) {
+            // The device stops streaming, and whatever it has not yet sent
+            // is lost.
+            this->_output.clear();
+            stats.streaming = false;
+            input.erase(input.begin(),
+                input.begin() + commands_v2::bootload_mode.size());
+
+        } else if (calibration_ok > 0) {
+            input.erase(input.begin(),
+                input.begin() + commands_v2::calibration_ok.size());
+
+        } else if (clear > 0) {
+            input.erase(input.begin(),
+                input.begin() + commands_v2::clear_calibration.size());
+
+        } else if ((bootload == 0) || (calibration_ok == 0) || (clear == 0)
+                || (stream == 0)) {
+            // Wait for the rest of the command.
+            return;
+
+        } else {
+            input.erase(input.begin());
+            ++stats.unknown_bytes;
+            continue;
+        }
+
+        ++stats.commands;
+    }
+}
+
+
+/*
+ * simulator::receive
+ */
+HRESULT simulator::receive(void) {
+    std::uint8_t buffer[256];
+
+    while (true) {
+        const auto cnt = ::read(this->_master, buffer, sizeof(buffer));
+        if (cnt > 0) {
+            this->_input.insert(this->_input.end(), buffer, buffer + cnt);
+
+        } else if (cnt == 0) {
+            break;
+
+        } else if (errno == EINTR) {
+            continue;
+
+        } else if ((errno == EAGAIN) || (errno == EWOULDBLOCK)) {
+            break;
+
+        } else {
+            return static_cast<HRESULT>(-errno);
+        }
+    }
+
+    this->process();
+    return S_OK;
+}
+
+
+/*
+ * simulator::run
+ */
+void simulator::run(void) {
+    using namespace std::chrono;
+    const auto burst = duration_cast<nanoseconds>(this->_config.burst_interval);
+    const auto interval = static_cast<int>(this->_config.burst_interval.count());
+    const auto rate = this->_config.rate;
+
+    // Determine how many bytes we hold back at most if the client does not
+    // read, but at least one segment.
+    const auto backlog = segment_generator::segment_size * (std::max)(
+        static_cast<std::size_t>(rate * duration<double>(
+            this->_config.max_backlog).count()),
+        static_cast<std::size_t>(1));
+
+    while (!this->_exit.load(std::memory_order_acquire)) {
+        ::pollfd fd;
+        fd.fd = this->_master;
+        fd.events = POLLIN;
+        fd.revents = 0;
+        if (!this->_output.empty()) {
+            fd.events |= POLLOUT;
+        }
+
+        if (::poll(&fd, 1, interval) < 0) {
+            if (errno == EINTR) {
+                continue;
+            } else {
+                break;
+            }
+        }
+
+        if (((fd.revents & POLLIN) != 0) && FAILED(this->receive())) {
+            break;
+        }
+
+        if (this->_statistics.streaming) {
+            // Produce all segments that have become due until the begin of
+            // the current burst. If the backlog is full, the segments are
+            // lost, but consume their sequence numbers like on the device.
+            const auto elapsed = clock_type::now() - this->_start_time;
+            const auto due = static_cast<std::uint64_t>(
+                duration<double>(elapsed / burst * burst).count() * rate);
+
+            for (; this->_produced < due; ++this->_produced) {
+                if (this->_output.size() < backlog) {
+                    const auto time = duration_cast<nanoseconds>(
+                        duration<double>(this->_produced / rate));
+                    this->_generator->next(this->_output, time);
+                } else {
+                    this->_generator->skip();
+                    ++this->_statistics.overruns;
+                }
+            }
+        }
+
+        if (FAILED(this->send())) {
+            break;
+        }
+
+        {
+            std::lock_guard<std::mutex> l(this->_lock);
+            this->_snapshot = this->_statistics;
+            this->_snapshot.segments = this->_generator->statistics();
+        }
+    }
+
+    std::lock_guard<std::mutex> l(this->_lock);
+    this->_snapshot = this->_statistics;
+    this->_snapshot.segments = this->_generator->statistics();
+    this->_snapshot.streaming = false;
+}
+
+
+/*
+ * simulator::send
+ */
+HRESULT simulator::send(void) {
+    auto& output = this->_output;
+    std::size_t sent = 0;
+
+    while (sent < output.size()) {
+        const auto cnt = ::write(this->_master, output.data() + sent,
+            output.size() - sent);
+        if (cnt >= 0) {
+            sent += cnt;
+
+        } else if (errno == EINTR) {
+            continue;
+
+        } else if ((errno == EAGAIN) || (errno == EWOULDBLOCK)) {
+            break;
+
+        } else {
+            return static_cast<HRESULT>(-errno);
+        }
+    }
+
+    output.erase(output.begin(), output.begin() + sent);
+    this->_statistics.bytes_written += sent;
+    return S_OK;
+}
@@ -0,0 +1,135 @@
+﻿// <copyright file="cmd_line.cpp" company="Visualisierungsinstitut der Universität Stuttgart">
+// Copyright © 2026 Visualisierungsinstitut der Universität Stuttgart.
+// Licensed under the MIT licence. See LICENCE file for details.
+// </copyright>
+// <author>Christoph Müller</author>
+
+#include "cmd_line.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <stdexcept>
+
+
+template<class TIterator>
+static TIterator find_switch(TIterator begin, TIterator end,
+        const char *name) {
+    assert(name != nullptr);
+    return std::find_if(begin, end, [name](const char *s) {
+        return (::strcmp(s, name) == 0);
+    });
+}
+
+
+template<class TIterator>
+static TIterator find_argument(TIterator begin, TIterator end,
+        const char *name) {
+    auto retval = ::find_switch(begin, end, name);
+    if (retval == end) {
+        return end;
+    }
+
+    if (++retval == end) {
+        throw std::invalid_argument(std::string("The option \"") + name
+            + "\" requires a value.");
+    }
+
+    return retval;
+}
+
+
+template<class TIterator>
+static double find_probability(TIterator begin, TIterator end,
+        const char *name, const double fallback) {
+    auto it = ::find_argument(begin, end, name);
+    if (it == end) {
+        return fallback;
+    }
+
+    const auto retval = std::stod(*it);
+    if ((retval < 0.0) || (retval > 1.0)) {
+        throw std::invalid_argument(std::string("The option \"") + name
+            + "\" requires a probability within [0, 1].");
+    }
+
+    return retval;
+}
+
+
+template<class TIterator>
+static unsigned long find_number(TIterator begin, TIterator end,
+        const char *name, const unsigned long fallback) {
+    auto it = ::find_argument(begin, end, name);
+    return (it != end) ? std::stoul(*it) : fallback;
+}
+
+
+/*
+ * cmd_line::cmd_line
+ */
+cmd_line::cmd_line(_In_ const int argc, _In_reads_(argc) const char **argv)
+        : _duration(0), _verbose(false) {
+    const auto begin = argv;
+    const auto end = argv + argc;
+    auto& config = this->_configuration;
+    auto& corruption = config.corruption;
+
+    {
+        auto it = ::find_argument(begin, end, "--rate");
+        if (it != end) {
+            config.rate = std::stod(*it);
+            if (!(config.rate > 0.0)) {
+                throw std::invalid_argument("The rate must be positive.");
+            }
+        }
+    }
+
+    {
+        auto it = ::find_argument(begin, end, "--profile");
+        if (it != end) {
+            if (FAILED(load_profile::parse(config.profile, *it))) {
+                throw std::invalid_argument("The load profile is malformed.");
+            }
+        }
+    }
+
+    config.burst_interval = std::chrono::milliseconds(::find_number(begin,
+        end, "--burst", static_cast<unsigned long>(
+        config.burst_interval.count())));
+    if (config.burst_interval.count() <= 0) {
+        throw std::invalid_argument("The burst interval must be positive.");
+    }
+
+    config.max_backlog = std::chrono::milliseconds(::find_number(begin, end,
+        "--backlog", static_cast<unsigned long>(
+        config.max_backlog.count())));
+    config.pcie_powered = (::find_switch(begin, end, "--no-pcie") == end);
+    config.seed = static_cast<std::uint32_t>(::find_number(begin, end,
+        "--seed", config.seed));
+
+    corruption.bit_flip_rate = ::find_probability(begin, end, "--bit-flips",
+        corruption.bit_flip_rate);
+    corruption.delimiter_rate = ::find_probability(begin, end,
+        "--delimiters", corruption.delimiter_rate);
+    corruption.garbage_rate = ::find_probability(begin, end, "--garbage",
+        corruption.garbage_rate);
+    corruption.max_garbage = ::find_number(begin, end, "--max-garbage",
+        static_cast<unsigned long>(corruption.max_garbage));
+    corruption.skip_rate = ::find_probability(begin, end, "--skips",
+        corruption.skip_rate);
+    corruption.truncation_rate = ::find_probability(begin, end,
+        "--truncation", corruption.truncation_rate);
+
+    this->_duration = std::chrono::seconds(::find_number(begin, end,
+        "--duration", 0));
+
+    {
+        auto it = ::find_argument(begin, end, "--link");
+        if (it != end) {
+            this->_link = *it;
+        }
+    }
+
+    this->_verbose = (::find_switch(begin, end, "--verbose") != end);
+}
@@ -0,0 +1,71 @@
+﻿// <copyright file="cmd_line.h" company="Visualisierungsinstitut der Universität Stuttgart">
+// Copyright © 2026 Visualisierungsinstitut der Universität Stuttgart.
+// Licensed under the MIT licence. See LICENCE file for details.
+// </copyright>
+// <author>Christoph Müller</author>
+
+#pragma once
+
+#include <chrono>
+#include <string>
+
+#include <libpoweneticssim/simulator.h>
+
+
+/// <summary>
+/// Holds the results of processing the command line arguments.
+/// </summary>
+class cmd_line final {
+
+public:
+
+    /// <summary>
+    /// Initialises a new instance.
+    /// </summary>
+    /// <param name="argc">The number of command line arguments.</param>
+    /// <param name="argv">The list of command line arguments.</param>
+    /// <exception cref="std::invalid_argument">If any of the arguments is
+    /// malformed.</exception>
+    cmd_line(_In_ const int argc, _In_reads_(argc) const char **argv);
+
+    /// <summary>
+    /// Answer the configuration of the simulated device.
+    /// </summary>
+    inline const simulator_configuration& configuration(void) const noexcept {
+        return this->_configuration;
+    }
+
+    /// <summary>
+    /// Answer how long the simulator should run.
+    /// </summary>
+    /// <returns>The time after which the simulator exits, or zero if it
+    /// should run until it is interrupted.</returns>
+    inline std::chrono::seconds duration(void) const noexcept {
+        return this->_duration;
+    }
+
+    /// <summary>
+    /// Answer the path of a symbolic link to the pseudo-terminal, which gives
+    /// the simulated device a stable name.
+    /// </summary>
+    /// <returns>The path of the link, or an empty string if no link should be
+    /// created.</returns>
+    inline const std::string& link(void) const noexcept {
+        return this->_link;
+    }
+
+    /// <summary>
+    /// Answer whether the statistics should be printed every second.
+    /// </summary>
+    inline bool verbose(void) const noexcept {
+        return this->_verbose;
+    }
+
+private:
+
+    simulator_configuration _configuration;
+    std::chrono::seconds _duration;
+    std::string _link;
+    bool _verbose;
+
+};
@@ -0,0 +1,120 @@
+﻿// <copyright file="poweneticssim.cpp" company="Visualisierungsinstitut der Universität Stuttgart">
+// Copyright © 2026 Visualisierungsinstitut der Universität Stuttgart.
+// Licensed under the MIT licence. See LICENCE file for details.
+// </copyright>
+// <author>Christoph Müller</author>
+
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+
+#include <signal.h>
+#include <unistd.h>
+
+#include <libpoweneticssim/simulator.h>
+
+#include "cmd_line.h"
+
+
+/// <summary>
+/// Prints the statistics of the simulator to <paramref name="stream" />.
+/// </summary>
+static void print(_In_ std::ostream& stream,
+        _In_ const simulator_statistics& stats) {
+    stream << "Streaming: " << (stats.streaming ? "yes" : "no")
+        << ", segments: " << stats.segments.segments
+        << ", skipped: " << stats.segments.skipped
+        << ", overruns: " << stats.overruns
+        << ", bytes: " << stats.bytes_written
+        << ", commands: " << stats.commands
+        << ", unknown bytes: " << stats.unknown_bytes
+        << std::endl;
+}
+
+
+/// <summary>
+/// The entry point of the application.
+/// </summary>
+/// <remarks>
+/// This application simulates a Powenetics v2 power measurement kit behind a
+/// pseudo-terminal, such that the library and applications using it can be
+/// tested and benchmarked without the hardware. It prints the path of the
+/// pseudo-terminal, which can be passed to <see cref="powenetics_open" />,
+/// and runs until it is interrupted.
+/// </remarks>
+/// <param name="argc">The number of command line arguments.</param>
+/// <param name="argv">The list of command line arguments.</param>
+/// <returns>Zero in case of success, a negative number otherwise.</returns>
+int main(_In_ const int argc, _In_reads_(argc) const char **argv) {
+    try {
+        cmd_line cmd_line(argc, argv);
+
+        // Block the signals ending the simulation before starting any thread,
+        // such that we can wait for them synchronously.
+        sigset_t signals;
+        ::sigemptyset(&signals);
+        ::sigaddset(&signals, SIGINT);
+        ::sigaddset(&signals, SIGTERM);
+        ::pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+
+        simulator simulator;
+        {
+            auto hr = simulator.start(cmd_line.configuration());
+            if (FAILED(hr)) {
+                std::cerr << "Starting the simulator failed with error "
+                    << hr << "." << std::endl;
+                return hr;
+            }
+        }
+
+        if (!cmd_line.link().empty()) {
+            ::unlink(cmd_line.link().c_str());
+            if (::symlink(simulator.path().c_str(),
+                    cmd_line.link().c_str()) != 0) {
+                std::cerr << "Linking the pseudo-terminal to \""
+                    << cmd_line.link() << "\" failed: "
+                    << std::strerror(errno) << std::endl;
+            }
+        }
+
+        std::cout << simulator.path() << std::endl;
+
+        // Wait until we are interrupted or the requested time is over, and
+        // print the statistics every second if requested.
+        const auto begin = std::chrono::steady_clock::now();
+        const auto duration = cmd_line.duration();
+        while (true) {
+            timespec timeout { 1, 0 };
+            if (::sigtimedwait(&signals, nullptr, &timeout) > 0) {
+                break;
+            }
+
+            if (cmd_line.verbose()) {
+                ::print(std::cerr, simulator.statistics());
+            }
+
+            if ((duration.count() > 0) && (std::chrono::steady_clock::now()
+                    - begin >= duration)) {
+                break;
+            }
+        }
+
+        simulator.stop();
+
+        if (!cmd_line.link().empty()) {
+            ::unlink(cmd_line.link().c_str());
+        }
+
+        ::print(std::cerr, simulator.statistics());
+        return 0;
+
+    } catch (std::exception& ex) {
+        std::cerr << ex.what() << std::endl;
+        return -1;
+
+    } catch (...) {
+        std::cerr << "Unexpected exception caught at root level" << std::endl;
+        return -2;
+    }
+}
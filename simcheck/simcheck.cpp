@@ -0,0 +1,150 @@
+﻿// <copyright file="simcheck.cpp" company="Visualisierungsinstitut der Universität Stuttgart">
+// Copyright © 2026 Visualisierungsinstitut der Universität Stuttgart.
+// Licensed under the MIT licence. See LICENCE file for details.
+// </copyright>
+// <author>Christoph Müller</author>
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+
+#include <libpowenetics/powenetics.h>
+#include <libpoweneticssim/simulator.h>
+
+
+/// <summary>
+/// The number of samples the simulator produces per second.
+/// </summary>
+static constexpr double rate = 80000.0;
+
+/// <summary>
+/// The time the library streams from the simulator for each reader.
+/// </summary>
+static constexpr std::chrono::seconds duration(2);
+
+
+/// <summary>
+/// Counts the samples delivered to the callback.
+/// </summary>
+static void on_sample(_In_ const powenetics_handle,
+        _In_ const powenetics_sample *,
+        _In_opt_ void *context) {
+    auto received = static_cast<std::atomic<std::uint64_t> *>(context);
+    ++*received;
+}
+
+
+/// <summary>
+/// Streams from a new simulator using the given reader and checks that the
+/// library did not lose any sample.
+/// </summary>
+/// <remarks>
+/// The simulator does not corrupt its output, so any gap in the sequence
+/// numbers must have been caused by the library, for instance if the reader
+/// reordered the data read from the pseudo-terminal.
+/// </remarks>
+/// <returns><c>true</c> if the check passed, <c>false</c> otherwise.
+/// </returns>
+static bool check(_In_ const powenetics_reader reader,
+        _In_z_ const char *name) {
+    simulator_configuration config;
+    config.rate = rate;
+
+    simulator simulator;
+    {
+        auto hr = simulator.start(config);
+        if (FAILED(hr)) {
+            std::cerr << "Starting the simulator failed with error " << hr
+                << "." << std::endl;
+            return false;
+        }
+    }
+
+    powenetics_handle handle = nullptr;
+    std::atomic<std::uint64_t> received(0);
+    powenetics_statistics statistics;
+    statistics.version = 2;
+
+    auto hr = ::powenetics_open(&handle, simulator.path().c_str(), nullptr);
+    if (SUCCEEDED(hr)) {
+        hr = ::powenetics_set_reader(handle, reader);
+    }
+    if (SUCCEEDED(hr)) {
+        hr = ::powenetics_start_streaming(handle, on_sample, &received);
+    }
+    if (SUCCEEDED(hr)) {
+        std::this_thread::sleep_for(duration);
+        hr = ::powenetics_stop_streaming(handle);
+    }
+    if (SUCCEEDED(hr)) {
+        hr = ::powenetics_get_statistics(handle, &statistics);
+    }
+    if (handle != nullptr) {
+        ::powenetics_close(handle);
+    }
+
+    simulator.stop();
+    const auto produced = simulator.statistics();
+
+    if (FAILED(hr)) {
+        std::cerr << name << ": streaming failed with error " << hr << "."
+            << std::endl;
+        return false;
+    }
+
+    std::cout << name << ": " << received.load() << " samples, "
+        << statistics.sequence_gaps << " gaps, "
+        << statistics.samples_missing << " samples missing, "
+        << statistics.segments_rejected << " segments rejected, "
+        << produced.overruns << " overruns" << std::endl;
+
+    // If the simulator could not write all samples in time, the gaps are not
+    // the fault of the library.
+    if (produced.overruns > 0) {
+        std::cerr << name << ": the simulator could not keep up, so the "
+            "result is inconclusive." << std::endl;
+        return true;
+    }
+
+    return (received.load() > 0)
+        && (statistics.sequence_gaps == 0)
+        && (statistics.samples_missing == 0)
+        && (statistics.segments_rejected == 0);
+}
+
+
+/// <summary>
+/// The entry point of the application.
+/// </summary>
+/// <remarks>
+/// This application streams from the device simulator through a
+/// pseudo-terminal with each of the readers of the library and fails if any
+/// of them loses data. In contrast to the unit tests, which use pipes, it
+/// exercises the way the kernel serves reads from a terminal.
+/// </remarks>
+/// <returns>Zero if all checks passed, one otherwise.</returns>
+int main(void) {
+    try {
+        auto retval = EXIT_SUCCESS;
+
+        if (!::check(powenetics_reader::standard, "standard")) {
+            retval = EXIT_FAILURE;
+        }
+
+        if (!::check(powenetics_reader::io_uring, "io_uring")) {
+            retval = EXIT_FAILURE;
+        }
+
+        return retval;
+
+    } catch (std::exception& ex) {
+        std::cerr << ex.what() << std::endl;
+        return EXIT_FAILURE;
+
+    } catch (...) {
+        std::cerr << "Unexpected exception caught at root level" << std::endl;
+        return EXIT_FAILURE;
+    }
+}
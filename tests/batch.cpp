@@ -0,0 +1,48 @@
+﻿// <copyright file="batch.cpp" company="Visualisierungsinstitut der Universität Stuttgart">
+// Copyright © 2026 Visualisierungsinstitut der Universität Stuttgart.
+// Licensed under the MIT licence. See LICENCE file for details.
+// </copyright>
+// <author>Christoph Müller</author>
+
+#include <CppUnitTest.h>
+
+#include "libpowenetics/batch.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+
+namespace functions {
+
+    /// <summary>
+    /// Test the utility functions for batched delivery of samples.
+    /// </summary>
+    TEST_CLASS(batch) {
+
+        TEST_METHOD(create_default_config) {
+            powenetics_batch_configuration config;
+            ::ZeroMemory(&config, sizeof(config));
+
+            {
+                auto actual = ::powenetics_initialise_batch_configuration(nullptr);
+                Assert::AreEqual(E_POINTER, actual, L"nullptr rejected", LINE_INFO());
+            }
+
+            {
+                auto actual = ::powenetics_initialise_batch_configuration(&config);
+                Assert::AreEqual(E_INVALIDARG, actual, L"Invalid argument if version not set", LINE_INFO());
+            }
+
+            {
+                config.version = 2;
+                config.samples = 42;
+                config.window = 42;
+                auto actual = ::powenetics_initialise_batch_configuration(&config);
+                Assert::AreEqual(S_OK, actual, L"Initialisation succeeded", LINE_INFO());
+                Assert::AreEqual(std::size_t(0), config.samples, L"samples reset", LINE_INFO());
+                Assert::AreEqual(std::uint32_t(0), config.window, L"window reset", LINE_INFO());
+            }
+        }
+
+    };
+
+} /* namespace functions */
@@ -0,0 +1,236 @@
+﻿// <copyright file="capture_parser.cpp" company="Visualisierungsinstitut der Universität Stuttgart">
+// Copyright © 2026 Visualisierungsinstitut der Universität Stuttgart.
+// Licensed under the MIT licence. See LICENCE file for details.
+// </copyright>
+// <author>Christoph Müller</author>
+
+#include <CppUnitTest.h>
+
+#include <random>
+#include <vector>
+
+#include "libpowenetics/capture.h"
+
+#include "capture_parser.h"
+#include "stream_parser_v2.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+
+namespace types {
+
+    /// <summary>
+    /// Test the parallel parser for captures.
+    /// </summary>
+    TEST_CLASS(capture_parser) {
+
+        typedef std::vector<powenetics_raw_sample> sample_list;
+
+        /// <summary>
+        /// Appends all samples to the <see cref="sample_list" /> passed as
+        /// <paramref name="context" />.
+        /// </summary>
+        static void collect(const powenetics_raw_sample *samples,
+                const size_t cnt, void *context) {
+            auto dst = static_cast<sample_list *>(context);
+            dst->insert(dst->end(), samples, samples + cnt);
+        }
+
+        /// <summary>
+        /// A clock that makes the timestamps comparable to the ones from a
+        /// capture.
+        /// </summary>
+        static powenetics_timestamp zero_clock(void) {
+            return 0;
+        }
+
+        /// <summary>
+        /// Appends a segment with the given sequence number and a reading
+        /// derived from it to <paramref name="dst" />.
+        /// </summary>
+        static void append_segment(std::vector<std::uint8_t>& dst,
+                const std::uint16_t sequence_number) {
+            auto& delimiter = responses_v2::segment_delimiter;
+            dst.insert(dst.end(), delimiter.begin(), delimiter.end());
+
+            std::uint8_t buffer[5];
+            ::from_uint16(buffer, sequence_number);
+            dst.insert(dst.end(), buffer, buffer + 2);
+
+            for (int c = 0; c < 13; ++c) {
+                ::from_uint16(buffer, 12000);
+                ::from_uint24(buffer + 2, sequence_number % 5000);
+                dst.insert(dst.end(), buffer, buffer + 5);
+            }
+        }
+
+        /// <summary>
+        /// Creates a capture of <paramref name="cnt" /> segments with sequence
+        /// gaps, garbage, broken segments and delimiters in the payload.
+        /// </summary>
+        static std::vector<std::uint8_t> make_capture(std::mt19937& rng,
+                const std::size_t cnt) {
+            auto& delimiter = responses_v2::segment_delimiter;
+            std::uniform_int_distribution<int> bytes(0, 255);
+            std::uniform_int_distribution<int> percent(0, 99);
+            std::vector<std::uint8_t> retval;
+            std::uint16_t sequence_number = 0;
+
+            for (std::size_t i = 0; i < cnt; ++i) {
+                if (percent(rng) < 3) {
+                    const auto garbage = bytes(rng) % 100;
+                    for (int g = 0; g < garbage; ++g) {
+                        retval.push_back((percent(rng) < 10)
+                            ? delimiter[g % 2]
+                            : static_cast<std::uint8_t>(bytes(rng)));
+                    }
+                }
+
+                sequence_number += (percent(rng) < 2) ? 3 : 1;
+                append_segment(retval, sequence_number);
+
+                if (percent(rng) < 5) {
+                    // Fake delimiter in the payload.
+                    const auto at = retval.size() - 1 - bytes(rng) % 60;
+                    retval[at - 1] = delimiter.front();
+                    retval[at] = delimiter.back();
+                }
+
+                if (percent(rng) < 1) {
+                    // Truncated segment.
+                    retval.resize(retval.size() - 1 - bytes(rng) % 60);
+                }
+            }
+
+            retval.insert(retval.end(), delimiter.begin(), delimiter.end());
+            return retval;
+        }
+
+        /// <summary>
+        /// Parses <paramref name="capture" /> sequentially.
+        /// </summary>
+        static sample_list parse_sequentially(
+                const std::vector<std::uint8_t>& capture) {
+            sample_list retval;
+            stream_parser_v2 parser;
+            parser.clock(zero_clock);
+            parser.push_back<powenetics_raw_sample>(capture.data(),
+                    capture.size(), [&retval](const powenetics_raw_sample& s) {
+                retval.push_back(s);
+            });
+            return retval;
+        }
+
+        TEST_METHOD(same_as_stream_parser) {
+            std::mt19937 rng(20260402);
+            const auto capture = make_capture(rng, 5000);
+            const auto expected = parse_sequentially(capture);
+            Assert::IsTrue(expected.size() > 4500, L"Most segments parsed");
+
+            for (std::size_t chunk_size : { 69, 70, 137, 1000, 65536 }) {
+                for (std::size_t threads : { 1, 2, 3, 8 }) {
+                    ::capture_parser parser(capture.data(), capture.size(),
+                        threads, chunk_size);
+                    Assert::AreEqual(chunk_size, parser.chunk_size(),
+                        L"Chunk size honoured");
+
+                    sample_list actual;
+                    parser.parse(collect, &actual);
+
+                    Assert::AreEqual(expected.size(), actual.size(),
+                        L"# of samples");
+                    for (std::size_t i = 0; i < expected.size(); ++i) {
+                        Assert::AreEqual(expected[i].sequence_number,
+                            actual[i].sequence_number, L"sequence_number");
+                        Assert::AreEqual(expected[i].index, actual[i].index,
+                            L"index");
+                        Assert::AreEqual(expected[i].missing,
+                            actual[i].missing, L"missing");
+                        Assert::AreEqual(expected[i].timestamp,
+                            actual[i].timestamp, L"timestamp");
+                        Assert::AreEqual(expected[i].atx_12v.current,
+                            actual[i].atx_12v.current, L"atx_12v");
+                    }
+                }
+            }
+        }
+
+        TEST_METHOD(delimiter_at_boundary) {
+            auto& delimiter = responses_v2::segment_delimiter;
+            std::vector<std::uint8_t> capture;
+            for (std::uint16_t i = 1; i <= 8; ++i) {
+                append_segment(capture, i);
+            }
+            capture.insert(capture.end(), delimiter.begin(), delimiter.end());
+
+            // Put a delimiter into the payload of the second segment right at
+            // the begin of the second chunk, such that the second worker
+            // synchronises on the wrong position.
+            const std::size_t chunk_size = 100;
+            capture[chunk_size] = delimiter.front();
+            capture[chunk_size + 1] = delimiter.back();
+            const auto expected = parse_sequentially(capture);
+            Assert::AreEqual(std::size_t(8), expected.size(),
+                L"Fake delimiter ignored by sequential parser");
+
+            ::capture_parser parser(capture.data(), capture.size(), 2,
+                chunk_size);
+            sample_list actual;
+            parser.parse(collect, &actual);
+
+            Assert::AreEqual(expected.size(), actual.size(), L"# of samples");
+            for (std::size_t i = 0; i < expected.size(); ++i) {
+                Assert::AreEqual(expected[i].sequence_number,
+                    actual[i].sequence_number, L"sequence_number");
+                Assert::AreEqual(expected[i].index, actual[i].index,
+                    L"index");
+            }
+        }
+
+        TEST_METHOD(automatic_chunk_size) {
+            std::vector<std::uint8_t> capture(1000);
+            ::capture_parser small(capture.data(), capture.size(), 4);
+            Assert::AreEqual(std::size_t(4), small.threads(), L"threads");
+            Assert::AreEqual(std::size_t(64 * 1024), small.chunk_size(),
+                L"Small captures are not split into tiny chunks");
+
+            ::capture_parser huge(capture.data(), std::size_t(1) << 32, 2);
+            Assert::AreEqual(::capture_parser::default_chunk_size,
+                huge.chunk_size(), L"Huge captures are not held in memory");
+
+            ::capture_parser tiny(capture.data(), capture.size(), 1, 1);
+            Assert::AreEqual(::capture_parser::segment_stride,
+                tiny.chunk_size(), L"Chunk holds at least one segment");
+
+            ::capture_parser all(capture.data(), capture.size());
+            Assert::IsTrue(all.threads() > 0, L"Threads selected");
+        }
+
+        TEST_METHOD(api) {
+            sample_list samples;
+            std::vector<std::uint8_t> capture;
+            append_segment(capture, 1);
+            append_segment(capture, 2);
+            append_segment(capture, 3);
+
+            Assert::AreEqual(E_POINTER, ::powenetics_parse_capture(nullptr,
+                capture.size(), collect, &samples, 0), L"nullptr data");
+            Assert::AreEqual(E_POINTER, ::powenetics_parse_capture(
+                capture.data(), capture.size(), nullptr, &samples, 0),
+                L"nullptr callback");
+
+            Assert::AreEqual(S_OK, ::powenetics_parse_capture(nullptr, 0,
+                collect, &samples, 0), L"Empty capture");
+            Assert::IsTrue(samples.empty(), L"Nothing in empty capture");
+
+            Assert::AreEqual(S_OK, ::powenetics_parse_capture(capture.data(),
+                capture.size(), collect, &samples, 0), L"Capture parsed");
+            Assert::AreEqual(std::size_t(2), samples.size(),
+                L"Last segment has no delimiter");
+            Assert::AreEqual(std::uint16_t(1), samples.front().sequence_number,
+                L"sequence_number");
+            Assert::AreEqual(powenetics_timestamp(0),
+                samples.front().timestamp, L"No timestamps in capture");
+        }
+    };
+}
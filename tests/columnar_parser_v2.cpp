@@ -0,0 +1,210 @@
+﻿// <copyright file="columnar_parser_v2.cpp" company="Visualisierungsinstitut der Universität Stuttgart">
+// Copyright © 2026 Visualisierungsinstitut der Universität Stuttgart.
+// Licensed under the MIT licence. See LICENCE file for details.
+// </copyright>
+// <author>Christoph Müller</author>
+
+#include <CppUnitTest.h>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "columnar_parser_v2.h"
+#include "stream_parser.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+
+static_assert(is_stream_parser<stream_parser_v2>::value,
+    "stream_parser_v2 satisfies the parser concept.");
+static_assert(is_stream_parser<columnar_parser_v2>::value,
+    "columnar_parser_v2 satisfies the parser concept.");
+static_assert(!is_stream_parser<timestamp_estimator>::value,
+    "timestamp_estimator does not satisfy the parser concept.");
+
+
+namespace types {
+
+    /// <summary>
+    /// Test the parser decoding runs of segments into columns.
+    /// </summary>
+    TEST_CLASS(columnar_parser_v2) {
+
+        /// <summary>
+        /// A clock that makes the timestamps of both parsers comparable.
+        /// </summary>
+        static powenetics_timestamp fixed_clock(void) {
+            return 42;
+        }
+
+        /// <summary>
+        /// Creates a stream of <paramref name="cnt" /> segments with random
+        /// readings, sequence gaps, garbage and broken segments.
+        /// </summary>
+        static std::vector<std::uint8_t> make_stream(std::mt19937& rng,
+                const std::size_t cnt) {
+            auto& delimiter = responses_v2::segment_delimiter;
+            std::uniform_int_distribution<int> bytes(0, 255);
+            std::uniform_int_distribution<int> percent(0, 99);
+            std::uniform_int_distribution<int> voltages(0, 13000);
+            std::vector<std::uint8_t> retval;
+            std::uint16_t sequence_number = 0;
+
+            for (std::size_t i = 0; i < cnt; ++i) {
+                if (percent(rng) < 2) {
+                    // Garbage between segments.
+                    const auto garbage = bytes(rng) % 100;
+                    for (int g = 0; g < garbage; ++g) {
+                        retval.push_back(static_cast<std::uint8_t>(bytes(rng)));
+                    }
+                }
+
+                retval.insert(retval.end(), delimiter.begin(), delimiter.end());
+
+                sequence_number += (percent(rng) < 2) ? 3 : 1;
+                std::uint8_t buffer[5];
+                ::from_uint16(buffer, sequence_number);
+                retval.insert(retval.end(), buffer, buffer + 2);
+
+                // Truncate some of the segments.
+                const auto channels = (percent(rng) < 1) ? 7 : 13;
+                for (int c = 0; c < channels; ++c) {
+                    ::from_uint16(buffer, static_cast<std::uint16_t>(
+                        voltages(rng)));
+                    ::from_uint24(buffer + 2, static_cast<std::uint32_t>(
+                        rng() & 0xFFFFFF));
+                    retval.insert(retval.end(), buffer, buffer + 5);
+                }
+            }
+
+            retval.insert(retval.end(), delimiter.begin(), delimiter.end());
+            return retval;
+        }
+
+        /// <summary>
+        /// Feeds <paramref name="stream" /> in random chunks to a new parser
+        /// of type <typeparamref name="TParser" />.
+        /// </summary>
+        template<class TParser>
+        static std::vector<powenetics_raw_sample> parse(
+                const std::vector<std::uint8_t>& stream,
+                const std::uint32_t seed,
+                typename TParser::statistics_type& statistics) {
+            std::mt19937 rng(seed);
+            std::uniform_int_distribution<std::size_t> chunks(1, 1024);
+            std::vector<powenetics_raw_sample> retval;
+            TParser parser;
+            parser.clock(fixed_clock);
+
+            for (std::size_t i = 0; i < stream.size();) {
+                const auto cnt = (std::min)(chunks(rng), stream.size() - i);
+                parser.template push_back<powenetics_raw_sample>(
+                        stream.data() + i, cnt,
+                        [&retval](const powenetics_raw_sample& s) {
+                    retval.push_back(s);
+                });
+                i += cnt;
+            }
+
+            statistics = parser.collect_statistics();
+            return retval;
+        }
+
+        static void assert_equal(const powenetics_raw_voltage_current& expected,
+                const powenetics_raw_voltage_current& actual) {
+            Assert::AreEqual(expected.voltage, actual.voltage, L"voltage");
+            Assert::AreEqual(expected.current, actual.current, L"current");
+        }
+
+        TEST_METHOD(same_as_stream_parser) {
+            std::mt19937 rng(20260313);
+            const auto stream = make_stream(rng, 5000);
+
+            stream_parser_v2::statistics_type es, as;
+            const auto expected = parse<::stream_parser_v2>(stream, 1, es);
+            const auto actual = parse<::columnar_parser_v2>(stream, 1, as);
+
+            Assert::IsTrue(expected.size() > 4500, L"Most segments parsed");
+            Assert::AreEqual(expected.size(), actual.size(), L"# of samples");
+
+            for (std::size_t i = 0; i < expected.size(); ++i) {
+                auto& e = expected[i];
+                auto& a = actual[i];
+                Assert::AreEqual(e.version, a.version, L"version");
+                Assert::AreEqual(e.sequence_number, a.sequence_number,
+                    L"sequence_number");
+                Assert::AreEqual(e.index, a.index, L"index");
+                Assert::AreEqual(e.missing, a.missing, L"missing");
+                Assert::AreEqual(e.timestamp, a.timestamp, L"timestamp");
+                assert_equal(e.atx_12v, a.atx_12v);
+                assert_equal(e.atx_3_3v, a.atx_3_3v);
+                assert_equal(e.atx_5v, a.atx_5v);
+                assert_equal(e.atx_stb, a.atx_stb);
+                assert_equal(e.eps1, a.eps1);
+                assert_equal(e.eps2, a.eps2);
+                assert_equal(e.eps3, a.eps3);
+                assert_equal(e.pcie_12v1, a.pcie_12v1);
+                assert_equal(e.pcie_12v2, a.pcie_12v2);
+                assert_equal(e.pcie_12v3, a.pcie_12v3);
+                assert_equal(e.peg_12v, a.peg_12v);
+                assert_equal(e.peg_3_3v, a.peg_3_3v);
+            }
+
+            Assert::AreEqual(es.segments_parsed, as.segments_parsed,
+                L"segments_parsed");
+            Assert::AreEqual(es.segments_rejected, as.segments_rejected,
+                L"segments_rejected");
+            Assert::AreEqual(es.bytes_discarded, as.bytes_discarded,
+                L"bytes_discarded");
+            Assert::AreEqual(es.carry_overs, as.carry_overs, L"carry_overs");
+            Assert::AreEqual(es.sequence_gaps, as.sequence_gaps,
+                L"sequence_gaps");
+            Assert::AreEqual(es.samples_missing, as.samples_missing,
+                L"samples_missing");
+        }
+
+        TEST_METHOD(connector_profile) {
+            auto& delimiter = responses_v2::segment_delimiter;
+            std::vector<std::uint8_t> stream;
+
+            for (std::uint16_t i = 0; i < 4; ++i) {
+                stream.insert(stream.end(), delimiter.begin(), delimiter.end());
+                std::uint8_t buffer[5];
+                ::from_uint16(buffer, i);
+                stream.insert(stream.end(), buffer, buffer + 2);
+
+                for (int c = 0; c < 13; ++c) {
+                    // 10-pin connector without any PCIe power.
+                    const auto supplied = (c != 0) && (c != 8) && (c != 9)
+                        && (c != 12);
+                    const auto voltage = (c == 1) ? 5000 : 12000;
+                    ::from_uint16(buffer, supplied ? voltage : 0);
+                    ::from_uint24(buffer + 2, 1000);
+                    stream.insert(stream.end(), buffer, buffer + 5);
+                }
+            }
+            stream.insert(stream.end(), delimiter.begin(), delimiter.end());
+
+            ::columnar_parser_v2 parser;
+            Assert::AreEqual(int(connector_profile_unknown),
+                int(parser.profile()), L"Profile unknown initially");
+
+            std::size_t cnt = 0;
+            parser.push_back<powenetics_raw_sample>(stream.data(),
+                    stream.size(), [&cnt](const powenetics_raw_sample& s) {
+                Assert::AreEqual(std::uint32_t(0), s.atx_3_3v.current,
+                    L"No 3.3V on 10-pin");
+                Assert::AreEqual(std::uint16_t(12000), s.atx_stb.voltage,
+                    L"Standby from channel 6");
+                Assert::AreEqual(std::uint32_t(0), s.pcie_12v1.current,
+                    L"No PCIe");
+                ++cnt;
+            });
+
+            Assert::AreEqual(std::size_t(4), cnt, L"All segments parsed");
+            Assert::AreEqual(int(connector_profile_atx_10pin),
+                int(parser.profile()), L"10-pin profile detected");
+        }
+    };
+}
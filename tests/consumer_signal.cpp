@@ -0,0 +1,80 @@
+﻿// <copyright file="consumer_signal.cpp" company="Visualisierungsinstitut der Universität Stuttgart">
+// Copyright © 2026 Visualisierungsinstitut der Universität Stuttgart.
+// Licensed under the MIT licence. See LICENCE file for details.
+// </copyright>
+// <author>Christoph Müller</author>
+
+#include <CppUnitTest.h>
+
+#include <thread>
+
+#include "consumer_signal.h"
+#include "spsc_queue.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+
+namespace types {
+
+    /// <summary>
+    /// Test the signal that lets the consumer of a queue sleep while the
+    /// queue is empty.
+    /// </summary>
+    TEST_CLASS(consumer_signal) {
+
+        TEST_METHOD(timeout) {
+            ::consumer_signal signal;
+            ::spsc_queue<int> queue(4);
+
+            auto actual = signal.wait(std::chrono::milliseconds(10), [&queue](void) {
+                return !queue.empty();
+            });
+            Assert::IsFalse(actual, L"Timeout expired", LINE_INFO());
+
+            // Notifying without a waiting consumer must not block.
+            signal.notify();
+
+            queue.push(42);
+            actual = signal.wait(std::chrono::milliseconds(10000), [&queue](void) {
+                return !queue.empty();
+            });
+            Assert::IsTrue(actual, L"No wait if satisfied", LINE_INFO());
+        }
+
+        TEST_METHOD(ping_pong) {
+            ::consumer_signal signal;
+            ::spsc_queue<int> queue(4);
+            const int total = 10000;
+
+            std::thread producer([&signal, &queue, total](void) {
+                for (int i = 0; i < total; ) {
+                    if (queue.push(i)) {
+                        signal.notify();
+                        ++i;
+                    } else {
+                        std::this_thread::yield();
+                    }
+                }
+            });
+
+            // If a notification were lost, the consumer would run into the
+            // timeout, which we detect.
+            int expected = 0;
+            auto lost = 0;
+            while (expected < total) {
+                int value;
+                if (queue.pop(&value, 1) == 1) {
+                    Assert::AreEqual(expected++, value, L"In order", LINE_INFO());
+                } else if (!signal.wait(std::chrono::milliseconds(5000),
+                        [&queue](void) { return !queue.empty(); })) {
+                    ++lost;
+                }
+            }
+
+            producer.join();
+            Assert::AreEqual(0, lost, L"No notification lost", LINE_INFO());
+        }
+
+    };
+
+} /* namespace types */
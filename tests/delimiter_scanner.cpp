@@ -0,0 +1,86 @@
+﻿// <copyright file="delimiter_scanner.cpp" company="Visualisierungsinstitut der Universität Stuttgart">
+// Copyright © 2026 Visualisierungsinstitut der Universität Stuttgart.
+// Licensed under the MIT licence. See LICENCE file for details.
+// </copyright>
+// <author>Christoph Müller</author>
+
+#include <CppUnitTest.h>
+
+#include <vector>
+
+#include "delimiter_scanner.h"
+#include "responses.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+
+namespace functions {
+
+    /// <summary>
+    /// Test the implementations of the search for the segment delimiter.
+    /// </summary>
+    TEST_CLASS(delimiter_scanner) {
+
+        /// <summary>
+        /// Checks that <paramref name="scanner" /> finds the delimiter at every
+        /// position of buffers of various lengths, including the case of a
+        /// partial delimiter at the very end.
+        /// </summary>
+        static void check(const ::delimiter_scanner scanner) {
+            auto& delimiter = responses_v2::segment_delimiter;
+
+            for (std::size_t len = 0; len < 100; ++len) {
+                std::vector<std::uint8_t> data(len, delimiter.front());
+                Assert::IsNull(scanner(data.data(), data.size()), L"Only first half of delimiter", LINE_INFO());
+
+                for (std::size_t pos = 0; pos + 1 < len; ++pos) {
+                    std::vector<std::uint8_t> data(len, 0x42);
+                    data[pos] = delimiter.front();
+                    data[pos + 1] = delimiter.back();
+
+                    // Place a second delimiter behind the first one to make
+                    // sure that we find the first one.
+                    if (pos + 3 < len) {
+                        data[pos + 2] = delimiter.front();
+                        data[pos + 3] = delimiter.back();
+                    }
+
+                    auto actual = scanner(data.data(), data.size());
+                    Assert::IsTrue(data.data() + pos == actual, L"Delimiter found", LINE_INFO());
+                }
+
+                if (len > 0) {
+                    std::vector<std::uint8_t> data(len, delimiter.back());
+                    data.back() = delimiter.front();
+                    Assert::IsNull(scanner(data.data(), data.size()), L"Partial delimiter at end", LINE_INFO());
+                }
+            }
+        }
+
+        TEST_METHOD(scalar) {
+            check(::find_delimiter_scalar);
+        }
+
+        TEST_METHOD(sse2) {
+#if defined(POWENETICS_X86)
+            if (::has_cpu_feature(cpu_feature::sse2)) {
+                check(::find_delimiter_sse2);
+            }
+#endif /* defined(POWENETICS_X86) */
+        }
+
+        TEST_METHOD(avx2) {
+#if defined(POWENETICS_X86)
+            if (::has_cpu_feature(cpu_feature::avx2)) {
+                check(::find_delimiter_avx2);
+            }
+#endif /* defined(POWENETICS_X86) */
+        }
+
+        TEST_METHOD(dispatch) {
+            check(::select_delimiter_scanner());
+        }
+
+    };
+
+} /* namespace functions */
@@ -0,0 +1,54 @@
+﻿// <copyright file="dispatch.cpp" company="Visualisierungsinstitut der Universität Stuttgart">
+// Copyright © 2026 Visualisierungsinstitut der Universität Stuttgart.
+// Licensed under the MIT licence. See LICENCE file for details.
+// </copyright>
+// <author>Christoph Müller</author>
+
+#include <CppUnitTest.h>
+
+#include "libpowenetics/powenetics.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+
+namespace functions {
+
+    /// <summary>
+    /// Test the utility functions for invoking the callbacks on a dispatch
+    /// thread.
+    /// </summary>
+    TEST_CLASS(dispatch) {
+
+        TEST_METHOD(create_default_config) {
+            powenetics_dispatch_configuration config;
+            ::ZeroMemory(&config, sizeof(config));
+
+            {
+                auto actual = ::powenetics_initialise_dispatch_configuration(nullptr);
+                Assert::AreEqual(E_POINTER, actual, L"nullptr rejected", LINE_INFO());
+            }
+
+            {
+                auto actual = ::powenetics_initialise_dispatch_configuration(&config);
+                Assert::AreEqual(E_INVALIDARG, actual, L"Invalid argument if version not set", LINE_INFO());
+            }
+
+            {
+                config.version = 2;
+                config.dispatch = powenetics_dispatch::asynchronous;
+                auto actual = ::powenetics_initialise_dispatch_configuration(&config);
+                Assert::AreEqual(S_OK, actual, L"Initialisation succeeded", LINE_INFO());
+                Assert::IsTrue(config.dispatch == powenetics_dispatch::synchronous, L"dispatch reset", LINE_INFO());
+                Assert::IsTrue(config.capacity > 0, L"capacity set", LINE_INFO());
+                Assert::IsTrue(config.overflow == powenetics_overflow::drop_newest, L"overflow set", LINE_INFO());
+            }
+
+            {
+                auto actual = ::powenetics_set_dispatch(nullptr, &config);
+                Assert::AreEqual(E_HANDLE, actual, L"nullptr handle rejected", LINE_INFO());
+            }
+        }
+
+    };
+
+} /* namespace functions */
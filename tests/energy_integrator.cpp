@@ -0,0 +1,244 @@
+﻿// <copyright file="energy_integrator.cpp" company="Visualisierungsinstitut der Universität Stuttgart">
+// Copyright © 2026 Visualisierungsinstitut der Universität Stuttgart.
+// Licensed under the MIT licence. See LICENCE file for details.
+// </copyright>
+// <author>Christoph Müller</author>
+
+#include <CppUnitTest.h>
+
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "libpowenetics/powenetics.h"
+
+#include "columnar_parser_v2.h"
+#include "energy_integrator.h"
+#include "resumable_parser_v2.h"
+#include "stream_parser_v2.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+
+namespace types {
+
+    /// <summary>
+    /// Test the fixed-point integration of the energy.
+    /// </summary>
+    TEST_CLASS(energy_integrator) {
+
+        /// <summary>
+        /// A clock that advances by 1 ms each time it is read.
+        /// </summary>
+        static powenetics_timestamp ticking_clock(void) {
+            static powenetics_timestamp now = 0;
+            return now += 10000;
+        }
+
+        /// <summary>
+        /// Creates a sample with the given timestamp and all rails reading
+        /// <paramref name="voltage" /> and <paramref name="current" />.
+        /// </summary>
+        static powenetics_raw_sample make_sample(
+                const powenetics_timestamp timestamp,
+                const std::uint16_t voltage,
+                const std::uint32_t current) {
+            powenetics_raw_sample retval;
+            ::memset(&retval, 0, sizeof(retval));
+            retval.version = 2;
+            retval.timestamp = timestamp;
+
+            for (auto r : { &retval.atx_12v, &retval.atx_3_3v,
+                    &retval.atx_5v, &retval.atx_stb, &retval.eps1,
+                    &retval.eps2, &retval.eps3, &retval.pcie_12v1,
+                    &retval.pcie_12v2, &retval.pcie_12v3, &retval.peg_12v,
+                    &retval.peg_3_3v }) {
+                r->voltage = voltage;
+                r->current = current;
+            }
+
+            return retval;
+        }
+
+        /// <summary>
+        /// Answer the energy of <paramref name="integrator" /> for timestamps
+        /// in units of 100ns.
+        /// </summary>
+        static powenetics_energy to_energy(
+                const ::energy_integrator& integrator) {
+            powenetics_energy retval;
+            retval.version = 2;
+            integrator.energy(retval, 10000000);
+            return retval;
+        }
+
+        /// <summary>
+        /// Integrates a random stream with <typeparamref name="TParser" />
+        /// delivering <typeparamref name="TSample" />.
+        /// </summary>
+        template<class TParser, class TSample>
+        static ::energy_integrator integrate(
+                const std::vector<std::uint8_t>& stream) {
+            const std::size_t chunk = 1000;
+            TParser parser;
+            parser.clock(ticking_clock);
+
+            for (std::size_t i = 0; i < stream.size(); i += chunk) {
+                parser.template push_back<TSample>(stream.data() + i,
+                    (std::min)(chunk, stream.size() - i),
+                    [](const TSample&) { });
+            }
+
+            return parser.energy();
+        }
+
+        TEST_METHOD(multiply_add) {
+            ::energy_integrator::accumulator_type a = { 0, 0 };
+            ::energy_integrator::multiply_add(a, 1ull << 32, 1ull << 32);
+            Assert::AreEqual(std::uint64_t(0), a.low, L"2^64 low");
+            Assert::AreEqual(std::uint64_t(1), a.high, L"2^64 high");
+
+            a = { 0, 0 };
+            ::energy_integrator::multiply_add(a, ~0ull, ~0ull);
+            Assert::AreEqual(std::uint64_t(1), a.low, L"(2^64 - 1)^2 low");
+            Assert::AreEqual(~0ull - 1, a.high, L"(2^64 - 1)^2 high");
+
+            a = { ~0ull, 0 };
+            ::energy_integrator::multiply_add(a, 1, 1);
+            Assert::AreEqual(std::uint64_t(0), a.low, L"Carry low");
+            Assert::AreEqual(std::uint64_t(1), a.high, L"Carry high");
+        }
+
+        TEST_METHOD(constant_power) {
+            ::energy_integrator integrator;
+            const std::size_t cnt = 1001;
+
+            for (std::size_t i = 0; i < cnt; ++i) {
+                // 12V at 1A for 1 ms.
+                integrator.integrate(make_sample(10000 * i, 12000, 1000));
+            }
+
+            const auto energy = to_energy(integrator);
+            Assert::AreEqual(std::uint64_t(cnt), energy.samples, L"samples");
+            Assert::AreEqual(1.0, energy.duration, L"duration");
+            Assert::AreEqual(12.0, energy.atx_12v, L"atx_12v");
+            Assert::AreEqual(12.0, energy.peg_3_3v, L"peg_3_3v");
+            Assert::AreEqual(12.0 * 12.0, energy.total, L"total");
+        }
+
+        TEST_METHOD(trapezoid) {
+            ::energy_integrator integrator;
+            integrator.integrate(make_sample(0, 12000, 0));
+            // The interval of 1 s is too long for 64-bit products.
+            integrator.integrate(make_sample(10000000, 12000, 2000));
+
+            const auto energy = to_energy(integrator);
+            Assert::AreEqual(12.0, energy.eps1, L"Ramp from 0W to 24W");
+            Assert::AreEqual(1.0, energy.duration, L"duration");
+        }
+
+        TEST_METHOD(no_overflow) {
+            ::energy_integrator integrator;
+            // Maximum readings for a day, which overflows 64 bits.
+            const powenetics_timestamp day = 24LL * 60 * 60 * 10000000;
+            integrator.integrate(make_sample(0, 0xFFFF, 0xFFFFFF));
+            integrator.integrate(make_sample(day, 0xFFFF, 0xFFFFFF));
+
+            Assert::AreNotEqual(std::uint64_t(0),
+                integrator.accumulator(0).high, L"Sum exceeds 64 bits");
+
+            const auto expected = 65.535 * 16777.215 * 24 * 60 * 60;
+            const auto energy = to_energy(integrator);
+            Assert::AreEqual(expected, energy.atx_12v, expected * 1e-12,
+                L"atx_12v");
+            Assert::AreEqual(12 * expected, energy.total, expected * 1e-11,
+                L"total");
+        }
+
+        TEST_METHOD(non_monotonic) {
+            ::energy_integrator integrator;
+            integrator.integrate(make_sample(10000, 12000, 1000));
+            integrator.integrate(make_sample(5000, 12000, 1000));
+            integrator.integrate(make_sample(15000, 12000, 1000));
+
+            const auto energy = to_energy(integrator);
+            Assert::AreEqual(std::uint64_t(3), energy.samples, L"samples");
+            Assert::AreEqual(0.001, energy.duration, L"duration");
+            Assert::AreEqual(0.012, energy.atx_5v, 1e-15,
+                L"Interval backwards skipped");
+
+            integrator.reset();
+            Assert::AreEqual(std::uint64_t(0), integrator.samples(),
+                L"reset");
+            Assert::AreEqual(std::uint64_t(0), integrator.accumulator(2).low,
+                L"reset");
+        }
+
+        TEST_METHOD(same_for_all_parsers) {
+            auto& delimiter = responses_v2::segment_delimiter;
+            std::mt19937 rng(20260517);
+            std::uniform_int_distribution<int> voltages(0, 13000);
+            std::uniform_int_distribution<int> currents(0, 0xFFFFFF);
+            std::vector<std::uint8_t> stream;
+
+            for (std::uint16_t i = 0; i < 2000; ++i) {
+                stream.insert(stream.end(), delimiter.begin(),
+                    delimiter.end());
+
+                std::uint8_t buffer[5];
+                ::from_uint16(buffer, i);
+                stream.insert(stream.end(), buffer, buffer + 2);
+
+                for (int c = 0; c < 13; ++c) {
+                    ::from_uint16(buffer, static_cast<std::uint16_t>(
+                        voltages(rng)));
+                    ::from_uint24(buffer + 2, currents(rng));
+                    stream.insert(stream.end(), buffer, buffer + 5);
+                }
+            }
+            stream.insert(stream.end(), delimiter.begin(), delimiter.end());
+
+            const ::energy_integrator actual[] = {
+                integrate<::stream_parser_v2, powenetics_raw_sample>(stream),
+                integrate<::stream_parser_v2, powenetics_sample>(stream),
+                integrate<::columnar_parser_v2, powenetics_raw_sample>(stream),
+                integrate<::columnar_parser_v2, powenetics_sample>(stream),
+                integrate<::resumable_parser_v2, powenetics_raw_sample>(stream),
+                integrate<::resumable_parser_v2, powenetics_sample>(stream)
+            };
+
+            auto& expected = actual[0];
+            Assert::AreEqual(std::uint64_t(2000), expected.samples(),
+                L"All samples integrated");
+            Assert::AreNotEqual(std::uint64_t(0), expected.accumulator(0).low,
+                L"Energy integrated");
+
+            for (auto& a : actual) {
+                Assert::AreEqual(expected.samples(), a.samples(), L"samples");
+                Assert::AreEqual(expected.duration(), a.duration(),
+                    L"duration");
+                for (std::size_t r = 0; r < ::energy_integrator::rails; ++r) {
+                    Assert::AreEqual(expected.accumulator(r).low,
+                        a.accumulator(r).low, L"low");
+                    Assert::AreEqual(expected.accumulator(r).high,
+                        a.accumulator(r).high, L"high");
+                }
+            }
+
+            {
+                ::stream_parser_v2 parser;
+                parser.push_back<powenetics_segment>(stream.data(),
+                    stream.size(), [](const powenetics_segment&) { });
+                Assert::AreEqual(std::uint64_t(0), parser.energy().samples(),
+                    L"Segments are not integrated");
+            }
+        }
+
+        TEST_METHOD(api) {
+            powenetics_energy energy;
+            energy.version = 2;
+            Assert::AreEqual(E_HANDLE, ::powenetics_get_energy(nullptr,
+                &energy), L"nullptr handle");
+        }
+    };
+}
@@ -0,0 +1,324 @@
+﻿// <copyright file="overflow_queue.cpp" company="Visualisierungsinstitut der Universität Stuttgart">
+// Copyright © 2026 Visualisierungsinstitut der Universität Stuttgart.
+// Licensed under the MIT licence. See LICENCE file for details.
+// </copyright>
+// <author>Christoph Müller</author>
+
+#include <CppUnitTest.h>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "dispatch_event.h"
+#include "overflow_queue.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+
+namespace types {
+
+    /// <summary>
+    /// Test the policies applied if the consumer of the samples falls behind.
+    /// </summary>
+    TEST_CLASS(overflow_queue) {
+
+        static powenetics_sample make_sample(const std::uint64_t index) {
+            powenetics_sample retval;
+            ::ZeroMemory(&retval, sizeof(retval));
+            retval.version = 2;
+            retval.index = index;
+            return retval;
+        }
+
+        static bool never(void) {
+            return false;
+        }
+
+        TEST_METHOD(drop_newest) {
+            consumer_signal signal;
+            ::overflow_queue<powenetics_sample> queue(4, powenetics_overflow::drop_newest, signal);
+            powenetics_sample dst[8];
+            std::uint64_t dropped = 0;
+
+            Assert::AreEqual(std::size_t(4), queue.capacity(), L"Capacity", LINE_INFO());
+
+            for (std::uint64_t i = 0; i < 4; ++i) {
+                Assert::IsTrue(queue.push(make_sample(i), never), L"Push succeeds", LINE_INFO());
+            }
+            Assert::IsFalse(queue.push(make_sample(4), never), L"Newest dropped", LINE_INFO());
+            Assert::IsFalse(queue.push(make_sample(5), never), L"Newest dropped", LINE_INFO());
+
+            Assert::AreEqual(std::size_t(4), queue.pop(dst, 8, dropped), L"Pop oldest", LINE_INFO());
+            Assert::AreEqual(std::uint64_t(0), dropped, L"Consumer drops nothing", LINE_INFO());
+            Assert::AreEqual(std::uint64_t(3), dst[3].index, L"Last retained", LINE_INFO());
+            Assert::AreEqual(std::uint32_t(0), dst[3].dropped, L"Not marked", LINE_INFO());
+
+            Assert::IsTrue(queue.push(make_sample(6), never), L"Room after pop", LINE_INFO());
+            Assert::AreEqual(std::size_t(1), queue.pop(dst, 8, dropped), L"Pop new", LINE_INFO());
+            Assert::AreEqual(std::uint64_t(6), dst[0].index, L"Index after gap", LINE_INFO());
+            Assert::AreEqual(std::uint32_t(2), dst[0].dropped, L"Gap marked", LINE_INFO());
+        }
+
+        TEST_METHOD(drop_oldest) {
+            consumer_signal signal;
+            ::overflow_queue<powenetics_sample> queue(4, powenetics_overflow::drop_oldest, signal);
+            powenetics_sample dst[8];
+            std::uint64_t dropped = 0;
+
+            Assert::AreEqual(std::size_t(4), queue.capacity(), L"Capacity", LINE_INFO());
+
+            for (std::uint64_t i = 0; i < 10; ++i) {
+                Assert::IsTrue(queue.push(make_sample(i), never), L"Push succeeds", LINE_INFO());
+            }
+            Assert::AreEqual(std::size_t(4), queue.size(), L"Capacity not exceeded", LINE_INFO());
+
+            Assert::AreEqual(std::size_t(4), queue.pop(dst, 8, dropped), L"Only capacity returned", LINE_INFO());
+            Assert::AreEqual(std::uint64_t(6), dropped, L"Oldest dropped", LINE_INFO());
+            for (std::size_t i = 0; i < 4; ++i) {
+                Assert::AreEqual(std::uint64_t(i + 6), dst[i].index, L"Newest retained", LINE_INFO());
+            }
+            Assert::AreEqual(std::uint32_t(6), dst[0].dropped, L"Gap marked", LINE_INFO());
+            Assert::AreEqual(std::uint32_t(0), dst[1].dropped, L"Marked once", LINE_INFO());
+
+            Assert::IsTrue(queue.push(make_sample(10), never), L"Room after pop", LINE_INFO());
+            Assert::AreEqual(std::size_t(1), queue.pop(dst, 1, dropped), L"Pop new", LINE_INFO());
+            Assert::AreEqual(std::uint64_t(0), dropped, L"Nothing dropped since", LINE_INFO());
+            Assert::AreEqual(std::uint32_t(0), dst[0].dropped, L"No gap", LINE_INFO());
+        }
+
+        static dispatch_event make_event(const std::uint64_t index) {
+            dispatch_event retval;
+            retval.kind = dispatch_kind::sample;
+            retval.follows_end_of_batch = false;
+            retval.sample = make_sample(index);
+            return retval;
+        }
+
+        static dispatch_event make_end_of_batch(void) {
+            dispatch_event retval;
+            ::ZeroMemory(&retval, sizeof(retval));
+            retval.kind = dispatch_kind::end_of_batch;
+            return retval;
+        }
+
+        TEST_METHOD(drop_oldest_carries_end_of_batch) {
+            consumer_signal signal;
+            ::overflow_queue<dispatch_event> queue(2, powenetics_overflow::drop_oldest, signal);
+            dispatch_event dst[4];
+            std::uint64_t dropped = 0;
+
+            queue.push(make_event(0), never);
+            queue.push(make_end_of_batch(), never);
+            queue.push(make_event(1), never);
+            queue.push(make_event(2), never);
+
+            // Sample 0 and the end of the batch are evicted, and sample 1
+            // carries the latter.
+            Assert::AreEqual(std::size_t(2), queue.pop(dst, 4, dropped), L"Newest retained", LINE_INFO());
+            Assert::AreEqual(std::uint64_t(1), dropped, L"Only samples counted", LINE_INFO());
+            Assert::AreEqual(std::uint64_t(1), dst[0].sample.index, L"Oldest retained sample", LINE_INFO());
+            Assert::IsTrue(dst[0].follows_end_of_batch, L"End of batch carried", LINE_INFO());
+            Assert::AreEqual(std::uint32_t(1), dst[0].sample.dropped, L"Gap marked in sample", LINE_INFO());
+            Assert::AreEqual(std::uint64_t(2), dst[1].sample.index, L"Newest sample", LINE_INFO());
+            Assert::IsFalse(dst[1].follows_end_of_batch, L"Carried once", LINE_INFO());
+        }
+
+        TEST_METHOD(drop_newest_carries_end_of_batch) {
+            consumer_signal signal;
+            ::overflow_queue<dispatch_event> queue(2, powenetics_overflow::drop_newest, signal);
+            dispatch_event dst[4];
+            std::uint64_t dropped = 0;
+
+            queue.push(make_event(0), never);
+            queue.push(make_event(1), never);
+            Assert::IsFalse(queue.push(make_end_of_batch(), never), L"End of batch dropped", LINE_INFO());
+            Assert::AreEqual(std::size_t(2), queue.pop(dst, 4, dropped), L"Pop full queue", LINE_INFO());
+
+            queue.push(make_event(2), never);
+            Assert::AreEqual(std::size_t(1), queue.pop(dst, 4, dropped), L"Pop new", LINE_INFO());
+            Assert::IsTrue(dst[0].follows_end_of_batch, L"End of batch carried", LINE_INFO());
+            Assert::AreEqual(std::uint32_t(0), dst[0].sample.dropped, L"No sample dropped", LINE_INFO());
+        }
+
+        TEST_METHOD(batches_ordered_under_eviction) {
+            const std::uint64_t batch = 3;
+            consumer_signal signal;
+            ::overflow_queue<dispatch_event> queue(8, powenetics_overflow::drop_oldest, signal);
+            std::vector<powenetics_sample> assembled;
+            std::vector<dispatch_event> dst(4);
+            std::uint64_t evicted = 0;
+            std::uint64_t next = 0;
+            std::uint64_t received = 0;
+            std::size_t batches = 0;
+            auto bounded = true;
+            auto ordered = true;
+
+            // Reassemble the batches like the dispatch thread does and check
+            // that each of them only holds consecutive samples of one batch.
+            auto deliver = [&](void) {
+                if (!assembled.empty()) {
+                    const auto first = assembled.front().index;
+                    for (std::size_t i = 0; i < assembled.size(); ++i) {
+                        ordered &= (assembled[i].index / batch == first / batch);
+                        ordered &= (assembled[i].index == first + i);
+                    }
+                    received += assembled.size();
+                    assembled.clear();
+                    ++batches;
+                }
+            };
+
+            auto consume = [&](const std::size_t cnt) {
+                std::uint64_t dropped = 0;
+                const auto retval = queue.pop(dst.data(), cnt, dropped);
+                evicted += dropped;
+                for (std::size_t i = 0; i < retval; ++i) {
+                    if (dst[i].follows_end_of_batch) {
+                        deliver();
+                    }
+                    if (dst[i].kind == dispatch_kind::end_of_batch) {
+                        deliver();
+                    } else {
+                        assembled.push_back(dst[i].sample);
+                        bounded &= (assembled.size() <= batch);
+                    }
+                }
+                return retval;
+            };
+
+            // The producer outpaces the consumer by a varying number of
+            // batches, such that ends of batches are evicted at different
+            // positions.
+            for (std::size_t round = 0; round < 1000; ++round) {
+                for (std::size_t b = 0; b < round % 5; ++b) {
+                    for (std::uint64_t i = 0; i < batch; ++i) {
+                        Assert::IsTrue(queue.push(make_event(next++), never), L"Push succeeds", LINE_INFO());
+                    }
+                    Assert::IsTrue(queue.push(make_end_of_batch(), never), L"Push succeeds", LINE_INFO());
+                }
+
+                consume(1 + round % dst.size());
+            }
+
+            while (consume(dst.size()) > 0);
+            deliver();
+
+            Assert::IsTrue(bounded, L"Batches do not grow", LINE_INFO());
+            Assert::IsTrue(ordered, L"Batches not merged", LINE_INFO());
+            Assert::IsTrue(evicted > 0, L"Samples evicted", LINE_INFO());
+            Assert::IsTrue(batches > 0, L"Batches delivered", LINE_INFO());
+            Assert::AreEqual(next, received + evicted, L"All samples accounted for", LINE_INFO());
+        }
+
+        TEST_METHOD(drop_oldest_concurrent) {
+            const std::uint64_t total = 1000000;
+            consumer_signal signal;
+            ::overflow_queue<powenetics_sample> queue(16, powenetics_overflow::drop_oldest, signal);
+            std::atomic<bool> done(false);
+            std::uint64_t rejected = 0;
+
+            std::thread producer([&](void) {
+                for (std::uint64_t i = 0; i < total; ++i) {
+                    if (!queue.push(make_sample(i), never)) {
+                        ++rejected;
+                    }
+                }
+                done.store(true);
+            });
+
+            std::vector<powenetics_sample> dst(7);
+            std::uint64_t dropped = 0;
+            std::uint64_t evicted = 0;
+            std::uint64_t next = 0;
+            std::uint64_t received = 0;
+            auto in_order = true;
+            while (true) {
+                const auto finished = done.load();
+                const auto cnt = queue.pop(dst.data(), dst.size(), dropped);
+                evicted += dropped;
+                for (std::size_t i = 0; i < cnt; ++i) {
+                    in_order &= (dst[i].index >= next);
+                    next = dst[i].index + 1;
+                }
+                received += cnt;
+
+                if (cnt == 0) {
+                    if (finished) {
+                        break;
+                    }
+                    std::this_thread::yield();
+                }
+            }
+
+            producer.join();
+            Assert::IsTrue(in_order, L"Order preserved", LINE_INFO());
+            Assert::AreEqual(total, received + evicted + rejected, L"All samples accounted for", LINE_INFO());
+        }
+
+        TEST_METHOD(decimate) {
+            consumer_signal signal;
+            ::overflow_queue<powenetics_sample> queue(8, powenetics_overflow::decimate, signal);
+            powenetics_sample dst[16];
+            std::uint64_t dropped = 0;
+
+            for (std::uint64_t i = 0; i < 11; ++i) {
+                queue.push(make_sample(i), never);
+            }
+
+            const std::uint64_t indices[] = { 0, 1, 2, 3, 4, 5, 7, 9 };
+            const std::uint32_t marks[] = { 0, 0, 0, 0, 0, 0, 1, 1 };
+            Assert::AreEqual(std::size_t(8), queue.pop(dst, 16, dropped), L"Queue filled", LINE_INFO());
+            for (std::size_t i = 0; i < 8; ++i) {
+                Assert::AreEqual(indices[i], dst[i].index, L"Every second sample above half", LINE_INFO());
+                Assert::AreEqual(marks[i], dst[i].dropped, L"Decimation marked", LINE_INFO());
+            }
+
+            Assert::IsTrue(queue.push(make_sample(11), never), L"Below half after pop", LINE_INFO());
+            Assert::AreEqual(std::size_t(1), queue.pop(dst, 16, dropped), L"Pop new", LINE_INFO());
+            Assert::AreEqual(std::uint32_t(1), dst[0].dropped, L"Overflow marked", LINE_INFO());
+        }
+
+        TEST_METHOD(block) {
+            const std::uint64_t total = 100000;
+            consumer_signal signal;
+            ::overflow_queue<powenetics_sample> queue(16, powenetics_overflow::block, signal);
+
+            std::thread producer([&queue, total](void) {
+                for (std::uint64_t i = 0; i < total; ++i) {
+                    queue.push(make_sample(i), [](void) { return true; });
+                }
+            });
+
+            std::vector<powenetics_sample> dst(7);
+            std::uint64_t expected = 0;
+            std::uint64_t dropped = 0;
+            auto in_order = true;
+            while (expected < total) {
+                const auto cnt = queue.pop(dst.data(), dst.size(), dropped);
+                in_order &= (dropped == 0);
+                for (std::size_t i = 0; i < cnt; ++i) {
+                    in_order &= (dst[i].index == expected++);
+                    in_order &= (dst[i].dropped == 0);
+                }
+                if (cnt == 0) {
+                    std::this_thread::yield();
+                }
+            }
+
+            producer.join();
+            Assert::IsTrue(in_order, L"Nothing dropped", LINE_INFO());
+        }
+
+        TEST_METHOD(block_gives_up) {
+            consumer_signal signal;
+            ::overflow_queue<powenetics_sample> queue(1, powenetics_overflow::block, signal);
+
+            Assert::IsTrue(queue.push(make_sample(0), never), L"Push succeeds", LINE_INFO());
+            Assert::IsFalse(queue.push(make_sample(1), never), L"Dropped if producer must not wait", LINE_INFO());
+        }
+
+    };
+
+} /* namespace types */
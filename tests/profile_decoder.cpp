@@ -0,0 +1,173 @@
+﻿// <copyright file="profile_decoder.cpp" company="Visualisierungsinstitut der Universität Stuttgart">
+// Copyright © 2026 Visualisierungsinstitut der Universität Stuttgart.
+// Licensed under the MIT licence. See LICENCE file for details.
+// </copyright>
+// <author>Christoph Müller</author>
+
+#include <CppUnitTest.h>
+
+#include <random>
+#include <vector>
+
+#include "convert.h"
+#include "profile_decoder.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+
+namespace functions {
+
+    /// <summary>
+    /// Test the decoders specialised for the connector profile.
+    /// </summary>
+    TEST_CLASS(profile_decoder) {
+
+        /// <summary>
+        /// Decodes a channel like the generic parser did before the decoders
+        /// were specialised.
+        /// </summary>
+        static powenetics_raw_voltage_current reference_value(
+                const std::uint8_t *data) {
+            powenetics_raw_voltage_current retval;
+            retval.voltage = ::to_uint16(data);
+            retval.current = (retval.voltage > 1000) ? ::to_uint24(data + 2) : 0;
+            return retval;
+        }
+
+        /// <summary>
+        /// Decodes a segment like the generic parser did before the decoders
+        /// were specialised.
+        /// </summary>
+        static void reference_decode(powenetics_raw_sample& dst,
+                const std::uint8_t *segment) {
+            auto channel = [segment](const std::size_t c) {
+                return reference_value(segment + 2 + 5 * (c - 1));
+            };
+
+            dst.atx_3_3v = channel(1);
+            dst.atx_stb = (dst.atx_3_3v.voltage < 1000) ? channel(6) : channel(2);
+            dst.atx_12v = channel(3);
+            dst.atx_5v = channel(4);
+            dst.eps1 = channel(5);
+            dst.eps3 = channel(7);
+            dst.eps2 = channel(8);
+            dst.pcie_12v3 = channel(9);
+            dst.pcie_12v2 = channel(10);
+            dst.peg_3_3v = channel(11);
+            dst.peg_12v = channel(12);
+            dst.pcie_12v1 = channel(13);
+        }
+
+        /// <summary>
+        /// Sets the voltage of the one-based <paramref name="channel" />.
+        /// </summary>
+        static void set_voltage(std::uint8_t *segment, const std::size_t channel,
+                const std::uint16_t voltage) {
+            ::from_uint16(segment + 2 + 5 * (channel - 1), voltage);
+        }
+
+        /// <summary>
+        /// Creates a segment of random data that matches
+        /// <paramref name="profile" />.
+        /// </summary>
+        static std::vector<std::uint8_t> make_segment(std::mt19937& rng,
+                const connector_profile profile) {
+            std::uniform_int_distribution<int> bytes(0, 255);
+            std::uniform_int_distribution<int> low(0, 1000);
+            std::uniform_int_distribution<int> high(1001, 0xFFFF);
+            std::vector<std::uint8_t> retval(67);
+
+            for (auto& b : retval) {
+                b = static_cast<std::uint8_t>(bytes(rng));
+            }
+
+            // Make sure that the voltage is at the threshold every now and
+            // then for channels that are not determined by the profile.
+            if (bytes(rng) < 64) {
+                set_voltage(retval.data(), 3, 1000);
+            }
+
+            auto voltage = [&](const connector_profile flag) {
+                return static_cast<std::uint16_t>(((profile & flag) != 0)
+                    ? high(rng)
+                    : low(rng));
+            };
+            set_voltage(retval.data(), 1, ((profile & connector_profile_atx_10pin) != 0)
+                ? static_cast<std::uint16_t>(low(rng) % 1000)
+                : static_cast<std::uint16_t>(1000 + low(rng)));
+            set_voltage(retval.data(), 13, voltage(connector_profile_pcie_12v1));
+            set_voltage(retval.data(), 10, voltage(connector_profile_pcie_12v2));
+            set_voltage(retval.data(), 9, voltage(connector_profile_pcie_12v3));
+
+            return retval;
+        }
+
+        static bool equals(const powenetics_raw_voltage_current& lhs,
+                const powenetics_raw_voltage_current& rhs) {
+            return (lhs.voltage == rhs.voltage) && (lhs.current == rhs.current);
+        }
+
+        static bool equals(const powenetics_raw_sample& lhs,
+                const powenetics_raw_sample& rhs) {
+            return equals(lhs.atx_3_3v, rhs.atx_3_3v)
+                && equals(lhs.atx_stb, rhs.atx_stb)
+                && equals(lhs.atx_12v, rhs.atx_12v)
+                && equals(lhs.atx_5v, rhs.atx_5v)
+                && equals(lhs.eps1, rhs.eps1)
+                && equals(lhs.eps3, rhs.eps3)
+                && equals(lhs.eps2, rhs.eps2)
+                && equals(lhs.pcie_12v3, rhs.pcie_12v3)
+                && equals(lhs.pcie_12v2, rhs.pcie_12v2)
+                && equals(lhs.peg_3_3v, rhs.peg_3_3v)
+                && equals(lhs.peg_12v, rhs.peg_12v)
+                && equals(lhs.pcie_12v1, rhs.pcie_12v1);
+        }
+
+        TEST_METHOD(detect) {
+            std::vector<std::uint8_t> segment(67, 0);
+            Assert::AreEqual(int(connector_profile_atx_10pin), int(::detect_connector_profile(segment.data())), L"Everything off", LINE_INFO());
+
+            set_voltage(segment.data(), 1, 1000);
+            Assert::AreEqual(0, int(::detect_connector_profile(segment.data())), L"1V is 24-pin", LINE_INFO());
+
+            set_voltage(segment.data(), 13, 1000);
+            set_voltage(segment.data(), 10, 1001);
+            set_voltage(segment.data(), 9, 12000);
+            Assert::AreEqual(int(connector_profile_pcie_12v2 | connector_profile_pcie_12v3), int(::detect_connector_profile(segment.data())), L"PCIe above 1V", LINE_INFO());
+        }
+
+        TEST_METHOD(unknown) {
+            std::vector<std::uint8_t> segment(67, 0);
+            powenetics_raw_sample sample;
+            auto decoder = ::select_profile_decoder(connector_profile_unknown);
+            Assert::IsTrue(decoder != nullptr, L"Decoder for unknown profile", LINE_INFO());
+            Assert::IsFalse(decoder(sample, segment.data()), L"Unknown profile rejects everything", LINE_INFO());
+        }
+
+        TEST_METHOD(differential) {
+            std::mt19937 rng(42);
+
+            for (connector_profile p = 0; p < connector_profiles; ++p) {
+                auto decoder = ::select_profile_decoder(p);
+                Assert::IsTrue(decoder != nullptr, L"Decoder exists", LINE_INFO());
+
+                for (int i = 0; i < 256; ++i) {
+                    const auto segment = make_segment(rng, p);
+                    Assert::AreEqual(int(p), int(::detect_connector_profile(segment.data())), L"Segment matches profile", LINE_INFO());
+
+                    powenetics_raw_sample expected, actual;
+                    reference_decode(expected, segment.data());
+                    Assert::IsTrue(decoder(actual, segment.data()), L"Decoder accepts segment", LINE_INFO());
+                    Assert::IsTrue(equals(expected, actual), L"Same result as generic parser", LINE_INFO());
+
+                    for (connector_profile q = 0; q < connector_profiles; ++q) {
+                        if (q != p) {
+                            Assert::IsFalse(::select_profile_decoder(q)(actual, segment.data()), L"Other decoders reject segment", LINE_INFO());
+                        }
+                    }
+                }
+            }
+        }
+    };
+
+} /* namespace functions */
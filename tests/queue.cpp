@@ -0,0 +1,61 @@
+﻿// <copyright file="queue.cpp" company="Visualisierungsinstitut der Universität Stuttgart">
+// Copyright © 2026 Visualisierungsinstitut der Universität Stuttgart.
+// Licensed under the MIT licence. See LICENCE file for details.
+// </copyright>
+// <author>Christoph Müller</author>
+
+#include <CppUnitTest.h>
+
+#include "libpowenetics/powenetics.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+
+namespace functions {
+
+    /// <summary>
+    /// Test the utility functions for pulling samples from a queue.
+    /// </summary>
+    TEST_CLASS(queue) {
+
+        TEST_METHOD(create_default_config) {
+            powenetics_queue_configuration config;
+            ::ZeroMemory(&config, sizeof(config));
+
+            {
+                auto actual = ::powenetics_initialise_queue_configuration(nullptr);
+                Assert::AreEqual(E_POINTER, actual, L"nullptr rejected", LINE_INFO());
+            }
+
+            {
+                auto actual = ::powenetics_initialise_queue_configuration(&config);
+                Assert::AreEqual(E_INVALIDARG, actual, L"Invalid argument if version not set", LINE_INFO());
+            }
+
+            {
+                config.version = 2;
+                auto actual = ::powenetics_initialise_queue_configuration(&config);
+                Assert::AreEqual(S_OK, actual, L"Initialisation succeeded", LINE_INFO());
+                Assert::IsTrue(config.capacity > 0, L"capacity set", LINE_INFO());
+                Assert::IsTrue(config.overflow == powenetics_overflow::drop_newest, L"overflow set", LINE_INFO());
+            }
+        }
+
+        TEST_METHOD(read_samples) {
+            powenetics_sample sample;
+            std::size_t cnt = 1;
+
+            {
+                auto actual = ::powenetics_read_samples(nullptr, &sample, &cnt, 0);
+                Assert::AreEqual(E_HANDLE, actual, L"nullptr handle rejected", LINE_INFO());
+            }
+
+            {
+                auto actual = ::powenetics_start_streaming_queued(nullptr, nullptr);
+                Assert::AreEqual(E_HANDLE, actual, L"nullptr handle rejected", LINE_INFO());
+            }
+        }
+
+    };
+
+} /* namespace functions */
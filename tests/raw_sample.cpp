@@ -0,0 +1,97 @@
+﻿// <copyright file="raw_sample.cpp" company="Visualisierungsinstitut der Universität Stuttgart">
+// Copyright © 2026 Visualisierungsinstitut der Universität Stuttgart.
+// Licensed under the MIT licence. See LICENCE file for details.
+// </copyright>
+// <author>Christoph Müller</author>
+
+#include <CppUnitTest.h>
+
+#include <cstddef>
+#include <cstring>
+#include <vector>
+
+#include "libpowenetics/raw_sample.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+
+namespace functions {
+
+    /// <summary>
+    /// Test the conversion of raw samples.
+    /// </summary>
+    TEST_CLASS(raw_sample) {
+
+        TEST_METHOD(convert) {
+            powenetics_raw_sample src;
+            ::ZeroMemory(&src, sizeof(src));
+            powenetics_sample dst;
+            dst.version = 3;
+
+            {
+                auto actual = ::powenetics_convert_raw_sample(nullptr, &src);
+                Assert::AreEqual(E_POINTER, actual, L"nullptr rejected", LINE_INFO());
+            }
+
+            {
+                auto actual = ::powenetics_convert_raw_sample(&dst, &src);
+                Assert::AreEqual(E_INVALIDARG, actual, L"Invalid argument if version not set", LINE_INFO());
+            }
+
+            {
+                src.version = 3;
+                src.sequence_number = 42;
+                src.timestamp = 4711;
+                src.atx_12v.voltage = 12150;
+                src.atx_12v.current = 16777215;
+                src.peg_3_3v.voltage = 3300;
+                src.peg_3_3v.current = 1;
+                auto actual = ::powenetics_convert_raw_sample(&dst, &src);
+                Assert::AreEqual(S_OK, actual, L"Conversion succeeded", LINE_INFO());
+                Assert::AreEqual(std::uint32_t(3), dst.version, L"Version", LINE_INFO());
+                Assert::AreEqual(std::uint16_t(42), dst.sequence_number, L"Sequence number", LINE_INFO());
+                Assert::AreEqual(powenetics_timestamp(4711), dst.timestamp, L"Timestamp", LINE_INFO());
+                Assert::AreEqual(12.15f, dst.atx_12v.voltage, 0.0001f, L"ATX 12V voltage", LINE_INFO());
+                Assert::AreEqual(16777.215f, dst.atx_12v.current, 0.001f, L"ATX 12V current", LINE_INFO());
+                Assert::AreEqual(3.3f, dst.peg_3_3v.voltage, 0.0001f, L"PEG 3.3V voltage", LINE_INFO());
+                Assert::AreEqual(0.001f, dst.peg_3_3v.current, 0.0001f, L"PEG 3.3V current", LINE_INFO());
+                Assert::AreEqual(0.0f, dst.eps1.voltage, 0.0001f, L"EPS #1 voltage", LINE_INFO());
+            }
+
+            {
+                auto actual = ::powenetics_convert_raw_samples(nullptr, nullptr, 0);
+                Assert::AreEqual(S_OK, actual, L"Empty range accepted", LINE_INFO());
+            }
+        }
+
+        TEST_METHOD(convert_version_2) {
+            // Samples of version 2 end before the index, so an array of them
+            // is more dense than one of the current version.
+            const auto size = offsetof(powenetics_sample, index);
+            std::vector<std::uint8_t> dst(3 * size + 1, 0xCC);
+            reinterpret_cast<powenetics_sample *>(dst.data())->version = 2;
+
+            std::vector<powenetics_raw_sample> src(3);
+            ::ZeroMemory(src.data(), src.size() * sizeof(powenetics_raw_sample));
+            for (std::uint16_t i = 0; i < src.size(); ++i) {
+                src[i].version = 3;
+                src[i].sequence_number = i;
+                src[i].index = i;
+            }
+
+            auto actual = ::powenetics_convert_raw_samples(reinterpret_cast<powenetics_sample *>(dst.data()), src.data(), src.size());
+            Assert::AreEqual(S_OK, actual, L"Conversion succeeded", LINE_INFO());
+
+            for (std::uint16_t i = 0; i < src.size(); ++i) {
+                powenetics_sample sample;
+                std::memcpy(&sample, dst.data() + i * size, size);
+                Assert::AreEqual(std::uint32_t(2), sample.version, L"Version", LINE_INFO());
+                Assert::AreEqual(i, sample.sequence_number, L"Sequence number", LINE_INFO());
+            }
+
+            Assert::AreEqual(std::uint8_t(0xCC), dst.back(), L"Nothing written behind the array", LINE_INFO());
+        }
+
+    };
+
+} /* namespace functions */
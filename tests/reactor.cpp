@@ -0,0 +1,64 @@
+﻿// <copyright file="reactor.cpp" company="Visualisierungsinstitut der Universität Stuttgart">
+// Copyright © 2026 Visualisierungsinstitut der Universität Stuttgart.
+// Licensed under the MIT licence. See LICENCE file for details.
+// </copyright>
+// <author>Christoph Müller</author>
+
+#include <CppUnitTest.h>
+
+#include "libpowenetics/powenetics.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+
+namespace functions {
+
+    /// <summary>
+    /// Test the API of the reactor serving multiple devices.
+    /// </summary>
+    TEST_CLASS(reactor) {
+
+        TEST_METHOD(create_destroy) {
+            powenetics_reactor_handle reactor = nullptr;
+
+            {
+                auto actual = ::powenetics_create_reactor(nullptr, 1);
+                Assert::AreEqual(E_POINTER, actual, L"nullptr rejected", LINE_INFO());
+            }
+
+            {
+                auto actual = ::powenetics_create_reactor(&reactor, 0);
+                Assert::AreEqual(E_INVALIDARG, actual, L"At least one thread required", LINE_INFO());
+                Assert::IsNull(reactor, L"No reactor created", LINE_INFO());
+            }
+
+            {
+                auto actual = ::powenetics_create_reactor(&reactor, 2);
+#if defined(__linux__)
+                Assert::AreEqual(S_OK, actual, L"Reactor created", LINE_INFO());
+                Assert::IsNotNull(reactor, L"Reactor returned", LINE_INFO());
+#else /* defined(__linux__) */
+                Assert::AreEqual(E_NOTIMPL, actual, L"Reactor only supported on Linux", LINE_INFO());
+                Assert::IsNull(reactor, L"No reactor created", LINE_INFO());
+#endif /* defined(__linux__) */
+            }
+
+            {
+                auto actual = ::powenetics_set_reactor(nullptr, reactor);
+                Assert::AreEqual(E_HANDLE, actual, L"Invalid device handle rejected", LINE_INFO());
+            }
+
+            if (reactor != nullptr) {
+                auto actual = ::powenetics_destroy_reactor(reactor);
+                Assert::AreEqual(S_OK, actual, L"Reactor destroyed", LINE_INFO());
+            }
+
+            {
+                auto actual = ::powenetics_destroy_reactor(nullptr);
+                Assert::AreEqual(E_HANDLE, actual, L"Invalid reactor handle rejected", LINE_INFO());
+            }
+        }
+
+    };
+
+} /* namespace functions */
@@ -0,0 +1,273 @@
+﻿// <copyright file="resumable_parser_v2.cpp" company="Visualisierungsinstitut der Universität Stuttgart">
+// Copyright © 2026 Visualisierungsinstitut der Universität Stuttgart.
+// Licensed under the MIT licence. See LICENCE file for details.
+// </copyright>
+// <author>Christoph Müller</author>
+
+#include <CppUnitTest.h>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "resumable_parser_v2.h"
+#include "stream_parser.h"
+#include "stream_parser_v2.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+
+static_assert(is_stream_parser<resumable_parser_v2>::value,
+    "resumable_parser_v2 satisfies the parser concept.");
+static_assert(resumable_parser_v2::scratch_size == 69,
+    "The scratch area holds a segment and its delimiter.");
+
+
+namespace types {
+
+    /// <summary>
+    /// Test the byte-wise state machine parser.
+    /// </summary>
+    TEST_CLASS(resumable_parser_v2) {
+
+        typedef ::resumable_parser_v2::state_type state_type;
+
+        /// <summary>
+        /// A clock that makes the timestamps of both parsers comparable.
+        /// </summary>
+        static powenetics_timestamp fixed_clock(void) {
+            return 42;
+        }
+
+        /// <summary>
+        /// Appends a segment with the given sequence number and all channels
+        /// set to 12V and 1A to <paramref name="dst" />.
+        /// </summary>
+        static void append_segment(std::vector<std::uint8_t>& dst,
+                const std::uint16_t sequence_number) {
+            auto& delimiter = responses_v2::segment_delimiter;
+            dst.insert(dst.end(), delimiter.begin(), delimiter.end());
+
+            std::uint8_t buffer[5];
+            ::from_uint16(buffer, sequence_number);
+            dst.insert(dst.end(), buffer, buffer + 2);
+
+            for (int c = 0; c < 13; ++c) {
+                ::from_uint16(buffer, 12000);
+                ::from_uint24(buffer + 2, 1000);
+                dst.insert(dst.end(), buffer, buffer + 5);
+            }
+        }
+
+        /// <summary>
+        /// Creates a stream of <paramref name="cnt" /> segments with random
+        /// readings, sequence gaps, garbage, broken segments and delimiters in
+        /// the payload.
+        /// </summary>
+        static std::vector<std::uint8_t> make_stream(std::mt19937& rng,
+                const std::size_t cnt) {
+            auto& delimiter = responses_v2::segment_delimiter;
+            std::uniform_int_distribution<int> bytes(0, 255);
+            std::uniform_int_distribution<int> percent(0, 99);
+            std::vector<std::uint8_t> retval;
+            std::uint16_t sequence_number = 0;
+
+            for (std::size_t i = 0; i < cnt; ++i) {
+                if (percent(rng) < 3) {
+                    // Garbage between segments, which might contain parts of a
+                    // delimiter.
+                    const auto garbage = bytes(rng) % 100;
+                    for (int g = 0; g < garbage; ++g) {
+                        retval.push_back((percent(rng) < 10)
+                            ? delimiter[g % 2]
+                            : static_cast<std::uint8_t>(bytes(rng)));
+                    }
+                }
+
+                sequence_number += (percent(rng) < 2) ? 3 : 1;
+                append_segment(retval, sequence_number);
+
+                if (percent(rng) < 2) {
+                    // Fake delimiter in the payload.
+                    const auto at = retval.size() - 1 - bytes(rng) % 60;
+                    retval[at - 1] = delimiter.front();
+                    retval[at] = delimiter.back();
+                }
+
+                if (percent(rng) < 1) {
+                    // Truncated segment.
+                    retval.resize(retval.size() - 1 - bytes(rng) % 60);
+                }
+            }
+
+            retval.insert(retval.end(), delimiter.begin(), delimiter.end());
+            return retval;
+        }
+
+        /// <summary>
+        /// Feeds <paramref name="stream" /> in random chunks of at most
+        /// <paramref name="max_chunk" /> bytes to a new parser of type
+        /// <typeparamref name="TParser" />.
+        /// </summary>
+        template<class TParser>
+        static std::vector<powenetics_raw_sample> parse(
+                const std::vector<std::uint8_t>& stream,
+                const std::size_t max_chunk,
+                parser_statistics& statistics) {
+            std::mt19937 rng(static_cast<std::uint32_t>(max_chunk));
+            std::uniform_int_distribution<std::size_t> chunks(1, max_chunk);
+            std::vector<powenetics_raw_sample> retval;
+            TParser parser;
+            parser.clock(fixed_clock);
+
+            for (std::size_t i = 0; i < stream.size();) {
+                const auto cnt = (std::min)(chunks(rng), stream.size() - i);
+                parser.template push_back<powenetics_raw_sample>(
+                        stream.data() + i, cnt,
+                        [&retval](const powenetics_raw_sample& s) {
+                    retval.push_back(s);
+                });
+                i += cnt;
+            }
+
+            statistics = parser.collect_statistics();
+            return retval;
+        }
+
+        TEST_METHOD(same_as_stream_parser) {
+            std::mt19937 rng(20260314);
+            const auto stream = make_stream(rng, 5000);
+
+            for (auto max_chunk : { 1, 7, 69, 1024 }) {
+                parser_statistics es, as;
+                const auto expected = parse<::stream_parser_v2>(stream,
+                    max_chunk, es);
+                const auto actual = parse<::resumable_parser_v2>(stream,
+                    max_chunk, as);
+
+                Assert::IsTrue(expected.size() > 4500, L"Most segments parsed");
+                Assert::AreEqual(expected.size(), actual.size(),
+                    L"# of samples");
+
+                for (std::size_t i = 0; i < expected.size(); ++i) {
+                    Assert::AreEqual(expected[i].sequence_number,
+                        actual[i].sequence_number, L"sequence_number");
+                    Assert::AreEqual(expected[i].index, actual[i].index,
+                        L"index");
+                    Assert::AreEqual(expected[i].missing, actual[i].missing,
+                        L"missing");
+                    Assert::AreEqual(expected[i].timestamp,
+                        actual[i].timestamp, L"timestamp");
+                    Assert::AreEqual(expected[i].atx_12v.current,
+                        actual[i].atx_12v.current, L"atx_12v");
+                    Assert::AreEqual(expected[i].pcie_12v1.voltage,
+                        actual[i].pcie_12v1.voltage, L"pcie_12v1");
+                }
+
+                Assert::AreEqual(es.segments_parsed, as.segments_parsed,
+                    L"segments_parsed");
+                Assert::AreEqual(es.segments_rejected, as.segments_rejected,
+                    L"segments_rejected");
+                Assert::AreEqual(es.bytes_discarded, as.bytes_discarded,
+                    L"bytes_discarded");
+                Assert::AreEqual(es.carry_overs, as.carry_overs,
+                    L"carry_overs");
+                Assert::AreEqual(es.sequence_gaps, as.sequence_gaps,
+                    L"sequence_gaps");
+                Assert::AreEqual(es.samples_missing, as.samples_missing,
+                    L"samples_missing");
+            }
+        }
+
+        TEST_METHOD(states) {
+            auto& delimiter = responses_v2::segment_delimiter;
+            std::vector<std::uint8_t> stream;
+            append_segment(stream, 1);
+            append_segment(stream, 2);
+            stream.insert(stream.end(), delimiter.begin(), delimiter.end());
+
+            ::resumable_parser_v2 parser;
+            std::size_t cnt = 0;
+            auto count = [&cnt](const powenetics_sample&) { ++cnt; };
+            Assert::IsTrue(parser.state() == state_type::hunting,
+                L"Hunting initially");
+
+            const std::uint8_t garbage[] = { 0x00, 0x11 };
+            Assert::IsFalse(parser.push_back(garbage, 2, count),
+                L"Garbage not retained");
+            Assert::IsTrue(parser.state() == state_type::hunting,
+                L"Still hunting");
+
+            Assert::IsTrue(parser.push_back(stream.data(), 1, count),
+                L"First half of delimiter retained");
+            Assert::IsTrue(parser.state() == state_type::delimiter_seen,
+                L"Delimiter seen");
+
+            Assert::IsTrue(parser.push_back(stream.data() + 1, 30, count),
+                L"Partial segment retained");
+            Assert::IsTrue(parser.state() == state_type::collecting,
+                L"Collecting");
+            Assert::AreEqual(std::size_t(0), cnt, L"Nothing delivered");
+
+            Assert::IsFalse(parser.push_back(stream.data() + 31,
+                stream.size() - 31, count), L"Nothing retained");
+            Assert::AreEqual(std::size_t(2), cnt, L"Segments delivered");
+            Assert::IsTrue(parser.state() == state_type::collecting,
+                L"Terminating delimiter starts the next segment");
+
+            const auto statistics = parser.collect_statistics();
+            Assert::AreEqual(std::uint64_t(2), statistics.bytes_discarded,
+                L"bytes_discarded");
+            Assert::AreEqual(std::uint64_t(2), statistics.carry_overs,
+                L"carry_overs");
+        }
+
+        TEST_METHOD(resync) {
+            auto& delimiter = responses_v2::segment_delimiter;
+            std::vector<std::uint8_t> stream;
+            append_segment(stream, 1);
+            // Truncate the first segment, so its expected delimiter is in the
+            // middle of the second one.
+            stream.resize(stream.size() - 10);
+            append_segment(stream, 2);
+            append_segment(stream, 3);
+            stream.insert(stream.end(), delimiter.begin(), delimiter.end());
+
+            ::resumable_parser_v2 parser;
+            std::vector<std::uint16_t> sequence_numbers;
+            for (auto b : stream) {
+                parser.push_back(&b, 1, [&sequence_numbers](
+                        const powenetics_sample& s) {
+                    sequence_numbers.push_back(s.sequence_number);
+                });
+            }
+
+            Assert::AreEqual(std::size_t(2), sequence_numbers.size(),
+                L"Two segments after resync");
+            Assert::AreEqual(std::uint16_t(2), sequence_numbers[0], L"#2");
+            Assert::AreEqual(std::uint16_t(3), sequence_numbers[1], L"#3");
+
+            const auto statistics = parser.collect_statistics();
+            Assert::AreEqual(std::uint64_t(1), statistics.segments_rejected,
+                L"segments_rejected");
+            Assert::AreEqual(std::uint64_t(57), statistics.bytes_discarded,
+                L"bytes_discarded");
+        }
+
+        TEST_METHOD(flush) {
+            std::vector<std::uint8_t> stream;
+            append_segment(stream, 1);
+
+            ::resumable_parser_v2 parser;
+            auto ignore = [](const powenetics_sample&) { };
+            parser.push_back(stream.data(), 12, ignore);
+            parser.flush();
+
+            Assert::IsTrue(parser.state() == state_type::hunting,
+                L"Hunting after flush");
+            const auto statistics = parser.collect_statistics();
+            Assert::AreEqual(std::uint64_t(10), statistics.bytes_discarded,
+                L"Partial segment discarded");
+        }
+    };
+}
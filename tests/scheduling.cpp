@@ -0,0 +1,107 @@
+﻿// <copyright file="scheduling.cpp" company="Visualisierungsinstitut der Universität Stuttgart">
+// Copyright © 2026 Visualisierungsinstitut der Universität Stuttgart.
+// Licensed under the MIT licence. See LICENCE file for details.
+// </copyright>
+// <author>Christoph Müller</author>
+
+#include <CppUnitTest.h>
+
+#include "libpowenetics/scheduling.h"
+
+#include "thread_configuration.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+
+namespace functions {
+
+    /// <summary>
+    /// Test the utility functions for configuring the streaming thread.
+    /// </summary>
+    TEST_CLASS(scheduling) {
+
+        TEST_METHOD(check_config) {
+            powenetics_thread_configuration config;
+            ::ZeroMemory(&config, sizeof(config));
+
+            {
+                auto actual = ::check_thread_configuration(config);
+                Assert::AreEqual(E_INVALIDARG, actual, L"Invalid argument if version not set", LINE_INFO());
+            }
+
+            config.version = 2;
+            Assert::AreEqual(S_OK, ::powenetics_initialise_thread_configuration(&config), L"Initialisation succeeded", LINE_INFO());
+            Assert::AreEqual(S_OK, ::check_thread_configuration(config), L"Default is valid", LINE_INFO());
+
+            {
+                config.scheduling = static_cast<powenetics_scheduling>(42);
+                auto actual = ::check_thread_configuration(config);
+                Assert::AreEqual(E_INVALIDARG, actual, L"Invalid policy", LINE_INFO());
+            }
+
+            {
+                config.scheduling = powenetics_scheduling::fifo;
+                config.priority = 1;
+                auto actual = ::check_thread_configuration(config);
+                Assert::AreEqual(S_OK, actual, L"Lowest real-time priority", LINE_INFO());
+            }
+
+#if !defined(_WIN32)
+            {
+                config.scheduling = powenetics_scheduling::round_robin;
+                config.priority = 0;
+                auto actual = ::check_thread_configuration(config);
+                Assert::AreEqual(E_INVALIDARG, actual, L"Priority out of range", LINE_INFO());
+            }
+#endif /* !defined(_WIN32) */
+
+            {
+                config.scheduling = powenetics_scheduling::inherit;
+                config.priority = -1;
+                auto actual = ::check_thread_configuration(config);
+                Assert::AreEqual(S_OK, actual, L"Priority ignored", LINE_INFO());
+            }
+
+            {
+                config.affinity[1] = 1;
+                auto actual = ::check_thread_configuration(config);
+#if defined(_WIN32)
+                Assert::AreEqual(E_NOTIMPL, actual, L"Processor beyond first group", LINE_INFO());
+#elif defined(__linux__)
+                Assert::AreEqual(S_OK, actual, L"Processor 64 selected", LINE_INFO());
+#endif /* defined(_WIN32) */
+            }
+        }
+
+        TEST_METHOD(create_default_config) {
+            powenetics_thread_configuration config;
+            ::ZeroMemory(&config, sizeof(config));
+
+            {
+                auto actual = ::powenetics_initialise_thread_configuration(nullptr);
+                Assert::AreEqual(E_POINTER, actual, L"nullptr rejected", LINE_INFO());
+            }
+
+            {
+                auto actual = ::powenetics_initialise_thread_configuration(&config);
+                Assert::AreEqual(E_INVALIDARG, actual, L"Invalid argument if version not set", LINE_INFO());
+            }
+
+            {
+                config.version = 2;
+                config.affinity[3] = 42;
+                config.scheduling = powenetics_scheduling::fifo;
+                config.priority = 42;
+                config.lock_memory = 1;
+                auto actual = ::powenetics_initialise_thread_configuration(&config);
+                Assert::AreEqual(S_OK, actual, L"Initialisation succeeded", LINE_INFO());
+                Assert::AreEqual(std::uint64_t(0), config.affinity[3], L"affinity reset", LINE_INFO());
+                Assert::IsTrue(config.scheduling == powenetics_scheduling::inherit, L"scheduling reset", LINE_INFO());
+                Assert::AreEqual(std::int32_t(0), config.priority, L"priority reset", LINE_INFO());
+                Assert::AreEqual(std::uint32_t(0), config.lock_memory, L"lock_memory reset", LINE_INFO());
+            }
+        }
+
+    };
+
+} /* namespace functions */
@@ -0,0 +1,214 @@
+﻿// <copyright file="segment.cpp" company="Visualisierungsinstitut der Universität Stuttgart">
+// Copyright © 2026 Visualisierungsinstitut der Universität Stuttgart.
+// Licensed under the MIT licence. See LICENCE file for details.
+// </copyright>
+// <author>Christoph Müller</author>
+
+#include <CppUnitTest.h>
+
+#include <random>
+#include <vector>
+
+#include "libpowenetics/segment.h"
+
+#include "columnar_parser_v2.h"
+#include "resumable_parser_v2.h"
+#include "stream_parser_v2.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+
+namespace functions {
+
+    /// <summary>
+    /// Test the delivery and the decoding of undecoded segments.
+    /// </summary>
+    TEST_CLASS(segment) {
+
+        /// <summary>
+        /// A clock that makes the timestamps of both passes comparable.
+        /// </summary>
+        static powenetics_timestamp fixed_clock(void) {
+            return 42;
+        }
+
+        /// <summary>
+        /// Creates a stream of <paramref name="cnt" /> segments with random
+        /// readings, some of which are below the threshold of a powered rail,
+        /// such that the connector profile changes.
+        /// </summary>
+        static std::vector<std::uint8_t> make_stream(std::mt19937& rng,
+                const std::size_t cnt) {
+            auto& delimiter = responses_v2::segment_delimiter;
+            std::uniform_int_distribution<int> voltages(0, 13000);
+            std::uniform_int_distribution<int> currents(0, 0xFFFFFF);
+            std::uniform_int_distribution<int> percent(0, 99);
+            std::vector<std::uint8_t> retval;
+            std::uint16_t sequence_number = 0;
+
+            for (std::size_t i = 0; i < cnt; ++i) {
+                retval.insert(retval.end(), delimiter.begin(),
+                    delimiter.end());
+
+                std::uint8_t buffer[5];
+                sequence_number += (percent(rng) < 2) ? 2 : 1;
+                ::from_uint16(buffer, sequence_number);
+                retval.insert(retval.end(), buffer, buffer + 2);
+
+                for (int c = 0; c < 13; ++c) {
+                    ::from_uint16(buffer, static_cast<std::uint16_t>(
+                        voltages(rng)));
+                    ::from_uint24(buffer + 2, currents(rng));
+                    retval.insert(retval.end(), buffer, buffer + 5);
+                }
+            }
+
+            retval.insert(retval.end(), delimiter.begin(), delimiter.end());
+            return retval;
+        }
+
+        /// <summary>
+        /// Checks that decoding the segments delivered by
+        /// <typeparamref name="TParser" /> yields the raw samples it delivers.
+        /// </summary>
+        template<class TParser>
+        static void check_parser(const std::vector<std::uint8_t>& stream) {
+            std::vector<powenetics_raw_sample> expected;
+            std::vector<powenetics_raw_sample> actual;
+            const std::size_t chunk = 1000;
+
+            {
+                TParser parser;
+                parser.clock(fixed_clock);
+                for (std::size_t i = 0; i < stream.size(); i += chunk) {
+                    parser.template push_back<powenetics_raw_sample>(
+                            stream.data() + i,
+                            (std::min)(chunk, stream.size() - i),
+                            [&expected](const powenetics_raw_sample& s) {
+                        expected.push_back(s);
+                    });
+                }
+            }
+
+            {
+                TParser parser;
+                parser.clock(fixed_clock);
+                for (std::size_t i = 0; i < stream.size(); i += chunk) {
+                    parser.template push_back<powenetics_segment>(
+                            stream.data() + i,
+                            (std::min)(chunk, stream.size() - i),
+                            [&actual](const powenetics_segment& s) {
+                        Assert::AreEqual(std::uint32_t(3), s.version,
+                            L"version");
+                        Assert::IsNotNull(s.data, L"data");
+                        powenetics_raw_sample sample;
+                        sample.version = 3;
+                        Assert::AreEqual(S_OK,
+                            ::powenetics_decode_segment(&sample, &s),
+                            L"Segment decoded");
+                        actual.push_back(sample);
+                    });
+                }
+
+                Assert::IsTrue(parser.profile() == connector_profile_unknown,
+                    L"Segments are not decoded");
+            }
+
+            Assert::AreEqual(expected.size(), actual.size(), L"# of samples");
+            for (std::size_t i = 0; i < expected.size(); ++i) {
+                Assert::AreEqual(expected[i].sequence_number,
+                    actual[i].sequence_number, L"sequence_number");
+                Assert::AreEqual(expected[i].index, actual[i].index,
+                    L"index");
+                Assert::AreEqual(expected[i].missing, actual[i].missing,
+                    L"missing");
+                Assert::AreEqual(expected[i].timestamp, actual[i].timestamp,
+                    L"timestamp");
+                Assert::AreEqual(expected[i].atx_12v.voltage,
+                    actual[i].atx_12v.voltage, L"atx_12v.voltage");
+                Assert::AreEqual(expected[i].atx_stb.current,
+                    actual[i].atx_stb.current, L"atx_stb.current");
+                Assert::AreEqual(expected[i].pcie_12v3.current,
+                    actual[i].pcie_12v3.current, L"pcie_12v3.current");
+                Assert::AreEqual(expected[i].peg_3_3v.voltage,
+                    actual[i].peg_3_3v.voltage, L"peg_3_3v.voltage");
+            }
+        }
+
+        TEST_METHOD(decode) {
+            powenetics_raw_sample dst;
+            dst.version = 3;
+            powenetics_segment src;
+            ::ZeroMemory(&src, sizeof(src));
+
+            Assert::AreEqual(E_POINTER, ::powenetics_decode_segment(nullptr,
+                &src), L"nullptr destination");
+            Assert::AreEqual(E_POINTER, ::powenetics_decode_segment(&dst,
+                nullptr), L"nullptr source");
+            Assert::AreEqual(E_INVALIDARG, ::powenetics_decode_segment(&dst,
+                &src), L"Invalid version");
+
+            src.version = 3;
+            Assert::AreEqual(E_POINTER, ::powenetics_decode_segment(&dst,
+                &src), L"nullptr data");
+
+            std::uint8_t data[POWENETICS_SEGMENT_LENGTH] = { 0 };
+            ::from_uint16(data, 7);
+            // The third channel is the 12V rail of the ATX connector.
+            ::from_uint16(data + 12, 12000);
+            ::from_uint24(data + 14, 1500);
+            src.sequence_number = 7;
+            src.timestamp = 4711;
+            src.data = data;
+            src.index = 3;
+            src.missing = 1;
+
+            Assert::AreEqual(S_OK, ::powenetics_decode_segment(&dst, &src),
+                L"Segment decoded");
+            Assert::AreEqual(std::uint32_t(3), dst.version, L"version");
+            Assert::AreEqual(std::uint16_t(7), dst.sequence_number,
+                L"sequence_number");
+            Assert::AreEqual(powenetics_timestamp(4711), dst.timestamp,
+                L"timestamp");
+            Assert::AreEqual(std::uint64_t(3), dst.index, L"index");
+            Assert::AreEqual(std::uint32_t(1), dst.missing, L"missing");
+            Assert::AreEqual(std::uint16_t(12000), dst.atx_12v.voltage,
+                L"atx_12v.voltage");
+            Assert::AreEqual(std::uint32_t(1500), dst.atx_12v.current,
+                L"atx_12v.current");
+
+            // Version 2 of the sample ends before the index, so nothing
+            // behind it must be written.
+            dst.version = 2;
+            dst.index = 42;
+            dst.missing = 42;
+            dst.dropped = 42;
+            Assert::AreEqual(S_OK, ::powenetics_decode_segment(&dst, &src),
+                L"Segment decoded into version 2");
+            Assert::AreEqual(std::uint32_t(2), dst.version, L"version 2");
+            Assert::AreEqual(std::uint64_t(42), dst.index, L"index untouched");
+            Assert::AreEqual(std::uint32_t(42), dst.missing,
+                L"missing untouched");
+            Assert::AreEqual(std::uint32_t(42), dst.dropped,
+                L"dropped untouched");
+            Assert::AreEqual(std::uint32_t(1500), dst.atx_12v.current,
+                L"atx_12v.current in version 2");
+
+            // A segment of version 2 has no index.
+            src.version = 2;
+            dst.version = 3;
+            Assert::AreEqual(S_OK, ::powenetics_decode_segment(&dst, &src),
+                L"Segment of version 2 decoded");
+            Assert::AreEqual(std::uint64_t(0), dst.index, L"no index");
+            Assert::AreEqual(std::uint32_t(0), dst.missing, L"none missing");
+        }
+
+        TEST_METHOD(same_as_raw_sample) {
+            std::mt19937 rng(20260501);
+            const auto stream = make_stream(rng, 2000);
+            check_parser<::stream_parser_v2>(stream);
+            check_parser<::columnar_parser_v2>(stream);
+            check_parser<::resumable_parser_v2>(stream);
+        }
+    };
+}
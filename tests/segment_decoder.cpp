@@ -0,0 +1,176 @@
+﻿// <copyright file="segment_decoder.cpp" company="Visualisierungsinstitut der Universität Stuttgart">
+// Copyright © 2026 Visualisierungsinstitut der Universität Stuttgart.
+// Licensed under the MIT licence. See LICENCE file for details.
+// </copyright>
+// <author>Christoph Müller</author>
+
+#include <CppUnitTest.h>
+
+#include <random>
+#include <vector>
+
+#include "segment_decoder.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+
+namespace functions {
+
+    /// <summary>
+    /// Test the columnar decoders for batches of segments.
+    /// </summary>
+    TEST_CLASS(segment_decoder) {
+
+        /// <summary>
+        /// Storage for decoded columns.
+        /// </summary>
+        struct columns {
+            std::vector<std::uint16_t> sequence_numbers;
+            std::vector<std::uint16_t> voltages[segment_channels];
+            std::vector<std::uint32_t> currents[segment_channels];
+
+            columns(const std::size_t cnt) : sequence_numbers(cnt) {
+                for (std::size_t c = 0; c < segment_channels; ++c) {
+                    this->voltages[c].resize(cnt);
+                    this->currents[c].resize(cnt);
+                }
+            }
+
+            segment_columns get(void) {
+                segment_columns retval;
+                retval.sequence_numbers = this->sequence_numbers.data();
+                for (std::size_t c = 0; c < segment_channels; ++c) {
+                    retval.voltages[c] = this->voltages[c].data();
+                    retval.currents[c] = this->currents[c].data();
+                }
+                return retval;
+            }
+
+            bool operator ==(const columns& rhs) const {
+                if (this->sequence_numbers != rhs.sequence_numbers) {
+                    return false;
+                }
+                for (std::size_t c = 0; c < segment_channels; ++c) {
+                    if ((this->voltages[c] != rhs.voltages[c])
+                            || (this->currents[c] != rhs.currents[c])) {
+                        return false;
+                    }
+                }
+                return true;
+            }
+        };
+
+        /// <summary>
+        /// Creates <paramref name="cnt" /> segments of random data, each
+        /// followed by a delimiter.
+        /// </summary>
+        static std::vector<std::uint8_t> make_segments(const std::size_t cnt) {
+            const auto stride = segment_min_stride + 2;
+            std::vector<std::uint8_t> retval(cnt * stride);
+            std::mt19937 rng(42);
+            std::uniform_int_distribution<int> dist(0, 255);
+
+            for (std::size_t i = 0; i < cnt; ++i) {
+                auto s = retval.data() + i * stride;
+                for (std::size_t j = 0; j < segment_min_stride; ++j) {
+                    s[j] = static_cast<std::uint8_t>(dist(rng));
+                }
+
+                // Make sure that we hit the discard threshold every now and
+                // then.
+                if (i % 3 == 0) {
+                    s[2] = 0x03;
+                    s[3] = static_cast<std::uint8_t>(0xE0 + i % 16);
+                }
+
+                s[segment_min_stride] = 0xCA;
+                s[segment_min_stride + 1] = 0xAC;
+            }
+
+            return retval;
+        }
+
+        TEST_METHOD(scalar) {
+            std::vector<std::uint8_t> segment { 0x01, 0x02 };
+            for (std::size_t c = 0; c < segment_channels; ++c) {
+                const std::uint8_t voltage = (c == 1) ? 0x03 : 0x2E;
+                segment.insert(segment.end(), { voltage, 0xE8, 0x01, 0x02, 0x03 });
+            }
+
+            columns actual(1);
+            ::decode_segments_scalar(actual.get(), segment.data(), segment.size(), 1);
+            Assert::AreEqual(std::uint16_t(0x0102), actual.sequence_numbers[0], L"Sequence number", LINE_INFO());
+            Assert::AreEqual(std::uint16_t(12008), actual.voltages[0][0], L"Voltage", LINE_INFO());
+            Assert::AreEqual(std::uint32_t(0x010203), actual.currents[0][0], L"Current", LINE_INFO());
+            Assert::AreEqual(std::uint16_t(1000), actual.voltages[1][0], L"Low voltage", LINE_INFO());
+            Assert::AreEqual(std::uint32_t(0), actual.currents[1][0], L"Current discarded", LINE_INFO());
+        }
+
+        TEST_METHOD(vectorised) {
+            const auto stride = segment_min_stride + 2;
+
+            for (std::size_t cnt = 0; cnt < 21; ++cnt) {
+                const auto segments = make_segments(cnt);
+                columns expected(cnt);
+                ::decode_segments_scalar(expected.get(), segments.data(), stride, cnt);
+
+                {
+                    columns actual(cnt);
+                    auto decoder = ::select_segment_decoder();
+                    decoder(actual.get(), segments.data(), stride, cnt);
+                    Assert::IsTrue(expected == actual, L"Selected decoder", LINE_INFO());
+                }
+
+#if defined(POWENETICS_X86)
+                if (::has_cpu_feature(cpu_feature::ssse3)) {
+                    columns actual(cnt);
+                    ::decode_segments_ssse3(actual.get(), segments.data(), stride, cnt);
+                    Assert::IsTrue(expected == actual, L"SSSE3 decoder", LINE_INFO());
+                }
+
+                if (::has_cpu_feature(cpu_feature::avx2)) {
+                    columns actual(cnt);
+                    ::decode_segments_avx2(actual.get(), segments.data(), stride, cnt);
+                    Assert::IsTrue(expected == actual, L"AVX2 decoder", LINE_INFO());
+                }
+#endif /* defined(POWENETICS_X86) */
+            }
+        }
+
+        TEST_METHOD(scaling) {
+            std::vector<std::uint16_t> voltages;
+            std::vector<std::uint32_t> currents;
+            for (std::uint32_t i = 0; i < 37; ++i) {
+                voltages.push_back(static_cast<std::uint16_t>(i * 1771));
+                currents.push_back(i * 453377);
+            }
+
+            std::vector<float> expected(voltages.size());
+            std::vector<float> actual(voltages.size());
+
+            ::scale_voltages_scalar(expected.data(), voltages.data(), voltages.size());
+            ::select_voltage_scaler()(actual.data(), voltages.data(), voltages.size());
+            Assert::IsTrue(expected == actual, L"Voltages scaled exactly", LINE_INFO());
+            Assert::AreEqual(1.771f, expected[1], 0.0001f, L"Voltage in Volts", LINE_INFO());
+
+            ::scale_currents_scalar(expected.data(), currents.data(), currents.size());
+            ::select_current_scaler()(actual.data(), currents.data(), currents.size());
+            Assert::IsTrue(expected == actual, L"Currents scaled exactly", LINE_INFO());
+            Assert::AreEqual(453.377f, expected[1], 0.001f, L"Current in Amperes", LINE_INFO());
+
+#if defined(POWENETICS_X86)
+            if (::has_cpu_feature(cpu_feature::sse2)) {
+                ::scale_voltages_scalar(expected.data(), voltages.data(), voltages.size());
+                ::scale_voltages_sse2(actual.data(), voltages.data(), voltages.size());
+                Assert::IsTrue(expected == actual, L"SSE2 voltages", LINE_INFO());
+
+                ::scale_currents_scalar(expected.data(), currents.data(), currents.size());
+                ::scale_currents_sse2(actual.data(), currents.data(), currents.size());
+                Assert::IsTrue(expected == actual, L"SSE2 currents", LINE_INFO());
+            }
+#endif /* defined(POWENETICS_X86) */
+        }
+
+    };
+
+} /* namespace functions */
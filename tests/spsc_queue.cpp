@@ -0,0 +1,167 @@
+﻿// <copyright file="spsc_queue.cpp" company="Visualisierungsinstitut der Universität Stuttgart">
+// Copyright © 2026 Visualisierungsinstitut der Universität Stuttgart.
+// Licensed under the MIT licence. See LICENCE file for details.
+// </copyright>
+// <author>Christoph Müller</author>
+
+#include <CppUnitTest.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "spsc_queue.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+
+namespace types {
+
+    /// <summary>
+    /// Test the lock-free ring buffer between the streaming thread and the
+    /// consumer of the samples.
+    /// </summary>
+    TEST_CLASS(spsc_queue) {
+
+        TEST_METHOD(capacity) {
+            Assert::AreEqual(std::size_t(1), ::spsc_queue<int>(0).capacity(), L"Minimum capacity", LINE_INFO());
+            Assert::AreEqual(std::size_t(8), ::spsc_queue<int>(8).capacity(), L"Power of two", LINE_INFO());
+            Assert::AreEqual(std::size_t(16), ::spsc_queue<int>(9).capacity(), L"Rounded up", LINE_INFO());
+        }
+
+        TEST_METHOD(push_and_pop) {
+            ::spsc_queue<int> queue(4);
+            int dst[8];
+
+            Assert::IsTrue(queue.empty(), L"Initially empty", LINE_INFO());
+            Assert::AreEqual(std::size_t(0), queue.pop(dst, 8), L"Nothing to pop", LINE_INFO());
+
+            for (int i = 0; i < 4; ++i) {
+                Assert::IsTrue(queue.push(i), L"Push succeeds", LINE_INFO());
+            }
+            Assert::IsFalse(queue.push(4), L"Queue full", LINE_INFO());
+            Assert::AreEqual(std::size_t(4), queue.size(), L"Queue size", LINE_INFO());
+
+            Assert::AreEqual(std::size_t(3), queue.pop(dst, 3), L"Partial pop", LINE_INFO());
+            Assert::AreEqual(0, dst[0], L"dst[0]", LINE_INFO());
+            Assert::AreEqual(2, dst[2], L"dst[2]", LINE_INFO());
+
+            // Wrap around the end of the buffer.
+            Assert::IsTrue(queue.push(4), L"Room after pop", LINE_INFO());
+            Assert::IsTrue(queue.push(5), L"Room after pop", LINE_INFO());
+            Assert::IsTrue(queue.push(6), L"Room after pop", LINE_INFO());
+            Assert::IsFalse(queue.push(7), L"Queue full again", LINE_INFO());
+
+            Assert::AreEqual(std::size_t(4), queue.pop(dst, 8), L"Pop what is there", LINE_INFO());
+            for (int i = 0; i < 4; ++i) {
+                Assert::AreEqual(i + 3, dst[i], L"In order across wrap", LINE_INFO());
+            }
+            Assert::IsTrue(queue.empty(), L"Empty after pop", LINE_INFO());
+        }
+
+        TEST_METHOD(evict) {
+            ::spsc_queue<int> queue(8);
+            int dst[8];
+            int evicted = -1;
+
+            Assert::IsFalse(queue.evict(evicted), L"Nothing to evict", LINE_INFO());
+
+            for (int i = 0; i < 4; ++i) {
+                Assert::IsTrue(queue.push(i), L"Push succeeds", LINE_INFO());
+            }
+            Assert::IsTrue(queue.evict(evicted), L"Eviction succeeds", LINE_INFO());
+            Assert::AreEqual(0, evicted, L"Oldest evicted", LINE_INFO());
+
+            Assert::AreEqual(std::size_t(3), queue.pop(dst, 8), L"Remaining popped", LINE_INFO());
+            Assert::AreEqual(1, dst[0], L"dst[0]", LINE_INFO());
+            Assert::IsTrue(queue.empty(), L"Empty after pop", LINE_INFO());
+        }
+
+        TEST_METHOD(concurrent) {
+            const std::size_t total = 1000000;
+            ::spsc_queue<std::size_t> queue(64);
+
+            std::thread producer([&queue, total](void) {
+                for (std::size_t i = 0; i < total; ) {
+                    if (queue.push(i)) {
+                        ++i;
+                    } else {
+                        std::this_thread::yield();
+                    }
+                }
+            });
+
+            std::vector<std::size_t> dst(17);
+            std::size_t expected = 0;
+            auto in_order = true;
+            while (expected < total) {
+                const auto cnt = queue.pop(dst.data(), dst.size());
+                for (std::size_t i = 0; i < cnt; ++i) {
+                    in_order &= (dst[i] == expected++);
+                }
+                if (cnt == 0) {
+                    std::this_thread::yield();
+                }
+            }
+
+            producer.join();
+            Assert::IsTrue(in_order, L"All elements received in order", LINE_INFO());
+            Assert::IsTrue(queue.empty(), L"Nothing left", LINE_INFO());
+        }
+
+        TEST_METHOD(concurrent_evict) {
+            const std::size_t total = 1000000;
+            ::spsc_queue<std::size_t> queue(64);
+            std::atomic<bool> done(false);
+            std::size_t evicted = 0;
+            std::size_t rejected = 0;
+
+            // The producer never fills more than half of the queue and evicts
+            // the oldest element instead, which forces the consumer to drop
+            // the copies of elements evicted while it copies them.
+            std::thread producer([&](void) {
+                const auto half = queue.capacity() / 2;
+                for (std::size_t i = 0; i < total; ++i) {
+                    std::size_t element;
+                    if ((queue.size() >= half) && queue.evict(element)) {
+                        ++evicted;
+                    }
+
+                    if ((queue.size() < half) && queue.push(i)) {
+                        continue;
+                    }
+
+                    ++rejected;
+                }
+                done.store(true);
+            });
+
+            std::vector<std::size_t> dst(17);
+            std::size_t next = 0;
+            std::size_t received = 0;
+            auto in_order = true;
+            while (true) {
+                const auto finished = done.load();
+                const auto cnt = queue.pop(dst.data(), dst.size());
+                for (std::size_t i = 0; i < cnt; ++i) {
+                    in_order &= (dst[i] >= next);
+                    next = dst[i] + 1;
+                }
+                received += cnt;
+
+                if (cnt == 0) {
+                    if (finished) {
+                        break;
+                    }
+                    std::this_thread::yield();
+                }
+            }
+
+            producer.join();
+            Assert::IsTrue(in_order, L"Order preserved", LINE_INFO());
+            Assert::AreEqual(total, received + evicted + rejected, L"All elements accounted for", LINE_INFO());
+        }
+
+    };
+
+} /* namespace types */
@@ -0,0 +1,375 @@
+﻿// <copyright file="stream_parser_v2.cpp" company="Visualisierungsinstitut der Universität Stuttgart">
+// Copyright © 2026 Visualisierungsinstitut der Universität Stuttgart.
+// Licensed under the MIT licence. See LICENCE file for details.
+// </copyright>
+// <author>Christoph Müller</author>
+
+#include <CppUnitTest.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "stream_parser_v2.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+
+namespace types {
+
+    /// <summary>
+    /// Test the parser for the data stream from the Powenetics v2 device.
+    /// </summary>
+    TEST_CLASS(stream_parser_v2) {
+
+        /// <summary>
+        /// Appends a segment with the given sequence number and all channels
+        /// set to 12V and 1A to <paramref name="dst" />.
+        /// </summary>
+        static void append_segment(std::vector<std::uint8_t>& dst,
+                const std::uint16_t sequence_number) {
+            auto& delimiter = responses_v2::segment_delimiter;
+            dst.insert(dst.end(), delimiter.begin(), delimiter.end());
+
+            std::uint8_t buffer[5];
+            ::from_uint16(buffer, sequence_number);
+            dst.insert(dst.end(), buffer, buffer + 2);
+
+            for (int c = 0; c < 13; ++c) {
+                ::from_uint16(buffer, 12000);
+                ::from_uint24(buffer + 2, 1000);
+                dst.insert(dst.end(), buffer, buffer + 5);
+            }
+        }
+
+        /// <summary>
+        /// Creates a stream of <paramref name="cnt" /> segments, which is
+        /// terminated by a delimiter such that all segments can be parsed.
+        /// </summary>
+        static std::vector<std::uint8_t> make_stream(const std::size_t cnt) {
+            std::vector<std::uint8_t> retval;
+            for (std::size_t i = 0; i < cnt; ++i) {
+                append_segment(retval, static_cast<std::uint16_t>(i));
+            }
+
+            auto& delimiter = responses_v2::segment_delimiter;
+            retval.insert(retval.end(), delimiter.begin(), delimiter.end());
+
+            return retval;
+        }
+
+        /// <summary>
+        /// Feeds <paramref name="stream" /> in chunks of
+        /// <paramref name="chunk" /> bytes to a new parser and returns the
+        /// sequence numbers of all samples that have been delivered.
+        /// </summary>
+        static std::vector<std::uint16_t> parse(
+                const std::vector<std::uint8_t>& stream,
+                const std::size_t chunk) {
+            ::stream_parser_v2 parser;
+            std::vector<std::uint16_t> retval;
+
+            for (std::size_t i = 0; i < stream.size(); i += chunk) {
+                const auto cnt = (std::min)(chunk, stream.size() - i);
+                parser.push_back(stream.data() + i, cnt,
+                        [&retval](const powenetics_sample& s) {
+                    retval.push_back(s.sequence_number);
+                });
+            }
+
+            return retval;
+        }
+
+        TEST_METHOD(single_chunk) {
+            const auto stream = make_stream(64);
+            const auto actual = parse(stream, stream.size());
+            Assert::AreEqual(std::size_t(64), actual.size(), L"All segments parsed", LINE_INFO());
+            for (std::size_t i = 0; i < actual.size(); ++i) {
+                Assert::AreEqual(int(i), int(actual[i]), L"Sequence preserved", LINE_INFO());
+            }
+        }
+
+        TEST_METHOD(values) {
+            // The first segment is only delivered once the second one has
+            // confirmed its sequence number.
+            const auto stream = make_stream(2);
+            ::stream_parser_v2 parser;
+            powenetics_sample sample;
+            std::size_t cnt = 0;
+
+            parser.push_back(stream.data(), stream.size(),
+                    [&](const powenetics_sample& s) {
+                sample = s;
+                ++cnt;
+            });
+
+            Assert::AreEqual(std::size_t(2), cnt, L"Two samples", LINE_INFO());
+            Assert::AreEqual(std::uint32_t(3), sample.version, L"Version", LINE_INFO());
+            Assert::AreEqual(12.0f, sample.atx_12v.voltage, 0.0001f, L"ATX 12V voltage", LINE_INFO());
+            Assert::AreEqual(1.0f, sample.atx_12v.current, 0.0001f, L"ATX 12V current", LINE_INFO());
+            Assert::AreEqual(12.0f, sample.pcie_12v1.voltage, 0.0001f, L"PCIe #1 voltage", LINE_INFO());
+            Assert::AreEqual(1.0f, sample.pcie_12v1.current, 0.0001f, L"PCIe #1 current", LINE_INFO());
+        }
+
+        TEST_METHOD(raw_values) {
+            // The first segment is only delivered once the second one has
+            // confirmed its sequence number.
+            const auto stream = make_stream(2);
+            ::stream_parser_v2 parser;
+            powenetics_raw_sample sample;
+            std::size_t cnt = 0;
+
+            parser.push_back<powenetics_raw_sample>(stream.data(), stream.size(),
+                    [&](const powenetics_raw_sample& s) {
+                sample = s;
+                ++cnt;
+            });
+
+            Assert::AreEqual(std::size_t(2), cnt, L"Two samples", LINE_INFO());
+            Assert::AreEqual(std::uint32_t(3), sample.version, L"Version", LINE_INFO());
+            Assert::AreEqual(std::uint16_t(12000), sample.atx_12v.voltage, L"ATX 12V voltage", LINE_INFO());
+            Assert::AreEqual(std::uint32_t(1000), sample.atx_12v.current, L"ATX 12V current", LINE_INFO());
+            Assert::AreEqual(std::uint16_t(12000), sample.pcie_12v1.voltage, L"PCIe #1 voltage", LINE_INFO());
+            Assert::AreEqual(std::uint32_t(1000), sample.pcie_12v1.current, L"PCIe #1 current", LINE_INFO());
+        }
+
+        TEST_METHOD(fragmented) {
+            const auto stream = make_stream(16);
+            const auto expected = parse(stream, stream.size());
+
+            for (std::size_t chunk = 1; chunk < 2 * 69 + 3; ++chunk) {
+                const auto actual = parse(stream, chunk);
+                Assert::IsTrue(expected == actual, L"Fragmentation does not change result", LINE_INFO());
+            }
+        }
+
+        TEST_METHOD(leading_garbage) {
+            std::vector<std::uint8_t> stream { 0x01, 0xAC, 0xCA, 0x17 };
+            const auto segments = make_stream(4);
+            stream.insert(stream.end(), segments.begin(), segments.end());
+
+            for (std::size_t chunk = 1; chunk <= stream.size(); ++chunk) {
+                const auto actual = parse(stream, chunk);
+                Assert::AreEqual(std::size_t(4), actual.size(), L"Garbage discarded", LINE_INFO());
+            }
+        }
+
+        TEST_METHOD(oversized_segment) {
+            std::vector<std::uint8_t> stream;
+            append_segment(stream, 0);
+            stream.insert(stream.end(), 200, 0x42);
+            const auto segments = make_stream(2);
+            stream.insert(stream.end(), segments.begin(), segments.end());
+
+            for (std::size_t chunk = 1; chunk <= stream.size(); ++chunk) {
+                const auto actual = parse(stream, chunk);
+                Assert::AreEqual(std::size_t(2), actual.size(), L"Oversized segment discarded", LINE_INFO());
+            }
+        }
+
+        TEST_METHOD(delimiter_in_payload) {
+            // 0xCAAC as sequence number puts a delimiter at the begin of the
+            // payload, which must not split the segment.
+            std::vector<std::uint8_t> stream;
+            append_segment(stream, 0xCAAB);
+            append_segment(stream, 0xCAAC);
+            append_segment(stream, 0xCAAD);
+            auto& delimiter = responses_v2::segment_delimiter;
+            stream.insert(stream.end(), delimiter.begin(), delimiter.end());
+
+            for (std::size_t chunk = 1; chunk <= stream.size(); ++chunk) {
+                const auto actual = parse(stream, chunk);
+                Assert::AreEqual(std::size_t(3), actual.size(), L"All segments parsed", LINE_INFO());
+                Assert::AreEqual(int(0xCAAC), int(actual[1]), L"Segment with delimiter in payload", LINE_INFO());
+            }
+        }
+
+        TEST_METHOD(false_lock) {
+            // A correctly framed segment after a resync that neither continues
+            // the sequence nor is continued by the next one, as if the parser
+            // had found a delimiter in the payload, must not be delivered. The
+            // garbage breaks the framing of segment 3, too.
+            std::vector<std::uint8_t> stream;
+            for (std::uint16_t i = 0; i < 4; ++i) {
+                append_segment(stream, i);
+            }
+            stream.insert(stream.end(), 7, 0x42);
+            append_segment(stream, 0x9999);
+            append_segment(stream, 10);
+            append_segment(stream, 11);
+            auto& delimiter = responses_v2::segment_delimiter;
+            stream.insert(stream.end(), delimiter.begin(), delimiter.end());
+
+            const std::vector<std::uint16_t> expected { 0, 1, 2, 10, 11 };
+            for (std::size_t chunk = 1; chunk <= stream.size(); ++chunk) {
+                const auto actual = parse(stream, chunk);
+                Assert::IsTrue(expected == actual, L"False lock discarded", LINE_INFO());
+            }
+
+            ::stream_parser_v2 parser;
+            parser.push_back(stream.data(), stream.size(), [](const powenetics_sample&) { });
+            const auto statistics = parser.collect_statistics();
+            Assert::AreEqual(std::uint64_t(2), statistics.segments_rejected, L"Broken segment and segment breaking the sequence rejected", LINE_INFO());
+        }
+
+        TEST_METHOD(gaps_while_locked) {
+            // Once locked, correctly framed segments are delivered even if
+            // two gaps are only two segments apart.
+            const std::vector<std::uint16_t> expected { 0, 1, 2, 5, 8, 9, 10 };
+            std::vector<std::uint8_t> stream;
+            for (auto s : expected) {
+                append_segment(stream, s);
+            }
+            auto& delimiter = responses_v2::segment_delimiter;
+            stream.insert(stream.end(), delimiter.begin(), delimiter.end());
+
+            for (std::size_t chunk = 1; chunk <= stream.size(); ++chunk) {
+                const auto actual = parse(stream, chunk);
+                Assert::IsTrue(expected == actual, L"All segments delivered", LINE_INFO());
+            }
+
+            ::stream_parser_v2 parser;
+            parser.push_back(stream.data(), stream.size(), [](const powenetics_sample&) { });
+            const auto statistics = parser.collect_statistics();
+            Assert::AreEqual(std::uint64_t(0), statistics.segments_rejected, L"No segment rejected", LINE_INFO());
+            Assert::AreEqual(std::uint64_t(2), statistics.sequence_gaps, L"Gaps counted", LINE_INFO());
+            Assert::AreEqual(std::uint64_t(4), statistics.samples_missing, L"Missing samples counted", LINE_INFO());
+        }
+
+        TEST_METHOD(framing) {
+            const auto stream = make_stream(3);
+            ::stream_parser_v2 parser;
+            auto callback = [](const powenetics_sample&) { };
+            Assert::AreEqual(int(framing_state::hunting), int(parser.framing()), L"Initially hunting", LINE_INFO());
+
+            parser.push_back(stream.data(), 69 + 2, callback);
+            Assert::AreEqual(int(framing_state::acquiring), int(parser.framing()), L"Acquiring after one segment", LINE_INFO());
+
+            parser.push_back(stream.data() + 69 + 2, stream.size() - 69 - 2, callback);
+            Assert::AreEqual(int(framing_state::locked), int(parser.framing()), L"Locked after consecutive segments", LINE_INFO());
+
+            std::vector<std::uint8_t> garbage(100, 0x42);
+            parser.push_back(garbage.data(), garbage.size(), callback);
+            Assert::AreEqual(int(framing_state::hunting), int(parser.framing()), L"Lost lock on garbage", LINE_INFO());
+        }
+
+        TEST_METHOD(statistics) {
+            std::vector<std::uint8_t> stream { 0x01, 0xAC, 0xCA, 0x17 };
+            append_segment(stream, 0);
+            stream.insert(stream.end(), 200, 0x42);
+            const auto segments = make_stream(2);
+            stream.insert(stream.end(), segments.begin(), segments.end());
+
+            for (std::size_t chunk = 1; chunk <= stream.size(); ++chunk) {
+                ::stream_parser_v2 parser;
+                std::size_t carry_overs = 0;
+
+                for (std::size_t i = 0; i < stream.size(); i += chunk) {
+                    const auto cnt = (std::min)(chunk, stream.size() - i);
+                    if (parser.push_back(stream.data() + i, cnt, [](const powenetics_sample&) { })) {
+                        ++carry_overs;
+                    }
+                }
+
+                const auto actual = parser.collect_statistics();
+                Assert::AreEqual(std::uint64_t(2), actual.segments_parsed, L"Segments parsed", LINE_INFO());
+                Assert::AreEqual(std::uint64_t(1), actual.segments_rejected, L"Segments rejected", LINE_INFO());
+                Assert::AreEqual(std::uint64_t(4 + 67 + 200), actual.bytes_discarded, L"Garbage and oversized segment discarded", LINE_INFO());
+                Assert::AreEqual(std::uint64_t(carry_overs), actual.carry_overs, L"Carry-overs", LINE_INFO());
+
+                const auto reset = parser.collect_statistics();
+                Assert::AreEqual(std::uint64_t(0), reset.segments_parsed, L"Counters reset", LINE_INFO());
+            }
+        }
+
+        TEST_METHOD(sequence_gaps) {
+            const std::uint16_t sequence[] = { 7, 8, 9, 12, 13, 65534, 65535, 0, 1 };
+            std::vector<std::uint8_t> stream;
+            for (auto s : sequence) {
+                append_segment(stream, s);
+            }
+            auto& delimiter = responses_v2::segment_delimiter;
+            stream.insert(stream.end(), delimiter.begin(), delimiter.end());
+
+            ::stream_parser_v2 parser;
+            std::vector<powenetics_sample> samples;
+            parser.push_back(stream.data(), stream.size(), [&samples](const powenetics_sample& s) {
+                samples.push_back(s);
+            });
+
+            const std::uint64_t expected_index[] = { 0, 1, 2, 5, 6, 65527, 65528, 65529, 65530 };
+            const std::uint32_t expected_missing[] = { 0, 0, 0, 2, 0, 65520, 0, 0, 0 };
+            Assert::AreEqual(std::size_t(9), samples.size(), L"All segments parsed", LINE_INFO());
+            for (std::size_t i = 0; i < samples.size(); ++i) {
+                Assert::AreEqual(expected_index[i], samples[i].index, L"Index", LINE_INFO());
+                Assert::AreEqual(expected_missing[i], samples[i].missing, L"Missing", LINE_INFO());
+            }
+
+            const auto statistics = parser.collect_statistics();
+            Assert::AreEqual(std::uint64_t(2), statistics.sequence_gaps, L"Gaps counted", LINE_INFO());
+            Assert::AreEqual(std::uint64_t(65522), statistics.samples_missing, L"Missing samples counted", LINE_INFO());
+        }
+
+        TEST_METHOD(connector_profile) {
+            // Two segments with all connectors, then PCIe #2 powers down.
+            auto stream = make_stream(4);
+            const auto pcie_12v2 = 2 + 2 + 5 * 9;
+            ::from_uint16(stream.data() + 2 * 69 + pcie_12v2, 0);
+            ::from_uint16(stream.data() + 3 * 69 + pcie_12v2, 0);
+
+            ::stream_parser_v2 parser;
+            Assert::AreEqual(int(connector_profile_unknown), int(parser.profile()), L"Profile unknown before first segment", LINE_INFO());
+
+            std::vector<powenetics_raw_sample> samples;
+            parser.push_back<powenetics_raw_sample>(stream.data(), stream.size(),
+                    [&samples](const powenetics_raw_sample& s) {
+                samples.push_back(s);
+            });
+
+            Assert::AreEqual(std::size_t(4), samples.size(), L"All segments parsed", LINE_INFO());
+            Assert::AreEqual(std::uint32_t(1000), samples[1].pcie_12v2.current, L"PCIe #2 powered", LINE_INFO());
+            Assert::AreEqual(std::uint16_t(0), samples[2].pcie_12v2.voltage, L"PCIe #2 voltage", LINE_INFO());
+            Assert::AreEqual(std::uint32_t(0), samples[2].pcie_12v2.current, L"PCIe #2 current discarded", LINE_INFO());
+            Assert::AreEqual(std::uint32_t(1000), samples[3].pcie_12v1.current, L"PCIe #1 still powered", LINE_INFO());
+            Assert::AreEqual(int(connector_profile_pcie_12v1 | connector_profile_pcie_12v3), int(parser.profile()), L"Profile switched", LINE_INFO());
+        }
+
+        TEST_METHOD(interpolated_timestamps) {
+            // Deliver ten segments per read, one read every 10 ms.
+            const auto stream = make_stream(100);
+            const auto read = 10 * 69;
+            ::stream_parser_v2 parser;
+            parser.timestamping(powenetics_timestamping::interpolated);
+
+            std::vector<powenetics_timestamp> timestamps;
+            for (std::size_t i = 0; i < stream.size(); i += read) {
+                const auto cnt = (std::min)(std::size_t(read), stream.size() - i);
+                parser.received(100000 * (i / read + 1));
+                parser.push_back(stream.data() + i, cnt, [&timestamps](const powenetics_sample& s) {
+                    timestamps.push_back(s.timestamp);
+                });
+            }
+
+            // The first read cannot be interpolated, the second one is
+            // extrapolated from the first two observations, which are one
+            // read apart. Afterwards, the samples must be 1 ms apart.
+            Assert::IsTrue(timestamps.size() >= 90, L"Segments parsed", LINE_INFO());
+            for (std::size_t i = 30; i < timestamps.size(); ++i) {
+                Assert::AreEqual(std::int64_t(10000), timestamps[i] - timestamps[i - 1], L"Evenly spaced", LINE_INFO());
+            }
+        }
+
+        TEST_METHOD(flush) {
+            const auto stream = make_stream(2);
+            ::stream_parser_v2 parser;
+            std::size_t cnt = 0;
+            auto callback = [&cnt](const powenetics_sample&) { ++cnt; };
+
+            Assert::IsTrue(parser.push_back(stream.data(), 50, callback), L"Incomplete segment retained", LINE_INFO());
+            parser.flush();
+            Assert::IsFalse(parser.push_back(stream.data() + 50, 19, callback), L"Nothing retained before the next delimiter", LINE_INFO());
+            Assert::AreEqual(std::size_t(0), cnt, L"Flushed segment not delivered", LINE_INFO());
+        }
+
+    };
+
+} /* namespace types */
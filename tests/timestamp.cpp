@@ -1,5 +1,5 @@
 ﻿// <copyright file="timestamp.cpp" company="Visualisierungsinstitut der Universität Stuttgart">
-// Copyright © 2023 - 2024 Visualisierungsinstitut der Universität Stuttgart.
+// Copyright © 2023 - 2026 Visualisierungsinstitut der Universität Stuttgart.
 // Licensed under the MIT licence. See LICENCE file for details.
 // </copyright>
 // <author>Christoph Müller</author>
@@ -27,6 +27,60 @@ namespace functions {
             Assert::IsTrue(expected - actual < 100, L"STL timestamp close to FILETIME", LINE_INFO());
         }
 
+        TEST_METHOD(read_clock) {
+            const powenetics_clock clocks[] = {
+                powenetics_clock::system_time,
+                powenetics_clock::monotonic,
+                powenetics_clock::monotonic_raw,
+                powenetics_clock::tsc
+            };
+
+            for (auto c : clocks) {
+                powenetics_timestamp t0, t1;
+                std::uint64_t frequency;
+                const auto hr = ::powenetics_read_clock(&t0, c);
+
+                if (hr == E_NOTIMPL) {
+                    Assert::IsTrue(c == powenetics_clock::tsc, L"Only TSC is optional", LINE_INFO());
+                    Assert::AreEqual(E_NOTIMPL, ::powenetics_get_clock_frequency(&frequency, c), L"No frequency for missing TSC", LINE_INFO());
+                    continue;
+                }
+
+                Assert::AreEqual(S_OK, hr, L"Clock read", LINE_INFO());
+                Assert::AreEqual(S_OK, ::powenetics_read_clock(&t1, c), L"Clock read", LINE_INFO());
+                Assert::IsTrue(t1 >= t0, L"Clock does not go backwards", LINE_INFO());
+                Assert::AreEqual(S_OK, ::powenetics_get_clock_frequency(&frequency, c), L"Frequency", LINE_INFO());
+                Assert::IsTrue(frequency >= 10000000, L"At least 100ns resolution", LINE_INFO());
+            }
+
+            powenetics_timestamp t;
+            Assert::AreEqual(E_POINTER, ::powenetics_read_clock(nullptr, powenetics_clock::monotonic), L"nullptr", LINE_INFO());
+            Assert::AreEqual(E_INVALIDARG, ::powenetics_read_clock(&t, static_cast<powenetics_clock>(42)), L"Invalid clock", LINE_INFO());
+        }
+
+        TEST_METHOD(convert) {
+            powenetics_timestamp system, monotonic, converted;
+            Assert::AreEqual(S_OK, ::powenetics_read_clock(&system, powenetics_clock::system_time), L"System time", LINE_INFO());
+            Assert::AreEqual(S_OK, ::powenetics_read_clock(&monotonic, powenetics_clock::monotonic), L"Monotonic time", LINE_INFO());
+
+            Assert::AreEqual(S_OK, ::powenetics_convert_timestamp(&converted, powenetics_clock::system_time, monotonic, powenetics_clock::monotonic), L"Convert", LINE_INFO());
+            Assert::IsTrue(std::abs(converted - system) < 10000, L"Converted within 1 ms", LINE_INFO());
+
+            Assert::AreEqual(S_OK, ::powenetics_convert_timestamp(&converted, powenetics_clock::monotonic, monotonic, powenetics_clock::monotonic), L"Identity", LINE_INFO());
+            Assert::AreEqual(monotonic, converted, L"Identity", LINE_INFO());
+
+            std::uint64_t frequency;
+            if (SUCCEEDED(::powenetics_get_clock_frequency(&frequency, powenetics_clock::tsc))) {
+                powenetics_timestamp tsc, back;
+                Assert::AreEqual(S_OK, ::powenetics_convert_timestamp(&tsc, powenetics_clock::tsc, monotonic, powenetics_clock::monotonic), L"To TSC", LINE_INFO());
+                Assert::AreEqual(S_OK, ::powenetics_convert_timestamp(&back, powenetics_clock::monotonic, tsc, powenetics_clock::tsc), L"From TSC", LINE_INFO());
+                Assert::IsTrue(std::abs(back - monotonic) < 10000, L"Round trip within 1 ms", LINE_INFO());
+            }
+
+            Assert::AreEqual(E_POINTER, ::powenetics_convert_timestamp(nullptr, powenetics_clock::monotonic, 0, powenetics_clock::system_time), L"nullptr", LINE_INFO());
+            Assert::AreEqual(E_INVALIDARG, ::powenetics_convert_timestamp(&converted, static_cast<powenetics_clock>(42), 0, powenetics_clock::system_time), L"Invalid clock", LINE_INFO());
+        }
+
     };
 
 } /* namespace functions */
@@ -0,0 +1,84 @@
+﻿// <copyright file="timestamp_estimator.cpp" company="Visualisierungsinstitut der Universität Stuttgart">
+// Copyright © 2026 Visualisierungsinstitut der Universität Stuttgart.
+// Licensed under the MIT licence. See LICENCE file for details.
+// </copyright>
+// <author>Christoph Müller</author>
+
+#include <CppUnitTest.h>
+
+#include <random>
+
+#include "timestamp_estimator.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+
+namespace types {
+
+    /// <summary>
+    /// Test the reconstruction of sample times from the times of reads.
+    /// </summary>
+    TEST_CLASS(timestamp_estimator) {
+
+        TEST_METHOD(unfitted) {
+            ::timestamp_estimator estimator;
+            Assert::AreEqual(0.0, estimator.period(), L"No period before first observation", LINE_INFO());
+            Assert::AreEqual(std::int64_t(1000), estimator.estimate(0, 1000), L"Time of read before first observation", LINE_INFO());
+
+            estimator.observe(0, 1000);
+            Assert::AreEqual(0.0, estimator.period(), L"No period after first observation", LINE_INFO());
+            Assert::AreEqual(std::int64_t(2000), estimator.estimate(1, 2000), L"Time of read after first observation", LINE_INFO());
+        }
+
+        TEST_METHOD(linear) {
+            // 1 ms per sample, ten samples per read.
+            const std::int64_t t0 = 133000000000000000LL;
+            ::timestamp_estimator estimator;
+
+            for (std::uint64_t i = 9; i < 1000; i += 10) {
+                estimator.observe(i, t0 + 10000 * i);
+            }
+
+            Assert::AreEqual(10000.0, estimator.period(), 0.001, L"Period", LINE_INFO());
+            for (std::uint64_t i = 1000; i < 1010; ++i) {
+                const auto expected = t0 + 10000 * std::int64_t(i);
+                Assert::AreEqual(expected, estimator.estimate(i, t0 + 10000 * 1009), L"Interpolated", LINE_INFO());
+            }
+        }
+
+        TEST_METHOD(jitter) {
+            const std::int64_t t0 = 133000000000000000LL;
+            std::mt19937 rng(42);
+            std::uniform_int_distribution<std::int64_t> latency(0, 20000);
+            ::timestamp_estimator estimator;
+
+            // The clock of the device is 100 ppm slow compared to the host.
+            const auto period = 10001.0;
+            for (std::uint64_t i = 9; i < 100000; i += 10) {
+                estimator.observe(i, t0 + std::int64_t(period * i) + latency(rng));
+            }
+
+            Assert::AreEqual(period, estimator.period(), 1.0, L"Drift tracked", LINE_INFO());
+
+            // The offset includes the average latency of 1 ms.
+            const auto i = 100000;
+            const auto expected = t0 + std::int64_t(period * i) + 10000;
+            const auto actual = estimator.estimate(i, t0 + std::int64_t(period * (i + 10)));
+            Assert::IsTrue(std::abs(expected - actual) < 2000, L"Offset within 0.2 ms", LINE_INFO());
+        }
+
+        TEST_METHOD(clamped) {
+            ::timestamp_estimator estimator;
+            estimator.observe(0, 0);
+            estimator.observe(10, 100);
+
+            Assert::AreEqual(std::int64_t(150), estimator.estimate(20, 150), L"Not later than read", LINE_INFO());
+            Assert::AreEqual(std::int64_t(150), estimator.estimate(12, 200), L"Monotonic", LINE_INFO());
+            Assert::AreEqual(std::int64_t(160), estimator.estimate(16, 200), L"Interpolated", LINE_INFO());
+
+            estimator.reset();
+            Assert::AreEqual(std::int64_t(5), estimator.estimate(16, 5), L"Reset", LINE_INFO());
+        }
+    };
+
+} /* namespace types */
@@ -0,0 +1,143 @@
+﻿// <copyright file="uring_reader.cpp" company="Visualisierungsinstitut der Universität Stuttgart">
+// Copyright © 2026 Visualisierungsinstitut der Universität Stuttgart.
+// Licensed under the MIT licence. See LICENCE file for details.
+// </copyright>
+// <author>Christoph Müller</author>
+
+#include <CppUnitTest.h>
+
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+#include "uring_reader.h"
+
+#if defined(POWENETICS_IO_URING)
+#include <unistd.h>
+
+#include "wake_event.h"
+#endif /* defined(POWENETICS_IO_URING) */
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+
+namespace types {
+
+    /// <summary>
+    /// Test the reader keeping multiple reads in flight in an io_uring.
+    /// </summary>
+    TEST_CLASS(uring_reader) {
+
+        TEST_METHOD(in_order) {
+#if defined(POWENETICS_IO_URING)
+            int pipe[2];
+            Assert::AreEqual(0, ::pipe(pipe), L"Pipe created", LINE_INFO());
+
+            ::uring_reader reader;
+            auto hr = reader.open(pipe[0], -1, 4, 64);
+            if (hr == E_NOTIMPL) {
+                // The kernel does not allow for using io_uring.
+                ::close(pipe[0]);
+                ::close(pipe[1]);
+                return;
+            }
+            Assert::AreEqual(S_OK, hr, L"Reader opened", LINE_INFO());
+
+            // Write much more than the buffers in flight can hold in chunks
+            // that do not fit into a buffer, such that the data are split
+            // across multiple chains of reads.
+            const std::size_t total = 256 * 1024;
+            std::thread writer([&pipe, total](void) {
+                std::vector<std::uint8_t> chunk(100);
+                std::size_t written = 0;
+                while (written < total) {
+                    for (std::size_t i = 0; i < chunk.size(); ++i) {
+                        chunk[i] = static_cast<std::uint8_t>(written + i);
+                    }
+                    auto cnt = ::write(pipe[1], chunk.data(),
+                        (std::min)(chunk.size(), total - written));
+                    if (cnt <= 0) {
+                        break;
+                    }
+                    written += cnt;
+                }
+            });
+
+            std::size_t reads = 0;
+            std::size_t received = 0;
+            auto in_order = true;
+            while ((received < total) && SUCCEEDED(reader.wait(1000))) {
+                const ::uring_reader::byte_type *data;
+                std::size_t cnt;
+
+                while (reader.next(data, cnt) == S_OK) {
+                    Assert::IsTrue(cnt <= 64, L"Read fits buffer", LINE_INFO());
+                    for (std::size_t i = 0; i < cnt; ++i) {
+                        in_order &= (data[i] == static_cast<std::uint8_t>(
+                            received + i));
+                    }
+                    received += cnt;
+                    ++reads;
+                }
+            }
+
+            writer.join();
+            Assert::AreEqual(total, received, L"All data received", LINE_INFO());
+            Assert::IsTrue(in_order, L"Data received in order", LINE_INFO());
+            Assert::IsTrue(reader.calls() < 2 * reads, L"Fewer calls than poll and read", LINE_INFO());
+
+            reader.close();
+            ::close(pipe[0]);
+            ::close(pipe[1]);
+#endif /* defined(POWENETICS_IO_URING) */
+        }
+
+        TEST_METHOD(timeout_and_wake) {
+#if defined(POWENETICS_IO_URING)
+            int pipe[2];
+            Assert::AreEqual(0, ::pipe(pipe), L"Pipe created", LINE_INFO());
+
+            wake_event wake;
+            Assert::AreEqual(S_OK, wake.open(), L"Event opened", LINE_INFO());
+
+            ::uring_reader reader;
+            Assert::AreEqual(E_NOT_VALID_STATE, reader.wait(0), L"Not open", LINE_INFO());
+
+            auto hr = reader.open(pipe[0], wake.handle(), 2, 16);
+            if (hr == E_NOTIMPL) {
+                ::close(pipe[0]);
+                ::close(pipe[1]);
+                return;
+            }
+            Assert::AreEqual(S_OK, hr, L"Reader opened", LINE_INFO());
+            Assert::AreEqual(E_NOT_VALID_STATE, reader.open(pipe[0], -1, 2, 16), L"Already open", LINE_INFO());
+
+            const ::uring_reader::byte_type *data;
+            std::size_t cnt;
+
+            Assert::AreEqual(S_OK, reader.wait(10), L"Timeout is no error", LINE_INFO());
+            Assert::AreEqual(S_FALSE, reader.next(data, cnt), L"Nothing read", LINE_INFO());
+            Assert::IsNull(data, L"No data", LINE_INFO());
+            Assert::IsFalse(reader.woken(), L"Not woken", LINE_INFO());
+
+            Assert::AreEqual(S_OK, wake.set(), L"Event set", LINE_INFO());
+            Assert::AreEqual(S_OK, reader.wait(1000), L"Woken", LINE_INFO());
+            Assert::AreEqual(S_FALSE, reader.next(data, cnt), L"Nothing read", LINE_INFO());
+            Assert::IsTrue(reader.woken(), L"Woken", LINE_INFO());
+
+            // After closing, no read must be pending that consumes the data.
+            reader.close();
+            const std::uint8_t expected = 42;
+            Assert::AreEqual(1, static_cast<int>(::write(pipe[1], &expected, 1)), L"Byte written", LINE_INFO());
+            std::uint8_t actual = 0;
+            Assert::AreEqual(1, static_cast<int>(::read(pipe[0], &actual, 1)), L"Byte still in pipe", LINE_INFO());
+            Assert::AreEqual(int(expected), int(actual), L"Byte read", LINE_INFO());
+
+            ::close(pipe[0]);
+            ::close(pipe[1]);
+#endif /* defined(POWENETICS_IO_URING) */
+        }
+
+    };
+
+} /* namespace types */